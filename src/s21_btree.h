@@ -0,0 +1,1346 @@
+#ifndef S21_BTREE_H
+#define S21_BTREE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "s21_tree_utility.h"
+
+namespace s21 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Storage for one element, constructed and destroyed by the tree. Map
+// slots overlay pair<const Key, T> with pair<Key, T>, so that shifting
+// elements around a node moves keys instead of copying them.
+template <typename Key, typename T>
+union BTreeSlot {
+  using value_type = std::pair<const Key, T>;
+  using mutable_type = std::pair<Key, T>;
+
+  BTreeSlot() {}
+  BTreeSlot(const BTreeSlot&) = delete;
+  BTreeSlot& operator=(const BTreeSlot&) = delete;
+  ~BTreeSlot() {}
+
+  value_type& Value() { return value_; }
+  mutable_type& Mutable() { return mutable_; }
+  const Key& GetKey() const { return value_.first; }
+
+  value_type value_;
+  mutable_type mutable_;
+};
+
+template <typename Key>
+union BTreeSlot<Key, void> {
+  using value_type = Key;
+  using mutable_type = Key;
+
+  BTreeSlot() {}
+  BTreeSlot(const BTreeSlot&) = delete;
+  BTreeSlot& operator=(const BTreeSlot&) = delete;
+  ~BTreeSlot() {}
+
+  value_type& Value() { return value_; }
+  mutable_type& Mutable() { return value_; }
+  const Key& GetKey() const { return value_; }
+
+  value_type value_;
+};
+
+template <typename Key, typename T>
+class BTreeInner;
+
+// Header shared by leaves and inner nodes
+template <typename Key, typename T>
+class BTreeNode {
+ public:
+  // A node spans a few cache lines, its slot count is derived from that
+  static constexpr std::size_t kTargetBytes{256};
+
+  explicit BTreeNode(bool leaf) : leaf_{leaf} {}
+  BTreeNode(const BTreeNode&) = delete;
+  BTreeNode& operator=(const BTreeNode&) = delete;
+
+  BTreeInner<Key, T>* parent_{nullptr};
+  // Elements in the whole subtree
+  std::size_t size_{0};
+  // Index among the parent's children
+  std::uint16_t position_{0};
+  // Elements of a leaf, separator keys of an inner node
+  std::uint16_t count_{0};
+  bool leaf_;
+};
+
+// Leaves hold the elements and are chained in key order, so iteration
+// never climbs back up the tree
+template <typename Key, typename T>
+class BTreeLeaf : public BTreeNode<Key, T> {
+  using Base = BTreeNode<Key, T>;
+
+ public:
+  using slot_type = BTreeSlot<Key, T>;
+  using value_type = typename slot_type::value_type;
+
+  static constexpr std::size_t kSlots{std::max<std::size_t>(
+      3, (Base::kTargetBytes - sizeof(Base) - 2 * sizeof(void*)) /
+             sizeof(slot_type))};
+
+  BTreeLeaf() : Base(true) {}
+  BTreeLeaf(const BTreeLeaf&) = delete;
+  BTreeLeaf& operator=(const BTreeLeaf&) = delete;
+
+  BTreeLeaf* prev_{nullptr};
+  BTreeLeaf* next_{nullptr};
+  slot_type slots_[kSlots]{};
+};
+
+// Inner nodes only route lookups: they hold copies of the keys that
+// separate their children
+template <typename Key, typename T>
+class BTreeInner : public BTreeNode<Key, T> {
+  using Base = BTreeNode<Key, T>;
+
+ public:
+  using key_slot_type = BTreeSlot<Key, void>;
+
+  static constexpr std::size_t kKeys{std::max<std::size_t>(
+      3, (Base::kTargetBytes - sizeof(Base) - sizeof(void*)) /
+             (sizeof(key_slot_type) + sizeof(void*)))};
+
+  BTreeInner() : Base(false) {}
+  BTreeInner(const BTreeInner&) = delete;
+  BTreeInner& operator=(const BTreeInner&) = delete;
+
+  key_slot_type keys_[kKeys]{};
+  Base* children_[kKeys + 1]{};
+};
+
+// Position in a leaf. The end iterator sits one past the last element of
+// the last leaf. Like the positions of any B-tree, iterators are
+// invalidated by every insert and erase.
+template <typename LeafType, bool is_const>
+class BTreeIterator {
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = typename LeafType::value_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = std::conditional_t<is_const, const value_type*, value_type*>;
+  using reference =
+      std::conditional_t<is_const, const value_type&, value_type&>;
+
+  BTreeIterator() = default;
+  BTreeIterator(LeafType* leaf, std::size_t position)
+      : leaf_{leaf}, position_{position} {}
+
+  template <bool other_is_const,
+            typename = std::enable_if_t<(is_const || !other_is_const)>>
+  BTreeIterator(const BTreeIterator<LeafType, other_is_const>& other)
+      : leaf_{other.leaf_}, position_{other.position_} {}
+
+  reference operator*() const { return leaf_->slots_[position_].Value(); }
+
+  pointer operator->() const { return &leaf_->slots_[position_].Value(); }
+
+  BTreeIterator& operator++() {
+    if (++position_ == leaf_->count_ && leaf_->next_) {
+      leaf_ = leaf_->next_;
+      position_ = 0;
+    }
+    return *this;
+  }
+
+  BTreeIterator operator++(int) {
+    BTreeIterator temp = *this;
+    ++*this;
+    return temp;
+  }
+
+  BTreeIterator& operator--() {
+    if (position_ == 0) {
+      leaf_ = leaf_->prev_;
+      position_ = leaf_->count_;
+    }
+    --position_;
+    return *this;
+  }
+
+  BTreeIterator operator--(int) {
+    BTreeIterator temp = *this;
+    --*this;
+    return temp;
+  }
+
+  template <bool other_is_const>
+  bool operator==(const BTreeIterator<LeafType, other_is_const>& other) const {
+    return leaf_ == other.leaf_ && position_ == other.position_;
+  }
+
+  template <bool other_is_const>
+  bool operator!=(const BTreeIterator<LeafType, other_is_const>& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  template <typename, bool>
+  friend class BTreeIterator;
+  template <typename, typename, typename, typename>
+  friend class BTree;
+
+  LeafType* leaf_{nullptr};
+  std::size_t position_{0};
+};
+
+// B+ tree: elements live in the leaves only, inner nodes route lookups
+// with copies of keys, so Key has to be copy constructible. Nodes are a
+// few cache lines wide, and a lookup touches one node per level of a tree
+// that is several times shallower than a red-black tree.
+//
+// With children c0..cn and separators k1..kn in an inner node, no key in
+// c(i-1) is greater than ki and no key in ci is less than it. Erasing
+// elements keeps that true, so erase never rewrites separators and never
+// copies a key. Moving values and keys must not throw.
+template <typename Key, typename T = void, typename Compare = std::less<Key>,
+          typename Allocator =
+              std::allocator<typename BTreeSlot<Key, T>::value_type>>
+class BTree {
+ public:
+  using node_type = BTreeNode<Key, T>;
+  using leaf_type = BTreeLeaf<Key, T>;
+  using inner_type = BTreeInner<Key, T>;
+
+ private:
+  using slot_type = typename leaf_type::slot_type;
+  using key_slot_type = typename inner_type::key_slot_type;
+  using mutable_type = typename slot_type::mutable_type;
+
+ public:
+  using value_type = typename slot_type::value_type;
+  using key_type = Key;
+  using mapped_type = T;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+  using iterator = BTreeIterator<leaf_type, false>;
+  using const_iterator = BTreeIterator<leaf_type, true>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  BTree() : BTree(Compare(), allocator_type()) {}
+  explicit BTree(const allocator_type& alloc) : BTree(Compare(), alloc) {}
+  explicit BTree(const Compare& compare,
+                 const allocator_type& alloc = allocator_type())
+      : compare_{compare}, alloc_{alloc} {}
+  BTree(const BTree&) = delete;
+  BTree(BTree&& other) noexcept
+      : compare_{other.compare_},
+        alloc_{other.alloc_},
+        root_{std::exchange(other.root_, nullptr)},
+        leftmost_{std::exchange(other.leftmost_, nullptr)},
+        rightmost_{std::exchange(other.rightmost_, nullptr)},
+        size_{std::exchange(other.size_, 0)} {}
+
+  ~BTree() { clear(); }
+
+  // O(n), other is sorted already, so every element is appended at the
+  // end. The allocator is kept unless it propagates on copy assignment.
+  BTree& operator=(const BTree& other) {
+    if (this != &other) {
+      if constexpr (alloc_traits::propagate_on_container_copy_assignment::
+                        value) {
+        if (alloc_ != other.alloc_) {
+          clear();
+          alloc_ = other.alloc_;
+        }
+      }
+      compare_ = other.compare_;
+      assign_equal(other.begin(), other.end());
+    }
+    return *this;
+  }
+
+  BTree& operator=(BTree&& other) noexcept(
+      alloc_traits::propagate_on_container_move_assignment::value ||
+      alloc_traits::is_always_equal::value) {
+    if (this != &other) {
+      clear();
+      compare_ = other.compare_;
+      if constexpr (alloc_traits::propagate_on_container_move_assignment::
+                        value) {
+        alloc_ = other.alloc_;
+      } else if (alloc_ != other.alloc_) {
+        // Nodes from a foreign allocator can't be adopted, move the values
+        for (iterator it{other.begin()}; it != other.end(); ++it) {
+          InsertAt(MakeEnd(), std::move(Mutable(it)));
+        }
+        other.clear();
+        return *this;
+      }
+      root_ = std::exchange(other.root_, nullptr);
+      leftmost_ = std::exchange(other.leftmost_, nullptr);
+      rightmost_ = std::exchange(other.rightmost_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+
+  allocator_type get_allocator() const { return alloc_; }
+
+  key_compare key_comp() const { return compare_; }
+
+  size_type size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  const node_type* get_root() const { return root_; }
+
+  iterator begin() { return MakeBegin(); }
+  iterator end() { return MakeEnd(); }
+  const_iterator begin() const { return MakeBegin(); }
+  const_iterator end() const { return MakeEnd(); }
+
+  // Inserts only if no equivalent key is present, otherwise returns the
+  // element holding it
+  template <typename Value>
+  std::pair<iterator, bool> insert_unique(Value&& value) {
+    auto [slot, exists] = FindUniqueSlot(KeyOf(value));
+    if (exists) {
+      return {slot, false};
+    }
+    return {InsertAt(slot, std::forward<Value>(value)), true};
+  }
+
+  // The key is only known once the value is built, so it is built aside
+  // and moved in if the key turns out to be free
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_unique(Args&&... args) {
+    Staged<slot_type> value{alloc_, std::forward<Args>(args)...};
+    auto [slot, exists] = FindUniqueSlot(KeyOf(value.get()));
+    if (exists) {
+      return {slot, false};
+    }
+    return {LinkAt(slot, value.get()), true};
+  }
+
+  // Map only: nothing is constructed unless the key is missing
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+    auto [slot, exists] = FindUniqueSlot(key);
+    if (exists) {
+      return {slot, false};
+    }
+    return {InsertAt(slot, std::piecewise_construct,
+                     std::forward_as_tuple(std::forward<K>(key)),
+                     std::forward_as_tuple(std::forward<Args>(args)...)),
+            true};
+  }
+
+  // Hinted versions of the inserts above. When the key belongs right
+  // before hint it goes there after two comparisons, so feeding keys in
+  // order with end() as the hint appends without a descent.
+  template <typename Value>
+  std::pair<iterator, bool> insert_unique(const_iterator hint,
+                                          Value&& value) {
+    auto [slot, exists] = FindUniqueSlot(hint, KeyOf(value));
+    if (exists) {
+      return {slot, false};
+    }
+    return {InsertAt(slot, std::forward<Value>(value)), true};
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_hint_unique(const_iterator hint,
+                                                Args&&... args) {
+    Staged<slot_type> value{alloc_, std::forward<Args>(args)...};
+    auto [slot, exists] = FindUniqueSlot(hint, KeyOf(value.get()));
+    if (exists) {
+      return {slot, false};
+    }
+    return {LinkAt(slot, value.get()), true};
+  }
+
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> try_emplace_hint(const_iterator hint, K&& key,
+                                             Args&&... args) {
+    auto [slot, exists] = FindUniqueSlot(hint, key);
+    if (exists) {
+      return {slot, false};
+    }
+    return {InsertAt(slot, std::piecewise_construct,
+                     std::forward_as_tuple(std::forward<K>(key)),
+                     std::forward_as_tuple(std::forward<Args>(args)...)),
+            true};
+  }
+
+  // Inserts even when the key is already present, after the equal keys
+  template <typename... Args>
+  iterator emplace_equal(Args&&... args) {
+    Staged<slot_type> value{alloc_, std::forward<Args>(args)...};
+    return LinkAt(FindEqualSlot(KeyOf(value.get())), value.get());
+  }
+
+  // Equal keys are placed as close to hint as ordering allows
+  template <typename... Args>
+  iterator emplace_hint_equal(const_iterator hint, Args&&... args) {
+    Staged<slot_type> value{alloc_, std::forward<Args>(args)...};
+    return LinkAt(FindEqualSlot(hint, KeyOf(value.get())), value.get());
+  }
+
+  // Moves the elements of other over, other always ends up empty. Keys
+  // already present here are dropped.
+  void merge_unique(BTree& other) {
+    if (this != &other) {
+      for (iterator it{other.begin()}; it != other.end(); ++it) {
+        insert_unique(std::move(Mutable(it)));
+      }
+      other.clear();
+    }
+  }
+
+  // Same for multisets, other's elements go after the equal keys here
+  void merge_equal(BTree& other) {
+    if (this != &other) {
+      for (iterator it{other.begin()}; it != other.end(); ++it) {
+        emplace_equal(std::move(Mutable(it)));
+      }
+      other.clear();
+    }
+  }
+
+  // Set algebra that consumes other: this tree becomes the union,
+  // intersection or difference and other ends up empty. Both trees are
+  // walked side by side and the result is appended leaf by leaf, O(n + m)
+  // with packed leaves. A key present in both keeps the element of this
+  // tree. Compare must not throw.
+  void union_with(BTree& other) { Combine(other, true, true, true); }
+
+  void intersect_with(BTree& other) { Combine(other, false, false, true); }
+
+  void subtract(BTree& other) { Combine(other, true, false, false); }
+
+  // First element with an equivalent key, so for multisets the first
+  // occurrence
+  template <typename K>
+  iterator find(const K& key) {
+    return Find(key);
+  }
+
+  template <typename K>
+  const_iterator find(const K& key) const {
+    return Find(key);
+  }
+
+  template <typename K>
+  bool contains(const K& key) const {
+    return Find(key) != MakeEnd();
+  }
+
+  // First element not less than key
+  template <typename K>
+  iterator lower_bound(const K& key) {
+    return Bound<false>(key);
+  }
+
+  template <typename K>
+  const_iterator lower_bound(const K& key) const {
+    return Bound<false>(key);
+  }
+
+  // First element greater than key
+  template <typename K>
+  iterator upper_bound(const K& key) {
+    return Bound<true>(key);
+  }
+
+  template <typename K>
+  const_iterator upper_bound(const K& key) const {
+    return Bound<true>(key);
+  }
+
+  template <typename K>
+  std::pair<iterator, iterator> equal_range(const K& key) {
+    return {Bound<false>(key), Bound<true>(key)};
+  }
+
+  template <typename K>
+  std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+    return {Bound<false>(key), Bound<true>(key)};
+  }
+
+  // Elements with keys in [lo, hi), empty when hi is not greater than lo
+  template <typename K>
+  TreeRange<iterator> range(const K& lo, const K& hi) {
+    auto [first, last] = Range(lo, hi);
+    return {first, last};
+  }
+
+  template <typename K>
+  TreeRange<const_iterator> range(const K& lo, const K& hi) const {
+    auto [first, last] = Range(lo, hi);
+    return {first, last};
+  }
+
+  // Returns the element that followed pos. A leaf left less than half
+  // full is merged with a sibling when the two fit in one node.
+  iterator erase(const_iterator pos) {
+    leaf_type* leaf{pos.leaf_};
+    size_type position{pos.position_};
+    DestroySlot(leaf->slots_ + position);
+    Relocate(leaf->slots_ + position + 1, leaf->slots_ + position,
+             leaf->count_ - position - 1);
+    --leaf->count_;
+    for (node_type* node{leaf}; node; node = node->parent_) {
+      --node->size_;
+    }
+    --size_;
+    return RebalanceLeaf(leaf, position);
+  }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    iterator it{first.leaf_, first.position_};
+    for (size_type count{CountBetween(first, last)}; count != 0; --count) {
+      it = erase(it);
+    }
+    return it;
+  }
+
+  // Removes every element with an equivalent key, returns how many
+  template <typename K>
+  size_type erase_equal(const K& key) {
+    auto [first, last] = equal_range(key);
+    size_type count{CountBetween(first, last)};
+    erase(first, last);
+    return count;
+  }
+
+  void clear() {
+    if (root_) {
+      DestroySubtree(root_);
+    }
+    root_ = nullptr;
+    leftmost_ = nullptr;
+    rightmost_ = nullptr;
+    size_ = 0;
+  }
+
+  // Replace the contents with [first, last). Every element is offered at
+  // end() as the hint, so input sorted by key costs O(n) and fills the
+  // leaves completely. assign_unique keeps the first of equal keys.
+  template <typename InputIt>
+  void assign_unique(InputIt first, InputIt last) {
+    clear();
+    try {
+      for (; first != last; ++first) {
+        insert_unique(MakeEnd(), *first);
+      }
+    } catch (...) {
+      clear();
+      throw;
+    }
+  }
+
+  template <typename InputIt>
+  void assign_equal(InputIt first, InputIt last) {
+    clear();
+    try {
+      for (; first != last; ++first) {
+        emplace_hint_equal(MakeEnd(), *first);
+      }
+    } catch (...) {
+      clear();
+      throw;
+    }
+  }
+
+  // Order statistics, from the subtree sizes every node keeps
+
+  // k-th smallest element counting from 0, end() when k >= size()
+  iterator nth_element(size_type k) { return Select(k); }
+  const_iterator nth_element(size_type k) const { return Select(k); }
+
+  // Number of elements less than key
+  template <typename K>
+  size_type rank(const K& key) const {
+    return CountBefore<false>(key);
+  }
+
+  template <typename K>
+  size_type count(const K& key) const {
+    return CountBefore<true>(key) - CountBefore<false>(key);
+  }
+
+  // Position of pos in sorted order, size() for end()
+  size_type index_of(const_iterator pos) const {
+    if (pos.leaf_ == nullptr) {
+      return 0;
+    }
+    size_type index{pos.position_};
+    const node_type* node{pos.leaf_};
+    for (const inner_type* parent{node->parent_}; parent;
+         node = parent, parent = parent->parent_) {
+      for (size_type i{0}; i < node->position_; ++i) {
+        index += parent->children_[i]->size_;
+      }
+    }
+    return index;
+  }
+
+  difference_type distance(const_iterator first, const_iterator last) const {
+    return static_cast<difference_type>(index_of(last)) -
+           static_cast<difference_type>(index_of(first));
+  }
+
+ private:
+  using alloc_traits = std::allocator_traits<allocator_type>;
+  using leaf_allocator =
+      typename alloc_traits::template rebind_alloc<leaf_type>;
+  using leaf_traits = typename alloc_traits::template rebind_traits<leaf_type>;
+  using inner_allocator =
+      typename alloc_traits::template rebind_alloc<inner_type>;
+  using inner_traits =
+      typename alloc_traits::template rebind_traits<inner_type>;
+
+  static constexpr size_type kMinLeafSlots{leaf_type::kSlots / 2};
+  static constexpr size_type kMinKeys{inner_type::kKeys / 2};
+
+  // Arithmetic keys under the standard orderings are compared against
+  // every key of a node in one branch-free pass, which the compiler turns
+  // into SIMD compares. Other keys are binary searched.
+  static constexpr bool kLinearSearch{
+      std::is_arithmetic_v<Key> &&
+      (std::is_same_v<Compare, std::less<Key>> ||
+       std::is_same_v<Compare, std::greater<Key>> ||
+       std::is_same_v<Compare, std::less<>> ||
+       std::is_same_v<Compare, std::greater<>>)};
+
+  // A value built outside the tree, for inserts that need its key before
+  // they know where it goes, or whose arguments may refer to elements
+  // that the insert is about to move
+  template <typename Slot>
+  class Staged {
+   public:
+    template <typename... Args>
+    explicit Staged(allocator_type& alloc, Args&&... args) : alloc_{alloc} {
+      alloc_traits::construct(alloc_, &slot_.Mutable(),
+                              std::forward<Args>(args)...);
+    }
+    Staged(const Staged&) = delete;
+    Staged& operator=(const Staged&) = delete;
+    ~Staged() { alloc_traits::destroy(alloc_, &slot_.Mutable()); }
+
+    auto& get() { return slot_.Mutable(); }
+
+   private:
+    allocator_type& alloc_;
+    Slot slot_{};
+  };
+
+  // Where a new element goes, or with exists_ the element that already
+  // holds its key
+  struct InsertSlot {
+    iterator position_;
+    bool exists_;
+  };
+
+  template <typename Value>
+  static const auto& KeyOf(const Value& value) {
+    if constexpr (std::is_same_v<T, void>) {
+      return value;
+    } else {
+      return value.first;
+    }
+  }
+
+  static const Key& KeyAt(const_iterator it) {
+    return it.leaf_->slots_[it.position_].GetKey();
+  }
+
+  static mutable_type& Mutable(iterator it) {
+    return it.leaf_->slots_[it.position_].Mutable();
+  }
+
+  static leaf_type* AsLeaf(node_type* node) {
+    return static_cast<leaf_type*>(node);
+  }
+
+  static inner_type* AsInner(node_type* node) {
+    return static_cast<inner_type*>(node);
+  }
+
+  iterator MakeBegin() const {
+    return leftmost_ ? iterator(leftmost_, 0) : iterator();
+  }
+
+  iterator MakeEnd() const {
+    return rightmost_ ? iterator(rightmost_, rightmost_->count_) : iterator();
+  }
+
+  // One past the last slot of a leaf is the first slot of the next one
+  static iterator Normalize(leaf_type* leaf, size_type position) {
+    if (position == leaf->count_ && leaf->next_) {
+      return iterator(leaf->next_, 0);
+    }
+    return iterator(leaf, position);
+  }
+
+  // How many keys of a node go before key: the ones less than key, or
+  // with upper the ones not greater than it
+  template <bool upper, typename Slot, typename K>
+  size_type SearchNode(const Slot* slots, size_type count,
+                       const K& key) const {
+    if constexpr (kLinearSearch) {
+      size_type position{0};
+      for (size_type i{0}; i < count; ++i) {
+        bool before{upper ? !compare_(key, slots[i].GetKey())
+                          : compare_(slots[i].GetKey(), key)};
+        position += before;
+      }
+      return position;
+    } else {
+      size_type first{0};
+      while (count != 0) {
+        size_type half{count / 2};
+        const Key& middle{slots[first + half].GetKey()};
+        bool before{upper ? !compare_(key, middle) : compare_(middle, key)};
+        if (before) {
+          first += half + 1;
+          count -= half + 1;
+        } else {
+          count = half;
+        }
+      }
+      return first;
+    }
+  }
+
+  // Leaf slot of the lower or upper bound of key. It may be one past the
+  // end of a leaf, which is still a valid place to insert key.
+  template <bool upper, typename K>
+  iterator Descend(const K& key) const {
+    node_type* node{root_};
+    while (node->leaf_ == false) {
+      inner_type* inner{AsInner(node)};
+      node = inner->children_[SearchNode<upper>(inner->keys_, inner->count_,
+                                                key)];
+    }
+    leaf_type* leaf{AsLeaf(node)};
+    return iterator(leaf, SearchNode<upper>(leaf->slots_, leaf->count_, key));
+  }
+
+  template <bool upper, typename K>
+  iterator Bound(const K& key) const {
+    if (root_ == nullptr) {
+      return iterator();
+    }
+    iterator slot{Descend<upper>(key)};
+    return Normalize(slot.leaf_, slot.position_);
+  }
+
+  template <typename K>
+  iterator Find(const K& key) const {
+    iterator lower{Bound<false>(key)};
+    if (lower != MakeEnd() && compare_(key, KeyAt(lower)) == false) {
+      return lower;
+    }
+    return MakeEnd();
+  }
+
+  // lo and hi are never compared with each other, so a transparent
+  // comparator only has to know how to compare them with keys
+  template <typename K>
+  std::pair<iterator, iterator> Range(const K& lo, const K& hi) const {
+    iterator first{Bound<false>(lo)};
+    if (first == MakeEnd() || compare_(KeyAt(first), hi) == false) {
+      return {first, first};
+    }
+    return {first, Bound<false>(hi)};
+  }
+
+  iterator Select(size_type k) const {
+    if (k >= size_) {
+      return MakeEnd();
+    }
+    node_type* node{root_};
+    while (node->leaf_ == false) {
+      inner_type* inner{AsInner(node)};
+      size_type child{0};
+      while (k >= inner->children_[child]->size_) {
+        k -= inner->children_[child]->size_;
+        ++child;
+      }
+      node = inner->children_[child];
+    }
+    return iterator(AsLeaf(node), k);
+  }
+
+  // Counts elements less than key, or not greater with inclusive
+  template <bool inclusive, typename K>
+  size_type CountBefore(const K& key) const {
+    if (root_ == nullptr) {
+      return 0;
+    }
+    size_type result{0};
+    node_type* node{root_};
+    while (node->leaf_ == false) {
+      inner_type* inner{AsInner(node)};
+      size_type child{
+          SearchNode<inclusive>(inner->keys_, inner->count_, key)};
+      for (size_type i{0}; i < child; ++i) {
+        result += inner->children_[i]->size_;
+      }
+      node = inner->children_[child];
+    }
+    leaf_type* leaf{AsLeaf(node)};
+    return result + SearchNode<inclusive>(leaf->slots_, leaf->count_, key);
+  }
+
+  // Elements in [first, last), counted a leaf at a time
+  static size_type CountBetween(const_iterator first, const_iterator last) {
+    size_type count{0};
+    leaf_type* leaf{first.leaf_};
+    size_type position{first.position_};
+    for (; leaf != last.leaf_; leaf = leaf->next_, position = 0) {
+      count += leaf->count_ - position;
+    }
+    return count + last.position_ - position;
+  }
+
+  // The descent stops at the lower bound, which is the only element that
+  // can be equivalent to key
+  template <typename K>
+  InsertSlot FindUniqueSlot(const K& key) const {
+    if (root_ == nullptr) {
+      return {iterator(), false};
+    }
+    iterator slot{Descend<false>(key)};
+    iterator lower{Normalize(slot.leaf_, slot.position_)};
+    if (lower != MakeEnd() && compare_(key, KeyAt(lower)) == false) {
+      return {lower, true};
+    }
+    return {slot, false};
+  }
+
+  template <typename K>
+  iterator FindEqualSlot(const K& key) const {
+    return root_ ? Descend<true>(key) : iterator();
+  }
+
+  // A hint is taken when key belongs right before it. The first slot of a
+  // leaf other than the leftmost is the exception: the separator above it
+  // is out of reach, and key may have to go to the previous leaf instead.
+  template <typename K>
+  InsertSlot FindUniqueSlot(const_iterator hint, const K& key) const {
+    iterator next{hint.leaf_, hint.position_};
+    if (next == MakeEnd() || compare_(key, KeyAt(next))) {
+      if (next == MakeBegin()) {
+        return {next, false};
+      }
+      if (next.position_ != 0 && compare_(KeyAt(std::prev(next)), key)) {
+        return {next, false};
+      }
+    } else if (compare_(KeyAt(next), key) == false) {
+      return {next, true};
+    }
+    return FindUniqueSlot(key);
+  }
+
+  template <typename K>
+  iterator FindEqualSlot(const_iterator hint, const K& key) const {
+    iterator next{hint.leaf_, hint.position_};
+    if (next != MakeEnd() && compare_(KeyAt(next), key)) {
+      // key goes after hint, closest to it is before any equal keys
+      return Descend<false>(key);
+    }
+    if (next == MakeBegin()) {
+      return next;
+    }
+    if (next.position_ != 0 && !compare_(key, KeyAt(std::prev(next)))) {
+      return next;
+    }
+    return Descend<true>(key);
+  }
+
+  template <typename... Args>
+  iterator InsertAt(iterator slot, Args&&... args) {
+    Staged<slot_type> value{alloc_, std::forward<Args>(args)...};
+    return LinkAt(slot, value.get());
+  }
+
+  // Moves value into slot, splitting its leaf first when that is full
+  iterator LinkAt(iterator slot, mutable_type& value) {
+    leaf_type* leaf{slot.leaf_};
+    size_type position{slot.position_};
+    if (leaf == nullptr) {
+      leaf = NewLeaf();
+      root_ = leftmost_ = rightmost_ = leaf;
+    } else if (leaf->count_ == leaf_type::kSlots) {
+      std::tie(leaf, position) = SplitLeaf(leaf, position, KeyOf(value));
+    }
+    Relocate(leaf->slots_ + position, leaf->slots_ + position + 1,
+             leaf->count_ - position);
+    alloc_traits::construct(alloc_, &leaf->slots_[position].Mutable(),
+                            std::move(value));
+    ++leaf->count_;
+    for (node_type* node{leaf}; node; node = node->parent_) {
+      ++node->size_;
+    }
+    ++size_;
+    return iterator(leaf, position);
+  }
+
+  // Moves the upper part of a full leaf into a new right sibling and says
+  // where position, the slot for key, ended up. Inserting at the very end
+  // leaves the old leaf full and starts the new one with key, inserting at
+  // the very front does the opposite, so keys that arrive in order pack
+  // the leaves.
+  std::pair<leaf_type*, size_type> SplitLeaf(leaf_type* leaf,
+                                             size_type position,
+                                             const Key& key) {
+    const bool append{position == leaf->count_};
+    size_type split{leaf_type::kSlots / 2};
+    if (append || position == 0) {
+      split = position;
+    }
+
+    // Everything that can throw happens before the first element moves
+    Staged<key_slot_type> separator{
+        alloc_, append ? key : leaf->slots_[split].GetKey()};
+    inner_type* spares{ReserveInnerNodes(leaf)};
+    leaf_type* right{nullptr};
+    try {
+      right = NewLeaf();
+    } catch (...) {
+      FreeSpares(spares);
+      throw;
+    }
+
+    Relocate(leaf->slots_ + split, right->slots_, leaf->count_ - split);
+    right->count_ = static_cast<std::uint16_t>(leaf->count_ - split);
+    leaf->count_ = static_cast<std::uint16_t>(split);
+    right->size_ = right->count_;
+    leaf->size_ = leaf->count_;
+
+    right->prev_ = leaf;
+    right->next_ = leaf->next_;
+    if (leaf->next_) {
+      leaf->next_->prev_ = right;
+    } else {
+      rightmost_ = right;
+    }
+    leaf->next_ = right;
+
+    InsertSeparator(leaf, separator.get(), right, spares);
+    // Both halves of every inner node that split are counted already,
+    // except the ones on the path that received the new leaf
+    for (inner_type* node{leaf->parent_}; node; node = node->parent_) {
+      UpdateSize(node);
+    }
+
+    if (append) {
+      return {right, 0};
+    }
+    if (position <= split) {
+      return {leaf, position};
+    }
+    return {right, position - split};
+  }
+
+  // Inner nodes a split will use: one for every full ancestor and one more
+  // for a new root when the split goes all the way up
+  inner_type* ReserveInnerNodes(node_type* node) {
+    inner_type* spares{nullptr};
+    try {
+      for (inner_type* parent{node->parent_};; parent = parent->parent_) {
+        if (parent && parent->count_ < inner_type::kKeys) {
+          break;
+        }
+        inner_type* spare{NewInner()};
+        spare->parent_ = spares;
+        spares = spare;
+        if (parent == nullptr) {
+          break;
+        }
+      }
+    } catch (...) {
+      FreeSpares(spares);
+      throw;
+    }
+    return spares;
+  }
+
+  static inner_type* TakeSpare(inner_type*& spares) {
+    inner_type* spare{spares};
+    spares = spare->parent_;
+    spare->parent_ = nullptr;
+    return spare;
+  }
+
+  void FreeSpares(inner_type* spares) {
+    while (spares) {
+      FreeInner(TakeSpare(spares));
+    }
+  }
+
+  // Links right into left's parent, just after left, with key separating
+  // the two. A full parent is split first, and so on up to the root.
+  void InsertSeparator(node_type* left, Key& key, node_type* right,
+                       inner_type*& spares) {
+    inner_type* parent{left->parent_};
+    if (parent == nullptr) {
+      inner_type* root{TakeSpare(spares)};
+      alloc_traits::construct(alloc_, &root->keys_[0].Mutable(),
+                              std::move(key));
+      root->count_ = 1;
+      SetChild(root, 0, left);
+      SetChild(root, 1, right);
+      root_ = root;
+      return;
+    }
+    size_type index{left->position_ + 1u};
+    if (parent->count_ == inner_type::kKeys) {
+      std::tie(parent, index) = SplitInner(parent, index, spares);
+    }
+    Relocate(parent->keys_ + index - 1, parent->keys_ + index,
+             parent->count_ - (index - 1));
+    alloc_traits::construct(alloc_, &parent->keys_[index - 1].Mutable(),
+                            std::move(key));
+    for (size_type i{parent->count_ + 1u}; i > index; --i) {
+      SetChild(parent, i, parent->children_[i - 1]);
+    }
+    SetChild(parent, index, right);
+    ++parent->count_;
+  }
+
+  // Moves the upper keys and children of a full inner node into a spare
+  // one and pushes the middle key up. Returns where the child that was
+  // about to go in at index goes now. The split is biased like leaf splits.
+  std::pair<inner_type*, size_type> SplitInner(inner_type* node,
+                                               size_type index,
+                                               inner_type*& spares) {
+    size_type middle{inner_type::kKeys / 2};
+    if (index == node->count_ + 1u) {
+      middle = node->count_ - 1u;
+    } else if (index == 1) {
+      middle = 1;
+    }
+    inner_type* right{TakeSpare(spares)};
+    size_type moved{node->count_ - middle - 1};
+    Relocate(node->keys_ + middle + 1, right->keys_, moved);
+    for (size_type i{0}; i <= moved; ++i) {
+      SetChild(right, i, node->children_[middle + 1 + i]);
+    }
+    right->count_ = static_cast<std::uint16_t>(moved);
+    node->count_ = static_cast<std::uint16_t>(middle);
+    UpdateSize(node);
+    UpdateSize(right);
+
+    InsertSeparator(node, node->keys_[middle].Mutable(), right, spares);
+    DestroyKey(node->keys_ + middle);
+
+    if (index <= middle + 1) {
+      return {node, index};
+    }
+    return {right, index - middle - 1};
+  }
+
+  static void UpdateSize(inner_type* node) {
+    size_type size{0};
+    for (size_type i{0}; i <= node->count_; ++i) {
+      size += node->children_[i]->size_;
+    }
+    node->size_ = size;
+  }
+
+  static void SetChild(inner_type* parent, size_type index,
+                       node_type* child) {
+    parent->children_[index] = child;
+    child->parent_ = parent;
+    child->position_ = static_cast<std::uint16_t>(index);
+  }
+
+  // Merges a leaf that fell below half full into a sibling when both fit
+  // in one node. Otherwise it stays as it is: the sibling is then more
+  // than half full, and separators never change, so erase copies no keys.
+  iterator RebalanceLeaf(leaf_type* leaf, size_type position) {
+    if (leaf == root_) {
+      if (leaf->count_ == 0) {
+        FreeLeaf(leaf);
+        root_ = leftmost_ = rightmost_ = nullptr;
+        return iterator();
+      }
+      return Normalize(leaf, position);
+    }
+    if (leaf->count_ >= kMinLeafSlots) {
+      return Normalize(leaf, position);
+    }
+    inner_type* parent{leaf->parent_};
+    size_type index{leaf->position_};
+    if (index > 0) {
+      leaf_type* left{AsLeaf(parent->children_[index - 1])};
+      if (left->count_ + leaf->count_ <= leaf_type::kSlots) {
+        position += left->count_;
+        MergeLeaves(left, leaf);
+        RebalanceInner(parent);
+        return Normalize(left, position);
+      }
+    }
+    if (index < parent->count_) {
+      leaf_type* right{AsLeaf(parent->children_[index + 1])};
+      if (leaf->count_ + right->count_ <= leaf_type::kSlots) {
+        MergeLeaves(leaf, right);
+        RebalanceInner(parent);
+      }
+    }
+    return Normalize(leaf, position);
+  }
+
+  void MergeLeaves(leaf_type* left, leaf_type* right) {
+    Relocate(right->slots_, left->slots_ + left->count_, right->count_);
+    left->count_ = static_cast<std::uint16_t>(left->count_ + right->count_);
+    left->size_ = left->count_;
+    left->next_ = right->next_;
+    if (right->next_) {
+      right->next_->prev_ = left;
+    } else {
+      rightmost_ = left;
+    }
+    RemoveChild(left->parent_, right->position_);
+    FreeLeaf(right);
+  }
+
+  // Drops child index and the separator before it from node
+  void RemoveChild(inner_type* node, size_type index) {
+    DestroyKey(node->keys_ + index - 1);
+    Relocate(node->keys_ + index, node->keys_ + index - 1,
+             node->count_ - index);
+    for (size_type i{index}; i < node->count_; ++i) {
+      SetChild(node, i, node->children_[i + 1]);
+    }
+    --node->count_;
+  }
+
+  // Inner nodes below half full are merged with a sibling, pulling their
+  // separator down, or else take one child over from it. Only keys that
+  // already exist are moved around.
+  void RebalanceInner(inner_type* node) {
+    while (node != root_) {
+      if (node->count_ >= kMinKeys) {
+        return;
+      }
+      inner_type* parent{node->parent_};
+      size_type index{node->position_};
+      inner_type* left{
+          index > 0 ? AsInner(parent->children_[index - 1]) : nullptr};
+      inner_type* right{index < parent->count_
+                            ? AsInner(parent->children_[index + 1])
+                            : nullptr};
+      if (left && left->count_ + node->count_ < inner_type::kKeys) {
+        MergeInner(left, node);
+      } else if (right && node->count_ + right->count_ < inner_type::kKeys) {
+        MergeInner(node, right);
+      } else {
+        if (left) {
+          RotateRight(left, node);
+        } else {
+          RotateLeft(node, right);
+        }
+        return;
+      }
+      node = parent;
+    }
+    if (node->count_ == 0) {
+      root_ = node->children_[0];
+      root_->parent_ = nullptr;
+      root_->position_ = 0;
+      FreeInner(node);
+    }
+  }
+
+  void MergeInner(inner_type* left, inner_type* right) {
+    inner_type* parent{left->parent_};
+    size_type count{left->count_};
+    alloc_traits::construct(
+        alloc_, &left->keys_[count].Mutable(),
+        std::move(parent->keys_[right->position_ - 1].Mutable()));
+    Relocate(right->keys_, left->keys_ + count + 1, right->count_);
+    for (size_type i{0}; i <= right->count_; ++i) {
+      SetChild(left, count + 1 + i, right->children_[i]);
+    }
+    left->count_ = static_cast<std::uint16_t>(count + 1 + right->count_);
+    left->size_ += right->size_;
+    RemoveChild(parent, right->position_);
+    FreeInner(right);
+  }
+
+  // Moves the last child of left to the front of right, passing the keys
+  // through the separator in their parent
+  void RotateRight(inner_type* left, inner_type* right) {
+    Key& separator{left->parent_->keys_[left->position_].Mutable()};
+    Relocate(right->keys_, right->keys_ + 1, right->count_);
+    alloc_traits::construct(alloc_, &right->keys_[0].Mutable(),
+                            std::move(separator));
+    separator = std::move(left->keys_[left->count_ - 1].Mutable());
+    DestroyKey(left->keys_ + left->count_ - 1);
+    for (size_type i{right->count_ + 1u}; i > 0; --i) {
+      SetChild(right, i, right->children_[i - 1]);
+    }
+    node_type* child{left->children_[left->count_]};
+    SetChild(right, 0, child);
+    --left->count_;
+    ++right->count_;
+    left->size_ -= child->size_;
+    right->size_ += child->size_;
+  }
+
+  void RotateLeft(inner_type* left, inner_type* right) {
+    Key& separator{left->parent_->keys_[left->position_].Mutable()};
+    alloc_traits::construct(alloc_, &left->keys_[left->count_].Mutable(),
+                            std::move(separator));
+    separator = std::move(right->keys_[0].Mutable());
+    DestroyKey(right->keys_);
+    Relocate(right->keys_ + 1, right->keys_, right->count_ - 1u);
+    node_type* child{right->children_[0]};
+    SetChild(left, left->count_ + 1u, child);
+    for (size_type i{0}; i < right->count_; ++i) {
+      SetChild(right, i, right->children_[i + 1]);
+    }
+    ++left->count_;
+    --right->count_;
+    left->size_ += child->size_;
+    right->size_ -= child->size_;
+  }
+
+  void Combine(BTree& other, bool keep_here, bool keep_there,
+               bool keep_both) {
+    BTree result{compare_, alloc_};
+    iterator lhs{begin()};
+    iterator rhs{other.begin()};
+    const iterator lhs_end{end()};
+    const iterator rhs_end{other.end()};
+    while (lhs != lhs_end && rhs != rhs_end) {
+      if (compare_(KeyAt(lhs), KeyAt(rhs))) {
+        if (keep_here) {
+          result.InsertAt(result.MakeEnd(), std::move(Mutable(lhs)));
+        }
+        ++lhs;
+      } else if (compare_(KeyAt(rhs), KeyAt(lhs))) {
+        if (keep_there) {
+          result.InsertAt(result.MakeEnd(), std::move(Mutable(rhs)));
+        }
+        ++rhs;
+      } else {
+        if (keep_both) {
+          result.InsertAt(result.MakeEnd(), std::move(Mutable(lhs)));
+        }
+        ++lhs;
+        ++rhs;
+      }
+    }
+    for (; keep_here && lhs != lhs_end; ++lhs) {
+      result.InsertAt(result.MakeEnd(), std::move(Mutable(lhs)));
+    }
+    for (; keep_there && rhs != rhs_end; ++rhs) {
+      result.InsertAt(result.MakeEnd(), std::move(Mutable(rhs)));
+    }
+    *this = std::move(result);
+    other.clear();
+  }
+
+  // Moves count values between slots, constructing the targets and
+  // destroying the sources. The two ranges may overlap within one node.
+  template <typename Slot>
+  void Relocate(Slot* from, Slot* to, size_type count) {
+    using moved_type = std::remove_reference_t<decltype(from->Mutable())>;
+    if constexpr (std::is_trivially_copyable_v<moved_type>) {
+      std::memmove(static_cast<void*>(to), static_cast<const void*>(from),
+                   count * sizeof(Slot));
+    } else if (std::less<Slot*>()(to, from)) {
+      for (size_type i{0}; i < count; ++i) {
+        Transfer(from + i, to + i);
+      }
+    } else {
+      for (size_type i{count}; i > 0; --i) {
+        Transfer(from + i - 1, to + i - 1);
+      }
+    }
+  }
+
+  template <typename Slot>
+  void Transfer(Slot* from, Slot* to) {
+    alloc_traits::construct(alloc_, &to->Mutable(), std::move(from->Mutable()));
+    alloc_traits::destroy(alloc_, &from->Mutable());
+  }
+
+  void DestroySlot(slot_type* slot) {
+    alloc_traits::destroy(alloc_, &slot->Mutable());
+  }
+
+  void DestroyKey(key_slot_type* slot) {
+    alloc_traits::destroy(alloc_, &slot->Mutable());
+  }
+
+  void DestroySubtree(node_type* node) {
+    if (node->leaf_) {
+      leaf_type* leaf{AsLeaf(node)};
+      for (size_type i{0}; i < leaf->count_; ++i) {
+        DestroySlot(leaf->slots_ + i);
+      }
+      FreeLeaf(leaf);
+      return;
+    }
+    inner_type* inner{AsInner(node)};
+    for (size_type i{0}; i <= inner->count_; ++i) {
+      DestroySubtree(inner->children_[i]);
+    }
+    for (size_type i{0}; i < inner->count_; ++i) {
+      DestroyKey(inner->keys_ + i);
+    }
+    FreeInner(inner);
+  }
+
+  leaf_type* NewLeaf() {
+    leaf_allocator alloc{alloc_};
+    leaf_type* leaf{leaf_traits::allocate(alloc, 1)};
+    return ::new (static_cast<void*>(leaf)) leaf_type();
+  }
+
+  void FreeLeaf(leaf_type* leaf) {
+    leaf_allocator alloc{alloc_};
+    leaf->~leaf_type();
+    leaf_traits::deallocate(alloc, leaf, 1);
+  }
+
+  inner_type* NewInner() {
+    inner_allocator alloc{alloc_};
+    inner_type* inner{inner_traits::allocate(alloc, 1)};
+    return ::new (static_cast<void*>(inner)) inner_type();
+  }
+
+  void FreeInner(inner_type* inner) {
+    inner_allocator alloc{alloc_};
+    inner->~inner_type();
+    inner_traits::deallocate(alloc, inner, 1);
+  }
+
+  Compare compare_;
+  allocator_type alloc_;
+  node_type* root_{nullptr};
+  leaf_type* leftmost_{nullptr};
+  leaf_type* rightmost_{nullptr};
+  size_type size_{0};
+};
+
+#pragma GCC diagnostic pop
+
+}  // namespace s21
+
+#endif  // S21_BTREE_H
@@ -0,0 +1,267 @@
+#ifndef S21_BTREE_MULTISET_H
+#define S21_BTREE_MULTISET_H
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+#include "s21_btree.h"
+
+namespace s21 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Drop-in replacement for s21::multiset on a B+ tree. Every node counts
+// the elements below it, so count, rank and nth_element stay
+// logarithmic. Every insert and erase invalidates all iterators.
+template <typename Key, typename Compare = std::less<Key>,
+          typename Allocator = std::allocator<Key>>
+class btree_multiset {
+  using tree_type = BTree<Key, void, Compare, Allocator>;
+
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+  using iterator = typename tree_type::const_iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  btree_multiset() : tree_{} {}
+
+  explicit btree_multiset(const Compare& compare,
+                          const allocator_type& alloc = allocator_type())
+      : tree_{compare, alloc} {}
+
+  explicit btree_multiset(const allocator_type& alloc) : tree_{alloc} {}
+
+  btree_multiset(std::initializer_list<value_type> const& items,
+                 const Compare& compare = Compare(),
+                 const allocator_type& alloc = allocator_type())
+      : tree_{compare, alloc} {
+    tree_.assign_equal(items.begin(), items.end());
+  }
+
+  btree_multiset(std::initializer_list<value_type> const& items,
+                 const allocator_type& alloc)
+      : btree_multiset(items, Compare(), alloc) {}
+
+  // O(n) when the range is sorted, O(n log n) otherwise. Equal keys keep
+  // their order from the range.
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  btree_multiset(InputIt first, InputIt last,
+                 const Compare& compare = Compare(),
+                 const allocator_type& alloc = allocator_type())
+      : tree_{compare, alloc} {
+    tree_.assign_equal(first, last);
+  }
+
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  btree_multiset(InputIt first, InputIt last, const allocator_type& alloc)
+      : btree_multiset(first, last, Compare(), alloc) {}
+
+  btree_multiset(const btree_multiset& other)
+      : tree_{other.key_comp(),
+              std::allocator_traits<allocator_type>::
+                  select_on_container_copy_construction(
+                      other.get_allocator())} {
+    tree_.assign_equal(other.begin(), other.end());
+  }
+
+  btree_multiset(btree_multiset&& other) noexcept
+      : tree_(std::move(other.tree_)) {}
+
+  explicit btree_multiset(size_type size, value_type value,
+                          const allocator_type& alloc = allocator_type())
+      : tree_{alloc} {
+    for (size_type i{0}; i < size; i++) {
+      tree_.emplace_hint_equal(tree_.end(), value);
+    }
+  }
+
+  ~btree_multiset() = default;
+
+  btree_multiset& operator=(const btree_multiset& other) {
+    tree_ = other.tree_;
+    return *this;
+  }
+
+  btree_multiset& operator=(btree_multiset&& other) noexcept(
+      std::is_nothrow_move_assignable_v<tree_type>) {
+    if (this != &other) {
+      tree_ = std::move(other.tree_);
+    }
+    return *this;
+  }
+
+  allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+  key_compare key_comp() const { return tree_.key_comp(); }
+
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  void assign(InputIt first, InputIt last) {
+    tree_.assign_equal(first, last);
+  }
+
+  iterator begin() const { return tree_.begin(); }
+  iterator end() const { return tree_.end(); }
+
+  bool empty() const { return tree_.empty(); }
+
+  size_type size() const { return tree_.size(); }
+
+  size_type max_size() const {
+    return std::numeric_limits<size_type>::max() / sizeof(key_type);
+  }
+
+  void clear() { tree_.clear(); }
+
+  iterator insert(const value_type& value) {
+    return tree_.emplace_equal(value);
+  }
+
+  iterator insert(value_type&& value) {
+    return tree_.emplace_equal(std::move(value));
+  }
+
+  // Lands as close to hint as ordering allows, after two comparisons when
+  // value belongs right before it
+  iterator insert(const_iterator hint, const value_type& value) {
+    return tree_.emplace_hint_equal(hint, value);
+  }
+
+  iterator insert(const_iterator hint, value_type&& value) {
+    return tree_.emplace_hint_equal(hint, std::move(value));
+  }
+
+  template <typename... Args>
+  iterator emplace(Args&&... args) {
+    return tree_.emplace_equal(std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    return tree_.emplace_hint_equal(hint, std::forward<Args>(args)...);
+  }
+
+  iterator erase(const_iterator pos) { return tree_.erase(pos); }
+
+  // Erases [first, last) one element at a time, see BTree::erase
+  iterator erase(const_iterator first, const_iterator last) {
+    return tree_.erase(first, last);
+  }
+
+  // erase by key removes all occurrences
+  size_type erase(const key_type& key) { return tree_.erase_equal(key); }
+
+  void swap(btree_multiset& other) noexcept { std::swap(tree_, other.tree_); }
+
+  // Moves the elements of other over, after the equal keys here
+  void merge(btree_multiset& other) { tree_.merge_equal(other.tree_); }
+
+  // k-th smallest element counting from 0, end() when k >= size()
+  iterator nth_element(size_type k) const { return tree_.nth_element(k); }
+
+  difference_type distance(const_iterator first, const_iterator last) const {
+    return tree_.distance(first, last);
+  }
+
+  // Every lookup below also has a template overload taking any K, which
+  // exists only for transparent comparators and builds no key_type
+
+  // Returns first occurrence
+  iterator find(const key_type& key) const { return tree_.find(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator find(const K& key) const {
+    return tree_.find(key);
+  }
+
+  bool contains(const key_type& key) const { return tree_.contains(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  bool contains(const K& key) const {
+    return tree_.contains(key);
+  }
+
+  size_type count(const key_type& key) const { return tree_.count(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  size_type count(const K& key) const {
+    return tree_.count(key);
+  }
+
+  // Number of elements less than key
+  size_type rank(const key_type& key) const { return tree_.rank(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  size_type rank(const K& key) const {
+    return tree_.rank(key);
+  }
+
+  iterator lower_bound(const key_type& key) const {
+    return tree_.lower_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator lower_bound(const K& key) const {
+    return tree_.lower_bound(key);
+  }
+
+  iterator upper_bound(const key_type& key) const {
+    return tree_.upper_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator upper_bound(const K& key) const {
+    return tree_.upper_bound(key);
+  }
+
+  std::pair<iterator, iterator> equal_range(const key_type& key) const {
+    return tree_.equal_range(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  std::pair<iterator, iterator> equal_range(const K& key) const {
+    return tree_.equal_range(key);
+  }
+
+  // Lazy view of the elements with keys in [lo, hi)
+  TreeRange<iterator> range(const key_type& lo, const key_type& hi) const {
+    return tree_.range(lo, hi);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  TreeRange<iterator> range(const K& lo, const K& hi) const {
+    return tree_.range(lo, hi);
+  }
+
+  bool operator==(const btree_multiset& other) const {
+    if (this->size() != other.size()) return false;
+    auto it1 = begin();
+    auto it2 = other.begin();
+
+    while (it1 != end() && it2 != other.end()) {
+      if (*it1 != *it2) return false;
+      ++it1;
+      ++it2;
+    }
+
+    return it1 == end() && it2 == other.end();
+  }
+
+ private:
+  tree_type tree_;
+};
+
+#pragma GCC diagnostic pop
+
+namespace pmr {
+template <typename Key, typename Compare = std::less<Key>>
+using btree_multiset =
+    s21::btree_multiset<Key, Compare, std::pmr::polymorphic_allocator<Key>>;
+}  // namespace pmr
+
+}  // namespace s21
+
+#endif  // S21_BTREE_MULTISET_H
@@ -0,0 +1,330 @@
+#ifndef S21_CONCURRENT_MAP_H
+#define S21_CONCURRENT_MAP_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+#include "s21_map.h"
+
+namespace s21 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Thread-safe map split into Shards independent s21::maps. A key always
+// lives in the shard its hash picks, and every shard has its own
+// reader-writer lock on a cache line of its own, so threads working on
+// different shards never wait for each other or bounce each other's
+// lines.
+//
+// Nothing here hands out references into a shard once its lock is
+// released: lookups return copies, and changes in place go through
+// update(). Ordered iteration needs a lock_ordered() view, which holds
+// all shards for reading while it lives. A thread holding one must not
+// write to the same map, or it waits for itself.
+template <typename Key, typename T, std::size_t Shards = 16,
+          typename Hash = std::hash<Key>, typename Compare = std::less<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, T>>>
+class concurrent_map {
+  static_assert(Shards > 0, "concurrent_map needs at least one shard");
+
+ public:
+  using map_type = map<Key, T, Compare, Allocator>;
+  using value_type = std::pair<const Key, T>;
+  using key_type = Key;
+  using mapped_type = T;
+  using hasher = Hash;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+  using size_type = std::size_t;
+
+  class ordered_view;
+
+  concurrent_map() : concurrent_map(Hash()) {}
+
+  explicit concurrent_map(const Hash& hash, const Compare& compare = Compare(),
+                          const allocator_type& alloc = allocator_type())
+      : hash_{hash},
+        shards_{MakeShards(compare, alloc,
+                           std::make_index_sequence<Shards>{})} {}
+
+  // Shards hold their own mutexes, so the map stays where it was built
+  concurrent_map(const concurrent_map&) = delete;
+  concurrent_map& operator=(const concurrent_map&) = delete;
+
+  ~concurrent_map() = default;
+
+  static constexpr size_type shard_count() { return Shards; }
+
+  // Index of the shard that holds key
+  size_type shard_of(const key_type& key) const {
+    // Hashes of integers are often the integers themselves, so the bits
+    // are mixed before reducing, lest strided keys pile up in one shard
+    std::uint64_t mixed{static_cast<std::uint64_t>(hash_(key)) *
+                        0x9E3779B97F4A7C15ull};
+    return static_cast<size_type>((mixed >> 32) % Shards);
+  }
+
+  std::optional<mapped_type> find(const key_type& key) const {
+    const Shard& shard{ShardFor(key)};
+    std::shared_lock<std::shared_mutex> lock{shard.mutex_};
+    auto it = shard.map_.find(key);
+    if (it == shard.map_.end()) return std::nullopt;
+    return it->second;
+  }
+
+  bool contains(const key_type& key) const {
+    const Shard& shard{ShardFor(key)};
+    std::shared_lock<std::shared_mutex> lock{shard.mutex_};
+    return shard.map_.contains(key);
+  }
+
+  size_type count(const key_type& key) const { return contains(key); }
+
+  bool insert(const value_type& value) {
+    Shard& shard{ShardFor(value.first)};
+    std::unique_lock<std::shared_mutex> lock{shard.mutex_};
+    return shard.map_.insert(value).second;
+  }
+
+  bool insert(value_type&& value) {
+    Shard& shard{ShardFor(value.first)};
+    std::unique_lock<std::shared_mutex> lock{shard.mutex_};
+    return shard.map_.insert(std::move(value)).second;
+  }
+
+  bool insert(const key_type& key, const T& obj) {
+    return try_emplace(key, obj);
+  }
+
+  bool insert(const key_type& key, T&& obj) {
+    return try_emplace(key, std::move(obj));
+  }
+
+  // The mapped value is only built when key is missing
+  template <typename... Args>
+  bool try_emplace(const key_type& key, Args&&... args) {
+    Shard& shard{ShardFor(key)};
+    std::unique_lock<std::shared_mutex> lock{shard.mutex_};
+    return shard.map_.try_emplace(key, std::forward<Args>(args)...).second;
+  }
+
+  // True when key was inserted, false when an existing value was replaced
+  template <typename M>
+  bool insert_or_assign(const key_type& key, M&& obj) {
+    Shard& shard{ShardFor(key)};
+    std::unique_lock<std::shared_mutex> lock{shard.mutex_};
+    return shard.map_.insert_or_assign(key, std::forward<M>(obj)).second;
+  }
+
+  size_type erase(const key_type& key) {
+    Shard& shard{ShardFor(key)};
+    std::unique_lock<std::shared_mutex> lock{shard.mutex_};
+    return shard.map_.erase(key);
+  }
+
+  // Calls fn(mapped_type&) on the value of key while its shard is locked
+  // for writing. Returns false, without calling fn, when key is missing.
+  template <typename Fn>
+  bool update(const key_type& key, Fn&& fn) {
+    Shard& shard{ShardFor(key)};
+    std::unique_lock<std::shared_mutex> lock{shard.mutex_};
+    auto it = shard.map_.find(key);
+    if (it == shard.map_.end()) return false;
+    std::invoke(std::forward<Fn>(fn), it->second);
+    return true;
+  }
+
+  // Calls fn(map_type&) on each shard in turn, each one locked for
+  // writing only while fn runs on it
+  template <typename Fn>
+  void for_each_shard(Fn&& fn) {
+    for (Shard& shard : shards_) {
+      std::unique_lock<std::shared_mutex> lock{shard.mutex_};
+      std::invoke(fn, shard.map_);
+    }
+  }
+
+  // Same, with each shard locked for reading and passed as const
+  template <typename Fn>
+  void for_each_shard(Fn&& fn) const {
+    for (const Shard& shard : shards_) {
+      std::shared_lock<std::shared_mutex> lock{shard.mutex_};
+      std::invoke(fn, shard.map_);
+    }
+  }
+
+  // Sum of the shard sizes. Shards are counted one after another, so
+  // with concurrent writers the total need not have held at any instant.
+  size_type size() const {
+    size_type total{0};
+    for_each_shard([&total](const map_type& shard) { total += shard.size(); });
+    return total;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  void clear() {
+    for_each_shard([](map_type& shard) { shard.clear(); });
+  }
+
+  // Locks every shard for reading, in index order, and returns a view
+  // of all elements in key order. Writers block until it is destroyed.
+  ordered_view lock_ordered() const { return ordered_view{*this}; }
+
+ private:
+  static constexpr size_type kCacheLineSize{64};
+
+  struct alignas(kCacheLineSize) Shard {
+    Shard(const Compare& compare, const allocator_type& alloc)
+        : mutex_{}, map_{compare, alloc} {}
+
+    mutable std::shared_mutex mutex_;
+    map_type map_;
+  };
+
+  // Shards cannot be moved, so the array is built with each one in place
+  template <std::size_t... Indices>
+  static std::array<Shard, Shards> MakeShards(
+      const Compare& compare, const allocator_type& alloc,
+      std::index_sequence<Indices...>) {
+    return {(static_cast<void>(Indices), Shard{compare, alloc})...};
+  }
+
+  Shard& ShardFor(const key_type& key) { return shards_[shard_of(key)]; }
+
+  const Shard& ShardFor(const key_type& key) const {
+    return shards_[shard_of(key)];
+  }
+
+  Hash hash_;
+  std::array<Shard, Shards> shards_;
+};
+
+// Consistent, ordered view of a concurrent_map. Iteration merges the
+// shards, which are each sorted already, through a binary heap of the
+// shards' current elements: O(log Shards) per step.
+template <typename Key, typename T, std::size_t Shards, typename Hash,
+          typename Compare, typename Allocator>
+class concurrent_map<Key, T, Shards, Hash, Compare, Allocator>::ordered_view {
+  using shard_iterator = typename map_type::const_iterator;
+
+  struct Cursor {
+    shard_iterator current_;
+    shard_iterator end_;
+  };
+
+ public:
+  class iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = concurrent_map::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    reference operator*() const { return *heap_.front().current_; }
+    pointer operator->() const { return &**this; }
+
+    iterator& operator++() {
+      std::pop_heap(heap_.begin(), heap_.end(), After{compare_});
+      Cursor& cursor{heap_.back()};
+      if (++cursor.current_ == cursor.end_) {
+        heap_.pop_back();
+      } else {
+        std::push_heap(heap_.begin(), heap_.end(), After{compare_});
+      }
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator old{*this};
+      ++*this;
+      return old;
+    }
+
+    bool operator==(const iterator& other) const {
+      if (heap_.size() != other.heap_.size()) return false;
+      return heap_.empty() ||
+             heap_.front().current_ == other.heap_.front().current_;
+    }
+
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+
+   private:
+    friend class ordered_view;
+
+    // Orders the heap so that its front holds the smallest key
+    struct After {
+      bool operator()(const Cursor& lhs, const Cursor& rhs) const {
+        return compare_(rhs.current_->first, lhs.current_->first);
+      }
+      Compare compare_;
+    };
+
+    explicit iterator(const Compare& compare) : compare_{compare}, heap_{} {}
+
+    Compare compare_;
+    std::vector<Cursor> heap_;
+  };
+
+  using const_iterator = iterator;
+
+  ordered_view(const ordered_view&) = delete;
+  ordered_view& operator=(const ordered_view&) = delete;
+  ordered_view(ordered_view&&) = default;
+  ~ordered_view() = default;
+
+  iterator begin() const {
+    iterator it{compare_};
+    it.heap_.reserve(Shards);
+    for (const Shard& shard : owner_->shards_) {
+      if (shard.map_.begin() != shard.map_.end()) {
+        it.heap_.push_back(Cursor{shard.map_.begin(), shard.map_.end()});
+      }
+    }
+    std::make_heap(it.heap_.begin(), it.heap_.end(),
+                   typename iterator::After{compare_});
+    return it;
+  }
+
+  iterator end() const { return iterator{compare_}; }
+
+  size_type size() const {
+    size_type total{0};
+    for (const Shard& shard : owner_->shards_) total += shard.map_.size();
+    return total;
+  }
+
+ private:
+  friend class concurrent_map;
+
+  explicit ordered_view(const concurrent_map& owner)
+      : owner_{&owner},
+        compare_{owner.shards_.front().map_.key_comp()},
+        locks_{} {
+    for (size_type i{0}; i < Shards; ++i) {
+      locks_[i] = std::shared_lock<std::shared_mutex>{owner.shards_[i].mutex_};
+    }
+  }
+
+  const concurrent_map* owner_;
+  Compare compare_;
+  std::array<std::shared_lock<std::shared_mutex>, Shards> locks_;
+};
+
+#pragma GCC diagnostic pop
+
+}  // namespace s21
+
+#endif  // S21_CONCURRENT_MAP_H
@@ -2,6 +2,20 @@
 #define S21_CONTAINERSPLUS_H
 
 #include "s21_array.h"
+#include "s21_btree_map.h"
+#include "s21_btree_multiset.h"
+#include "s21_btree_set.h"
+#include "s21_concurrent_map.h"
+#include "s21_flat_map.h"
+#include "s21_flat_multiset.h"
+#include "s21_flat_set.h"
+#include "s21_frozen_map.h"
+#include "s21_frozen_set.h"
+#include "s21_interval_map.h"
+#include "s21_mapped_map.h"
 #include "s21_multiset.h"
+#include "s21_persistent_map.h"
+#include "s21_unordered_map.h"
+#include "s21_unordered_set.h"
 
 #endif  // S21_CONTAINERSPLUS_H
@@ -5,27 +5,33 @@
 #include <cstring>
 #include <initializer_list>
 #include <limits>
+#include <memory>
+#include <memory_resource>
 
 namespace s21 {
 
-template <typename T, bool is_const>
+template <typename T, bool is_const, typename Allocator = std::allocator<T>>
 class DequeIterator;
 
-template <typename T>
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+template <typename T, typename Allocator = std::allocator<T>>
 class deque {
  public:
   using value_type = T;
+  using allocator_type = Allocator;
   using pointer = T*;
   using const_pointer = const T*;
   using reference = T&;
   using const_reference = const T&;
   using size_type = std::size_t;
 
-  using iterator = DequeIterator<T, false>;
-  using const_iterator = DequeIterator<T, true>;
+  using iterator = DequeIterator<T, false, Allocator>;
+  using const_iterator = DequeIterator<T, true, Allocator>;
 
-  friend class DequeIterator<T, true>;
-  friend class DequeIterator<T, false>;
+  friend class DequeIterator<T, true, Allocator>;
+  friend class DequeIterator<T, false, Allocator>;
 
  private:
   static constexpr size_type kPageSize{4096};
@@ -37,8 +43,11 @@ class deque {
     value_type data_[deque::kChunkSize];
   };
 
-  deque() : map_{nullptr} {
-    map_ = new Chunk* [kInitialMapSize] {};
+  deque() : deque(allocator_type()) {}
+
+  explicit deque(const allocator_type& alloc)
+      : allocator_{alloc}, map_{nullptr} {
+    map_ = AllocateMap(kInitialMapSize);
     map_size_ = kInitialMapSize;
     front_chunk_index_ = back_chunk_index_ = map_size_ / 2;
     front_element_index_ = back_vacant_index_ = kChunkSize / 2;
@@ -46,33 +55,37 @@ class deque {
     AddChunkAt(front_chunk_index_);
   }
 
-  deque(size_type n, const value_type& value) : deque() {
+  deque(size_type n, const value_type& value,
+        const allocator_type& alloc = allocator_type())
+      : deque(alloc) {
     for (size_type i{0}; i < n; i++) {
       push_back(value);
     }
   }
 
   deque(const deque& other)
-      : map_{nullptr},
+      : allocator_{std::allocator_traits<allocator_type>::
+                       select_on_container_copy_construction(
+                           other.allocator_)},
+        map_{nullptr},
         map_size_{other.map_size_},
         front_chunk_index_{other.front_chunk_index_},
         back_chunk_index_{other.back_chunk_index_},
         front_element_index_{other.front_element_index_},
         back_vacant_index_{other.back_vacant_index_},
         size_{other.size_} {
-    map_ = new Chunk* [map_size_] {};
+    map_ = AllocateMap(map_size_);
 
     for (size_type i = front_chunk_index_; i <= back_chunk_index_; ++i) {
-      if (other.map_[i]) {
-        map_[i] = new Chunk();
-        std::copy(std::begin(other.map_[i]->data_),
-                  std::end(other.map_[i]->data_), std::begin(map_[i]->data_));
+      if (i < map_size_ && other.map_[i]) {
+        map_[i] = AllocateChunk(*other.map_[i]);
       }
     }
   }
 
   deque(deque&& other) noexcept
-      : map_{nullptr},
+      : allocator_{std::move(other.allocator_)},
+        map_{nullptr},
         map_size_{0},
         front_chunk_index_{0},
         back_chunk_index_{0},
@@ -96,26 +109,39 @@ class deque {
     other.size_ = 0;
   }
 
-  explicit deque(std::initializer_list<value_type> init) : deque() {
+  explicit deque(std::initializer_list<value_type> init,
+                 const allocator_type& alloc = allocator_type())
+      : deque(alloc) {
     for (const auto& i : init) {
       push_back(i);
     }
   }
 
-  ~deque() {
-    for (size_type i{0}; i < map_size_; ++i) {
-      delete map_[i];
-    }
+  ~deque() { ReleaseStorage(); };
 
-    delete[] map_;
-  };
+  allocator_type get_allocator() const { return allocator_; }
 
-  deque& operator=(deque&& other) noexcept {
+  deque& operator=(deque&& other) noexcept(
+      std::allocator_traits<
+          allocator_type>::propagate_on_container_move_assignment::value ||
+      std::allocator_traits<allocator_type>::is_always_equal::value) {
+    using alloc_traits = std::allocator_traits<allocator_type>;
     if (this != &other) {
-      for (size_type i = 0; i < map_size_; ++i) {
-        delete map_[i];
+      if constexpr (alloc_traits::propagate_on_container_move_assignment::
+                        value == false) {
+        // Chunks from a foreign allocator can't be adopted, copy them over
+        if (allocator_ != other.allocator_) {
+          *this = static_cast<const deque&>(other);
+          other.ReleaseStorage();
+          other.ResetToEmpty();
+          return *this;
+        }
+      }
+      ReleaseStorage();
+      if constexpr (alloc_traits::propagate_on_container_move_assignment::
+                        value) {
+        allocator_ = std::move(other.allocator_);
       }
-      delete[] map_;
 
       map_ = other.map_;
       map_size_ = other.map_size_;
@@ -138,10 +164,11 @@ class deque {
 
   deque& operator=(const deque& other) {
     if (this != &other) {
-      for (size_type i = 0; i < map_size_; ++i) {
-        delete map_[i];
+      ReleaseStorage();
+      if constexpr (std::allocator_traits<allocator_type>::
+                        propagate_on_container_copy_assignment::value) {
+        allocator_ = other.allocator_;
       }
-      delete[] map_;
 
       map_size_ = other.map_size_;
       front_chunk_index_ = other.front_chunk_index_;
@@ -150,10 +177,10 @@ class deque {
       back_vacant_index_ = other.back_vacant_index_;
       size_ = other.size_;
 
-      map_ = new Chunk* [map_size_] {};
+      map_ = AllocateMap(map_size_);
       for (size_type i = 0; i < map_size_; ++i) {
         if (other.map_[i]) {
-          map_[i] = new Chunk(*other.map_[i]);
+          map_[i] = AllocateChunk(*other.map_[i]);
         }
       }
     }
@@ -217,7 +244,7 @@ class deque {
   void pop_front() {
     if (size_ > 0) {
       --size_;
-      map_[front_chunk_index_]->data_[front_element_index_].~value_type();
+      ResetSlot(map_[front_chunk_index_]->data_[front_element_index_]);
       if (front_element_index_ == kChunkSize - 1) {
         front_element_index_ = 0;
         ++front_chunk_index_;
@@ -236,9 +263,7 @@ class deque {
       } else {
         --back_vacant_index_;
       }
-      if constexpr (std::is_trivially_destructible_v<value_type> == false) {
-        map_[back_chunk_index_]->data_[back_vacant_index_].~value_type();
-      }
+      ResetSlot(map_[back_chunk_index_]->data_[back_vacant_index_]);
     }
   }
 
@@ -252,6 +277,10 @@ class deque {
   }
 
   void swap(deque& other) {
+    if constexpr (std::allocator_traits<
+                      allocator_type>::propagate_on_container_swap::value) {
+      std::swap(other.allocator_, allocator_);
+    }
     std::swap(other.map_, map_);
     std::swap(other.map_size_, map_size_);
     std::swap(other.front_chunk_index_, front_chunk_index_);
@@ -312,11 +341,83 @@ class deque {
   }
 
  private:
-  void AddChunkAt(size_type chunk_index) { map_[chunk_index] = new Chunk(); }
+  using chunk_allocator_type = typename std::allocator_traits<
+      allocator_type>::template rebind_alloc<Chunk>;
+  using map_allocator_type = typename std::allocator_traits<
+      allocator_type>::template rebind_alloc<Chunk*>;
+  using chunk_traits = std::allocator_traits<chunk_allocator_type>;
+  using map_traits = std::allocator_traits<map_allocator_type>;
+
+  // Allocates a map with every chunk pointer set to nullptr
+  Chunk** AllocateMap(size_type size) {
+    map_allocator_type map_allocator{allocator_};
+    Chunk** map{map_traits::allocate(map_allocator, size)};
+    std::uninitialized_fill_n(map, size, nullptr);
+    return map;
+  }
+
+  void DeallocateMap(Chunk** map, size_type size) {
+    map_allocator_type map_allocator{allocator_};
+    map_traits::deallocate(map_allocator, map, size);
+  }
+
+  template <typename... Args>
+  Chunk* AllocateChunk(Args&&... args) {
+    chunk_allocator_type chunk_allocator{allocator_};
+    Chunk* chunk{chunk_traits::allocate(chunk_allocator, 1)};
+    try {
+      chunk_traits::construct(chunk_allocator, chunk,
+                              std::forward<Args>(args)...);
+    } catch (...) {
+      chunk_traits::deallocate(chunk_allocator, chunk, 1);
+      throw;
+    }
+    return chunk;
+  }
+
+  void DeallocateChunk(Chunk* chunk) {
+    chunk_allocator_type chunk_allocator{allocator_};
+    chunk_traits::destroy(chunk_allocator, chunk);
+    chunk_traits::deallocate(chunk_allocator, chunk, 1);
+  }
+
+  // Chunks are constructed as a whole, so a popped element is reset to a
+  // default value and only destroyed together with its chunk
+  static void ResetSlot(value_type& slot) {
+    if constexpr (std::is_trivially_destructible_v<value_type> == false) {
+      slot = value_type();
+    }
+  }
+
+  void ReleaseStorage() {
+    if (map_ == nullptr) {
+      return;
+    }
+    for (size_type i{0}; i < map_size_; ++i) {
+      if (map_[i]) {
+        DeallocateChunk(map_[i]);
+      }
+    }
+    DeallocateMap(map_, map_size_);
+  }
+
+  void ResetToEmpty() {
+    map_ = nullptr;
+    map_size_ = 0;
+    front_chunk_index_ = 0;
+    back_chunk_index_ = 0;
+    front_element_index_ = 0;
+    back_vacant_index_ = 0;
+    size_ = 0;
+  }
+
+  void AddChunkAt(size_type chunk_index) {
+    map_[chunk_index] = AllocateChunk();
+  }
 
   void GrowMap(bool to_the_front) {
     size_type new_size_map{map_size_ * 2};
-    Chunk** new_map = new Chunk* [new_size_map] {};
+    Chunk** new_map = AllocateMap(new_size_map);
 
     size_type new_front_chunk_index{};
     size_type new_back_chunk_index{};
@@ -333,13 +434,14 @@ class deque {
 
       std::move(map_, map_ + map_size_, new_map);
     }
-    delete[] map_;
+    DeallocateMap(map_, map_size_);
     front_chunk_index_ = new_front_chunk_index;
     back_chunk_index_ = new_back_chunk_index;
     map_size_ = new_size_map;
     map_ = new_map;
   }
 
+  allocator_type allocator_;          // Chunks and the map are rebound from it
   Chunk** map_{nullptr};              // Pointer to array of chunk pointers
   size_type map_size_{0};             // Current size of the map array
   size_type front_chunk_index_{0};    // Index of the first chunk in map
@@ -349,20 +451,23 @@ class deque {
   size_type size_{0};                 // Total number of elements
 };
 
-template <typename T, bool is_const>
+#pragma GCC diagnostic pop
+
+template <typename T, bool is_const, typename Allocator>
 class DequeIterator {
  public:
   using iterator_category = std::random_access_iterator_tag;
-  using size_type = typename deque<T>::size_type;
+  using size_type = typename deque<T, Allocator>::size_type;
   using value_type = T;
   using pointer = std::conditional_t<is_const, const T*, T*>;
   using reference = std::conditional_t<is_const, const T&, T&>;
   using difference_type = std::ptrdiff_t;
 
-  template <typename U, bool other_is_const>
+  template <typename U, bool other_is_const, typename OtherAllocator>
   friend class DequeIterator;
 
-  using container_type = std::conditional_t<is_const, const deque<T>, deque<T>>;
+  using container_type = std::conditional_t<is_const, const deque<T, Allocator>,
+                                            deque<T, Allocator>>;
   using container_pointer = container_type*;
 
   DequeIterator() = default;
@@ -375,7 +480,7 @@ class DequeIterator {
 
   template <bool other_is_const,
             typename = std::enable_if_t<(is_const || !other_is_const)>>
-  DequeIterator(const DequeIterator<T, other_is_const>& other)
+  DequeIterator(const DequeIterator<T, other_is_const, Allocator>& other)
       : container_{other.container_},
         current_chunk_(other.current_chunk_),
         current_element_(other.current_element_) {}
@@ -509,15 +614,15 @@ class DequeIterator {
   size_type current_element_{};
 };
 
-template <typename T, bool is_const>
-DequeIterator<T, is_const> operator+(
-    typename DequeIterator<T, is_const>::difference_type n,
-    const DequeIterator<T, is_const>& it) {
+template <typename T, bool is_const, typename Allocator>
+DequeIterator<T, is_const, Allocator> operator+(
+    typename DequeIterator<T, is_const, Allocator>::difference_type n,
+    const DequeIterator<T, is_const, Allocator>& it) {
   return it + n;
 }
 
-template <typename T>
-std::ostream& operator<<(std::ostream& out, deque<T>& q) {
+template <typename T, typename Allocator>
+std::ostream& operator<<(std::ostream& out, deque<T, Allocator>& q) {
   for (size_t index{0}; index < q.size(); ++index) {
     out << q[index] << ' ';
   }
@@ -525,9 +630,10 @@ std::ostream& operator<<(std::ostream& out, deque<T>& q) {
   return out;
 }
 
-template <typename T>
-bool operator==(const s21::deque<T>& first, const std::deque<T>& other) {
-  using size_type = typename s21::deque<T>::size_type;
+template <typename T, typename Allocator>
+bool operator==(const s21::deque<T, Allocator>& first,
+                const std::deque<T>& other) {
+  using size_type = typename s21::deque<T, Allocator>::size_type;
 
   if (first.size() != other.size()) {
     return false;
@@ -541,11 +647,17 @@ bool operator==(const s21::deque<T>& first, const std::deque<T>& other) {
   return true;
 }
 
-template <typename T>
-bool operator==(const std::deque<T>& first, const s21::deque<T>& other) {
+template <typename T, typename Allocator>
+bool operator==(const std::deque<T>& first,
+                const s21::deque<T, Allocator>& other) {
   return other == first;
 }
 
+namespace pmr {
+template <typename T>
+using deque = s21::deque<T, std::pmr::polymorphic_allocator<T>>;
+}  // namespace pmr
+
 }  // namespace s21
 
 #endif  // S21_DEQUE_H
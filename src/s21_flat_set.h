@@ -0,0 +1,338 @@
+#ifndef S21_FLAT_SET_H
+#define S21_FLAT_SET_H
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+#include "s21_flat_tree.h"
+#include "s21_vector.h"
+
+namespace s21 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Replacement for s21::set on a sorted array, for lookup tables that are
+// built once and read many times. Lookups are a binary search over
+// contiguous memory, but a single insert or erase shifts the elements
+// after it and invalidates all iterators. Key must be default
+// constructible. There are no node handles.
+template <typename Key, typename Compare = std::less<Key>,
+          typename Allocator = std::allocator<Key>>
+class flat_set {
+  using tree_type = FlatTree<Key, void, Compare, Allocator>;
+
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+  // Keys are never modified in place, that would break the order
+  using iterator = typename tree_type::const_iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = std::size_t;
+  using container_type = typename tree_type::container_type;
+
+  flat_set() : tree_{} {}
+
+  explicit flat_set(const Compare& compare,
+                    const allocator_type& alloc = allocator_type())
+      : tree_{compare, alloc} {}
+
+  explicit flat_set(const allocator_type& alloc) : tree_{alloc} {}
+
+  flat_set(std::initializer_list<value_type> const& items,
+           const Compare& compare = Compare(),
+           const allocator_type& alloc = allocator_type())
+      : tree_{compare, alloc} {
+    tree_.assign_unique(items.begin(), items.end());
+  }
+
+  flat_set(std::initializer_list<value_type> const& items,
+           const allocator_type& alloc)
+      : flat_set(items, Compare(), alloc) {}
+
+  // O(n) when the range is sorted, O(n log n) otherwise
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  flat_set(InputIt first, InputIt last, const Compare& compare = Compare(),
+           const allocator_type& alloc = allocator_type())
+      : tree_{compare, alloc} {
+    tree_.assign_unique(first, last);
+  }
+
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  flat_set(InputIt first, InputIt last, const allocator_type& alloc)
+      : flat_set(first, last, Compare(), alloc) {}
+
+  flat_set(const flat_set& other) : tree_{other.tree_} {}
+
+  flat_set(flat_set&& other) noexcept : tree_(std::move(other.tree_)) {}
+
+  explicit flat_set(size_type size, value_type value,
+                    const allocator_type& alloc = allocator_type())
+      : tree_{alloc} {
+    if (size > 0) {
+      insert(value);
+    }
+  }
+
+  ~flat_set() = default;
+
+  // Takes over storage that is already sorted with no duplicates, without
+  // copying or checking anything
+  static flat_set adopt(container_type&& sorted,
+                        const Compare& compare = Compare()) {
+    return flat_set(tree_type(std::move(sorted), compare));
+  }
+
+  flat_set& operator=(const flat_set& other) {
+    tree_ = other.tree_;
+    return *this;
+  }
+
+  flat_set& operator=(flat_set&& other) noexcept(
+      std::is_nothrow_move_assignable_v<tree_type>) {
+    if (this != &other) {
+      tree_ = std::move(other.tree_);
+    }
+    return *this;
+  }
+
+  allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+  key_compare key_comp() const { return tree_.key_comp(); }
+
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  void assign(InputIt first, InputIt last) {
+    tree_.assign_unique(first, last);
+  }
+
+  // Appends the range, sorts it and merges it in with one pass over the
+  // elements instead of shifting them once per new element
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  void insert(InputIt first, InputIt last) {
+    tree_.insert_range_unique(first, last);
+  }
+
+  iterator begin() const { return tree_.begin(); }
+  iterator end() const { return tree_.end(); }
+
+  bool empty() const { return tree_.empty(); }
+
+  size_type size() const { return tree_.size(); }
+
+  size_type max_size() const {
+    return std::numeric_limits<size_type>::max() / sizeof(key_type);
+  }
+
+  void clear() { tree_.clear(); }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return tree_.insert_unique(value);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return tree_.insert_unique(std::move(value));
+  }
+
+  // Two comparisons when value belongs right before hint, so appending
+  // keys in ascending order at end() skips the binary search and the shift
+  iterator insert(const_iterator hint, const value_type& value) {
+    return tree_.insert_unique(hint, value).first;
+  }
+
+  iterator insert(const_iterator hint, value_type&& value) {
+    return tree_.insert_unique(hint, std::move(value)).first;
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return tree_.emplace_unique(std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    return tree_.emplace_hint_unique(hint, std::forward<Args>(args)...).first;
+  }
+
+  // Iterators are looked up once everything is in, so all of them are
+  // still valid when this returns
+  template <typename... Args>
+  s21::vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
+    auto values = {std::forward<Args>(args)...};
+    s21::vector<decltype(values.begin())> inserted;
+    for (auto value = values.begin(); value != values.end(); ++value) {
+      if (tree_.insert_unique(*value).second) {
+        inserted.push_back(value);
+      }
+    }
+    s21::vector<std::pair<iterator, bool>> results;
+    for (const auto& value : inserted) {
+      results.push_back(std::make_pair(find(*value), true));
+    }
+    return results;
+  }
+
+  iterator erase(const_iterator pos) { return tree_.erase(pos); }
+
+  // Erases [first, last) with one shift of the tail
+  iterator erase(const_iterator first, const_iterator last) {
+    return tree_.erase(first, last);
+  }
+
+  size_type erase(const key_type& key) { return tree_.erase_equal(key); }
+
+  void swap(flat_set& other) noexcept { std::swap(tree_, other.tree_); }
+
+  // Moves the elements of other over in one merge pass. Keys already
+  // present here are dropped from other, which always ends up empty.
+  void merge(flat_set& other) { tree_.merge_unique(other.tree_); }
+
+  // Every lookup below also has a template overload taking any K, which
+  // exists only for transparent comparators and builds no key_type
+
+  iterator find(const key_type& key) const { return tree_.find(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator find(const K& key) const {
+    return tree_.find(key);
+  }
+
+  bool contains(const key_type& key) const { return tree_.contains(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  bool contains(const K& key) const {
+    return tree_.contains(key);
+  }
+
+  // Looks up every key of [first, last) and writes, in the same order, an
+  // iterator to each element found or end() to out. Unlike set::find_many
+  // this is a plain loop of binary searches over contiguous keys.
+  template <typename ForwardIt, typename OutputIt>
+  OutputIt find_many(ForwardIt first, ForwardIt last, OutputIt out) const {
+    for (; first != last; ++first) {
+      *out++ = find(*first);
+    }
+    return out;
+  }
+
+  // Writes one bool per key of [first, last) to out, like find_many
+  template <typename ForwardIt, typename OutputIt>
+  OutputIt contains_many(ForwardIt first, ForwardIt last, OutputIt out) const {
+    for (; first != last; ++first) {
+      *out++ = contains(*first);
+    }
+    return out;
+  }
+
+  size_type count(const key_type& key) const { return contains(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  size_type count(const K& key) const {
+    return contains(key);
+  }
+
+  iterator lower_bound(const key_type& key) const {
+    return tree_.lower_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator lower_bound(const K& key) const {
+    return tree_.lower_bound(key);
+  }
+
+  iterator upper_bound(const key_type& key) const {
+    return tree_.upper_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator upper_bound(const K& key) const {
+    return tree_.upper_bound(key);
+  }
+
+  std::pair<iterator, iterator> equal_range(const key_type& key) const {
+    return tree_.equal_range(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  std::pair<iterator, iterator> equal_range(const K& key) const {
+    return tree_.equal_range(key);
+  }
+
+  // Lazy view of the elements with keys in [lo, hi)
+  TreeRange<iterator> range(const key_type& lo, const key_type& hi) const {
+    return tree_.range(lo, hi);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  TreeRange<iterator> range(const K& lo, const K& hi) const {
+    return tree_.range(lo, hi);
+  }
+
+  bool operator==(const flat_set& other) const {
+    if (this->size() != other.size()) return false;
+    auto it1 = begin();
+    auto it2 = other.begin();
+
+    while (it1 != end() && it2 != other.end()) {
+      if (*it1 != *it2) return false;
+      ++it1;
+      ++it2;
+    }
+
+    return it1 == end() && it2 == other.end();
+  }
+
+ private:
+  explicit flat_set(tree_type&& tree) : tree_{std::move(tree)} {}
+
+  template <typename K, typename C, typename A>
+  friend flat_set<K, C, A> set_union(flat_set<K, C, A> lhs,
+                                     flat_set<K, C, A> rhs);
+  template <typename K, typename C, typename A>
+  friend flat_set<K, C, A> set_intersection(flat_set<K, C, A> lhs,
+                                            flat_set<K, C, A> rhs);
+  template <typename K, typename C, typename A>
+  friend flat_set<K, C, A> set_difference(flat_set<K, C, A> lhs,
+                                          flat_set<K, C, A> rhs);
+
+  tree_type tree_;
+};
+
+#pragma GCC diagnostic pop
+
+// Set algebra as one merge pass over both sets, O(n + m). The arguments
+// are consumed, hand them over with std::move when they are no longer
+// needed.
+template <typename Key, typename Compare, typename Allocator>
+flat_set<Key, Compare, Allocator> set_union(
+    flat_set<Key, Compare, Allocator> lhs,
+    flat_set<Key, Compare, Allocator> rhs) {
+  lhs.tree_.union_with(rhs.tree_);
+  return lhs;
+}
+
+template <typename Key, typename Compare, typename Allocator>
+flat_set<Key, Compare, Allocator> set_intersection(
+    flat_set<Key, Compare, Allocator> lhs,
+    flat_set<Key, Compare, Allocator> rhs) {
+  lhs.tree_.intersect_with(rhs.tree_);
+  return lhs;
+}
+
+template <typename Key, typename Compare, typename Allocator>
+flat_set<Key, Compare, Allocator> set_difference(
+    flat_set<Key, Compare, Allocator> lhs,
+    flat_set<Key, Compare, Allocator> rhs) {
+  lhs.tree_.subtract(rhs.tree_);
+  return lhs;
+}
+
+namespace pmr {
+template <typename Key, typename Compare = std::less<Key>>
+using flat_set =
+    s21::flat_set<Key, Compare, std::pmr::polymorphic_allocator<Key>>;
+}  // namespace pmr
+
+}  // namespace s21
+
+#endif  // S21_FLAT_SET_H
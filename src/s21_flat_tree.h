@@ -0,0 +1,525 @@
+#ifndef S21_FLAT_TREE_H
+#define S21_FLAT_TREE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "s21_tree_utility.h"
+#include "s21_vector.h"
+
+namespace s21 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Sorted array behind flat_map, flat_set and flat_multiset. Lookups are a
+// binary search over contiguous memory, inserts and erases shift the
+// elements after the position, so it suits tables that are built once
+// and read many times. Every insert and erase invalidates iterators.
+//
+// Elements are kept in an s21::vector, which assigns into default
+// constructed slots: map elements are pair<Key, T> rather than
+// pair<const Key, T>, and both Key and T have to be default
+// constructible and move assignable.
+template <typename Key, typename T = void, typename Compare = std::less<Key>,
+          typename Allocator = std::allocator<
+              std::conditional_t<std::is_void_v<T>, Key, std::pair<Key, T>>>>
+class FlatTree {
+ public:
+  using value_type =
+      std::conditional_t<std::is_void_v<T>, Key, std::pair<Key, T>>;
+  using key_type = Key;
+  using mapped_type = T;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+  using container_type = s21::vector<value_type, Allocator>;
+  using iterator = VectorIterator<value_type, false>;
+  using const_iterator = VectorIterator<value_type, true>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  FlatTree() : FlatTree(Compare(), allocator_type()) {}
+  explicit FlatTree(const allocator_type& alloc)
+      : FlatTree(Compare(), alloc) {}
+  explicit FlatTree(const Compare& compare,
+                    const allocator_type& alloc = allocator_type())
+      : compare_{compare}, data_(alloc) {}
+
+  // Takes over storage that already holds the elements in order
+  FlatTree(container_type&& sorted, const Compare& compare)
+      : compare_{compare}, data_(std::move(sorted)) {}
+
+  FlatTree(const FlatTree& other)
+      : compare_{other.compare_}, data_(other.data_) {}
+  FlatTree(FlatTree&& other) noexcept
+      : compare_{other.compare_}, data_(std::move(other.data_)) {}
+
+  ~FlatTree() = default;
+
+  // O(n), other is sorted already, so its storage is copied as it is
+  FlatTree& operator=(const FlatTree& other) {
+    if (this != &other) {
+      compare_ = other.compare_;
+      data_ = other.data_;
+    }
+    return *this;
+  }
+
+  FlatTree& operator=(FlatTree&& other) noexcept(
+      std::is_nothrow_move_assignable_v<container_type>) {
+    if (this != &other) {
+      compare_ = other.compare_;
+      data_ = std::move(other.data_);
+    }
+    return *this;
+  }
+
+  allocator_type get_allocator() const { return data_.get_allocator(); }
+
+  key_compare key_comp() const { return compare_; }
+
+  size_type size() const { return data_.size(); }
+
+  bool empty() const { return data_.empty(); }
+
+  iterator begin() { return iterator(data_.data()); }
+  iterator end() { return iterator(data_.data() + data_.size()); }
+  const_iterator begin() const { return const_iterator(data_.data()); }
+  const_iterator end() const {
+    return const_iterator(data_.data() + data_.size());
+  }
+
+  // Inserts only if no equivalent key is present, otherwise returns the
+  // element holding it
+  template <typename Value>
+  std::pair<iterator, bool> insert_unique(Value&& value) {
+    size_type position{LowerBound(KeyOf(value))};
+    if (Holds(position, KeyOf(value))) {
+      return {begin() + Offset(position), false};
+    }
+    return {InsertAt(position, std::forward<Value>(value)), true};
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_unique(Args&&... args) {
+    return insert_unique(value_type(std::forward<Args>(args)...));
+  }
+
+  // Builds the mapped value only when key is new
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+    size_type position{LowerBound(key)};
+    if (Holds(position, key)) {
+      return {begin() + Offset(position), false};
+    }
+    return {InsertAt(position, std::piecewise_construct,
+                     std::forward_as_tuple(std::forward<K>(key)),
+                     std::forward_as_tuple(std::forward<Args>(args)...)),
+            true};
+  }
+
+  // A hint saves the binary search when key belongs right before it,
+  // which makes appending keys in ascending order at end() O(1)
+  template <typename Value>
+  std::pair<iterator, bool> insert_unique(const_iterator hint,
+                                          Value&& value) {
+    size_type position{UniqueSlot(hint, KeyOf(value))};
+    if (Holds(position, KeyOf(value))) {
+      return {begin() + Offset(position), false};
+    }
+    return {InsertAt(position, std::forward<Value>(value)), true};
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_hint_unique(const_iterator hint,
+                                                Args&&... args) {
+    return insert_unique(hint, value_type(std::forward<Args>(args)...));
+  }
+
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> try_emplace_hint(const_iterator hint, K&& key,
+                                             Args&&... args) {
+    size_type position{UniqueSlot(hint, key)};
+    if (Holds(position, key)) {
+      return {begin() + Offset(position), false};
+    }
+    return {InsertAt(position, std::piecewise_construct,
+                     std::forward_as_tuple(std::forward<K>(key)),
+                     std::forward_as_tuple(std::forward<Args>(args)...)),
+            true};
+  }
+
+  // Equal keys keep insertion order: the new element goes after them
+  template <typename... Args>
+  iterator emplace_equal(Args&&... args) {
+    value_type value(std::forward<Args>(args)...);
+    return InsertAt(UpperBound(KeyOf(value)), std::move(value));
+  }
+
+  // Lands as close to hint as ordering allows
+  template <typename... Args>
+  iterator emplace_hint_equal(const_iterator hint, Args&&... args) {
+    value_type value(std::forward<Args>(args)...);
+    return InsertAt(EqualSlot(hint, KeyOf(value)), std::move(value));
+  }
+
+  // Appends the whole range, sorts only the new part and merges it into
+  // the old one, O(n + k log k) for k new elements instead of k shifts.
+  // Among equivalent keys the element that was here first wins, then the
+  // first one in the range.
+  template <typename InputIt>
+  void insert_range_unique(InputIt first, InputIt last) {
+    size_type old_size{Append(first, last)};
+    value_type* data{data_.data()};
+    value_type* middle{data + old_size};
+    value_type* end{data + data_.size()};
+    SortTail(middle, end);
+    end = std::unique(middle, end, ValueEquivalent());
+    MergeTail(data, middle, end);
+    end = std::unique(data, end, ValueEquivalent());
+    data_.erase(data_.begin() + Offset(end - data), data_.end());
+  }
+
+  // Same as above, equal keys keep the order they came in
+  template <typename InputIt>
+  void insert_range_equal(InputIt first, InputIt last) {
+    size_type old_size{Append(first, last)};
+    value_type* data{data_.data()};
+    value_type* middle{data + old_size};
+    value_type* end{data + data_.size()};
+    SortTail(middle, end);
+    MergeTail(data, middle, end);
+  }
+
+  template <typename InputIt>
+  void assign_unique(InputIt first, InputIt last) {
+    data_.clear();
+    insert_range_unique(first, last);
+  }
+
+  template <typename InputIt>
+  void assign_equal(InputIt first, InputIt last) {
+    data_.clear();
+    insert_range_equal(first, last);
+  }
+
+  // Moves the elements of other over in one merge. Keys already present
+  // here are dropped, and other always ends up empty.
+  void merge_unique(FlatTree& other) {
+    insert_range_unique(std::make_move_iterator(other.begin()),
+                        std::make_move_iterator(other.end()));
+    other.clear();
+  }
+
+  void merge_equal(FlatTree& other) {
+    insert_range_equal(std::make_move_iterator(other.begin()),
+                       std::make_move_iterator(other.end()));
+    other.clear();
+  }
+
+  // Set algebra on unique keys as one linear pass over both arrays. A key
+  // in both keeps the element from this tree; other is left empty.
+  void union_with(FlatTree& other) {
+    container_type result(get_allocator());
+    result.reserve(size() + other.size());
+    std::set_union(std::make_move_iterator(Data()),
+                   std::make_move_iterator(Data() + size()),
+                   std::make_move_iterator(other.Data()),
+                   std::make_move_iterator(other.Data() + other.size()),
+                   std::back_inserter(result), ValueCompare());
+    data_ = std::move(result);
+    other.clear();
+  }
+
+  void intersect_with(FlatTree& other) {
+    container_type result(get_allocator());
+    result.reserve(std::min(size(), other.size()));
+    std::set_intersection(std::make_move_iterator(Data()),
+                          std::make_move_iterator(Data() + size()),
+                          other.Data(), other.Data() + other.size(),
+                          std::back_inserter(result), ValueCompare());
+    data_ = std::move(result);
+    other.clear();
+  }
+
+  void subtract(FlatTree& other) {
+    container_type result(get_allocator());
+    result.reserve(size());
+    std::set_difference(std::make_move_iterator(Data()),
+                        std::make_move_iterator(Data() + size()),
+                        other.Data(), other.Data() + other.size(),
+                        std::back_inserter(result), ValueCompare());
+    data_ = std::move(result);
+    other.clear();
+  }
+
+  template <typename K>
+  iterator find(const K& key) {
+    return begin() + Offset(Find(key));
+  }
+
+  template <typename K>
+  const_iterator find(const K& key) const {
+    return begin() + Offset(Find(key));
+  }
+
+  template <typename K>
+  bool contains(const K& key) const {
+    return Holds(LowerBound(key), key);
+  }
+
+  template <typename K>
+  iterator lower_bound(const K& key) {
+    return begin() + Offset(LowerBound(key));
+  }
+
+  template <typename K>
+  const_iterator lower_bound(const K& key) const {
+    return begin() + Offset(LowerBound(key));
+  }
+
+  template <typename K>
+  iterator upper_bound(const K& key) {
+    return begin() + Offset(UpperBound(key));
+  }
+
+  template <typename K>
+  const_iterator upper_bound(const K& key) const {
+    return begin() + Offset(UpperBound(key));
+  }
+
+  template <typename K>
+  std::pair<iterator, iterator> equal_range(const K& key) {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  template <typename K>
+  std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  // lo and hi are never compared with each other, so a transparent
+  // comparator only has to know how to compare them with keys
+  template <typename K>
+  TreeRange<iterator> range(const K& lo, const K& hi) {
+    size_type first{LowerBound(lo)};
+    size_type last{std::max(first, LowerBound(hi))};
+    return {begin() + Offset(first), begin() + Offset(last)};
+  }
+
+  template <typename K>
+  TreeRange<const_iterator> range(const K& lo, const K& hi) const {
+    size_type first{LowerBound(lo)};
+    size_type last{std::max(first, LowerBound(hi))};
+    return {begin() + Offset(first), begin() + Offset(last)};
+  }
+
+  iterator erase(const_iterator pos) { return data_.erase(pos); }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    return data_.erase(first, last);
+  }
+
+  // Removes all elements equivalent to key with one shift of the tail
+  template <typename K>
+  size_type erase_equal(const K& key) {
+    size_type first{LowerBound(key)};
+    size_type last{UpperBound(key)};
+    data_.erase(begin() + Offset(first), begin() + Offset(last));
+    return last - first;
+  }
+
+  void clear() { data_.clear(); }
+
+  // Elements less than key, or not greater with upper
+  template <typename K>
+  size_type rank(const K& key) const {
+    return LowerBound(key);
+  }
+
+  template <typename K>
+  size_type count(const K& key) const {
+    return UpperBound(key) - LowerBound(key);
+  }
+
+  const_iterator nth_element(size_type k) const {
+    return k < size() ? begin() + Offset(k) : end();
+  }
+
+  static difference_type distance(const_iterator first,
+                                  const_iterator last) {
+    return last - first;
+  }
+
+ private:
+  using alloc_traits = std::allocator_traits<allocator_type>;
+
+  template <typename Value>
+  static const auto& KeyOf(const Value& value) {
+    if constexpr (std::is_void_v<T>) {
+      return value;
+    } else {
+      return value.first;
+    }
+  }
+
+  static difference_type Offset(size_type position) {
+    return static_cast<difference_type>(position);
+  }
+
+  static difference_type Offset(difference_type position) {
+    return position;
+  }
+
+  value_type* Data() const { return data_.data(); }
+
+  auto ValueCompare() const {
+    return [this](const value_type& lhs, const value_type& rhs) {
+      return compare_(KeyOf(lhs), KeyOf(rhs));
+    };
+  }
+
+  // Neighbours in sorted order are equivalent unless the first goes
+  // strictly before the second
+  auto ValueEquivalent() const {
+    return [this](const value_type& lhs, const value_type& rhs) {
+      return compare_(KeyOf(lhs), KeyOf(rhs)) == false;
+    };
+  }
+
+  // Binary search without a branch on the comparison, so the CPU has
+  // nothing to mispredict: the loop only narrows the window with a
+  // conditional move. Counts the elements before key: the ones less than
+  // key, or with upper the ones not greater than it.
+  template <bool upper, typename K>
+  size_type Search(const K& key) const {
+    size_type length{size()};
+    if (length == 0) {
+      return 0;
+    }
+    const value_type* base{Data()};
+    while (length > 1) {
+      size_type half{length / 2};
+      base = Before<upper>(base[half], key) ? base + half : base;
+      length -= half;
+    }
+    return static_cast<size_type>(base - Data()) +
+           static_cast<size_type>(Before<upper>(*base, key));
+  }
+
+  template <bool upper, typename K>
+  bool Before(const value_type& value, const K& key) const {
+    if constexpr (upper) {
+      return compare_(key, KeyOf(value)) == false;
+    } else {
+      return compare_(KeyOf(value), key);
+    }
+  }
+
+  template <typename K>
+  size_type LowerBound(const K& key) const {
+    return Search<false>(key);
+  }
+
+  template <typename K>
+  size_type UpperBound(const K& key) const {
+    return Search<true>(key);
+  }
+
+  template <typename K>
+  size_type Find(const K& key) const {
+    size_type position{LowerBound(key)};
+    return Holds(position, key) ? position : size();
+  }
+
+  // Whether the element at a lower bound is equivalent to key
+  template <typename K>
+  bool Holds(size_type position, const K& key) const {
+    return position < size() &&
+           compare_(key, KeyOf(Data()[position])) == false;
+  }
+
+  // The hint is the slot when key goes between it and its predecessor
+  template <typename K>
+  size_type UniqueSlot(const_iterator hint, const K& key) const {
+    size_type position{static_cast<size_type>(hint - begin())};
+    if ((position == size() || compare_(key, KeyOf(Data()[position]))) &&
+        (position == 0 || compare_(KeyOf(Data()[position - 1]), key))) {
+      return position;
+    }
+    return LowerBound(key);
+  }
+
+  // Equal keys around the hint are fine on either side, otherwise the
+  // closest slot that keeps the order is the bound facing the hint
+  template <typename K>
+  size_type EqualSlot(const_iterator hint, const K& key) const {
+    size_type position{static_cast<size_type>(hint - begin())};
+    if (position < size() && compare_(KeyOf(Data()[position]), key)) {
+      return LowerBound(key);
+    }
+    if (position > 0 && compare_(key, KeyOf(Data()[position - 1]))) {
+      return UpperBound(key);
+    }
+    return position;
+  }
+
+  // Grows storage geometrically: s21::vector::insert only grows to fit
+  template <typename... Args>
+  iterator InsertAt(size_type position, Args&&... args) {
+    value_type value(std::forward<Args>(args)...);
+    if (data_.size() == data_.capacity()) {
+      data_.reserve(std::max<size_type>(1, 2 * data_.size()));
+    }
+    return data_.insert(begin() + Offset(position), std::move(value));
+  }
+
+  // Puts the range after the elements and returns where it starts
+  template <typename InputIt>
+  size_type Append(InputIt first, InputIt last) {
+    size_type old_size{size()};
+    if constexpr (std::is_base_of_v<
+                      std::forward_iterator_tag,
+                      typename std::iterator_traits<InputIt>::
+                          iterator_category>) {
+      data_.reserve(old_size +
+                    static_cast<size_type>(std::distance(first, last)));
+    }
+    for (; first != last; ++first) {
+      data_.push_back(*first);
+    }
+    return old_size;
+  }
+
+  // One pass when the batch comes sorted already
+  void SortTail(value_type* first, value_type* last) {
+    if (std::is_sorted(first, last, ValueCompare()) == false) {
+      std::stable_sort(first, last, ValueCompare());
+    }
+  }
+
+  // Nothing moves when the new elements all go after the old ones, as
+  // they do when a sorted batch is appended
+  void MergeTail(value_type* first, value_type* middle, value_type* last) {
+    if (first == middle || middle == last ||
+        compare_(KeyOf(*middle), KeyOf(*(middle - 1))) == false) {
+      return;
+    }
+    std::inplace_merge(first, middle, last, ValueCompare());
+  }
+
+  Compare compare_;
+  container_type data_;
+};
+
+#pragma GCC diagnostic pop
+
+}  // namespace s21
+
+#endif  // S21_FLAT_TREE_H
@@ -0,0 +1,119 @@
+#ifndef S21_FROZEN_MAP_H
+#define S21_FROZEN_MAP_H
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_frozen_tree.h"
+#include "s21_map.h"
+#include "s21_tree_utility.h"
+
+namespace s21 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Map that is built once and never changes, laid out like frozen_set:
+// keys in BFS order in one cache-aligned array, mapped values in a second
+// array in the same order, so lookups never pull values into the cache.
+// Iterators yield pair<const Key&, const T&> proxies, which structured
+// bindings take apart as usual.
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class frozen_map {
+  using tree_type = FrozenTree<Key, T, Compare>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const Key, T>;
+  using reference = typename tree_type::reference;
+  using key_compare = Compare;
+  using iterator = typename tree_type::const_iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = std::size_t;
+
+  frozen_map() : tree_{} {}
+
+  explicit frozen_map(const Compare& compare) : tree_{compare} {}
+
+  // O(n), the map is in order already
+  template <typename Allocator>
+  explicit frozen_map(const map<Key, T, Compare, Allocator>& source)
+      : tree_{std::vector<std::pair<Key, T>>(source.begin(), source.end()),
+              source.key_comp()} {}
+
+  // O(n) when the range is sorted, O(n log n) otherwise. Of equivalent
+  // keys the first one wins, as with map::insert.
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  frozen_map(InputIt first, InputIt last, const Compare& compare = Compare())
+      : tree_{tree_type::Collect(first, last, compare), compare} {}
+
+  frozen_map(std::initializer_list<value_type> const& items,
+             const Compare& compare = Compare())
+      : frozen_map(items.begin(), items.end(), compare) {}
+
+  key_compare key_comp() const { return tree_.key_comp(); }
+
+  iterator begin() const { return tree_.begin(); }
+  iterator end() const { return tree_.end(); }
+
+  bool empty() const { return tree_.empty(); }
+  size_type size() const { return tree_.size(); }
+
+  const T& at(const key_type& key) const {
+    iterator it{tree_.find(key)};
+    if (it == end()) {
+      throw std::out_of_range("Out of range");
+    }
+    return (*it).second;
+  }
+
+  // Every lookup below also has a template overload taking any K, which
+  // exists only for transparent comparators and builds no key_type
+
+  iterator find(const key_type& key) const { return tree_.find(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator find(const K& key) const {
+    return tree_.find(key);
+  }
+
+  bool contains(const key_type& key) const { return tree_.contains(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  bool contains(const K& key) const {
+    return tree_.contains(key);
+  }
+
+  size_type count(const key_type& key) const { return contains(key); }
+
+  iterator lower_bound(const key_type& key) const {
+    return tree_.lower_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator lower_bound(const K& key) const {
+    return tree_.lower_bound(key);
+  }
+
+  iterator upper_bound(const key_type& key) const {
+    return tree_.upper_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator upper_bound(const K& key) const {
+    return tree_.upper_bound(key);
+  }
+
+  std::pair<iterator, iterator> equal_range(const key_type& key) const {
+    return tree_.equal_range(key);
+  }
+
+ private:
+  tree_type tree_;
+};
+
+#pragma GCC diagnostic pop
+
+}  // namespace s21
+
+#endif  // S21_FROZEN_MAP_H
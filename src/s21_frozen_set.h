@@ -0,0 +1,107 @@
+#ifndef S21_FROZEN_SET_H
+#define S21_FROZEN_SET_H
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <utility>
+
+#include "s21_frozen_tree.h"
+#include "s21_set.h"
+#include "s21_tree_utility.h"
+
+namespace s21 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Set that is built once and never changes, for tables probed far more
+// often than they are built. Keys sit in one cache-aligned array in BFS
+// order, so a lookup is a branch-free walk down implicit indices with
+// the next levels prefetched, rather than a chase of node pointers.
+// Iterators are bidirectional and stay valid for the life of the set.
+template <typename Key, typename Compare = std::less<Key>>
+class frozen_set {
+  using tree_type = FrozenTree<Key, void, Compare>;
+
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using key_compare = Compare;
+  using iterator = typename tree_type::const_iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = std::size_t;
+
+  frozen_set() : tree_{} {}
+
+  explicit frozen_set(const Compare& compare) : tree_{compare} {}
+
+  // O(n), the set is in order already
+  template <typename Allocator>
+  explicit frozen_set(const set<Key, Compare, Allocator>& source)
+      : tree_{std::vector<Key>(source.begin(), source.end()),
+              source.key_comp()} {}
+
+  // O(n) when the range is sorted, O(n log n) otherwise
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  frozen_set(InputIt first, InputIt last, const Compare& compare = Compare())
+      : tree_{tree_type::Collect(first, last, compare), compare} {}
+
+  frozen_set(std::initializer_list<value_type> const& items,
+             const Compare& compare = Compare())
+      : frozen_set(items.begin(), items.end(), compare) {}
+
+  key_compare key_comp() const { return tree_.key_comp(); }
+
+  iterator begin() const { return tree_.begin(); }
+  iterator end() const { return tree_.end(); }
+
+  bool empty() const { return tree_.empty(); }
+  size_type size() const { return tree_.size(); }
+
+  // Every lookup below also has a template overload taking any K, which
+  // exists only for transparent comparators and builds no key_type
+
+  iterator find(const key_type& key) const { return tree_.find(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator find(const K& key) const {
+    return tree_.find(key);
+  }
+
+  bool contains(const key_type& key) const { return tree_.contains(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  bool contains(const K& key) const {
+    return tree_.contains(key);
+  }
+
+  size_type count(const key_type& key) const { return contains(key); }
+
+  iterator lower_bound(const key_type& key) const {
+    return tree_.lower_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator lower_bound(const K& key) const {
+    return tree_.lower_bound(key);
+  }
+
+  iterator upper_bound(const key_type& key) const {
+    return tree_.upper_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator upper_bound(const K& key) const {
+    return tree_.upper_bound(key);
+  }
+
+  std::pair<iterator, iterator> equal_range(const key_type& key) const {
+    return tree_.equal_range(key);
+  }
+
+ private:
+  tree_type tree_;
+};
+
+#pragma GCC diagnostic pop
+
+}  // namespace s21
+
+#endif  // S21_FROZEN_SET_H
@@ -0,0 +1,427 @@
+#ifndef S21_FROZEN_TREE_H
+#define S21_FROZEN_TREE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "s21_tree_utility.h"
+
+namespace s21 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Slots 1 to size of U in one allocation aligned to a cache line. Slot 0
+// is never constructed, which keeps the 1-based indices of an Eytzinger
+// layout plain array indices, and puts the children of any k * B to
+// k * B + B - 1 on a single line when B elements fill one.
+template <typename U>
+class CacheAlignedArray {
+ public:
+  static constexpr std::size_t kAlignment{
+      std::max<std::size_t>(64, alignof(U))};
+
+  CacheAlignedArray() = default;
+
+  // Slot k is built from source[order[k]] for k from 1 up
+  template <typename Source>
+  CacheAlignedArray(Source& source, const std::vector<std::size_t>& order)
+      : data_{Allocate(source.size())} {
+    try {
+      for (std::size_t k{1}; k <= source.size(); ++k, ++size_) {
+        ::new (static_cast<void*>(data_ + k)) U(std::move(source[order[k]]));
+      }
+    } catch (...) {
+      Release();
+      throw;
+    }
+  }
+
+  CacheAlignedArray(const CacheAlignedArray& other)
+      : data_{Allocate(other.size_)} {
+    try {
+      for (std::size_t k{1}; k <= other.size_; ++k, ++size_) {
+        ::new (static_cast<void*>(data_ + k)) U(other.data_[k]);
+      }
+    } catch (...) {
+      Release();
+      throw;
+    }
+  }
+
+  CacheAlignedArray(CacheAlignedArray&& other) noexcept
+      : data_{std::exchange(other.data_, nullptr)},
+        size_{std::exchange(other.size_, 0)} {}
+
+  CacheAlignedArray& operator=(CacheAlignedArray other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    return *this;
+  }
+
+  ~CacheAlignedArray() { Release(); }
+
+  const U* data() const { return data_; }
+  const U& operator[](std::size_t k) const { return data_[k]; }
+
+ private:
+  static U* Allocate(std::size_t size) {
+    if (size == 0) {
+      return nullptr;
+    }
+    return static_cast<U*>(::operator new((size + 1) * sizeof(U),
+                                          std::align_val_t{kAlignment}));
+  }
+
+  void Release() {
+    if (data_ == nullptr) {
+      return;
+    }
+    for (std::size_t k{1}; k <= size_; ++k) {
+      data_[k].~U();
+    }
+    ::operator delete(data_, std::align_val_t{kAlignment});
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  U* data_{nullptr};
+  std::size_t size_{0};
+};
+
+// Immutable sorted container behind frozen_set and frozen_map. Keys are
+// laid out in BFS (Eytzinger) order: the root in slot 1 and the children
+// of slot k in slots 2k and 2k + 1. A lookup walks down from the root,
+// turning with k = 2k + (key went right), which the compiler turns into
+// a conditional add instead of a branch, and prefetches the cache line
+// holding the descendants several levels down while it compares.
+//
+// Mapped values, if any, sit in a second array in the same order, so
+// the lookup only ever touches keys. Iteration follows the in-order
+// successor through the slot indices.
+template <typename Key, typename T = void, typename Compare = std::less<Key>>
+class FrozenTree {
+  static constexpr bool kIsMap{!std::is_void_v<T>};
+  // Something for the unused values array of a set to hold
+  using stored_mapped = std::conditional_t<kIsMap, T, char>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using key_compare = Compare;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  // What the sorted input is collected as before it is laid out
+  using sorted_type =
+      std::conditional_t<kIsMap, std::pair<Key, stored_mapped>, Key>;
+  using reference =
+      std::conditional_t<kIsMap, std::pair<const Key&, const stored_mapped&>,
+                         const Key&>;
+
+  class const_iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::remove_cv_t<std::remove_reference_t<
+        std::conditional_t<kIsMap, std::pair<const Key, stored_mapped>,
+                           Key>>>;
+    using difference_type = std::ptrdiff_t;
+    using reference = FrozenTree::reference;
+
+    // Holds the pair that operator-> points into
+    struct ArrowProxy {
+      const reference* operator->() const { return &pair_; }
+      reference pair_;
+    };
+    using pointer = std::conditional_t<kIsMap, ArrowProxy, const Key*>;
+
+    const_iterator() = default;
+
+    reference operator*() const {
+      if constexpr (kIsMap) {
+        return {tree_->keys_[slot_], tree_->values_[slot_]};
+      } else {
+        return tree_->keys_[slot_];
+      }
+    }
+
+    pointer operator->() const {
+      if constexpr (kIsMap) {
+        return ArrowProxy{**this};
+      } else {
+        return &**this;
+      }
+    }
+
+    const_iterator& operator++() {
+      slot_ = tree_->Next(slot_);
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator old{*this};
+      ++*this;
+      return old;
+    }
+
+    const_iterator& operator--() {
+      slot_ = tree_->Previous(slot_);
+      return *this;
+    }
+
+    const_iterator operator--(int) {
+      const_iterator old{*this};
+      --*this;
+      return old;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return slot_ == other.slot_;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return slot_ != other.slot_;
+    }
+
+    const Key& key() const { return tree_->keys_[slot_]; }
+
+   private:
+    friend class FrozenTree;
+
+    const_iterator(const FrozenTree* tree, size_type slot)
+        : tree_{tree}, slot_{slot} {}
+
+    const FrozenTree* tree_{nullptr};
+    // 0 is end()
+    size_type slot_{0};
+  };
+
+  using iterator = const_iterator;
+
+  FrozenTree() : FrozenTree(Compare()) {}
+  explicit FrozenTree(const Compare& compare)
+      : compare_{compare}, keys_{}, values_{} {}
+
+  // sorted has to be in order with no equivalent keys
+  FrozenTree(std::vector<sorted_type>&& sorted, const Compare& compare)
+      : compare_{compare},
+        keys_{},
+        values_{},
+        size_{sorted.size()} {
+    std::vector<size_type> order(size_ + 1);
+    size_type rank{0};
+    for (size_type slot{First()}; slot != 0; slot = Next(slot)) {
+      order[slot] = rank++;
+    }
+    if constexpr (kIsMap) {
+      KeyView key_view{sorted};
+      keys_ = CacheAlignedArray<Key>{key_view, order};
+      MappedView mapped_view{sorted};
+      values_ = CacheAlignedArray<stored_mapped>{mapped_view, order};
+    } else {
+      keys_ = CacheAlignedArray<Key>{sorted, order};
+    }
+  }
+
+  FrozenTree(const FrozenTree&) = default;
+  FrozenTree(FrozenTree&& other) noexcept
+      : compare_{other.compare_},
+        keys_{std::move(other.keys_)},
+        values_{std::move(other.values_)},
+        size_{std::exchange(other.size_, 0)} {}
+  FrozenTree& operator=(const FrozenTree&) = default;
+  FrozenTree& operator=(FrozenTree&& other) noexcept {
+    if (this != &other) {
+      compare_ = other.compare_;
+      keys_ = std::move(other.keys_);
+      values_ = std::move(other.values_);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+  ~FrozenTree() = default;
+
+  // Collects [first, last) of sorted_type, sorting it unless it is in
+  // order already. Of equivalent keys the first one is kept, as inserting
+  // them one by one would.
+  template <typename InputIt>
+  static std::vector<sorted_type> Collect(InputIt first, InputIt last,
+                                          const Compare& compare) {
+    std::vector<sorted_type> sorted(first, last);
+    auto less = [&compare](const sorted_type& lhs, const sorted_type& rhs) {
+      return compare(KeyOf(lhs), KeyOf(rhs));
+    };
+    if (std::is_sorted(sorted.begin(), sorted.end(), less) == false) {
+      std::stable_sort(sorted.begin(), sorted.end(), less);
+    }
+    auto equivalent = [&less](const sorted_type& lhs,
+                              const sorted_type& rhs) {
+      return less(lhs, rhs) == false && less(rhs, lhs) == false;
+    };
+    sorted.erase(std::unique(sorted.begin(), sorted.end(), equivalent),
+                 sorted.end());
+    return sorted;
+  }
+
+  key_compare key_comp() const { return compare_; }
+
+  const_iterator begin() const { return {this, First()}; }
+  const_iterator end() const { return {this, 0}; }
+
+  bool empty() const { return size_ == 0; }
+  size_type size() const { return size_; }
+
+  template <typename K>
+  const_iterator lower_bound(const K& key) const {
+    return {this, Descend(key, [this](const Key& node, const K& target) {
+              return compare_(node, target);
+            })};
+  }
+
+  template <typename K>
+  const_iterator upper_bound(const K& key) const {
+    return {this, Descend(key, [this](const Key& node, const K& target) {
+              return compare_(target, node) == false;
+            })};
+  }
+
+  template <typename K>
+  const_iterator find(const K& key) const {
+    const_iterator it{lower_bound(key)};
+    if (it == end() || compare_(key, it.key())) {
+      return end();
+    }
+    return it;
+  }
+
+  template <typename K>
+  bool contains(const K& key) const {
+    if (size_ == 0) {
+      return false;
+    }
+    size_type slot{lower_bound(key).slot_};
+    // Reads the root instead of slot 0 on a miss, so nothing branches on
+    // whether the key was found
+    bool found{compare_(key, keys_[std::max<size_type>(slot, 1)]) == false};
+    return (slot != 0) & found;
+  }
+
+  template <typename K>
+  std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+    const_iterator first{lower_bound(key)};
+    if (first == end() || compare_(key, first.key())) {
+      return {first, first};
+    }
+    return {first, std::next(first)};
+  }
+
+ private:
+  // Keys per cache line. Slot k * kKeysPerLine is the leftmost of the
+  // descendants of k that many levels down, and its line holds the rest.
+  static constexpr size_type kKeysPerLine{
+      std::max<size_type>(1, CacheAlignedArray<Key>::kAlignment / sizeof(Key))};
+
+  // Reads the key or mapped half of the collected pairs for a map
+  struct KeyView {
+    size_type size() const { return sorted_.size(); }
+    Key& operator[](size_type i) { return sorted_[i].first; }
+    std::vector<sorted_type>& sorted_;
+  };
+  struct MappedView {
+    size_type size() const { return sorted_.size(); }
+    stored_mapped& operator[](size_type i) { return sorted_[i].second; }
+    std::vector<sorted_type>& sorted_;
+  };
+
+  static const Key& KeyOf(const sorted_type& value) {
+    if constexpr (kIsMap) {
+      return value.first;
+    } else {
+      return value;
+    }
+  }
+
+  static size_type CountTrailingOnes(size_type slot) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_type>(__builtin_ctzll(~std::uint64_t{slot}));
+#else
+    size_type ones{0};
+    for (; slot & 1; slot >>= 1) ++ones;
+    return ones;
+#endif
+  }
+
+  // Walks down turning right where go_right(node, key) says so, then
+  // backs up to the last node where the walk turned left: the first key
+  // go_right rejects, or 0 when there is none. The prefetch is clamped to
+  // the array, past the bottom levels there is nothing left to fetch.
+  template <typename K, typename GoRight>
+  size_type Descend(const K& key, GoRight go_right) const {
+    const Key* keys{keys_.data()};
+    size_type slot{1};
+    while (slot <= size_) {
+      Prefetch(keys + std::min(slot * kKeysPerLine, size_));
+      slot = 2 * slot + static_cast<size_type>(go_right(keys[slot], key));
+    }
+    return slot >> (CountTrailingOnes(slot) + 1);
+  }
+
+  size_type First() const {
+    if (size_ == 0) {
+      return 0;
+    }
+    size_type slot{1};
+    while (2 * slot <= size_) slot = 2 * slot;
+    return slot;
+  }
+
+  size_type Last() const {
+    if (size_ == 0) {
+      return 0;
+    }
+    size_type slot{1};
+    while (2 * slot + 1 <= size_) slot = 2 * slot + 1;
+    return slot;
+  }
+
+  // In-order successor: leftmost node of the right subtree, or else the
+  // parent of the first ancestor that is a left child. 0 after the last.
+  size_type Next(size_type slot) const {
+    if (2 * slot + 1 <= size_) {
+      slot = 2 * slot + 1;
+      while (2 * slot <= size_) slot = 2 * slot;
+      return slot;
+    }
+    return slot >> (CountTrailingOnes(slot) + 1);
+  }
+
+  // Mirror image of Next, and Last() from end()
+  size_type Previous(size_type slot) const {
+    if (slot == 0) {
+      return Last();
+    }
+    if (2 * slot <= size_) {
+      slot = 2 * slot;
+      while (2 * slot + 1 <= size_) slot = 2 * slot + 1;
+      return slot;
+    }
+    while ((slot & 1) == 0) slot >>= 1;
+    return slot >> 1;
+  }
+
+  Compare compare_;
+  CacheAlignedArray<Key> keys_;
+  CacheAlignedArray<stored_mapped> values_;
+  size_type size_{0};
+};
+
+#pragma GCC diagnostic pop
+
+}  // namespace s21
+
+#endif  // S21_FROZEN_TREE_H
@@ -0,0 +1,765 @@
+#ifndef S21_HASH_TABLE_H
+#define S21_HASH_TABLE_H
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace s21 {
+
+namespace hash_table_detail {
+
+// One control byte per slot: the 7 low bits of the hash for a full slot,
+// or one of the negative markers below, so that a single sign bit tells
+// full from free
+using ctrl_t = std::int8_t;
+constexpr ctrl_t kEmpty{-128};
+constexpr ctrl_t kDeleted{-2};
+
+inline bool IsFull(ctrl_t ctrl) { return ctrl >= 0; }
+
+inline std::size_t CountTrailingZeros(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<std::size_t>(__builtin_ctzll(word));
+#else
+  std::size_t zeros{0};
+  for (; (word & 1) == 0; word >>= 1) ++zeros;
+  return zeros;
+#endif
+}
+
+inline std::size_t CountLeadingZeros(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<std::size_t>(__builtin_clzll(word));
+#else
+  std::size_t zeros{0};
+  for (; (word >> 63) == 0; word <<= 1) ++zeros;
+  return zeros;
+#endif
+}
+
+// Set of slot offsets within a group, each one kBitsPerSlot bits wide in
+// word, with only the top bit of a slot ever set. Range-for walks the
+// offsets from the lowest up.
+template <std::size_t kWidth, std::size_t kBitsPerSlot>
+class BitMask {
+ public:
+  explicit BitMask(std::uint64_t word) : word_{word} {}
+
+  explicit operator bool() const { return word_ != 0; }
+
+  std::size_t operator*() const { return LowestBitSet(); }
+  BitMask& operator++() {
+    word_ &= word_ - 1;
+    return *this;
+  }
+  bool operator!=(const BitMask& other) const { return word_ != other.word_; }
+
+  BitMask begin() const { return *this; }
+  BitMask end() const { return BitMask{0}; }
+
+  std::size_t LowestBitSet() const {
+    return CountTrailingZeros(word_) / kBitsPerSlot;
+  }
+
+  // Free slots at the start of the group
+  std::size_t TrailingZeros() const {
+    return word_ == 0 ? kWidth : LowestBitSet();
+  }
+
+  // Free slots at the end of the group
+  std::size_t LeadingZeros() const {
+    if (word_ == 0) {
+      return kWidth;
+    }
+    constexpr std::size_t kUnusedBits{64 - kWidth * kBitsPerSlot};
+    return (CountLeadingZeros(word_) - kUnusedBits) / kBitsPerSlot;
+  }
+
+ private:
+  std::uint64_t word_;
+};
+
+#if defined(__SSE2__)
+
+// Sixteen control bytes matched with one SSE2 compare each
+class Group {
+ public:
+  static constexpr std::size_t kWidth{16};
+  using Mask = BitMask<kWidth, 1>;
+
+  explicit Group(const ctrl_t* position)
+      : ctrl_{_mm_loadu_si128(reinterpret_cast<const __m128i*>(position))} {}
+
+  Mask Match(ctrl_t h2) const { return MaskOf(_mm_set1_epi8(h2)); }
+  Mask MaskEmpty() const { return MaskOf(_mm_set1_epi8(kEmpty)); }
+  // Free slots are exactly the ones with the sign bit set
+  Mask MaskEmptyOrDeleted() const {
+    return Mask{static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl_))};
+  }
+
+ private:
+  Mask MaskOf(__m128i pattern) const {
+    return Mask{static_cast<std::uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(pattern, ctrl_)))};
+  }
+
+  __m128i ctrl_;
+};
+
+#else
+
+// Eight control bytes in one word, matched with plain integer arithmetic
+class Group {
+ public:
+  static constexpr std::size_t kWidth{8};
+  using Mask = BitMask<kWidth, 8>;
+
+  explicit Group(const ctrl_t* position) : ctrl_{0} {
+    // Compilers fold this into one load on little-endian targets
+    for (std::size_t i{0}; i < kWidth; ++i) {
+      ctrl_ |= std::uint64_t{static_cast<std::uint8_t>(position[i])}
+               << (8 * i);
+    }
+  }
+
+  // May also report a full slot right above a real match, which the key
+  // comparison that follows every match throws out
+  Mask Match(ctrl_t h2) const {
+    std::uint64_t diff{ctrl_ ^ (kLsbs * static_cast<std::uint8_t>(h2))};
+    return Mask{(diff - kLsbs) & ~diff & kMsbs};
+  }
+  // kEmpty is the one marker with bit 1 clear
+  Mask MaskEmpty() const { return Mask{ctrl_ & ~(ctrl_ << 6) & kMsbs}; }
+  Mask MaskEmptyOrDeleted() const { return Mask{ctrl_ & kMsbs}; }
+
+ private:
+  static constexpr std::uint64_t kLsbs{0x0101010101010101ull};
+  static constexpr std::uint64_t kMsbs{0x8080808080808080ull};
+
+  std::uint64_t ctrl_;
+};
+
+#endif
+
+}  // namespace hash_table_detail
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Open-addressing hash table behind unordered_map and unordered_set, laid
+// out the Swiss-table way. Elements sit in one flat array of slots, and a
+// parallel array holds a control byte per slot. A lookup splits the hash
+// in two: the high bits pick the group of slots to start probing at, the
+// low 7 bits are matched against a whole group of control bytes at once,
+// so keys are only compared for slots whose bytes match. Probing moves
+// on by a growing number of groups until a group with an empty slot.
+//
+// The first Group::kWidth control bytes are mirrored after the last one,
+// so a group read at any slot wraps around without a bounds check.
+// Capacity is a power of two no smaller than a group, and the table
+// grows once it is 7/8 full, counting erased slots that were left as
+// tombstones. Erase leaves one only when some probe may have passed the
+// slot, which needs a full group around it; otherwise the slot is simply
+// empty again.
+//
+// Any insert may rehash, which invalidates all iterators. Erase
+// invalidates only the iterators to the erased element.
+template <typename Key, typename T = void, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>,
+          typename Allocator = std::allocator<std::conditional_t<
+              std::is_void_v<T>, Key, std::pair<const Key, T>>>>
+class HashTable {
+  using ctrl_t = hash_table_detail::ctrl_t;
+  using Group = hash_table_detail::Group;
+  static constexpr bool kIsMap{!std::is_void_v<T>};
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type =
+      std::conditional_t<kIsMap, std::pair<const Key, T>, Key>;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using allocator_type = Allocator;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  template <bool IsConst>
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = HashTable::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer =
+        std::conditional_t<IsConst, const value_type*, value_type*>;
+    using reference =
+        std::conditional_t<IsConst, const value_type&, value_type&>;
+
+    Iterator() = default;
+
+    // iterator converts to const_iterator, not the other way around
+    template <bool OtherConst,
+              typename = std::enable_if_t<IsConst && !OtherConst>>
+    Iterator(const Iterator<OtherConst>& other)
+        : ctrl_{other.ctrl_}, slot_{other.slot_}, end_{other.end_} {}
+
+    reference operator*() const { return *slot_; }
+    pointer operator->() const { return slot_; }
+
+    Iterator& operator++() {
+      ++ctrl_;
+      ++slot_;
+      SkipFree();
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator old{*this};
+      ++*this;
+      return old;
+    }
+
+    bool operator==(const Iterator& other) const {
+      return ctrl_ == other.ctrl_;
+    }
+    bool operator!=(const Iterator& other) const {
+      return ctrl_ != other.ctrl_;
+    }
+
+   private:
+    friend class HashTable;
+    template <bool>
+    friend class Iterator;
+
+    Iterator(const ctrl_t* ctrl, pointer slot, const ctrl_t* end)
+        : ctrl_{ctrl}, slot_{slot}, end_{end} {
+      SkipFree();
+    }
+
+    void SkipFree() {
+      while (ctrl_ != end_ && hash_table_detail::IsFull(*ctrl_) == false) {
+        ++ctrl_;
+        ++slot_;
+      }
+    }
+
+    const ctrl_t* ctrl_{nullptr};
+    pointer slot_{nullptr};
+    const ctrl_t* end_{nullptr};
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  HashTable() : HashTable(0) {}
+
+  explicit HashTable(size_type bucket_count, const Hash& hash = Hash(),
+                     const KeyEqual& equal = KeyEqual(),
+                     const allocator_type& alloc = allocator_type())
+      : hash_{hash}, equal_{equal}, alloc_{alloc} {
+    rehash(bucket_count);
+  }
+
+  explicit HashTable(const allocator_type& alloc)
+      : HashTable(0, Hash(), KeyEqual(), alloc) {}
+
+  HashTable(const HashTable& other)
+      : HashTable(other, alloc_traits::select_on_container_copy_construction(
+                             other.alloc_)) {}
+
+  HashTable(const HashTable& other, const allocator_type& alloc)
+      : HashTable(0, other.hash_, other.equal_, alloc) {
+    reserve(other.size_);
+    for (const value_type& value : other) {
+      ConstructAt(PrepareInsert(HashOf(KeyOf(value))), value);
+    }
+  }
+
+  HashTable(HashTable&& other) noexcept
+      : hash_{std::move(other.hash_)},
+        equal_{std::move(other.equal_)},
+        alloc_{std::move(other.alloc_)},
+        ctrl_{std::exchange(other.ctrl_, nullptr)},
+        slots_{std::exchange(other.slots_, nullptr)},
+        capacity_{std::exchange(other.capacity_, 0)},
+        size_{std::exchange(other.size_, 0)},
+        growth_left_{std::exchange(other.growth_left_, 0)} {}
+
+  ~HashTable() { Release(); }
+
+  HashTable& operator=(const HashTable& other) {
+    if (this != &other) {
+      HashTable copy{other, alloc_};
+      Release();
+      StealFrom(copy);
+    }
+    return *this;
+  }
+
+  // Elements are moved one by one only when the allocators differ and
+  // the target keeps its own
+  HashTable& operator=(HashTable&& other) noexcept(
+      alloc_traits::propagate_on_container_move_assignment::value ||
+      alloc_traits::is_always_equal::value) {
+    if (this == &other) {
+      return *this;
+    }
+    Release();
+    if constexpr (alloc_traits::propagate_on_container_move_assignment::
+                      value) {
+      alloc_ = std::move(other.alloc_);
+    }
+    hash_ = std::move(other.hash_);
+    equal_ = std::move(other.equal_);
+    if (alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_ == other.alloc_) {
+      StealFrom(other);
+    } else {
+      reserve(other.size_);
+      for (value_type& value : other) {
+        ConstructAt(PrepareInsert(HashOf(KeyOf(value))), std::move(value));
+      }
+      other.clear();
+    }
+    return *this;
+  }
+
+  allocator_type get_allocator() const { return alloc_; }
+  hasher hash_function() const { return hash_; }
+  key_equal key_eq() const { return equal_; }
+
+  iterator begin() { return {ctrl_, slots_, ctrl_ + capacity_}; }
+  iterator end() { return IteratorAt(capacity_); }
+  const_iterator begin() const {
+    return {ctrl_, slots_, ctrl_ + capacity_};
+  }
+  const_iterator end() const {
+    return {ctrl_ + capacity_, slots_ + capacity_, ctrl_ + capacity_};
+  }
+
+  bool empty() const { return size_ == 0; }
+  size_type size() const { return size_; }
+  size_type capacity() const { return capacity_; }
+
+  // Destroys the elements but keeps the slots for reuse
+  void clear() {
+    Destroy(ctrl_, slots_, size_);
+    if (capacity_ != 0) {
+      std::fill(ctrl_, ctrl_ + capacity_ + Group::kWidth,
+                hash_table_detail::kEmpty);
+    }
+    size_ = 0;
+    growth_left_ = MaxLoad(capacity_);
+  }
+
+  template <typename Value>
+  std::pair<iterator, bool> insert_unique(Value&& value) {
+    auto [index, inserted] = FindOrPrepareInsert(KeyOf(value));
+    if (inserted) {
+      ConstructAt(index, std::forward<Value>(value));
+    }
+    return {IteratorAt(index), inserted};
+  }
+
+  // The element is built first to learn its key, and moved into its slot
+  // when the key is new
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_unique(Args&&... args) {
+    value_type value(std::forward<Args>(args)...);
+    return insert_unique(std::move(value));
+  }
+
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+    auto [index, inserted] = FindOrPrepareInsert(key);
+    if (inserted) {
+      ConstructAt(index, std::piecewise_construct,
+                  std::forward_as_tuple(std::forward<K>(key)),
+                  std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+    return {IteratorAt(index), inserted};
+  }
+
+  iterator erase(const_iterator pos) {
+    size_type index{IndexOf(pos)};
+    EraseAt(index);
+    return {ctrl_ + index + 1, slots_ + index + 1, ctrl_ + capacity_};
+  }
+
+  size_type erase(const key_type& key) {
+    size_type index{FindIndex(key, HashOf(key))};
+    if (index == capacity_) {
+      return 0;
+    }
+    EraseAt(index);
+    return 1;
+  }
+
+  void swap(HashTable& other) noexcept {
+    using std::swap;
+    swap(hash_, other.hash_);
+    swap(equal_, other.equal_);
+    if constexpr (alloc_traits::propagate_on_container_swap::value) {
+      swap(alloc_, other.alloc_);
+    }
+    swap(ctrl_, other.ctrl_);
+    swap(slots_, other.slots_);
+    swap(capacity_, other.capacity_);
+    swap(size_, other.size_);
+    swap(growth_left_, other.growth_left_);
+  }
+
+  // Moves over the elements of other whose keys are new here. Other
+  // always ends up empty.
+  void merge_unique(HashTable& other) {
+    if (this == &other) {
+      return;
+    }
+    for (value_type& value : other) {
+      auto [index, inserted] = FindOrPrepareInsert(KeyOf(value));
+      if (inserted) {
+        ConstructAt(index, std::move(value));
+      }
+    }
+    other.clear();
+  }
+
+  template <typename K>
+  iterator find(const K& key) {
+    return IteratorAt(FindIndex(key, HashOf(key)));
+  }
+
+  template <typename K>
+  const_iterator find(const K& key) const {
+    return const_cast<HashTable*>(this)->find(key);
+  }
+
+  template <typename K>
+  bool contains(const K& key) const {
+    return FindIndex(key, HashOf(key)) != capacity_;
+  }
+
+  // Makes room for count elements without another rehash
+  void reserve(size_type count) {
+    size_type capacity{CapacityFor(count)};
+    if (capacity > capacity_) {
+      Resize(capacity);
+    }
+  }
+
+  // Rebuilds the table with at least bucket_count slots, or the fewest
+  // the elements fit in, dropping all tombstones. rehash(0) shrinks the
+  // table to fit.
+  void rehash(size_type bucket_count) {
+    size_type capacity{
+        std::max(CapacityFor(size_), NextPowerOfTwo(bucket_count))};
+    if (capacity != capacity_ || growth_left_ != MaxLoad(capacity_) - size_) {
+      Resize(capacity);
+    }
+  }
+
+  static constexpr double max_load_factor() {
+    return static_cast<double>(kMaxLoadNumerator) / kMaxLoadDenominator;
+  }
+
+ private:
+  using alloc_traits = std::allocator_traits<allocator_type>;
+  using pointer = typename alloc_traits::pointer;
+  using ctrl_allocator = typename alloc_traits::template rebind_alloc<ctrl_t>;
+  using ctrl_traits = std::allocator_traits<ctrl_allocator>;
+
+  static constexpr size_type kMaxLoadNumerator{7};
+  static constexpr size_type kMaxLoadDenominator{8};
+  static constexpr size_type kProbeOn{static_cast<size_type>(-1)};
+
+  static const Key& KeyOf(const value_type& value) {
+    if constexpr (kIsMap) {
+      return value.first;
+    } else {
+      return value;
+    }
+  }
+
+  // Hashes of integers are often the integers themselves, so the bits
+  // are spread before they pick a group and a control byte
+  template <typename K>
+  size_type HashOf(const K& key) const {
+    std::uint64_t mixed{static_cast<std::uint64_t>(hash_(key)) *
+                        0x9E3779B97F4A7C15ull};
+    return static_cast<size_type>(mixed ^ (mixed >> 32));
+  }
+
+  static size_type H1(size_type hash) { return hash >> 7; }
+  static ctrl_t H2(size_type hash) { return static_cast<ctrl_t>(hash & 0x7F); }
+
+  static size_type MaxLoad(size_type capacity) {
+    return capacity / kMaxLoadDenominator * kMaxLoadNumerator;
+  }
+
+  static size_type NextPowerOfTwo(size_type count) {
+    if (count == 0) {
+      return 0;
+    }
+    size_type capacity{Group::kWidth};
+    while (capacity < count) capacity *= 2;
+    return capacity;
+  }
+
+  // Smallest capacity that holds count elements under the load limit
+  static size_type CapacityFor(size_type count) {
+    if (count == 0) {
+      return 0;
+    }
+    size_type capacity{Group::kWidth};
+    while (MaxLoad(capacity) < count) capacity *= 2;
+    return capacity;
+  }
+
+  // Offers visit the groups a key with this hash probes, in order, until
+  // it returns something other than kProbeOn. Each step skips one more
+  // group than the last, which over a power of two capacity reaches
+  // every group.
+  template <typename Visit>
+  size_type Probe(size_type hash, Visit visit) const {
+    size_type mask{capacity_ - 1};
+    size_type position{H1(hash) & mask};
+    for (size_type step{Group::kWidth};; step += Group::kWidth) {
+      size_type result{visit(Group{ctrl_ + position}, position)};
+      if (result != kProbeOn) {
+        return result;
+      }
+      position = (position + step) & mask;
+    }
+  }
+
+  // Slot holding key, or capacity_ when there is none
+  template <typename K>
+  size_type FindIndex(const K& key, size_type hash) const {
+    if (capacity_ == 0) {
+      return 0;
+    }
+    size_type mask{capacity_ - 1};
+    return Probe(hash, [&](const Group& group, size_type position) {
+      for (size_type offset : group.Match(H2(hash))) {
+        size_type index{(position + offset) & mask};
+        if (equal_(KeyOf(slots_[index]), key)) {
+          return index;
+        }
+      }
+      // An empty slot ends the probe, the key would have gone there
+      return group.MaskEmpty() ? capacity_ : kProbeOn;
+    });
+  }
+
+  size_type FindFirstNonFull(size_type hash) const {
+    size_type mask{capacity_ - 1};
+    return Probe(hash, [&](const Group& group, size_type position) {
+      auto free = group.MaskEmptyOrDeleted();
+      return free ? (position + free.LowestBitSet()) & mask : kProbeOn;
+    });
+  }
+
+  template <typename K>
+  std::pair<size_type, bool> FindOrPrepareInsert(const K& key) {
+    size_type hash{HashOf(key)};
+    size_type index{FindIndex(key, hash)};
+    if (index != capacity_) {
+      return {index, false};
+    }
+    return {PrepareInsert(hash), true};
+  }
+
+  // Claims a free slot for a new element with this hash, growing the
+  // table when it is out of room. A tombstone can always be reused.
+  size_type PrepareInsert(size_type hash) {
+    if (capacity_ == 0) {
+      Resize(Group::kWidth);
+    }
+    size_type index{FindFirstNonFull(hash)};
+    if (growth_left_ == 0 && ctrl_[index] != hash_table_detail::kDeleted) {
+      Grow();
+      index = FindFirstNonFull(hash);
+    }
+    growth_left_ -= ctrl_[index] == hash_table_detail::kEmpty;
+    SetCtrl(index, H2(hash));
+    ++size_;
+    return index;
+  }
+
+  // Out of room: rebuilt at the same size when tombstones take up much of
+  // it, doubled otherwise
+  void Grow() {
+    bool mostly_tombstones{size_ * 32 <= capacity_ * 25};
+    Resize(mostly_tombstones ? capacity_ : capacity_ * 2);
+  }
+
+  // Builds the element in a slot PrepareInsert claimed, giving the slot
+  // back if that throws
+  template <typename... Args>
+  void ConstructAt(size_type index, Args&&... args) {
+    try {
+      alloc_traits::construct(alloc_, std::addressof(slots_[index]),
+                              std::forward<Args>(args)...);
+    } catch (...) {
+      Free(index);
+      throw;
+    }
+  }
+
+  void EraseAt(size_type index) {
+    alloc_traits::destroy(alloc_, std::addressof(slots_[index]));
+    Free(index);
+  }
+
+  // Marks the slot empty when every group it lies in has an empty slot
+  // too, for then no probe ever went past it, and as a tombstone otherwise
+  void Free(size_type index) {
+    --size_;
+    size_type before{(index - Group::kWidth) & (capacity_ - 1)};
+    auto empty_before = Group{ctrl_ + before}.MaskEmpty();
+    auto empty_after = Group{ctrl_ + index}.MaskEmpty();
+    bool never_full{empty_before && empty_after &&
+                    empty_after.TrailingZeros() +
+                            empty_before.LeadingZeros() <
+                        Group::kWidth};
+    SetCtrl(index, never_full ? hash_table_detail::kEmpty
+                              : hash_table_detail::kDeleted);
+    growth_left_ += never_full;
+  }
+
+  // Writes the byte and, for the first group, its mirror past the end. For
+  // the other slots both stores land on the same byte.
+  void SetCtrl(size_type index, ctrl_t ctrl) {
+    ctrl_[index] = ctrl;
+    ctrl_[((index - Group::kWidth) & (capacity_ - 1)) + Group::kWidth] = ctrl;
+  }
+
+  // Moves every element into a fresh table of capacity slots. Elements
+  // that may throw on move are copied, so if anything throws the old
+  // table is left as it was.
+  void Resize(size_type capacity) {
+    ctrl_t* old_ctrl{ctrl_};
+    pointer old_slots{slots_};
+    size_type old_capacity{capacity_};
+    std::tie(ctrl_, slots_) = Allocate(capacity);
+    capacity_ = capacity;
+    size_type moved{0};
+    try {
+      for (size_type i{0}; moved != size_; ++i) {
+        if (hash_table_detail::IsFull(old_ctrl[i])) {
+          size_type hash{HashOf(KeyOf(old_slots[i]))};
+          size_type index{FindFirstNonFull(hash)};
+          alloc_traits::construct(alloc_, std::addressof(slots_[index]),
+                                  std::move_if_noexcept(old_slots[i]));
+          SetCtrl(index, H2(hash));
+          ++moved;
+        }
+      }
+    } catch (...) {
+      Destroy(ctrl_, slots_, moved);
+      Deallocate(ctrl_, slots_, capacity_);
+      ctrl_ = old_ctrl;
+      slots_ = old_slots;
+      capacity_ = old_capacity;
+      throw;
+    }
+    Destroy(old_ctrl, old_slots, size_);
+    Deallocate(old_ctrl, old_slots, old_capacity);
+    growth_left_ = MaxLoad(capacity_) - size_;
+  }
+
+  // Empty arrays of capacity slots, or nulls for no slots
+  std::pair<ctrl_t*, pointer> Allocate(size_type capacity) {
+    if (capacity == 0) {
+      return {nullptr, nullptr};
+    }
+    ctrl_allocator ctrl_alloc{alloc_};
+    ctrl_t* ctrl{ctrl_traits::allocate(ctrl_alloc, capacity + Group::kWidth)};
+    pointer slots{nullptr};
+    try {
+      slots = alloc_traits::allocate(alloc_, capacity);
+    } catch (...) {
+      ctrl_traits::deallocate(ctrl_alloc, ctrl, capacity + Group::kWidth);
+      throw;
+    }
+    std::fill(ctrl, ctrl + capacity + Group::kWidth,
+              hash_table_detail::kEmpty);
+    return {ctrl, slots};
+  }
+
+  void Deallocate(ctrl_t* ctrl, pointer slots, size_type capacity) {
+    if (capacity == 0) {
+      return;
+    }
+    ctrl_allocator ctrl_alloc{alloc_};
+    ctrl_traits::deallocate(ctrl_alloc, ctrl, capacity + Group::kWidth);
+    alloc_traits::deallocate(alloc_, slots, capacity);
+  }
+
+  // Destroys the first count elements of the slots, leaving the control
+  // bytes as they are
+  void Destroy(const ctrl_t* ctrl, pointer slots, size_type count) {
+    if constexpr (std::is_trivially_destructible_v<value_type> == false) {
+      for (size_type i{0}; count != 0; ++i) {
+        if (hash_table_detail::IsFull(ctrl[i])) {
+          alloc_traits::destroy(alloc_, std::addressof(slots[i]));
+          --count;
+        }
+      }
+    }
+  }
+
+  void Release() {
+    Destroy(ctrl_, slots_, size_);
+    Deallocate(ctrl_, slots_, capacity_);
+    ctrl_ = nullptr;
+    slots_ = nullptr;
+    capacity_ = 0;
+    size_ = 0;
+    growth_left_ = 0;
+  }
+
+  void StealFrom(HashTable& other) {
+    ctrl_ = std::exchange(other.ctrl_, nullptr);
+    slots_ = std::exchange(other.slots_, nullptr);
+    capacity_ = std::exchange(other.capacity_, 0);
+    size_ = std::exchange(other.size_, 0);
+    growth_left_ = std::exchange(other.growth_left_, 0);
+  }
+
+  iterator IteratorAt(size_type index) {
+    return {ctrl_ + index, slots_ + index, ctrl_ + capacity_};
+  }
+
+  size_type IndexOf(const_iterator pos) const {
+    return static_cast<size_type>(pos.ctrl_ - ctrl_);
+  }
+
+  Hash hash_;
+  KeyEqual equal_;
+  allocator_type alloc_;
+  ctrl_t* ctrl_{nullptr};
+  pointer slots_{nullptr};
+  size_type capacity_{0};
+  size_type size_{0};
+  // Inserts left before the table has to grow, tombstones counting as
+  // taken
+  size_type growth_left_{0};
+};
+
+#pragma GCC diagnostic pop
+
+}  // namespace s21
+
+#endif  // S21_HASH_TABLE_H
@@ -0,0 +1,381 @@
+#ifndef S21_INTERVAL_MAP_H
+#define S21_INTERVAL_MAP_H
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+#include "s21_red_black_tree.h"
+
+namespace s21 {
+
+// Half-open [low, high). Two intervals overlap when each starts before the
+// other ends, so a window that ends at t and one that starts at t don't.
+// No point falls inside an interval with high <= low, so such an interval
+// can be stored but never turns up in a query.
+template <typename Point>
+struct interval {
+  Point low;
+  Point high;
+
+  bool operator==(const interval& other) const {
+    return low == other.low && high == other.high;
+  }
+
+  bool operator!=(const interval& other) const { return !(*this == other); }
+};
+
+// Largest high endpoint in the subtree, which lets a query skip every
+// subtree that ends before the query starts. Compare has to be default
+// constructible, since Update gets no tree to take it from.
+template <typename Point, typename Compare = std::less<Point>>
+struct MaxEndpoint {
+  struct NodeData {
+    Point max_high_{};
+  };
+
+  template <typename NodeType>
+  static void Update(NodeType* node) {
+    const Point* max_high{&node->GetKey().high};
+    for (const NodeType* child : {node->left_, node->right_}) {
+      if (child && Compare{}(*max_high, child->max_high_)) {
+        max_high = &child->max_high_;
+      }
+    }
+    node->max_high_ = *max_high;
+  }
+};
+
+namespace interval_map_detail {
+
+// Orders by low, then by high, so that equal lows stay apart
+template <typename Point, typename Compare>
+struct IntervalLess {
+  bool operator()(const interval<Point>& lhs,
+                  const interval<Point>& rhs) const {
+    Compare compare{};
+    if (compare(lhs.low, rhs.low)) {
+      return true;
+    }
+    return !compare(rhs.low, lhs.low) && compare(lhs.high, rhs.high);
+  }
+};
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Which stored intervals meet [low_, high_), or contain the point low_
+// when closed_. Since nodes are ordered by low, the walk stops at the
+// first node starting past the query; subtrees whose max_high_ is not past
+// low_ are skipped without being entered.
+template <typename Point, typename Compare>
+class Query {
+ public:
+  Query() = default;
+  Query(const Point& low, const Point& high, bool closed)
+      : low_{low}, high_{high}, closed_{closed} {}
+
+  // First match of the subtree in key order. The left subtree is searched
+  // first and may come up empty even when it reaches past low_, since the
+  // interval that does so can be empty or inverted. Past the first node
+  // that starts after the query nothing can match.
+  template <typename NodeType>
+  NodeType* First(NodeType* node) const {
+    while (node && EndsAfterLow(node->max_high_)) {
+      if (NodeType* match{First(node->left_)}) {
+        return match;
+      }
+      if (StartsBeforeHigh(node->GetKey().low) == false) {
+        return nullptr;
+      }
+      if (Meets(node->GetKey())) {
+        return node;
+      }
+      node = node->right_;
+    }
+    return nullptr;
+  }
+
+  // Next match after node in key order, found by climbing to the next
+  // ancestor that follows it and searching its right subtree in turn
+  template <typename NodeType>
+  NodeType* Next(NodeType* node) const {
+    if (NodeType* match{First(node->right_)}) {
+      return match;
+    }
+    for (NodeType* parent{node->GetParent()}; parent;
+         node = parent, parent = parent->GetParent()) {
+      if (node != parent->left_) {
+        continue;
+      }
+      if (StartsBeforeHigh(parent->GetKey().low) == false) {
+        return nullptr;
+      }
+      if (Meets(parent->GetKey())) {
+        return parent;
+      }
+      if (NodeType* match{First(parent->right_)}) {
+        return match;
+      }
+    }
+    return nullptr;
+  }
+
+ private:
+  bool EndsAfterLow(const Point& high) const { return Compare{}(low_, high); }
+
+  bool StartsBeforeHigh(const Point& low) const {
+    return closed_ ? !Compare{}(high_, low) : Compare{}(low, high_);
+  }
+
+  // Whether an interval that starts before high_ meets the query. One with
+  // high <= low holds no point, so it meets nothing.
+  bool Meets(const interval<Point>& key) const {
+    return EndsAfterLow(key.high) && Compare{}(key.low, key.high);
+  }
+
+  Point low_{};
+  Point high_{};
+  bool closed_{false};
+};
+
+// Forward iterator over the matches of a query, each step finds the next
+// match right when it is asked for
+template <typename NodeType, typename QueryType, bool is_const>
+class MatchIterator {
+  using node_type = std::conditional_t<is_const, const NodeType, NodeType>;
+  using tree_type = const RedBlackTreeBase<NodeType>;
+
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = typename NodeType::value_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = std::conditional_t<is_const, const value_type*, value_type*>;
+  using reference =
+      std::conditional_t<is_const, const value_type&, value_type&>;
+  using base_iterator = RedBlackTreeIterator<NodeType, is_const>;
+
+  MatchIterator() = default;
+  MatchIterator(const QueryType& query, tree_type* tree)
+      : current_{query.First(tree->get_root())}, tree_{tree}, query_{query} {}
+
+  reference operator*() const { return current_->data_; }
+  pointer operator->() const { return &current_->data_; }
+
+  MatchIterator& operator++() {
+    current_ = query_.Next(current_);
+    return *this;
+  }
+
+  MatchIterator operator++(int) {
+    MatchIterator temp{*this};
+    ++*this;
+    return temp;
+  }
+
+  // All end iterators compare equal, whatever query they came from
+  bool operator==(const MatchIterator& other) const {
+    return current_ == other.current_;
+  }
+
+  bool operator!=(const MatchIterator& other) const {
+    return current_ != other.current_;
+  }
+
+  // The same element as an ordinary iterator, from where plain in-order
+  // iteration can go on
+  base_iterator base() const { return base_iterator(current_, tree_); }
+
+ private:
+  node_type* current_{nullptr};
+  tree_type* tree_{nullptr};
+  QueryType query_{};
+};
+
+#pragma GCC diagnostic pop
+
+}  // namespace interval_map_detail
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Intervals with a payload each, kept in a red-black tree augmented with
+// MaxEndpoint. Equal intervals may repeat, as in a multimap. Overlap and
+// stabbing queries take O(log n) to the first match and then walk to each
+// further one, skipping subtrees that end too early. Points are compared
+// with a default constructed Compare, so it can't carry state.
+template <typename Point, typename T, typename Compare = std::less<Point>,
+          typename Allocator =
+              std::allocator<std::pair<const interval<Point>, T>>>
+class interval_map {
+  using key_less = interval_map_detail::IntervalLess<Point, Compare>;
+  using tree_type = RedBlackTree<interval<Point>, T, key_less, Allocator,
+                                 MaxEndpoint<Point, Compare>>;
+  using query_type = interval_map_detail::Query<Point, Compare>;
+  using node_type = typename tree_type::node_type;
+
+ public:
+  using key_type = interval<Point>;
+  using point_type = Point;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, T>;
+  using point_compare = Compare;
+  using allocator_type = Allocator;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using match_iterator =
+      interval_map_detail::MatchIterator<node_type, query_type, false>;
+  using const_match_iterator =
+      interval_map_detail::MatchIterator<node_type, query_type, true>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  interval_map() : tree_{} {}
+
+  explicit interval_map(const allocator_type& alloc) : tree_{alloc} {}
+
+  interval_map(std::initializer_list<value_type> const& items,
+               const allocator_type& alloc = allocator_type())
+      : tree_{alloc} {
+    tree_.assign_equal(items.begin(), items.end());
+  }
+
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  interval_map(InputIt first, InputIt last,
+               const allocator_type& alloc = allocator_type())
+      : tree_{alloc} {
+    tree_.assign_equal(first, last);
+  }
+
+  interval_map(const interval_map& other) = default;
+  interval_map(interval_map&& other) noexcept = default;
+  ~interval_map() = default;
+
+  interval_map& operator=(const interval_map& other) = default;
+  interval_map& operator=(interval_map&& other) = default;
+
+  allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+  point_compare point_comp() const { return point_compare(); }
+
+  iterator begin() { return tree_.begin(); }
+  iterator end() { return tree_.end(); }
+
+  const_iterator begin() const { return tree_.begin(); }
+  const_iterator end() const { return tree_.end(); }
+
+  bool empty() const { return tree_.empty(); }
+
+  size_type size() const { return tree_.size(); }
+
+  size_type max_size() const {
+    return std::numeric_limits<size_type>::max() / sizeof(node_type);
+  }
+
+  void clear() { tree_.clear(); }
+
+  iterator insert(const value_type& value) {
+    return iterator(tree_.insert(value).first, &tree_);
+  }
+
+  iterator insert(value_type&& value) {
+    return iterator(tree_.insert(std::move(value)).first, &tree_);
+  }
+
+  iterator insert(const Point& low, const Point& high, const T& value) {
+    return emplace(key_type{low, high}, value);
+  }
+
+  template <typename... Args>
+  iterator emplace(Args&&... args) {
+    return iterator(tree_.emplace(std::forward<Args>(args)...).first,
+                    &tree_);
+  }
+
+  iterator erase(iterator pos) { return tree_.erase(pos); }
+
+  // Returns the next match, so expired windows can be dropped while the
+  // query runs
+  match_iterator erase(match_iterator pos) {
+    match_iterator next{pos};
+    ++next;
+    tree_.erase(pos.base());
+    return next;
+  }
+
+  // Erases every copy of key
+  size_type erase(const key_type& key) { return tree_.erase(key); }
+
+  iterator find(const key_type& key) { return tree_.find(key); }
+  const_iterator find(const key_type& key) const { return tree_.find(key); }
+
+  bool contains(const key_type& key) const {
+    return tree_.FindNode(key) != nullptr;
+  }
+
+  // Stored intervals that meet [low, high), in key order. The first match
+  // is found here, the others as the range is walked. A query with
+  // high <= low holds no point, so it meets nothing.
+  TreeRange<match_iterator> overlapping(const Point& low, const Point& high) {
+    if (Compare{}(low, high) == false) {
+      return {{}, {}};
+    }
+    return {match_iterator(query_type{low, high, false}, &tree_), {}};
+  }
+
+  TreeRange<const_match_iterator> overlapping(const Point& low,
+                                              const Point& high) const {
+    if (Compare{}(low, high) == false) {
+      return {{}, {}};
+    }
+    return {const_match_iterator(query_type{low, high, false}, &tree_), {}};
+  }
+
+  // Stored intervals that contain point
+  TreeRange<match_iterator> stabbing(const Point& point) {
+    return {match_iterator(query_type{point, point, true}, &tree_), {}};
+  }
+
+  TreeRange<const_match_iterator> stabbing(const Point& point) const {
+    return {const_match_iterator(query_type{point, point, true}, &tree_),
+            {}};
+  }
+
+  bool overlaps(const Point& low, const Point& high) const {
+    return overlapping(low, high).empty() == false;
+  }
+
+  void swap(interval_map& other) noexcept { tree_.swap(other.tree_); }
+
+  bool operator==(const interval_map& other) const {
+    if (size() != other.size()) return false;
+    auto it1 = begin();
+    auto it2 = other.begin();
+    for (; it1 != end(); ++it1, ++it2) {
+      if (*it1 != *it2) return false;
+    }
+    return true;
+  }
+
+ private:
+  tree_type tree_;
+};
+
+#pragma GCC diagnostic pop
+
+namespace pmr {
+template <typename Point, typename T, typename Compare = std::less<Point>>
+using interval_map = s21::interval_map<
+    Point, T, Compare,
+    std::pmr::polymorphic_allocator<std::pair<const interval<Point>, T>>>;
+}  // namespace pmr
+
+}  // namespace s21
+
+#endif  // S21_INTERVAL_MAP_H
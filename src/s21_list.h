@@ -5,6 +5,8 @@
 #include <initializer_list>
 #include <iterator>
 #include <limits>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
 
 namespace s21 {
@@ -26,12 +28,10 @@ struct Node {
   ~Node() = default;
 };
 
-#pragma GCC diagnostic pop
-
 template <typename T, bool is_const>
 class ListIterator;
 
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>>
 class list {
  public:
   friend struct Node<T>;
@@ -39,6 +39,7 @@ class list {
   friend class ListIterator<T, true>;
 
   using value_type = T;
+  using allocator_type = Allocator;
   using reference = T&;
   using const_reference = const T&;
 
@@ -49,19 +50,24 @@ class list {
   using const_iterator = const ListIterator<T, true>;
   using size_type = std::size_t;
 
-  list()
-      : head_{nullptr},
+  list() : list(allocator_type()) {}
+
+  explicit list(const allocator_type& alloc)
+      : node_allocator_{alloc},
+        head_{nullptr},
         tail_{nullptr},
         size_{0},
-        end_sentinel_{new node_type()} {}
+        end_sentinel_{CreateNode()} {}
 
-  list(std::initializer_list<value_type> init)
-      : head_{nullptr},
+  list(std::initializer_list<value_type> init,
+       const allocator_type& alloc = allocator_type())
+      : node_allocator_{alloc},
+        head_{nullptr},
         tail_{nullptr},
         size_{0},
-        end_sentinel_{new node_type()} {
+        end_sentinel_{CreateNode()} {
     for (const T& value : init) {
-      node_type* new_node = new node_type(value);
+      node_type* new_node = CreateNode(value);
       if (!head_) {
         head_ = new_node;
         tail_ = new_node;
@@ -76,13 +82,14 @@ class list {
     end_sentinel_->pre_ = tail_;
   }
 
-  list(size_type n)
-      : head_{nullptr},
+  list(size_type n, const allocator_type& alloc = allocator_type())
+      : node_allocator_{alloc},
+        head_{nullptr},
         tail_{nullptr},
         size_{0},
-        end_sentinel_{new node_type()} {
+        end_sentinel_{CreateNode()} {
     for (size_type i{0}; i < n; i++) {
-      node_type* new_node = new node_type();
+      node_type* new_node = CreateNode();
       if (!head_) {
         head_ = new_node;
         tail_ = new_node;
@@ -101,17 +108,20 @@ class list {
   }
 
   list(const list& other)
-      : head_{nullptr},
+      : node_allocator_{node_traits::select_on_container_copy_construction(
+            other.node_allocator_)},
+        head_{nullptr},
         tail_{nullptr},
         size_{0},
-        end_sentinel_{new node_type()} {
+        end_sentinel_{CreateNode()} {
     for (const auto& item : other) {
       push_back(item);
     }
   }
 
   list(list&& other) noexcept
-      : head_{other.head_},
+      : node_allocator_{std::move(other.node_allocator_)},
+        head_{other.head_},
         tail_{other.tail_},
         size_{other.size_},
         end_sentinel_{other.end_sentinel_} {
@@ -121,11 +131,12 @@ class list {
     other.end_sentinel_ = nullptr;
   }
 
-  explicit list(size_type n, const value_type& value)
-      : head_{nullptr}, tail_{nullptr}, size_{0} {
-    end_sentinel_ = new node_type();
+  explicit list(size_type n, const value_type& value,
+                const allocator_type& alloc = allocator_type())
+      : node_allocator_{alloc}, head_{nullptr}, tail_{nullptr}, size_{0} {
+    end_sentinel_ = CreateNode();
     for (size_type i{0}; i < n; ++i) {
-      node_type* new_node = new node_type(value);
+      node_type* new_node = CreateNode(value);
       if (!head_) {
         head_ = new_node;
 
@@ -144,6 +155,12 @@ class list {
   list& operator=(const list& other) {
     if (this != &other) {
       clear();
+      if constexpr (node_traits::propagate_on_container_copy_assignment::
+                        value) {
+        DestroyNode(end_sentinel_);
+        node_allocator_ = other.node_allocator_;
+        end_sentinel_ = CreateNode();
+      }
       for (const auto& item : other) {
         push_back(item);
       }
@@ -151,10 +168,28 @@ class list {
     return *this;
   }
 
-  list& operator=(list&& other) noexcept {
+  list& operator=(list&& other) noexcept(
+      node_traits::propagate_on_container_move_assignment::value ||
+      node_traits::is_always_equal::value) {
     if (this != &other) {
       clear();
-      delete end_sentinel_;
+
+      if constexpr (node_traits::propagate_on_container_move_assignment::
+                        value == false) {
+        // Nodes from a foreign allocator can't be adopted, copy them over
+        if (node_allocator_ != other.node_allocator_) {
+          for (const auto& item : other) {
+            push_back(item);
+          }
+          other.clear();
+          return *this;
+        }
+      }
+      DestroyNode(end_sentinel_);
+      if constexpr (node_traits::propagate_on_container_move_assignment::
+                        value) {
+        node_allocator_ = std::move(other.node_allocator_);
+      }
 
       head_ = other.head_;
       tail_ = other.tail_;
@@ -171,11 +206,17 @@ class list {
 
   ~list() {
     clear();
-    delete end_sentinel_;
+    if (end_sentinel_) {
+      DestroyNode(end_sentinel_);
+    }
   };
 
+  allocator_type get_allocator() const {
+    return allocator_type(node_allocator_);
+  }
+
   iterator insert(iterator pos, const_reference value) {
-    node_type* new_node = new node_type(value);
+    node_type* new_node = CreateNode(value);
 
     if (pos.get_current() == end_sentinel_) {
       if (tail_ != nullptr) {
@@ -211,7 +252,7 @@ class list {
 
   template <typename... Args>
   iterator insert_many(const_iterator pos, Args&&... args) {
-    list<T> temp_list{std::forward<Args>(args)...};
+    list temp_list({std::forward<Args>(args)...}, get_allocator());
 
     if (temp_list.empty()) {
       return iterator(const_cast<node_type*>(pos.get_current()));
@@ -246,7 +287,7 @@ class list {
 
   template <typename... Args>
   void insert_many_back(Args&&... args) {
-    list<T> temp_list{std::forward<Args>(args)...};
+    list temp_list({std::forward<Args>(args)...}, get_allocator());
 
     if (temp_list.empty()) {
       return;
@@ -277,7 +318,7 @@ class list {
 
   template <typename... Args>
   void insert_many_front(Args&&... args) {
-    list<T> temp_list{std::forward<Args>(args)...};
+    list temp_list({std::forward<Args>(args)...}, get_allocator());
 
     if (temp_list.empty()) {
       return;
@@ -399,6 +440,9 @@ class list {
 
   void swap(list& other) noexcept {
     if (this != &other) {
+      if constexpr (node_traits::propagate_on_container_swap::value) {
+        std::swap(node_allocator_, other.node_allocator_);
+      }
       std::swap(head_, other.head_);
       std::swap(tail_, other.tail_);
       std::swap(size_, other.size_);
@@ -419,7 +463,7 @@ class list {
         next_node = next_node->next_;
         --size_;
 
-        delete duplicate_node;
+        DestroyNode(duplicate_node);
       }
 
       current->next_ = next_node;
@@ -463,7 +507,7 @@ class list {
       tail_ = node_to_delete->pre_;
     }
 
-    delete node_to_delete;
+    DestroyNode(node_to_delete);
     --size_;
   }
 
@@ -473,7 +517,7 @@ class list {
     }
 
     if (head_ == tail_) {
-      delete head_;
+      DestroyNode(head_);
       head_ = nullptr;
       tail_ = nullptr;
       --size_;
@@ -488,7 +532,7 @@ class list {
   }
 
   void push_front(const_reference value) {
-    node_type* new_node = new node_type(value);
+    node_type* new_node = CreateNode(value);
     if (empty()) {
       head_ = new_node;
       tail_ = new_node;
@@ -502,7 +546,7 @@ class list {
   }
 
   void push_back(const_reference value) {
-    node_type* new_node = new node_type(value);
+    node_type* new_node = CreateNode(value);
     if (empty()) {
       head_ = new_node;
       tail_ = new_node;
@@ -555,14 +599,14 @@ class list {
     }
 
     if (head_ == tail_) {
-      delete head_;
+      DestroyNode(head_);
       head_ = nullptr;
       tail_ = nullptr;
       --size_;
       return;
     }
     head_ = head_->next_;
-    delete head_->pre_;
+    DestroyNode(head_->pre_);
     head_->pre_ = nullptr;
   }
 
@@ -594,7 +638,7 @@ class list {
     while (current != nullptr) {
       node_type* next_node = current->next_;
       if (current != end_sentinel_) {  // Don't delete sentinel
-        delete current;
+        DestroyNode(current);
       }
       current = next_node;
     }
@@ -676,12 +720,35 @@ class list {
   }
 
  private:
+  using node_allocator_type = typename std::allocator_traits<
+      allocator_type>::template rebind_alloc<node_type>;
+  using node_traits = std::allocator_traits<node_allocator_type>;
+
+  node_allocator_type node_allocator_;
   node_type* head_{nullptr};
   node_type* tail_{nullptr};
   size_type size_{};
   node_type* end_sentinel_{nullptr};
 
  private:
+  template <typename... Args>
+  node_type* CreateNode(Args&&... args) {
+    node_type* node{node_traits::allocate(node_allocator_, 1)};
+    try {
+      node_traits::construct(node_allocator_, node,
+                             std::forward<Args>(args)...);
+    } catch (...) {
+      node_traits::deallocate(node_allocator_, node, 1);
+      throw;
+    }
+    return node;
+  }
+
+  void DestroyNode(node_type* node) {
+    node_traits::destroy(node_allocator_, node);
+    node_traits::deallocate(node_allocator_, node, 1);
+  }
+
   // Helper function to link nodes together safely
   void LinkNodes(node_type* prev, node_type* curr) {
     if (prev) {
@@ -769,6 +836,8 @@ class list {
   }
 };
 
+#pragma GCC diagnostic pop
+
 template <typename T, bool is_const>
 class ListIterator {
  public:
@@ -891,6 +960,11 @@ class ListIterator {
   node_pointer current_;
 };
 
+namespace pmr {
+template <typename T>
+using list = s21::list<T, std::pmr::polymorphic_allocator<T>>;
+}  // namespace pmr
+
 }  // namespace s21
 
 #endif  // S21_LIST_H
@@ -2,8 +2,11 @@
 #define S21_MAP_H
 
 #include <cstddef>
+#include <functional>
 #include <initializer_list>
 #include <limits>
+#include <memory>
+#include <memory_resource>
 #include <type_traits>
 #include <utility>
 
@@ -15,42 +18,89 @@ namespace s21 {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpadded"
 
-template <typename Key, typename T>
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, T>>>
 class map {
+  using tree_type = RedBlackTree<Key, T, Compare, Allocator>;
+
  public:
   using value_type = std::pair<const Key, T>;
   using key_type = Key;
   using mapped_type = T;
-  using node_type = Node<Key, T>;
-  using iterator = RedBlackTreeIterator<Key, false, T>;
-  using const_iterator = RedBlackTreeIterator<Key, true, T>;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+  using node_type = typename tree_type::node_type;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
   using size_type = std::size_t;
+  using node_handle = typename tree_type::node_handle;
+
+  struct insert_return_type {
+    iterator position;
+    bool inserted;
+    node_handle node;
+  };
 
   map() : tree_{} {}
 
-  map(std::initializer_list<value_type> const& items) : tree_{} {
-    for (const auto& item : items) {
-      insert(item);
-    }
+  explicit map(const Compare& compare,
+               const allocator_type& alloc = allocator_type())
+      : tree_{compare, alloc} {}
+
+  explicit map(const allocator_type& alloc) : tree_{alloc} {}
+
+  map(std::initializer_list<value_type> const& items,
+      const Compare& compare = Compare(),
+      const allocator_type& alloc = allocator_type())
+      : tree_{compare, alloc} {
+    tree_.assign_unique(items.begin(), items.end());
   }
 
-  map(const map& other) : tree_{} {
-    for (auto it = other.begin(); it != other.end(); ++it) {
-      insert(*it);
-    }
+  map(std::initializer_list<value_type> const& items,
+      const allocator_type& alloc)
+      : map(items, Compare(), alloc) {}
+
+  // O(n) when the range is sorted by key, O(n log n) otherwise
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  map(InputIt first, InputIt last, const Compare& compare = Compare(),
+      const allocator_type& alloc = allocator_type())
+      : tree_{compare, alloc} {
+    tree_.assign_unique(first, last);
   }
+
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  map(InputIt first, InputIt last, const allocator_type& alloc)
+      : map(first, last, Compare(), alloc) {}
+
+  // O(n), the tree is cloned node for node instead of re-inserted
+  map(const map& other) : tree_(other.tree_) {}
   map(map&& m) noexcept : tree_(std::move(m.tree_)) {}
 
   ~map() = default;
 
-  map& operator=(map&& other) noexcept {
+  // Reuses the nodes this map already has
+  map& operator=(const map& other) {
+    tree_ = other.tree_;
+    return *this;
+  }
+
+  map& operator=(map&& other) noexcept(
+      std::is_nothrow_move_assignable_v<tree_type>) {
     if (this != &other) {
       tree_ = std::move(other.tree_);
-      other.tree_ = RedBlackTree<key_type, mapped_type>();
     }
     return *this;
   }
 
+  allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+  key_compare key_comp() const { return tree_.key_comp(); }
+
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  void assign(InputIt first, InputIt last) {
+    tree_.assign_unique(first, last);
+  }
+
   mapped_type& at(const key_type& key) {
     auto node = tree_.FindNode(key);
     if (node == nullptr) {
@@ -59,15 +109,13 @@ class map {
     return node->data_.second;
   }
 
+  // A missing key gets a value-initialized mapped value built in place
   mapped_type& operator[](const key_type& key) {
-    auto it = tree_.FindNode(key);
-    if (it != nullptr) {
-      return it->data_.second;
-    }
+    return tree_.try_emplace(key).first->data_.second;
+  }
 
-    auto result = tree_.insert({key, mapped_type{}});
-    mapped_type& result_value = result.first->data_.second;
-    return result_value;
+  mapped_type& operator[](key_type&& key) {
+    return tree_.try_emplace(std::move(key)).first->data_.second;
   }
 
   iterator begin() { return tree_.begin(); }
@@ -88,59 +136,235 @@ class map {
   void clear() { tree_.clear(); }
 
   std::pair<iterator, bool> insert(const value_type& value) {
-    key_type key = value.first;
-    node_type* found{tree_.FindNode(key)};
-    if (found) {
-      return {iterator(found, &tree_), false};
-    } else {
-      auto result = tree_.insert(value);
-      return {iterator(result.first, &tree_), result.second};
-    }
+    return WrapResult(tree_.insert_unique(value));
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return WrapResult(tree_.insert_unique(std::move(value)));
+  }
+
+  // O(1) comparisons when value belongs right before hint, so appending
+  // keys in ascending order at end() skips the descent altogether
+  iterator insert(const_iterator hint, const value_type& value) {
+    return WrapResult(tree_.insert_unique(hint, value)).first;
+  }
+
+  iterator insert(const_iterator hint, value_type&& value) {
+    return WrapResult(tree_.insert_unique(hint, std::move(value))).first;
   }
 
   std::pair<iterator, bool> insert(const key_type& key, const T& obj) {
-    node_type* found{tree_.FindNode(key)};
-    if (found) {
-      return {iterator(found, &tree_), false};
-    } else {
-      value_type value{key, obj};
-      auto result = tree_.insert(value);
-      return {iterator(result.first, &tree_), result.second};
+    return WrapResult(tree_.try_emplace(key, obj));
+  }
+
+  std::pair<iterator, bool> insert(const key_type& key, T&& obj) {
+    return WrapResult(tree_.try_emplace(key, std::move(obj)));
+  }
+
+  // Builds the pair from args right inside the node. Prefer try_emplace
+  // when the key is at hand, it doesn't build anything for a taken key.
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return WrapResult(tree_.emplace_unique(std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    return WrapResult(
+               tree_.emplace_hint_unique(hint, std::forward<Args>(args)...))
+        .first;
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+    return WrapResult(tree_.try_emplace(key, std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+    return WrapResult(
+        tree_.try_emplace(std::move(key), std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  iterator try_emplace(const_iterator hint, const key_type& key,
+                       Args&&... args) {
+    return WrapResult(tree_.try_emplace_hint(hint, key,
+                                             std::forward<Args>(args)...))
+        .first;
+  }
+
+  template <typename... Args>
+  iterator try_emplace(const_iterator hint, key_type&& key, Args&&... args) {
+    return WrapResult(tree_.try_emplace_hint(hint, std::move(key),
+                                             std::forward<Args>(args)...))
+        .first;
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+    auto result = tree_.try_emplace(key, std::forward<M>(obj));
+    if (result.second == false) {
+      result.first->data_.second = std::forward<M>(obj);
+    }
+    return WrapResult(result);
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj) {
+    auto result = tree_.try_emplace(std::move(key), std::forward<M>(obj));
+    if (result.second == false) {
+      result.first->data_.second = std::forward<M>(obj);
     }
+    return WrapResult(result);
   }
 
   template <typename... Args>
   s21::vector<std::pair<node_type*, bool>> insert_many(Args&&... args) {
     s21::vector<std::pair<node_type*, bool>> results;
     for (const auto& value : {std::forward<Args>(args)...}) {
-      node_type* found{tree_.FindNode(value.first)};
-      if (found) {
-        continue;
-      } else {
-        auto result = tree_.insert(value);
-        std::pair<node_type*, bool> pair =
-            std::make_pair(result.first, result.second);
-        results.push_back(pair);
+      auto result = tree_.insert_unique(value);
+      if (result.second) {
+        results.push_back(result);
       }
     }
     return results;
   }
 
   iterator erase(iterator pos) { return tree_.erase(pos); }
-  void swap(map& other) noexcept { std::swap(tree_, other.tree_); }
-  void merge(map& other) {
-    for (auto it = other.begin(); it != other.end();) {
-      insert(*it);
-      it = other.erase(it);
-    }
+
+  // Erases [first, last) in one walk, see RedBlackTree::erase
+  iterator erase(const_iterator first, const_iterator last) {
+    return tree_.erase(first, last);
+  }
+
+  size_type erase(const key_type& key) { return tree_.erase(key); }
+  void swap(map& other) noexcept { tree_.swap(other.tree_); }
+  // Relinks other's nodes instead of copying them. Keys already present
+  // here are dropped from other, which always ends up empty.
+  void merge(map& other) { tree_.merge_unique(other.tree_); }
+
+  // The node is unlinked as is, no copy is made and nothing is freed
+  node_handle extract(const_iterator pos) { return tree_.extract(pos); }
+  node_handle extract(const key_type& key) { return tree_.extract(key); }
+
+  // Relinks the handle's node. If the key is taken, the node stays in the
+  // returned handle; an empty handle inserts nothing.
+  insert_return_type insert(node_handle&& handle) {
+    auto [position, inserted] = WrapResult(tree_.insert_handle_unique(handle));
+    return {position, inserted, std::move(handle)};
+  }
+
+  // Every lookup below also has a template overload taking any K, which
+  // exists only for transparent comparators and builds no key_type
+
+  iterator find(const key_type& key) { return tree_.find(key); }
+  const_iterator find(const key_type& key) const { return tree_.find(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator find(const K& key) {
+    return tree_.find(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  const_iterator find(const K& key) const {
+    return tree_.find(key);
+  }
+
+  bool contains(const key_type& key) const { return tree_.contains(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  bool contains(const K& key) const {
+    return tree_.contains(key);
+  }
+
+  // Looks up every key of [first, last) and writes, in the same order, an
+  // iterator to each element found or end() to out. Faster than find in a
+  // loop once the map outgrows the cache, see RedBlackTree::FindMany.
+  template <typename ForwardIt, typename OutputIt>
+  OutputIt find_many(ForwardIt first, ForwardIt last, OutputIt out) {
+    tree_.FindMany(first, last, [this, &out](node_type* node) {
+      *out++ = iterator(node, &tree_);
+    });
+    return out;
+  }
+
+  template <typename ForwardIt, typename OutputIt>
+  OutputIt find_many(ForwardIt first, ForwardIt last, OutputIt out) const {
+    tree_.FindMany(first, last, [this, &out](const node_type* node) {
+      *out++ = const_iterator(node, &tree_);
+    });
+    return out;
+  }
+
+  // Writes one bool per key of [first, last) to out, like find_many
+  template <typename ForwardIt, typename OutputIt>
+  OutputIt contains_many(ForwardIt first, ForwardIt last, OutputIt out) const {
+    tree_.FindMany(first, last,
+                   [&out](const node_type* node) { *out++ = node != nullptr; });
+    return out;
+  }
+
+  size_type count(const key_type& key) const { return contains(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  size_type count(const K& key) const {
+    return contains(key);
+  }
+
+  iterator lower_bound(const key_type& key) { return tree_.lower_bound(key); }
+  const_iterator lower_bound(const key_type& key) const {
+    return tree_.lower_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator lower_bound(const K& key) {
+    return tree_.lower_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  const_iterator lower_bound(const K& key) const {
+    return tree_.lower_bound(key);
   }
 
-  iterator find(const key_type& key) {
-    return iterator(tree_.FindNode(key), &tree_);
+  iterator upper_bound(const key_type& key) { return tree_.upper_bound(key); }
+  const_iterator upper_bound(const key_type& key) const {
+    return tree_.upper_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator upper_bound(const K& key) {
+    return tree_.upper_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  const_iterator upper_bound(const K& key) const {
+    return tree_.upper_bound(key);
   }
 
-  bool contains(const key_type& key) {
-    return iterator(tree_.FindNode(key), &tree_) != tree_.end();
+  std::pair<iterator, iterator> equal_range(const key_type& key) {
+    return tree_.equal_range(key);
+  }
+  std::pair<const_iterator, const_iterator> equal_range(
+      const key_type& key) const {
+    return tree_.equal_range(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  std::pair<iterator, iterator> equal_range(const K& key) {
+    return tree_.equal_range(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+    return tree_.equal_range(key);
+  }
+
+  // Lazy view of the elements with keys in [lo, hi)
+  TreeRange<iterator> range(const key_type& lo, const key_type& hi) {
+    return tree_.range(lo, hi);
+  }
+  TreeRange<const_iterator> range(const key_type& lo,
+                                  const key_type& hi) const {
+    return tree_.range(lo, hi);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  TreeRange<iterator> range(const K& lo, const K& hi) {
+    return tree_.range(lo, hi);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  TreeRange<const_iterator> range(const K& lo, const K& hi) const {
+    return tree_.range(lo, hi);
   }
 
   bool operator==(const map& other) const {
@@ -158,8 +382,54 @@ class map {
   }
 
  private:
-  RedBlackTree<Key, mapped_type> tree_;
+  template <typename K, typename U, typename C, typename A>
+  friend map<K, U, C, A> set_union(map<K, U, C, A> lhs, map<K, U, C, A> rhs);
+  template <typename K, typename U, typename C, typename A>
+  friend map<K, U, C, A> set_intersection(map<K, U, C, A> lhs,
+                                          map<K, U, C, A> rhs);
+  template <typename K, typename U, typename C, typename A>
+  friend map<K, U, C, A> set_difference(map<K, U, C, A> lhs,
+                                        map<K, U, C, A> rhs);
+
+  std::pair<iterator, bool> WrapResult(std::pair<node_type*, bool> result) {
+    return {iterator(result.first, &tree_), result.second};
+  }
+
+  tree_type tree_;
 };
+
+// Set algebra by split and join. The arguments are consumed, so hand them
+// over with std::move when they are no longer needed: then the work is
+// O(m log(n/m + 1)) for sizes m <= n, and large inputs are processed in
+// parallel. Lvalue arguments are copied first. A key in both keeps
+// the mapped value from lhs.
+template <typename Key, typename T, typename Compare, typename Allocator>
+map<Key, T, Compare, Allocator> set_union(map<Key, T, Compare, Allocator> lhs,
+                                          map<Key, T, Compare, Allocator> rhs) {
+  lhs.tree_.union_with(rhs.tree_);
+  return lhs;
+}
+
+template <typename Key, typename T, typename Compare, typename Allocator>
+map<Key, T, Compare, Allocator> set_intersection(
+    map<Key, T, Compare, Allocator> lhs, map<Key, T, Compare, Allocator> rhs) {
+  lhs.tree_.intersect_with(rhs.tree_);
+  return lhs;
+}
+
+template <typename Key, typename T, typename Compare, typename Allocator>
+map<Key, T, Compare, Allocator> set_difference(
+    map<Key, T, Compare, Allocator> lhs, map<Key, T, Compare, Allocator> rhs) {
+  lhs.tree_.subtract(rhs.tree_);
+  return lhs;
+}
+
+namespace pmr {
+template <typename Key, typename T, typename Compare = std::less<Key>>
+using map = s21::map<Key, T, Compare,
+                     std::pmr::polymorphic_allocator<std::pair<const Key, T>>>;
+}  // namespace pmr
+
 }  // namespace s21
 
 #endif  // S21_MAP_H
@@ -0,0 +1,401 @@
+#ifndef S21_MAPPED_MAP_H
+#define S21_MAPPED_MAP_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "s21_map.h"
+
+namespace s21 {
+
+// Layout of a frozen map file: this header, then count keys at
+// keys_offset and count values at values_offset, both sorted by key and
+// aligned for their types. Everything is stored in the byte order of the
+// machine that wrote it, which the reader checks.
+struct MappedMapHeader {
+  static constexpr char kMagic[8]{'S', '2', '1', 'M', 'M', 'A', 'P', '\0'};
+  static constexpr std::uint32_t kByteOrder{0x01020304};
+  static constexpr std::uint32_t kVersion{1};
+
+  char magic[8];
+  std::uint32_t byte_order;
+  std::uint32_t version;
+  std::uint32_t key_size;
+  std::uint32_t key_align;
+  std::uint32_t value_size;
+  std::uint32_t value_align;
+  std::uint64_t count;
+  std::uint64_t keys_offset;
+  std::uint64_t values_offset;
+};
+
+namespace mapped_map_detail {
+
+constexpr std::uint64_t AlignUp(std::uint64_t offset, std::uint64_t align) {
+  return (offset + align - 1) / align * align;
+}
+
+template <typename Key, typename T>
+MappedMapHeader MakeHeader(std::uint64_t count) {
+  MappedMapHeader header{};
+  std::memcpy(header.magic, MappedMapHeader::kMagic, sizeof(header.magic));
+  header.byte_order = MappedMapHeader::kByteOrder;
+  header.version = MappedMapHeader::kVersion;
+  header.key_size = sizeof(Key);
+  header.key_align = alignof(Key);
+  header.value_size = sizeof(T);
+  header.value_align = alignof(T);
+  header.count = count;
+  header.keys_offset = AlignUp(sizeof(MappedMapHeader), alignof(Key));
+  header.values_offset =
+      AlignUp(header.keys_offset + count * sizeof(Key), alignof(T));
+  return header;
+}
+
+inline void WritePadding(std::ofstream& out, std::uint64_t target) {
+  static constexpr char kZeros[64]{};
+  auto position{static_cast<std::uint64_t>(out.tellp())};
+  out.write(kZeros, static_cast<std::streamsize>(target - position));
+}
+
+}  // namespace mapped_map_detail
+
+// Writes source to path in the format mapped_map reads. The file is
+// written under a temporary name and renamed into place, so a process
+// opening path sees either the old file or the complete new one.
+template <typename Key, typename T, typename Compare, typename Allocator>
+void freeze(const map<Key, T, Compare, Allocator>& source,
+            const std::string& path) {
+  static_assert(std::is_trivially_copyable_v<Key> &&
+                    std::is_trivially_copyable_v<T>,
+                "only trivially copyable keys and values can be frozen");
+  MappedMapHeader header{
+      mapped_map_detail::MakeHeader<Key, T>(source.size())};
+  std::string temporary_path{path + ".tmp"};
+  {
+    std::ofstream out;
+    out.exceptions(std::ios::failbit | std::ios::badbit);
+    out.open(temporary_path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    mapped_map_detail::WritePadding(out, header.keys_offset);
+    for (const auto& [key, value] : source) {
+      out.write(reinterpret_cast<const char*>(&key), sizeof(Key));
+    }
+    mapped_map_detail::WritePadding(out, header.values_offset);
+    for (const auto& [key, value] : source) {
+      out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+  }
+  if (std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+    int error{errno};
+    std::remove(temporary_path.c_str());
+    throw std::system_error(error, std::generic_category(), "rename");
+  }
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Read-only map served straight from a file written by freeze(). The file
+// is mapped into memory and the sorted key and value arrays are used in
+// place, so opening costs the same for any size, and processes mapping
+// the same file share one copy of it in the page cache.
+//
+// Lookups are a binary search over the keys. Iterators walk both arrays
+// side by side and yield pair<const Key&, const T&> proxies, which
+// structured bindings take apart as usual. Compare must order keys the
+// way the map that was frozen did.
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class mapped_map {
+  static_assert(std::is_trivially_copyable_v<Key> &&
+                    std::is_trivially_copyable_v<T>,
+                "mapped_map holds trivially copyable keys and values only");
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const Key&, const T&>;
+  using key_compare = Compare;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  class const_iterator {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = mapped_map::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type;
+
+    // Holds the pair that operator-> points into
+    struct pointer {
+      const value_type* operator->() const { return &pair_; }
+      value_type pair_;
+    };
+
+    const_iterator() = default;
+
+    reference operator*() const { return {*key_, *value_}; }
+    pointer operator->() const { return pointer{**this}; }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    const_iterator& operator++() {
+      ++key_;
+      ++value_;
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator old{*this};
+      ++*this;
+      return old;
+    }
+
+    const_iterator& operator--() {
+      --key_;
+      --value_;
+      return *this;
+    }
+
+    const_iterator operator--(int) {
+      const_iterator old{*this};
+      --*this;
+      return old;
+    }
+
+    const_iterator& operator+=(difference_type n) {
+      key_ += n;
+      value_ += n;
+      return *this;
+    }
+
+    const_iterator& operator-=(difference_type n) { return *this += -n; }
+
+    friend const_iterator operator+(const_iterator it, difference_type n) {
+      return it += n;
+    }
+
+    friend const_iterator operator+(difference_type n, const_iterator it) {
+      return it += n;
+    }
+
+    friend const_iterator operator-(const_iterator it, difference_type n) {
+      return it -= n;
+    }
+
+    difference_type operator-(const const_iterator& other) const {
+      return key_ - other.key_;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return key_ == other.key_;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return key_ != other.key_;
+    }
+    bool operator<(const const_iterator& other) const {
+      return key_ < other.key_;
+    }
+    bool operator>(const const_iterator& other) const {
+      return key_ > other.key_;
+    }
+    bool operator<=(const const_iterator& other) const {
+      return key_ <= other.key_;
+    }
+    bool operator>=(const const_iterator& other) const {
+      return key_ >= other.key_;
+    }
+
+    const Key& key() const { return *key_; }
+    const T& value() const { return *value_; }
+
+   private:
+    friend class mapped_map;
+
+    const_iterator(const Key* key, const T* value)
+        : key_{key}, value_{value} {}
+
+    const Key* key_{nullptr};
+    const T* value_{nullptr};
+  };
+
+  using iterator = const_iterator;
+
+  // Maps the file at path. Throws std::system_error when it cannot be
+  // opened or mapped, and std::runtime_error when it is not a frozen map
+  // of this Key and T.
+  explicit mapped_map(const std::string& path,
+                      const Compare& compare = Compare())
+      : compare_{compare} {
+    int fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(), path);
+    }
+    struct stat status {};
+    if (::fstat(fd, &status) != 0) {
+      int error{errno};
+      ::close(fd);
+      throw std::system_error(error, std::generic_category(), path);
+    }
+    mapping_size_ = static_cast<size_type>(status.st_size);
+    if (mapping_size_ < sizeof(MappedMapHeader)) {
+      ::close(fd);
+      throw std::runtime_error(path + ": not a frozen map");
+    }
+    void* mapping{
+        ::mmap(nullptr, mapping_size_, PROT_READ, MAP_SHARED, fd, 0)};
+    int error{errno};
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+      throw std::system_error(error, std::generic_category(), path);
+    }
+    mapping_ = mapping;
+    try {
+      ReadHeader(path);
+    } catch (...) {
+      ::munmap(mapping_, mapping_size_);
+      throw;
+    }
+  }
+
+  mapped_map(const mapped_map&) = delete;
+  mapped_map& operator=(const mapped_map&) = delete;
+
+  mapped_map(mapped_map&& other) noexcept
+      : compare_{std::move(other.compare_)},
+        mapping_{std::exchange(other.mapping_, nullptr)},
+        mapping_size_{std::exchange(other.mapping_size_, 0)},
+        keys_{std::exchange(other.keys_, nullptr)},
+        values_{std::exchange(other.values_, nullptr)},
+        size_{std::exchange(other.size_, 0)} {}
+
+  mapped_map& operator=(mapped_map&& other) noexcept {
+    if (this != &other) {
+      Unmap();
+      compare_ = std::move(other.compare_);
+      mapping_ = std::exchange(other.mapping_, nullptr);
+      mapping_size_ = std::exchange(other.mapping_size_, 0);
+      keys_ = std::exchange(other.keys_, nullptr);
+      values_ = std::exchange(other.values_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+
+  ~mapped_map() { Unmap(); }
+
+  key_compare key_comp() const { return compare_; }
+
+  const_iterator begin() const { return {keys_, values_}; }
+  const_iterator end() const { return {keys_ + size_, values_ + size_}; }
+
+  bool empty() const { return size_ == 0; }
+  size_type size() const { return size_; }
+
+  const T& at(const key_type& key) const {
+    const_iterator it{find(key)};
+    if (it == end()) {
+      throw std::out_of_range("Out of range");
+    }
+    return it.value();
+  }
+
+  const_iterator find(const key_type& key) const {
+    const_iterator it{lower_bound(key)};
+    if (it == end() || compare_(key, it.key())) {
+      return end();
+    }
+    return it;
+  }
+
+  bool contains(const key_type& key) const { return find(key) != end(); }
+
+  size_type count(const key_type& key) const { return contains(key); }
+
+  const_iterator lower_bound(const key_type& key) const {
+    return At(std::lower_bound(keys_, keys_ + size_, key, compare_));
+  }
+
+  const_iterator upper_bound(const key_type& key) const {
+    return At(std::upper_bound(keys_, keys_ + size_, key, compare_));
+  }
+
+  std::pair<const_iterator, const_iterator> equal_range(
+      const key_type& key) const {
+    const_iterator first{lower_bound(key)};
+    if (first == end() || compare_(key, first.key())) {
+      return {first, first};
+    }
+    return {first, std::next(first)};
+  }
+
+ private:
+  const_iterator At(const Key* key) const {
+    return {key, values_ + (key - keys_)};
+  }
+
+  void ReadHeader(const std::string& path) {
+    MappedMapHeader header;
+    std::memcpy(&header, mapping_, sizeof(header));
+    MappedMapHeader expected{
+        mapped_map_detail::MakeHeader<Key, T>(header.count)};
+    if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) ||
+        header.byte_order != expected.byte_order ||
+        header.version != expected.version) {
+      throw std::runtime_error(path + ": not a frozen map");
+    }
+    if (header.key_size != expected.key_size ||
+        header.key_align != expected.key_align ||
+        header.value_size != expected.value_size ||
+        header.value_align != expected.value_align) {
+      throw std::runtime_error(path + ": frozen with other key or value types");
+    }
+    // Checked before any multiplication by count could overflow
+    if (header.count > mapping_size_ ||
+        header.keys_offset != expected.keys_offset ||
+        header.values_offset != expected.values_offset ||
+        header.values_offset + header.count * sizeof(T) > mapping_size_) {
+      throw std::runtime_error(path + ": truncated or corrupt");
+    }
+    const char* base{static_cast<const char*>(mapping_)};
+    keys_ = reinterpret_cast<const Key*>(base + header.keys_offset);
+    values_ = reinterpret_cast<const T*>(base + header.values_offset);
+    size_ = static_cast<size_type>(header.count);
+  }
+
+  void Unmap() {
+    if (mapping_) {
+      ::munmap(mapping_, mapping_size_);
+      mapping_ = nullptr;
+    }
+  }
+
+  Compare compare_;
+  void* mapping_{nullptr};
+  size_type mapping_size_{0};
+  const Key* keys_{nullptr};
+  const T* values_{nullptr};
+  size_type size_{0};
+};
+
+#pragma GCC diagnostic pop
+
+}  // namespace s21
+
+#endif  // S21_MAPPED_MAP_H
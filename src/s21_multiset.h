@@ -3,9 +3,12 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <memory_resource>
 #include <type_traits>
 #include <utility>
 
@@ -13,33 +16,64 @@
 
 namespace s21 {
 
-template <typename Key>
+template <typename Key, typename Compare = std::less<Key>,
+          typename Allocator = std::allocator<Key>>
 class multiset {
+  // Subtree sizes make count and the order statistics logarithmic
+  using tree_type = RedBlackTree<Key, void, Compare, Allocator, SubtreeSize>;
+
  public:
   using key_type = Key;
   using value_type = Key;
-  using iterator = RedBlackTreeIterator<Key, false, void>;
-  using const_iterator = RedBlackTreeIterator<Key, true, void>;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
   using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using node_handle = typename tree_type::node_handle;
 
   multiset() : tree_{} {}
 
-  multiset(std::initializer_list<value_type> const& items) : tree_{} {
-    for (const auto& i : items) {
-      tree_.insert(i);
-    }
+  explicit multiset(const Compare& compare,
+                    const allocator_type& alloc = allocator_type())
+      : tree_{compare, alloc} {}
+
+  explicit multiset(const allocator_type& alloc) : tree_{alloc} {}
+
+  multiset(std::initializer_list<value_type> const& items,
+           const Compare& compare = Compare(),
+           const allocator_type& alloc = allocator_type())
+      : tree_{compare, alloc} {
+    tree_.assign_equal(items.begin(), items.end());
   }
 
-  multiset(const multiset& other) : tree_{} {
-    for (auto it = other.begin(); it != other.end(); ++it) {
-      tree_.insert(*it);
-    }
+  multiset(std::initializer_list<value_type> const& items,
+           const allocator_type& alloc)
+      : multiset(items, Compare(), alloc) {}
+
+  // O(n) when the range is sorted, O(n log n) otherwise. Equal keys keep
+  // their order from the range.
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  multiset(InputIt first, InputIt last, const Compare& compare = Compare(),
+           const allocator_type& alloc = allocator_type())
+      : tree_{compare, alloc} {
+    tree_.assign_equal(first, last);
   }
 
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  multiset(InputIt first, InputIt last, const allocator_type& alloc)
+      : multiset(first, last, Compare(), alloc) {}
+
+  // O(n), the tree is cloned node for node instead of re-inserted
+  multiset(const multiset& other) : tree_(other.tree_) {}
+
   multiset(multiset&& other) noexcept : tree_(std::move(other.tree_)) {}
 
   // Additional constructor for multiple identical elements
-  explicit multiset(size_type size, value_type value) : tree_{} {
+  explicit multiset(size_type size, value_type value,
+                  const allocator_type& alloc = allocator_type())
+      : tree_{alloc} {
     for (size_type i{0}; i < size; i++) {
       tree_.insert(value);
     }
@@ -47,14 +81,29 @@ class multiset {
 
   ~multiset() = default;
 
-  multiset& operator=(multiset&& other) noexcept {
+  // Reuses the nodes this multiset already has
+  multiset& operator=(const multiset& other) {
+    tree_ = other.tree_;
+    return *this;
+  }
+
+  multiset& operator=(multiset&& other) noexcept(
+      std::is_nothrow_move_assignable_v<tree_type>) {
     if (this != &other) {
       tree_ = std::move(other.tree_);
-      other.tree_ = RedBlackTree<key_type>();
     }
     return *this;
   }
 
+  allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+  key_compare key_comp() const { return tree_.key_comp(); }
+
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  void assign(InputIt first, InputIt last) {
+    tree_.assign_equal(first, last);
+  }
+
   iterator begin() { return tree_.begin(); }
   iterator end() { return tree_.end(); }
 
@@ -77,64 +126,161 @@ class multiset {
     return iterator(result.first, &tree_);
   }
 
+  iterator insert(value_type&& value) {
+    auto result = tree_.insert(std::move(value));
+    return iterator(result.first, &tree_);
+  }
+
+  // Lands as close to hint as ordering allows, in O(1) comparisons when
+  // value belongs right before it
+  iterator insert(const_iterator hint, const value_type& value) {
+    return iterator(tree_.emplace_hint(hint, value), &tree_);
+  }
+
+  iterator insert(const_iterator hint, value_type&& value) {
+    return iterator(tree_.emplace_hint(hint, std::move(value)), &tree_);
+  }
+
+  // Builds the key from args right inside the node
+  template <typename... Args>
+  iterator emplace(Args&&... args) {
+    auto result = tree_.emplace(std::forward<Args>(args)...);
+    return iterator(result.first, &tree_);
+  }
+
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    return iterator(tree_.emplace_hint(hint, std::forward<Args>(args)...),
+                    &tree_);
+  }
+
   iterator erase(iterator pos) { return tree_.erase(pos); }
 
-  // erase by key removes all occurrences
-  size_type erase(const key_type& key) {
-    size_type count = 0;
-    auto it = find(key);
-    while (it != end() && *it == key) {
-      it = erase(it);
-      ++count;
-    }
-    return count;
+  // Erases [first, last) in one walk, see RedBlackTree::erase
+  iterator erase(const_iterator first, const_iterator last) {
+    return tree_.erase(first, last);
   }
 
-  void swap(multiset& other) noexcept { std::swap(tree_, other.tree_); }
+  // erase by key removes all occurrences, with a single descent
+  size_type erase(const key_type& key) { return tree_.erase(key); }
 
-  void merge(multiset& other) {
-    for (auto it = other.begin(); it != other.end();) {
-      tree_.insert(*it);
-      it = other.erase(it);
-    }
+  void swap(multiset& other) noexcept { tree_.swap(other.tree_); }
+
+  // Relinks other's nodes instead of copying them
+  void merge(multiset& other) { tree_.merge_equal(other.tree_); }
+
+  // The node is unlinked as is, no copy is made and nothing is freed.
+  // By key the first occurrence is taken.
+  node_handle extract(const_iterator pos) { return tree_.extract(pos); }
+  node_handle extract(const key_type& key) { return tree_.extract(key); }
+
+  // Relinks the handle's node after its equal keys, end() for an empty one
+  iterator insert(node_handle&& handle) {
+    return iterator(tree_.insert_handle_equal(handle), &tree_);
   }
 
-  // multiset-specific methods
-  size_type count(const key_type& key) const {
-    size_type count = 0;
-    for (auto it = begin(); it != end(); ++it) {
-      if (*it == key) ++count;
-    }
-    return count;
+  // k-th smallest element counting from 0, end() when k >= size()
+  iterator nth_element(size_type k) { return tree_.nth_element(k); }
+  const_iterator nth_element(size_type k) const {
+    return tree_.nth_element(k);
   }
 
+  difference_type distance(const_iterator first, const_iterator last) const {
+    return tree_.distance(first, last);
+  }
+
+  // Every lookup below also has a template overload taking any K, which
+  // exists only for transparent comparators and builds no key_type
+
   // Returns first occurrence
-  iterator find(const key_type& key) {
-    return iterator(tree_.FindNode(key), &tree_);
+  iterator find(const key_type& key) { return tree_.find(key); }
+  const_iterator find(const key_type& key) const { return tree_.find(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator find(const K& key) {
+    return tree_.find(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  const_iterator find(const K& key) const {
+    return tree_.find(key);
   }
 
-  // Returns range of elements matching key
-  std::pair<iterator, iterator> equal_range(const key_type& key) {
-    iterator first = lower_bound(key);
-    iterator last = upper_bound(key);
-    return {first, last};
+  bool contains(const key_type& key) const { return tree_.contains(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  bool contains(const K& key) const {
+    return tree_.contains(key);
+  }
+
+  size_type count(const key_type& key) const { return tree_.count(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  size_type count(const K& key) const {
+    return tree_.count(key);
+  }
+
+  // Number of elements less than key
+  size_type rank(const key_type& key) const { return tree_.rank(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  size_type rank(const K& key) const {
+    return tree_.rank(key);
+  }
+
+  iterator lower_bound(const key_type& key) { return tree_.lower_bound(key); }
+  const_iterator lower_bound(const key_type& key) const {
+    return tree_.lower_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator lower_bound(const K& key) {
+    return tree_.lower_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  const_iterator lower_bound(const K& key) const {
+    return tree_.lower_bound(key);
   }
 
-  // First element not less than key
-  iterator lower_bound(const key_type& key) {
-    iterator it = begin();
-    while (it != end() && *it < key) ++it;
-    return it;
+  iterator upper_bound(const key_type& key) { return tree_.upper_bound(key); }
+  const_iterator upper_bound(const key_type& key) const {
+    return tree_.upper_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator upper_bound(const K& key) {
+    return tree_.upper_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  const_iterator upper_bound(const K& key) const {
+    return tree_.upper_bound(key);
   }
 
-  // First element greater than key
-  iterator upper_bound(const key_type& key) {
-    iterator it = begin();
-    while (it != end() && *it <= key) ++it;
-    return it;
+  std::pair<iterator, iterator> equal_range(const key_type& key) {
+    return tree_.equal_range(key);
+  }
+  std::pair<const_iterator, const_iterator> equal_range(
+      const key_type& key) const {
+    return tree_.equal_range(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  std::pair<iterator, iterator> equal_range(const K& key) {
+    return tree_.equal_range(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+    return tree_.equal_range(key);
   }
 
-  bool contains(const key_type& key) { return find(key) != end(); }
+  // Lazy view of the elements with keys in [lo, hi)
+  TreeRange<iterator> range(const key_type& lo, const key_type& hi) {
+    return tree_.range(lo, hi);
+  }
+  TreeRange<const_iterator> range(const key_type& lo,
+                                  const key_type& hi) const {
+    return tree_.range(lo, hi);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  TreeRange<iterator> range(const K& lo, const K& hi) {
+    return tree_.range(lo, hi);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  TreeRange<const_iterator> range(const K& lo, const K& hi) const {
+    return tree_.range(lo, hi);
+  }
 
   // Equality comparison needs to account for duplicates
   bool operator==(const multiset& other) const {
@@ -152,9 +298,15 @@ class multiset {
   }
 
  private:
-  RedBlackTree<key_type> tree_;
+  tree_type tree_;
 };
 
+namespace pmr {
+template <typename Key, typename Compare = std::less<Key>>
+using multiset =
+    s21::multiset<Key, Compare, std::pmr::polymorphic_allocator<Key>>;
+}  // namespace pmr
+
 }  // namespace s21
 
 #endif  // S21_MULTISET_H
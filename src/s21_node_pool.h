@@ -0,0 +1,232 @@
+#ifndef S21_NODE_POOL_H
+#define S21_NODE_POOL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Fixed-size object pool. Storage is carved out of page-sized slabs and
+// recycled through an intrusive free list threaded through vacant slots.
+// The pool only hands out raw storage: constructing and destroying the
+// objects is up to the caller. Slabs are requested from Allocator, rebound
+// to the slab type.
+//
+// The slabs belong to a reference-counted arena, so that an object can
+// leave the pool it was allocated from: Share() hands out a reference that
+// keeps the slabs alive, and a pool that Adopt()s it may then recycle the
+// object's slot as its own. Such arenas are only freed once the last
+// reference is gone.
+template <typename T, typename Allocator = std::allocator<T>>
+class NodePool {
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+
+  NodePool() : NodePool(Allocator()) {}
+
+  explicit NodePool(const Allocator& alloc)
+      : allocator_{alloc}, arena_{}, borrowed_{alloc} {}
+
+  NodePool(const NodePool&) = delete;
+
+  NodePool(NodePool&& other) noexcept
+      : allocator_{std::move(other.allocator_)},
+        arena_{std::move(other.arena_)},
+        borrowed_{std::move(other.borrowed_)},
+        current_{other.current_},
+        free_list_{other.free_list_},
+        next_unused_{other.next_unused_} {
+    other.current_ = nullptr;
+    other.free_list_ = nullptr;
+    other.next_unused_ = kSlotsPerSlab;
+  }
+
+  NodePool& operator=(const NodePool&) = delete;
+
+  // Adopts the slabs of other. Unless the allocator propagates, the caller
+  // makes sure both allocators compare equal.
+  NodePool& operator=(NodePool&& other) noexcept {
+    if (this != &other) {
+      Release();
+      if constexpr (slab_traits::propagate_on_container_move_assignment::
+                        value) {
+        allocator_ = std::move(other.allocator_);
+      }
+      arena_.swap(other.arena_);
+      borrowed_.swap(other.borrowed_);
+      std::swap(current_, other.current_);
+      std::swap(free_list_, other.free_list_);
+      std::swap(next_unused_, other.next_unused_);
+    }
+    return *this;
+  }
+
+  ~NodePool() { Release(); }
+
+  // Returns uninitialized storage suitable for one T
+  T* Allocate() {
+    if (free_list_) {
+      Slot* slot{free_list_};
+      free_list_ = slot->next_;
+      return reinterpret_cast<T*>(slot->storage_);
+    }
+    if (next_unused_ == kSlotsPerSlab) {
+      AddSlab();
+    }
+    return reinterpret_cast<T*>(current_->slots_[next_unused_++].storage_);
+  }
+
+  // Gives storage back to the pool, the object must already be destroyed.
+  // It may come from another pool whose arena was adopted.
+  void Deallocate(T* object) noexcept {
+    Slot* slot{reinterpret_cast<Slot*>(object)};
+    slot->next_ = free_list_;
+    free_list_ = slot;
+  }
+
+  // Frees every slab at once. Objects still living in the pool are not
+  // destroyed, so the caller either destroys them first or they are
+  // trivially destructible. Slabs that were shared are left to the other
+  // owners, the pool just starts over with a fresh arena.
+  void Release() noexcept {
+    if (arena_.use_count() == 1) {
+      arena_->FreeSlabs();
+    } else {
+      arena_.reset();
+    }
+    borrowed_.clear();
+    current_ = nullptr;
+    free_list_ = nullptr;
+    next_unused_ = kSlotsPerSlab;
+  }
+
+  // Reference that keeps every slab of the pool alive, empty while the
+  // pool has never allocated
+  std::shared_ptr<const void> Share() const { return arena_; }
+
+  // Keeps the arena behind a Share() reference for as long as this pool
+  // holds on to its own slabs, so that objects from it can be deallocated
+  // here. Both pools' allocators must compare equal.
+  void Adopt(const std::shared_ptr<const void>& arena) {
+    if (arena == nullptr || arena == arena_ ||
+        std::find(borrowed_.begin(), borrowed_.end(), arena) !=
+            borrowed_.end()) {
+      return;
+    }
+    borrowed_.push_back(arena);
+  }
+
+  void swap(NodePool& other) noexcept {
+    if constexpr (slab_traits::propagate_on_container_swap::value) {
+      std::swap(allocator_, other.allocator_);
+    }
+    arena_.swap(other.arena_);
+    borrowed_.swap(other.borrowed_);
+    std::swap(current_, other.current_);
+    std::swap(free_list_, other.free_list_);
+    std::swap(next_unused_, other.next_unused_);
+  }
+
+  Allocator get_allocator() const { return Allocator(allocator_); }
+
+  static constexpr size_type SlotSize() { return sizeof(Slot); }
+  static constexpr size_type SlotsPerSlab() { return kSlotsPerSlab; }
+
+ private:
+  static constexpr size_type kCacheLineSize{64};
+  static constexpr size_type kPageSize{4096};
+  static constexpr size_type kMinSlotsPerSlab{8};
+
+  static constexpr size_type CeilPowerOfTwo(size_type n) {
+    size_type result{1};
+    while (result < n) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  // Objects that fit in a cache line get a power of two slot, so that no
+  // object straddles two lines. Larger ones are simply packed.
+  static constexpr size_type kSlotAlignment{
+      sizeof(T) <= kCacheLineSize
+          ? CeilPowerOfTwo(std::max(sizeof(T), sizeof(void*)))
+          : std::max(alignof(T), alignof(void*))};
+
+  union alignas(kSlotAlignment) Slot {
+    Slot* next_;
+    alignas(T) unsigned char storage_[sizeof(T)];
+  };
+
+  static constexpr size_type kSlotsPerSlab{
+      std::max(kPageSize / sizeof(Slot), kMinSlotsPerSlab) - 1};
+
+  struct alignas(kCacheLineSize) Slab {
+    Slab* next_;
+    Slot slots_[kSlotsPerSlab];
+  };
+
+  using slab_allocator_type =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<Slab>;
+  using slab_traits = std::allocator_traits<slab_allocator_type>;
+  using arena_ref = std::shared_ptr<const void>;
+  using arena_ref_allocator_type = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<arena_ref>;
+
+  // Owner of the slabs, frees them when the last reference goes away
+  class Arena {
+   public:
+    explicit Arena(const slab_allocator_type& alloc) : allocator_{alloc} {}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    ~Arena() { FreeSlabs(); }
+
+    void Push(Slab* slab) noexcept {
+      slab->next_ = slabs_;
+      slabs_ = slab;
+    }
+
+    void FreeSlabs() noexcept {
+      while (slabs_) {
+        Slab* next{slabs_->next_};
+        slab_traits::deallocate(allocator_, slabs_, 1);
+        slabs_ = next;
+      }
+    }
+
+   private:
+    slab_allocator_type allocator_;
+    Slab* slabs_{nullptr};
+  };
+
+  // Slots are handed out uninitialized, so the slab is never constructed
+  // as a whole; only the link to the next slab is written
+  void AddSlab() {
+    if (arena_ == nullptr) {
+      arena_ = std::allocate_shared<Arena>(allocator_, allocator_);
+    }
+    Slab* slab{slab_traits::allocate(allocator_, 1)};
+    arena_->Push(slab);
+    current_ = slab;
+    next_unused_ = 0;
+  }
+
+  slab_allocator_type allocator_;
+  std::shared_ptr<Arena> arena_;
+  std::vector<arena_ref, arena_ref_allocator_type> borrowed_;
+  Slab* current_{nullptr};  // Slab that new slots are carved from
+  Slot* free_list_{nullptr};
+  size_type next_unused_{kSlotsPerSlab};  // First never used slot in current_
+};
+
+#pragma GCC diagnostic pop
+
+}  // namespace s21
+
+#endif  // S21_NODE_POOL_H
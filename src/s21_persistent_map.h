@@ -0,0 +1,256 @@
+#ifndef S21_PERSISTENT_MAP_H
+#define S21_PERSISTENT_MAP_H
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "s21_persistent_tree.h"
+
+namespace s21 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Map with O(1) copies for point-in-time views. A snapshot shares every
+// node with the map it was taken from, and a write to either one copies
+// only the O(log n) nodes it changes that the other one still sees.
+//
+// Take snapshots on the writer's thread, or under whatever lock guards
+// the writes: taking one is a read of the map. The snapshot itself then
+// belongs to whoever holds it and can be read without any locking while
+// the map goes on changing. Elements may be shared with other snapshots,
+// so iterators are read-only and there is no operator[]. Every write
+// invalidates the iterators into the written map.
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, T>>>
+class persistent_map {
+  using tree_type = PersistentTree<Key, T, Compare, Allocator>;
+
+ public:
+  using value_type = std::pair<const Key, T>;
+  using key_type = Key;
+  using mapped_type = T;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = std::size_t;
+
+  persistent_map() : tree_{} {}
+
+  explicit persistent_map(const Compare& compare,
+                          const allocator_type& alloc = allocator_type())
+      : tree_{compare, alloc} {}
+
+  explicit persistent_map(const allocator_type& alloc) : tree_{alloc} {}
+
+  persistent_map(std::initializer_list<value_type> const& items,
+                 const Compare& compare = Compare(),
+                 const allocator_type& alloc = allocator_type())
+      : tree_{compare, alloc} {
+    for (const value_type& item : items) {
+      tree_.insert_unique(item);
+    }
+  }
+
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  persistent_map(InputIt first, InputIt last,
+                 const Compare& compare = Compare(),
+                 const allocator_type& alloc = allocator_type())
+      : tree_{compare, alloc} {
+    for (; first != last; ++first) {
+      tree_.insert_unique(*first);
+    }
+  }
+
+  // O(1), the copy shares all nodes with other
+  persistent_map(const persistent_map& other) : tree_(other.tree_) {}
+
+  persistent_map(persistent_map&& other) noexcept
+      : tree_(std::move(other.tree_)) {}
+
+  ~persistent_map() = default;
+
+  persistent_map& operator=(const persistent_map& other) {
+    tree_ = other.tree_;
+    return *this;
+  }
+
+  persistent_map& operator=(persistent_map&& other) noexcept(
+      std::is_nothrow_move_assignable_v<tree_type>) {
+    tree_ = std::move(other.tree_);
+    return *this;
+  }
+
+  // Point-in-time view of the map, O(1)
+  persistent_map snapshot() const { return *this; }
+
+  allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+  key_compare key_comp() const { return tree_.key_comp(); }
+
+  const mapped_type& at(const key_type& key) const {
+    auto it = tree_.find(key);
+    if (it == tree_.end()) {
+      throw std::out_of_range("Out of range");
+    }
+    return it->second;
+  }
+
+  const_iterator begin() const { return tree_.begin(); }
+  const_iterator end() const { return tree_.end(); }
+
+  bool empty() const { return tree_.empty(); }
+
+  size_type size() const { return tree_.size(); }
+
+  size_type max_size() const {
+    return std::numeric_limits<size_type>::max() /
+           sizeof(typename tree_type::node_type);
+  }
+
+  void clear() { tree_.clear(); }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return tree_.insert_unique(value);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return tree_.insert_unique(std::move(value));
+  }
+
+  std::pair<iterator, bool> insert(const key_type& key, const T& obj) {
+    return tree_.try_emplace(key, obj);
+  }
+
+  std::pair<iterator, bool> insert(const key_type& key, T&& obj) {
+    return tree_.try_emplace(key, std::move(obj));
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return tree_.emplace_unique(std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+    return tree_.try_emplace(key, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+    return tree_.try_emplace(std::move(key), std::forward<Args>(args)...);
+  }
+
+  // The way to change a mapped value, snapshots keep the one they saw
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+    return tree_.insert_or_assign(key, std::forward<M>(obj));
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj) {
+    return tree_.insert_or_assign(std::move(key), std::forward<M>(obj));
+  }
+
+  iterator erase(const_iterator pos) { return tree_.erase(pos); }
+
+  size_type erase(const key_type& key) { return tree_.erase_unique(key); }
+
+  void swap(persistent_map& other) noexcept { tree_.swap(other.tree_); }
+
+  // Every lookup below also has a template overload taking any K, which
+  // exists only for transparent comparators and builds no key_type
+
+  const_iterator find(const key_type& key) const { return tree_.find(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  const_iterator find(const K& key) const {
+    return tree_.find(key);
+  }
+
+  bool contains(const key_type& key) const { return tree_.contains(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  bool contains(const K& key) const {
+    return tree_.contains(key);
+  }
+
+  size_type count(const key_type& key) const { return contains(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  size_type count(const K& key) const {
+    return contains(key);
+  }
+
+  const_iterator lower_bound(const key_type& key) const {
+    return tree_.lower_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  const_iterator lower_bound(const K& key) const {
+    return tree_.lower_bound(key);
+  }
+
+  const_iterator upper_bound(const key_type& key) const {
+    return tree_.upper_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  const_iterator upper_bound(const K& key) const {
+    return tree_.upper_bound(key);
+  }
+
+  std::pair<const_iterator, const_iterator> equal_range(
+      const key_type& key) const {
+    return tree_.equal_range(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+    return tree_.equal_range(key);
+  }
+
+  // Lazy view of the elements with keys in [lo, hi)
+  TreeRange<const_iterator> range(const key_type& lo,
+                                  const key_type& hi) const {
+    return {tree_.lower_bound(lo), tree_.lower_bound(hi)};
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  TreeRange<const_iterator> range(const K& lo, const K& hi) const {
+    return {tree_.lower_bound(lo), tree_.lower_bound(hi)};
+  }
+
+  // Snapshots of one another compare equal at once while they still
+  // share the root
+  bool operator==(const persistent_map& other) const {
+    if (this->size() != other.size()) return false;
+    if (tree_.get_root() == other.tree_.get_root()) return true;
+    auto it1 = begin();
+    auto it2 = other.begin();
+
+    while (it1 != end() && it2 != other.end()) {
+      if (*it1 != *it2) return false;
+      ++it1;
+      ++it2;
+    }
+
+    return it1 == end() && it2 == other.end();
+  }
+
+ private:
+  tree_type tree_;
+};
+
+#pragma GCC diagnostic pop
+
+namespace pmr {
+template <typename Key, typename T, typename Compare = std::less<Key>>
+using persistent_map = s21::persistent_map<
+    Key, T, Compare, std::pmr::polymorphic_allocator<std::pair<const Key, T>>>;
+}  // namespace pmr
+
+}  // namespace s21
+
+#endif  // S21_PERSISTENT_MAP_H
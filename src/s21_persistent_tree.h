@@ -0,0 +1,789 @@
+#ifndef S21_PERSISTENT_TREE_H
+#define S21_PERSISTENT_TREE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "s21_tree_utility.h"
+
+namespace s21 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Node of a persistent tree, possibly reachable from several versions of
+// it. The count is of the parents and trees that point here. A node is
+// only ever written to while it and all its ancestors have a count of
+// one, that is while no other version can see it.
+template <typename Value>
+class PersistentNode {
+ public:
+  using value_type = Value;
+
+  template <typename... Args>
+  explicit PersistentNode(std::in_place_t, Args&&... args)
+      : data_(std::forward<Args>(args)...) {}
+
+  PersistentNode(const PersistentNode&) = delete;
+  PersistentNode& operator=(const PersistentNode&) = delete;
+
+  value_type data_;
+  PersistentNode* left_{nullptr};
+  PersistentNode* right_{nullptr};
+  std::atomic<std::uint32_t> references_{1};
+  NodeColor color_{NodeColor::RED};
+};
+
+// Nodes have no parent links, a node may have a different parent in
+// every version, so the iterator carries the path down from the root.
+// Elements may be seen by other versions and are read-only.
+template <typename NodeType>
+class PersistentTreeIterator {
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = typename NodeType::value_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const value_type*;
+  using reference = const value_type&;
+
+  // A red-black tree is at most twice as deep as a perfectly balanced
+  // one, and no address space holds 2^52 nodes
+  static constexpr std::size_t kMaxDepth{104};
+
+  PersistentTreeIterator() = default;
+
+  reference operator*() const { return path_[depth_ - 1]->data_; }
+
+  pointer operator->() const { return &path_[depth_ - 1]->data_; }
+
+  PersistentTreeIterator& operator++() {
+    const NodeType* node{path_[depth_ - 1]};
+    if (node->right_) {
+      Push(node->right_);
+      DescendLeft();
+    } else {
+      ClimbWhile(&NodeType::right_);
+    }
+    return *this;
+  }
+
+  PersistentTreeIterator operator++(int) {
+    PersistentTreeIterator temp = *this;
+    ++*this;
+    return temp;
+  }
+
+  // Stepping back from end() walks down the right spine
+  PersistentTreeIterator& operator--() {
+    if (depth_ == 0) {
+      Push(root_);
+      DescendRight();
+      return *this;
+    }
+    const NodeType* node{path_[depth_ - 1]};
+    if (node->left_) {
+      Push(node->left_);
+      DescendRight();
+    } else {
+      ClimbWhile(&NodeType::left_);
+    }
+    return *this;
+  }
+
+  PersistentTreeIterator operator--(int) {
+    PersistentTreeIterator temp = *this;
+    --*this;
+    return temp;
+  }
+
+  bool operator==(const PersistentTreeIterator& other) const {
+    return Current() == other.Current();
+  }
+
+  bool operator!=(const PersistentTreeIterator& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  template <typename, typename, typename, typename>
+  friend class PersistentTree;
+
+  explicit PersistentTreeIterator(const NodeType* root) : root_{root} {}
+
+  const NodeType* Current() const {
+    return depth_ ? path_[depth_ - 1] : nullptr;
+  }
+
+  void Push(const NodeType* node) { path_[depth_++] = node; }
+
+  void DescendLeft() {
+    while (path_[depth_ - 1]->left_) {
+      Push(path_[depth_ - 1]->left_);
+    }
+  }
+
+  void DescendRight() {
+    while (path_[depth_ - 1]->right_) {
+      Push(path_[depth_ - 1]->right_);
+    }
+  }
+
+  // Pops the current node and every ancestor reached through side
+  void ClimbWhile(NodeType* NodeType::*side) {
+    const NodeType* child{path_[--depth_]};
+    while (depth_ != 0 && path_[depth_ - 1]->*side == child) {
+      child = path_[--depth_];
+    }
+  }
+
+  const NodeType* root_{nullptr};
+  std::size_t depth_{0};
+  const NodeType* path_[kMaxDepth];
+};
+
+// Red-black tree whose copies share all their nodes: copying is O(1), and
+// a write copies just the nodes it has to change that some other copy
+// can still see, O(log n) of them. Nodes nobody else sees are changed in
+// place, so a tree that isn't copied costs about as much to write as an
+// ordinary one. Elements have to be copy constructible.
+//
+// One tree object is no more thread-safe than an int, but copies are
+// independent: a reader may walk its copy while the writer keeps writing
+// to the original. Reference counts are atomic, so whichever copy goes
+// last frees the nodes, and the allocator has to cope with that happening
+// on any thread. Every write invalidates all iterators into the written
+// tree, those into other copies stay valid.
+template <typename Key, typename T = void, typename Compare = std::less<Key>,
+          typename Allocator = std::allocator<
+              std::conditional_t<std::is_void_v<T>, Key,
+                                 std::pair<const Key, T>>>>
+class PersistentTree {
+ public:
+  using value_type =
+      std::conditional_t<std::is_void_v<T>, Key, std::pair<const Key, T>>;
+  using node_type = PersistentNode<value_type>;
+  using key_type = Key;
+  using mapped_type = T;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+  using iterator = PersistentTreeIterator<node_type>;
+  using const_iterator = iterator;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+ private:
+  using alloc_traits = std::allocator_traits<allocator_type>;
+  using node_allocator_type =
+      typename alloc_traits::template rebind_alloc<node_type>;
+  using node_traits = typename alloc_traits::template rebind_traits<node_type>;
+
+ public:
+  PersistentTree() : PersistentTree(Compare(), allocator_type()) {}
+  explicit PersistentTree(const allocator_type& alloc)
+      : PersistentTree(Compare(), alloc) {}
+  explicit PersistentTree(const Compare& compare,
+                          const allocator_type& alloc = allocator_type())
+      : compare_{compare}, alloc_{alloc} {}
+
+  // Shares every node of other. The copy keeps other's allocator, which
+  // is the one the shared nodes go back to.
+  PersistentTree(const PersistentTree& other)
+      : compare_{other.compare_},
+        alloc_{other.alloc_},
+        root_{Share(other.root_)},
+        size_{other.size_} {}
+
+  PersistentTree(PersistentTree&& other) noexcept
+      : compare_{other.compare_},
+        alloc_{other.alloc_},
+        root_{std::exchange(other.root_, nullptr)},
+        size_{std::exchange(other.size_, 0)} {}
+
+  ~PersistentTree() { Release(root_); }
+
+  PersistentTree& operator=(const PersistentTree& other) {
+    if (this != &other) {
+      if constexpr (alloc_traits::propagate_on_container_copy_assignment::
+                        value) {
+        clear();
+        alloc_ = other.alloc_;
+      } else if (alloc_ != other.alloc_) {
+        // Nodes from a foreign allocator can't be shared, copy the values
+        PersistentTree copy{other.compare_, allocator_type(alloc_)};
+        for (const value_type& value : other) {
+          copy.insert_unique(value);
+        }
+        swap(copy);
+        return *this;
+      }
+      node_type* root{Share(other.root_)};
+      Release(root_);
+      compare_ = other.compare_;
+      root_ = root;
+      size_ = other.size_;
+    }
+    return *this;
+  }
+
+  PersistentTree& operator=(PersistentTree&& other) noexcept(
+      alloc_traits::propagate_on_container_move_assignment::value ||
+      alloc_traits::is_always_equal::value) {
+    if (this != &other) {
+      if constexpr (alloc_traits::propagate_on_container_move_assignment::
+                        value) {
+        clear();
+        alloc_ = other.alloc_;
+      } else if (alloc_ != other.alloc_) {
+        *this = std::as_const(other);
+        other.clear();
+        return *this;
+      }
+      clear();
+      compare_ = other.compare_;
+      root_ = std::exchange(other.root_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+
+  allocator_type get_allocator() const { return allocator_type(alloc_); }
+
+  key_compare key_comp() const { return compare_; }
+
+  size_type size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  const node_type* get_root() const { return root_; }
+
+  iterator begin() const {
+    iterator it{root_};
+    if (root_) {
+      it.Push(root_);
+      it.DescendLeft();
+    }
+    return it;
+  }
+
+  iterator end() const { return iterator(root_); }
+
+  // Inserts only if no equivalent key is present, otherwise returns the
+  // element holding it
+  template <typename Value>
+  std::pair<iterator, bool> insert_unique(Value&& value) {
+    return InsertUnique(KeyOf(value), [this, &value]() {
+      return CreateNode(std::in_place, std::forward<Value>(value));
+    });
+  }
+
+  // The key is only known once the value is built, so the node is built
+  // first and thrown away if the key turns out to be taken
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_unique(Args&&... args) {
+    node_type* node{CreateNode(std::in_place, std::forward<Args>(args)...)};
+    auto result = InsertUnique(KeyOf(node->data_), [node]() { return node; });
+    if (result.second == false) {
+      DestroyNode(node);
+    }
+    return result;
+  }
+
+  // Map only: nothing is constructed unless the key is missing
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+    return InsertUnique(key, [&]() {
+      return CreateNode(std::in_place, std::piecewise_construct,
+                        std::forward_as_tuple(std::forward<K>(key)),
+                        std::forward_as_tuple(std::forward<Args>(args)...));
+    });
+  }
+
+  // Map only. An existing element is made private to this tree before
+  // its mapped value is assigned, other copies keep the old value.
+  template <typename K, typename M>
+  std::pair<iterator, bool> insert_or_assign(K&& key, M&& obj) {
+    Path path;
+    if (FindPath(key, path)) {
+      UnsharePath(path);
+      path.Top()->data_.second = std::forward<M>(obj);
+      return {MakeIterator(path), false};
+    }
+    return try_emplace(std::forward<K>(key), std::forward<M>(obj));
+  }
+
+  template <typename K>
+  size_type erase_unique(const K& key) {
+    Path path;
+    if (FindPath(key, path) == false) {
+      return 0;
+    }
+    EraseAt(path);
+    return 1;
+  }
+
+  // Nodes are copied and rotated under the iterator, so the element after
+  // pos is looked up again by key once pos is gone
+  iterator erase(const_iterator pos) {
+    const_iterator next{std::next(pos)};
+    if (next == end()) {
+      erase_unique(KeyOf(*pos));
+      return end();
+    }
+    key_type next_key{KeyOf(*next)};
+    erase_unique(KeyOf(*pos));
+    return lower_bound(next_key);
+  }
+
+  void clear() {
+    Release(std::exchange(root_, nullptr));
+    size_ = 0;
+  }
+
+  void swap(PersistentTree& other) noexcept {
+    std::swap(compare_, other.compare_);
+    if constexpr (alloc_traits::propagate_on_container_swap::value) {
+      std::swap(alloc_, other.alloc_);
+    }
+    std::swap(root_, other.root_);
+    std::swap(size_, other.size_);
+  }
+
+  template <typename K>
+  iterator find(const K& key) const {
+    iterator it{lower_bound(key)};
+    if (it != end() && compare_(key, KeyOf(*it))) {
+      return end();
+    }
+    return it;
+  }
+
+  template <typename K>
+  bool contains(const K& key) const {
+    for (const node_type* node{root_}; node;) {
+      if (compare_(key, KeyOf(node->data_))) {
+        node = node->left_;
+      } else if (compare_(KeyOf(node->data_), key)) {
+        node = node->right_;
+      } else {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // The bounds keep the path down to the deepest node that qualified
+  template <typename K>
+  iterator lower_bound(const K& key) const {
+    iterator it{root_};
+    std::size_t found{0};
+    for (const node_type* node{root_}; node;) {
+      it.Push(node);
+      if (compare_(KeyOf(node->data_), key)) {
+        node = node->right_;
+      } else {
+        found = it.depth_;
+        node = node->left_;
+      }
+    }
+    it.depth_ = found;
+    return it;
+  }
+
+  template <typename K>
+  iterator upper_bound(const K& key) const {
+    iterator it{root_};
+    std::size_t found{0};
+    for (const node_type* node{root_}; node;) {
+      it.Push(node);
+      if (compare_(key, KeyOf(node->data_))) {
+        found = it.depth_;
+        node = node->left_;
+      } else {
+        node = node->right_;
+      }
+    }
+    it.depth_ = found;
+    return it;
+  }
+
+  template <typename K>
+  std::pair<iterator, iterator> equal_range(const K& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+ private:
+  // Nodes from the root down, each one the parent of the next
+  struct Path {
+    node_type*& Top() { return nodes_[depth_ - 1]; }
+    void Push(node_type* node) { nodes_[depth_++] = node; }
+
+    node_type* nodes_[iterator::kMaxDepth];
+    std::size_t depth_{0};
+  };
+
+  template <typename Value>
+  static const auto& KeyOf(const Value& value) {
+    if constexpr (std::is_void_v<T>) {
+      return value;
+    } else {
+      return value.first;
+    }
+  }
+
+  static bool IsRed(const node_type* node) {
+    return node && node->color_ == NodeColor::RED;
+  }
+
+  static node_type* Share(node_type* node) {
+    if (node) {
+      node->references_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return node;
+  }
+
+  // Drops one reference, freeing whatever nobody else holds any more
+  void Release(node_type* node) {
+    while (node &&
+           node->references_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      Release(node->left_);
+      node_type* right{node->right_};
+      DestroyNode(node);
+      node = right;
+    }
+  }
+
+  template <typename... Args>
+  node_type* CreateNode(Args&&... args) {
+    node_type* node{node_traits::allocate(alloc_, 1)};
+    try {
+      node_traits::construct(alloc_, node, std::forward<Args>(args)...);
+    } catch (...) {
+      node_traits::deallocate(alloc_, node, 1);
+      throw;
+    }
+    return node;
+  }
+
+  void DestroyNode(node_type* node) {
+    node_traits::destroy(alloc_, node);
+    node_traits::deallocate(alloc_, node, 1);
+  }
+
+  // Makes the node behind link private to this tree, copying it if some
+  // other version sees it too. Whatever holds link has to be private
+  // already, or the copy would be visible elsewhere.
+  node_type* Unshare(node_type*& link) {
+    node_type* node{link};
+    if (node && node->references_.load(std::memory_order_acquire) != 1) {
+      node_type* copy{CreateNode(std::in_place, std::as_const(node->data_))};
+      copy->left_ = Share(node->left_);
+      copy->right_ = Share(node->right_);
+      copy->color_ = node->color_;
+      link = copy;
+      Release(node);
+      return copy;
+    }
+    return node;
+  }
+
+  // The pointer to path.nodes_[index] held by its parent or by the tree
+  node_type*& LinkTo(Path& path, std::size_t index) {
+    if (index == 0) {
+      return root_;
+    }
+    node_type* parent{path.nodes_[index - 1]};
+    return parent->left_ == path.nodes_[index] ? parent->left_
+                                               : parent->right_;
+  }
+
+  // Top-down, so that every node is unshared through a private parent
+  void UnsharePath(Path& path) {
+    for (std::size_t i{0}; i < path.depth_; ++i) {
+      path.nodes_[i] = Unshare(LinkTo(path, i));
+    }
+  }
+
+  iterator MakeIterator(const Path& path) const {
+    iterator it{root_};
+    for (std::size_t i{0}; i < path.depth_; ++i) {
+      it.Push(path.nodes_[i]);
+    }
+    return it;
+  }
+
+  // Fills path down to the node holding key, or to the last node visited
+  // when there is none
+  template <typename K>
+  bool FindPath(const K& key, Path& path) const {
+    for (node_type* node{root_}; node;) {
+      path.Push(node);
+      if (compare_(key, KeyOf(node->data_))) {
+        node = node->left_;
+      } else if (compare_(KeyOf(node->data_), key)) {
+        node = node->right_;
+      } else {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static node_type* RotateLeft(node_type* node) {
+    node_type* right{node->right_};
+    node->right_ = right->left_;
+    right->left_ = node;
+    return right;
+  }
+
+  static node_type* RotateRight(node_type* node) {
+    node_type* left{node->left_};
+    node->left_ = left->right_;
+    left->right_ = node;
+    return left;
+  }
+
+  // Every node that may need copying is copied before anything changes,
+  // so an exception from a copy leaves the tree as it was. The node made
+  // by make_node is this tree's from then on.
+  template <typename K, typename MakeNode>
+  std::pair<iterator, bool> InsertUnique(const K& key, MakeNode make_node) {
+    Path path;
+    if (FindPath(key, path)) {
+      return {MakeIterator(path), false};
+    }
+    node_type* node{make_node()};
+    try {
+      UnshareForInsert(path);
+    } catch (...) {
+      DestroyNode(node);
+      throw;
+    }
+    node->left_ = nullptr;
+    node->right_ = nullptr;
+    node->color_ = NodeColor::RED;
+    if (path.depth_ == 0) {
+      root_ = node;
+    } else if (compare_(KeyOf(node->data_), KeyOf(path.Top()->data_))) {
+      path.Top()->left_ = node;
+    } else {
+      path.Top()->right_ = node;
+    }
+    ++size_;
+    InsertFixup(path, node);
+    return {lower_bound(KeyOf(node->data_)), true};
+  }
+
+  // Besides the path, the fixup recolours every red uncle it meets on the
+  // way up, which it does for as long as the parent is red
+  void UnshareForInsert(Path& path) {
+    UnsharePath(path);
+    for (std::size_t above{path.depth_};
+         above >= 2 && IsRed(path.nodes_[above - 1]); above -= 2) {
+      node_type* grandparent{path.nodes_[above - 2]};
+      node_type*& uncle{grandparent->left_ == path.nodes_[above - 1]
+                            ? grandparent->right_
+                            : grandparent->left_};
+      if (IsRed(uncle) == false) {
+        break;
+      }
+      Unshare(uncle);
+    }
+  }
+
+  // The usual bottom-up fixup, with the path standing in for parent links
+  void InsertFixup(Path& path, node_type* node) {
+    std::size_t above{path.depth_};
+    while (above >= 2 && IsRed(path.nodes_[above - 1])) {
+      node_type* parent{path.nodes_[above - 1]};
+      node_type* grandparent{path.nodes_[above - 2]};
+      bool parent_is_left{grandparent->left_ == parent};
+      node_type*& uncle{parent_is_left ? grandparent->right_
+                                       : grandparent->left_};
+      if (IsRed(uncle)) {
+        Unshare(uncle)->color_ = NodeColor::BLACK;
+        parent->color_ = NodeColor::BLACK;
+        grandparent->color_ = NodeColor::RED;
+        node = grandparent;
+        above -= 2;
+        continue;
+      }
+      node_type* top{nullptr};
+      if (parent_is_left) {
+        if (node == parent->right_) {
+          grandparent->left_ = RotateLeft(parent);
+        }
+        top = RotateRight(grandparent);
+      } else {
+        if (node == parent->left_) {
+          grandparent->right_ = RotateRight(parent);
+        }
+        top = RotateLeft(grandparent);
+      }
+      LinkTo(path, above - 2) = top;
+      top->color_ = NodeColor::BLACK;
+      grandparent->color_ = NodeColor::RED;
+      break;
+    }
+    root_->color_ = NodeColor::BLACK;
+  }
+
+  // Path ends at the node to erase. A node with two children trades
+  // places with its successor first, so that the node actually unlinked
+  // has at most one child.
+  void EraseAt(Path& path) {
+    std::size_t target_index{path.depth_ - 1};
+    node_type* target{path.Top()};
+    if (target->left_ && target->right_) {
+      path.Push(target->right_);
+      while (path.Top()->left_) {
+        path.Push(path.Top()->left_);
+      }
+    }
+    UnsharePath(path);
+    std::size_t bottom{path.depth_ - 1};
+    bool child_is_left{bottom != 0 &&
+                       path.nodes_[bottom - 1]->left_ == path.nodes_[bottom]};
+    UnshareForErase(path, child_is_left);
+
+    if (bottom != target_index) {
+      SwapWithSuccessor(path, target_index);
+    }
+    node_type* removed{path.Top()};
+    node_type* child{removed->left_ ? removed->left_ : removed->right_};
+    LinkTo(path, bottom) = child;
+    --path.depth_;
+    --size_;
+    NodeColor removed_color{removed->color_};
+    DestroyNode(removed);
+    if (removed_color == NodeColor::BLACK) {
+      EraseFixup(path, child, child_is_left);
+    }
+  }
+
+  // Moves the successor, last on the path, into the place of the node at
+  // target_index and the node down into the successor's old place. Both
+  // keep the colour of the place they take.
+  void SwapWithSuccessor(Path& path, std::size_t target_index) {
+    node_type* target{path.nodes_[target_index]};
+    node_type* successor{path.Top()};
+    LinkTo(path, target_index) = successor;
+    if (path.depth_ - 1 == target_index + 1) {
+      target->right_ = successor->right_;
+      successor->right_ = target;
+    } else {
+      std::swap(target->right_, successor->right_);
+      path.nodes_[path.depth_ - 2]->left_ = target;
+    }
+    successor->left_ = target->left_;
+    target->left_ = nullptr;
+    std::swap(target->color_, successor->color_);
+    path.nodes_[target_index] = successor;
+    path.Top() = target;
+  }
+
+  // Replays the decisions of EraseFixup, which only depend on colours
+  // that nothing changes before the fixup looks at them, and copies each
+  // node the fixup is going to write to. The path is private already.
+  void UnshareForErase(Path& path, bool child_is_left) {
+    node_type* removed{path.Top()};
+    node_type*& child{removed->left_ ? removed->left_ : removed->right_};
+    if (IsRed(removed)) {
+      return;
+    }
+    if (IsRed(child)) {
+      Unshare(child);
+      return;
+    }
+    for (std::size_t above{path.depth_ - 1}; above != 0; --above) {
+      node_type* parent{path.nodes_[above - 1]};
+      if (above != path.depth_ - 1) {
+        child_is_left = parent->left_ == path.nodes_[above];
+      }
+      node_type* sibling{
+          Unshare(child_is_left ? parent->right_ : parent->left_)};
+      if (IsRed(sibling)) {
+        // Rotated above the parent, the sibling hands its inner child
+        // over as the new sibling, whose children are next in line
+        node_type* inner{
+            Unshare(child_is_left ? sibling->left_ : sibling->right_)};
+        Unshare(inner->left_);
+        Unshare(inner->right_);
+        return;
+      }
+      if (IsRed(sibling->left_) || IsRed(sibling->right_)) {
+        Unshare(sibling->left_);
+        Unshare(sibling->right_);
+        return;
+      }
+      if (IsRed(parent)) {
+        return;
+      }
+    }
+  }
+
+  // A black node went missing below the top of the path, on the left
+  // when node_is_left. Node, possibly null, took its place.
+  void EraseFixup(Path& path, node_type* node, bool node_is_left) {
+    while (path.depth_ != 0 && IsRed(node) == false) {
+      node_type* parent{path.Top()};
+      node_type* node_type::*near{node_is_left ? &node_type::left_
+                                              : &node_type::right_};
+      node_type* node_type::*far{node_is_left ? &node_type::right_
+                                             : &node_type::left_};
+      node_type* sibling{Unshare(parent->*far)};
+      if (IsRed(sibling)) {
+        sibling->color_ = NodeColor::BLACK;
+        parent->color_ = NodeColor::RED;
+        LinkTo(path, path.depth_ - 1) = Rotate(parent, far);
+        path.Top() = sibling;
+        path.Push(parent);
+        sibling = Unshare(parent->*far);
+      }
+      if (IsRed(sibling->left_) == false && IsRed(sibling->right_) == false) {
+        sibling->color_ = NodeColor::RED;
+        node = parent;
+        --path.depth_;
+        node_is_left = path.depth_ != 0 && path.Top()->left_ == node;
+        continue;
+      }
+      if (IsRed(sibling->*far) == false) {
+        node_type* inner{Unshare(sibling->*near)};
+        inner->color_ = NodeColor::BLACK;
+        sibling->color_ = NodeColor::RED;
+        parent->*far = Rotate(sibling, near);
+        sibling = inner;
+      }
+      sibling->color_ = parent->color_;
+      parent->color_ = NodeColor::BLACK;
+      Unshare(sibling->*far)->color_ = NodeColor::BLACK;
+      LinkTo(path, path.depth_ - 1) = Rotate(parent, far);
+      return;
+    }
+    if (IsRed(node)) {
+      node->color_ = NodeColor::BLACK;
+    }
+  }
+
+  // Lifts the child on side above node
+  static node_type* Rotate(node_type* node, node_type* node_type::*side) {
+    return side == &node_type::right_ ? RotateLeft(node) : RotateRight(node);
+  }
+
+  Compare compare_;
+  node_allocator_type alloc_;
+  node_type* root_{nullptr};
+  size_type size_{0};
+};
+
+#pragma GCC diagnostic pop
+
+}  // namespace s21
+
+#endif  // S21_PERSISTENT_TREE_H
@@ -1,40 +1,170 @@
 #ifndef S21_RED_BLACK_TREE_H
 #define S21_RED_BLACK_TREE_H
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <iostream>
 #include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
+
+#include "s21_node_pool.h"
+#include "s21_thread_pool.h"
+#include "s21_tree_utility.h"
 
 namespace s21 {
 
-enum class NodeColor : int8_t { RED = 0, BLACK = 1 };
+// Augmentations keep extra data in every node, derived from the node and
+// its children. The tree calls Update on each node whose subtree changed,
+// bottom-up, so the data stays valid through inserts, erases and rotations.
+struct NoAugment {
+  struct NodeData {};
+
+  template <typename NodeType>
+  static void Update(NodeType*) {}
+};
+
+// Subtree sizes, which give O(log n) rank and select
+struct SubtreeSize {
+  struct NodeData {
+    std::size_t subtree_size_{1};
+  };
+
+  template <typename NodeType>
+  static std::size_t Of(const NodeType* node) {
+    return node ? node->subtree_size_ : 0;
+  }
+
+  template <typename NodeType>
+  static void Update(NodeType* node) {
+    node->subtree_size_ = Of(node->left_) + Of(node->right_) + 1;
+  }
+};
+
+// Operation counters. The tree reports every node-at-a-time insert and
+// removal, every iteration of their fixups and every rotation to its
+// Counters policy. NoCounters drops the calls at compile time, and being
+// an empty base it costs the tree no space either.
+struct NoCounters {
+  void OnInsert() {}
+  void OnRemoval() {}
+  void OnInsertFixup() {}
+  void OnRemovalFixup() {}
+  void OnRotation() {}
+};
+
+// Totals since the tree was built or its counters were reset, and the
+// most fixup iterations that any single insert or removal took. Bulk
+// operations, such as assign or set algebra, build and join subtrees
+// without fixups and are not counted.
+struct OperationCounters {
+  void OnInsert() {
+    ++inserts;
+    current_fixups_ = 0;
+  }
+
+  void OnRemoval() {
+    ++removals;
+    current_fixups_ = 0;
+  }
+
+  void OnInsertFixup() {
+    ++insert_fixups;
+    max_insert_fixups = std::max(max_insert_fixups, ++current_fixups_);
+  }
+
+  void OnRemovalFixup() {
+    ++removal_fixups;
+    max_removal_fixups = std::max(max_removal_fixups, ++current_fixups_);
+  }
+
+  void OnRotation() { ++rotations; }
+
+  std::size_t inserts{0};
+  std::size_t removals{0};
+  std::size_t insert_fixups{0};
+  std::size_t removal_fixups{0};
+  std::size_t max_insert_fixups{0};
+  std::size_t max_removal_fixups{0};
+  std::size_t rotations{0};
+
+ private:
+  std::size_t current_fixups_{0};
+};
+
+// Links of a node. The colour is kept in the lowest bit of the parent
+// pointer, which is always clear since nodes are pointer aligned, so a
+// node costs three pointers on top of its value.
+template <typename NodeType>
+class NodeLinks {
+ public:
+  NodeLinks() = default;
+  NodeLinks(const NodeLinks&) = default;
+  NodeLinks& operator=(const NodeLinks&) = default;
+  ~NodeLinks() = default;
+
+  NodeType* GetParent() const {
+    return reinterpret_cast<NodeType*>(parent_and_color_ & ~kColorBit);
+  }
+
+  void SetParent(NodeType* parent) {
+    parent_and_color_ = reinterpret_cast<std::uintptr_t>(parent) |
+                        (parent_and_color_ & kColorBit);
+  }
+
+  NodeColor GetColor() const {
+    return static_cast<NodeColor>(parent_and_color_ & kColorBit);
+  }
+
+  void SetColor(NodeColor color) {
+    parent_and_color_ = (parent_and_color_ & ~kColorBit) |
+                        static_cast<std::uintptr_t>(color);
+  }
+
+  NodeType* left_{nullptr};
+  NodeType* right_{nullptr};
+
+ private:
+  static constexpr std::uintptr_t kColorBit{1};
+  static_assert(static_cast<std::uintptr_t>(NodeColor::BLACK) == kColorBit);
+
+  // A red root-to-be: no parent, colour bit clear
+  std::uintptr_t parent_and_color_{0};
+};
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpadded"
 
-template <typename Key, typename T = void>
-class Node {
+template <typename Key, typename T = void, typename Augment = NoAugment>
+class Node : public Augment::NodeData,
+             public NodeLinks<Node<Key, T, Augment>> {
  public:
   using value_type = std::pair<const Key, T>;
   using key_type = Key;
   using mapped_type = T;
 
   value_type data_;
-  Node* left_{nullptr};
-  Node* right_{nullptr};
-  Node* parent_{nullptr};
-  NodeColor color_{NodeColor::RED};
 
   Node() = default;
 
   // Constructor for Map case
   Node(const key_type& key, const mapped_type& value) : data_(key, value) {}
 
-  Node(const Node<Key, T>& other) = delete;
-  Node(Node<Key, T>&& other) = delete;
+  // Builds the pair in place from anything std::pair accepts, including
+  // std::piecewise_construct
+  template <typename... Args>
+  explicit Node(std::in_place_t, Args&&... args)
+      : data_(std::forward<Args>(args)...) {}
+
+  Node(const Node& other) = delete;
+  Node(Node&& other) = delete;
   Node& operator=(const Node& other) = delete;
   Node& operator=(Node&&) = delete;
 
@@ -43,34 +173,35 @@ class Node {
 };
 
 // Specialization for Set case (T = void)
-template <typename Key>
-class Node<Key, void> {
+template <typename Key, typename Augment>
+class Node<Key, void, Augment> : public Augment::NodeData,
+                                 public NodeLinks<Node<Key, void, Augment>> {
+  using Links = NodeLinks<Node>;
+
  public:
   using value_type = Key;
   using key_type = Key;
 
   value_type data_;
-  Node* left_{nullptr};
-  Node* right_{nullptr};
-  Node* parent_{nullptr};
-  NodeColor color_{NodeColor::RED};
 
   Node() = default;
 
   // Constructor for Set case
   explicit Node(const Key& key) : data_(key) {}
 
-  Node(const Node<Key, void>& other) = delete;
+  template <typename... Args>
+  explicit Node(std::in_place_t, Args&&... args)
+      : data_(std::forward<Args>(args)...) {}
+
+  Node(const Node& other) = delete;
 
   Node(Node&& other) noexcept
-      : data_(std::move(other.data_)),  // Will use Key's move constructor
-        left_(other.left_),
-        right_(other.right_),
-        parent_(other.parent_),
-        color_(other.color_) {
+      : Augment::NodeData(other),
+        Links(other),
+        data_(std::move(other.data_)) {  // Will use Key's move constructor
     other.left_ = nullptr;
     other.right_ = nullptr;
-    other.parent_ = nullptr;
+    other.SetParent(nullptr);
   }
 
   Node& operator=(const Node& other) = delete;
@@ -80,261 +211,1542 @@ class Node<Key, void> {
 
 #pragma GCC diagnostic pop
 
-template <typename Key, typename T>
+template <typename NodeType, bool is_const>
+class RedBlackTreeIterator;
+
+// Part of the tree that doesn't depend on how nodes are allocated, so
+// iterators of trees with different allocators share one type
+template <typename NodeType>
+class RedBlackTreeBase {
+ public:
+  using size_type = std::size_t;
+
+  size_type size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  NodeType* get_root() const { return root_; }
+
+  // Smallest node, cached so that begin() and prepending with a begin()
+  // hint don't walk down the left spine
+  NodeType* get_leftmost() const { return leftmost_; }
+
+  // Largest node, cached so that appending in key order and stepping back
+  // from end() don't walk down the right spine
+  NodeType* get_rightmost() const { return rightmost_; }
+
+  NodeType* GetMin(NodeType* us) const {
+    NodeType* current = us;
+    while (current->left_ != nullptr) {
+      current = current->left_;
+    }
+    return current;
+  }
+
+  NodeType* GetMax(NodeType* us) const {
+    NodeType* current = us;
+    while (current->right_ != nullptr) {
+      current = current->right_;
+    }
+    return current;
+  }
+
+ protected:
+  RedBlackTreeBase() = default;
+  RedBlackTreeBase(const RedBlackTreeBase&) = delete;
+  RedBlackTreeBase& operator=(const RedBlackTreeBase&) = delete;
+  ~RedBlackTreeBase() = default;
+
+  NodeType* root_{nullptr};
+  NodeType* leftmost_{nullptr};
+  NodeType* rightmost_{nullptr};
+  size_type size_{0};
+};
+
+template <typename Key, typename T, typename Compare, typename Allocator,
+          typename Augment, typename Counters>
 class RedBlackTree;
 
-template <typename Key, bool is_const, typename T = void>
-class RedBlackTreeIterator;
+// Owns a node taken out of a tree by extract() until it is inserted into a
+// tree again, which relinks the very same node. The handle keeps the slabs
+// of the source pool alive, so it may outlive the tree it came from.
+template <typename NodeType>
+class NodeHandle {
+ public:
+  using value_type = typename NodeType::value_type;
+  using key_type = typename NodeType::key_type;
+
+  NodeHandle() = default;
+  NodeHandle(const NodeHandle&) = delete;
+  NodeHandle(NodeHandle&& other) noexcept
+      : node_{std::exchange(other.node_, nullptr)},
+        arena_{std::move(other.arena_)} {}
 
-template <typename Key, typename T>
-void print_tree(const RedBlackTree<Key, T>& tree);
+  NodeHandle& operator=(const NodeHandle&) = delete;
+  NodeHandle& operator=(NodeHandle&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      node_ = std::exchange(other.node_, nullptr);
+      arena_ = std::move(other.arena_);
+    }
+    return *this;
+  }
+
+  // The value is destroyed, its slot is only reclaimed with the slabs
+  ~NodeHandle() { Reset(); }
+
+  bool empty() const noexcept { return node_ == nullptr; }
+  explicit operator bool() const noexcept { return node_ != nullptr; }
+
+  const key_type& key() const { return node_->GetKey(); }
+  value_type& value() const { return node_->data_; }
+  // Map handles only
+  auto& mapped() const { return node_->data_.second; }
+
+  void swap(NodeHandle& other) noexcept {
+    std::swap(node_, other.node_);
+    arena_.swap(other.arena_);
+  }
+
+ private:
+  template <typename, typename, typename, typename, typename, typename>
+  friend class RedBlackTree;
+
+  void Reset() noexcept {
+    if (node_) {
+      node_->~NodeType();
+      node_ = nullptr;
+    }
+    arena_.reset();
+  }
+
+  NodeType* node_{nullptr};
+  std::shared_ptr<const void> arena_{};
+};
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Keys are only ever compared through Compare, one call per visited node.
+// Lookup functions take any K that Compare accepts, it is up to the
+// containers to restrict that to transparent comparators.
+template <typename Key, typename T = void, typename Compare = std::less<Key>,
+          typename Allocator =
+              std::allocator<typename Node<Key, T>::value_type>,
+          typename Augment = NoAugment, typename Counters = NoCounters>
+class RedBlackTree : public RedBlackTreeBase<Node<Key, T, Augment>>,
+                     private Counters {
+  using Base = RedBlackTreeBase<Node<Key, T, Augment>>;
+  using Base::leftmost_;
+  using Base::rightmost_;
+  using Base::root_;
+  using Base::size_;
 
-template <typename Key, typename T = void>
-class RedBlackTree {
  public:
-  using node_type = Node<Key, T>;
+  using node_type = Node<Key, T, Augment>;
   using value_type = typename node_type::value_type;
   using key_type = Key;
   using mapped_type = T;
-  using iterator = RedBlackTreeIterator<Key, false, T>;
-  using const_iterator = RedBlackTreeIterator<Key, true, T>;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+  using iterator = RedBlackTreeIterator<node_type, false>;
+  using const_iterator = RedBlackTreeIterator<node_type, true>;
   using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using node_handle = NodeHandle<node_type>;
+
+  RedBlackTree() : RedBlackTree(Compare(), allocator_type()) {}
+  explicit RedBlackTree(const allocator_type& alloc)
+      : RedBlackTree(Compare(), alloc) {}
+  explicit RedBlackTree(const Compare& compare,
+                        const allocator_type& alloc = allocator_type())
+      : Base(), compare_{compare}, pool_{alloc} {}
+  // Copies the shape and colours of other node for node in O(n), with no
+  // comparisons and no rebalancing
+  RedBlackTree(const RedBlackTree& other)
+      : Base(),
+        compare_{other.compare_},
+        pool_{alloc_traits::select_on_container_copy_construction(
+            other.get_allocator())} {
+    CopyFrom(other);
+  }
 
-  friend void print_tree<Key, T>(const RedBlackTree<Key, T>&);
-
-  RedBlackTree() : root_(nullptr), size_(0) {}
-  RedBlackTree(const RedBlackTree&) = delete;
   RedBlackTree(RedBlackTree&& other) noexcept
-      : root_(other.root_), size_(other.size_) {
+      : Base(), compare_{other.compare_}, pool_(std::move(other.pool_)) {
+    root_ = other.root_;
+    leftmost_ = other.leftmost_;
+    rightmost_ = other.rightmost_;
+    size_ = other.size_;
+    other.root_ = nullptr;
+    other.leftmost_ = nullptr;
+    other.rightmost_ = nullptr;
+    other.size_ = 0;
+  }
+
+  ~RedBlackTree() { clear(); }
+
+  allocator_type get_allocator() const {
+    return allocator_type(pool_.get_allocator());
+  }
+
+  key_compare key_comp() const { return compare_; }
+
+  const Counters& get_counters() const { return *this; }
+
+  void reset_counters() { static_cast<Counters&>(*this) = Counters(); }
+
+  iterator begin() { return iterator(leftmost_, this); }
+
+  iterator end() { return iterator(nullptr, this); }
+
+  const_iterator begin() const { return const_iterator(leftmost_, this); }
+
+  const_iterator end() const { return const_iterator(nullptr, this); }
+
+  // Inserts even when the key is already present, as multiset does
+  std::pair<node_type*, bool> insert(const value_type& value) {
+    return {InsertNode(CreateNode(value)), true};
+  }
+
+  std::pair<node_type*, bool> insert(value_type&& value) {
+    return {InsertNode(CreateNode(std::move(value))), true};
+  }
+
+  template <typename... Args>
+  std::pair<node_type*, bool> emplace(Args&&... args) {
+    return {InsertNode(CreateNode(std::forward<Args>(args)...)), true};
+  }
+
+  // Inserts only if no equivalent key is present, otherwise returns the
+  // node holding it. The key is read from value before anything is built,
+  // and one descent both detects a duplicate and finds the free slot.
+  template <typename Value>
+  std::pair<node_type*, bool> insert_unique(Value&& value) {
+    InsertSlot slot{FindUniqueSlot(ExtractKeyFromAmbiguousValue(value))};
+    if (slot.existing_) {
+      return {slot.existing_, false};
+    }
+    return {LinkNode(CreateNode(std::forward<Value>(value)), slot), true};
+  }
+
+  // The key is only known once the value is built, so the node is created
+  // up front and dropped again if the key turns out to be taken
+  template <typename... Args>
+  std::pair<node_type*, bool> emplace_unique(Args&&... args) {
+    node_type* new_node{CreateNode(std::forward<Args>(args)...)};
+    InsertSlot slot{FindUniqueSlot(new_node->GetKey())};
+    if (slot.existing_) {
+      DestroyNode(new_node);
+      return {slot.existing_, false};
+    }
+    return {LinkNode(new_node, slot), true};
+  }
+
+  // Map only: nothing is constructed, not even the key, unless the key is
+  // missing; then the mapped value is built in place from args
+  template <typename K, typename... Args>
+  std::pair<node_type*, bool> try_emplace(K&& key, Args&&... args) {
+    InsertSlot slot{FindUniqueSlot(key)};
+    if (slot.existing_) {
+      return {slot.existing_, false};
+    }
+    node_type* new_node{
+        CreateNode(std::piecewise_construct,
+                   std::forward_as_tuple(std::forward<K>(key)),
+                   std::forward_as_tuple(std::forward<Args>(args)...))};
+    return {LinkNode(new_node, slot), true};
+  }
+
+  // Hinted versions of the inserts above. When the key belongs right
+  // before hint the node is linked next to it after O(1) comparisons,
+  // so feeding keys in order with end() as the hint appends without a
+  // descent. A wrong hint costs two comparisons plus the usual descent.
+  template <typename Value>
+  std::pair<node_type*, bool> insert_unique(const_iterator hint,
+                                            Value&& value) {
+    InsertSlot slot{
+        FindUniqueSlot(MutableNode(hint), ExtractKeyFromAmbiguousValue(value))};
+    if (slot.existing_) {
+      return {slot.existing_, false};
+    }
+    return {LinkNode(CreateNode(std::forward<Value>(value)), slot), true};
+  }
+
+  template <typename... Args>
+  std::pair<node_type*, bool> emplace_hint_unique(const_iterator hint,
+                                                  Args&&... args) {
+    node_type* new_node{CreateNode(std::forward<Args>(args)...)};
+    InsertSlot slot{FindUniqueSlot(MutableNode(hint), new_node->GetKey())};
+    if (slot.existing_) {
+      DestroyNode(new_node);
+      return {slot.existing_, false};
+    }
+    return {LinkNode(new_node, slot), true};
+  }
+
+  template <typename K, typename... Args>
+  std::pair<node_type*, bool> try_emplace_hint(const_iterator hint, K&& key,
+                                               Args&&... args) {
+    InsertSlot slot{FindUniqueSlot(MutableNode(hint), key)};
+    if (slot.existing_) {
+      return {slot.existing_, false};
+    }
+    node_type* new_node{
+        CreateNode(std::piecewise_construct,
+                   std::forward_as_tuple(std::forward<K>(key)),
+                   std::forward_as_tuple(std::forward<Args>(args)...))};
+    return {LinkNode(new_node, slot), true};
+  }
+
+  // Equal keys are placed as close to hint as ordering allows
+  template <typename... Args>
+  node_type* emplace_hint(const_iterator hint, Args&&... args) {
+    node_type* new_node{CreateNode(std::forward<Args>(args)...)};
+    return LinkNode(new_node,
+                    FindEqualSlot(MutableNode(hint), new_node->GetKey()));
+  }
+
+  // Unlinks the node at pos and hands it over as is, nothing is copied
+  node_handle extract(const_iterator pos) {
+    node_type* node{MutableNode(pos)};
+    UnlinkNode(node);
+    node_handle handle;
+    handle.node_ = node;
+    handle.arena_ = pool_.Share();
+    return handle;
+  }
+
+  // First node with an equivalent key, or an empty handle
+  template <typename K>
+  node_handle extract(const K& key) {
+    node_type* node{FindNode(key)};
+    if (node == nullptr) {
+      return node_handle();
+    }
+    return extract(const_iterator(node, this));
+  }
+
+  // Relinks the handle's node unless its key is taken, in which case the
+  // handle keeps it. The allocator the node came from must compare equal.
+  std::pair<node_type*, bool> insert_handle_unique(node_handle& handle) {
+    if (handle.empty()) {
+      return {nullptr, false};
+    }
+    InsertSlot slot{FindUniqueSlot(handle.key())};
+    if (slot.existing_) {
+      return {slot.existing_, false};
+    }
+    return {LinkNode(TakeFromHandle(handle), slot), true};
+  }
+
+  node_type* insert_handle_equal(node_handle& handle) {
+    if (handle.empty()) {
+      return nullptr;
+    }
+    InsertSlot slot{FindEqualSlot(handle.key())};
+    return LinkNode(TakeFromHandle(handle), slot);
+  }
+
+  // Moves every node of other over by relinking it, without allocating or
+  // copying. Keys that are already present here are dropped, so other
+  // always ends up empty. Trees with unequal allocators can't share nodes
+  // and fall back to moving the values.
+  void merge_unique(RedBlackTree& other) {
+    Merge(other, [this](node_type* node) {
+      InsertSlot slot{FindUniqueSlot(node->GetKey())};
+      if (slot.existing_) {
+        DestroyNode(node);
+      } else {
+        LinkNode(node, slot);
+      }
+    });
+  }
+
+  // Same for multiset, other's nodes go after the equal keys here
+  void merge_equal(RedBlackTree& other) {
+    Merge(other, [this](node_type* node) {
+      LinkNode(node, FindEqualSlot(node->GetKey()));
+    });
+  }
+
+  // Set algebra that consumes other: this tree becomes the union,
+  // intersection or difference and other ends up empty. Both trees are cut
+  // apart with split and glued back with join, so for sizes m <= n the
+  // work is O(m log(n/m + 1)), and branches over large subtrees run in
+  // parallel on ThreadPool::Instance(). A key present in both keeps the
+  // node of this tree. Compare must not throw.
+  void union_with(RedBlackTree& other) {
+    SetOperation(other, [this](Subtree lhs, Subtree rhs, Discards& discards) {
+      return Union(lhs, rhs, discards);
+    });
+  }
+
+  void intersect_with(RedBlackTree& other) {
+    SetOperation(other, [this](Subtree lhs, Subtree rhs, Discards& discards) {
+      return Intersection(lhs, rhs, discards);
+    });
+  }
+
+  void subtract(RedBlackTree& other) {
+    SetOperation(other, [this](Subtree lhs, Subtree rhs, Discards& discards) {
+      return Difference(lhs, rhs, discards);
+    });
+  }
+
+  // First node with an equivalent key, so for multiset the first
+  // occurrence. The descent makes one comparison per level and only the
+  // final candidate is checked for equivalence.
+  template <typename K>
+  node_type* FindNode(const K& key) const {
+    node_type* candidate{LowerBoundNode(key)};
+    if (candidate && compare_(key, candidate->GetKey()) == false) {
+      return candidate;
+    }
+    return nullptr;
+  }
+
+  // Finds the keys of [first, last) and calls emit with each one's node,
+  // null when missing, in input order. Up to kLookupBatch descents go
+  // down together, one level per round, each prefetching the child it
+  // moves to. On a tree much larger than the cache, the misses of the
+  // whole batch then overlap instead of coming one after another.
+  template <typename ForwardIt, typename Emit>
+  void FindMany(ForwardIt first, ForwardIt last, Emit&& emit) const {
+    ForwardIt keys[kLookupBatch];
+    node_type* current[kLookupBatch];
+    node_type* candidate[kLookupBatch];
+    while (first != last) {
+      size_type count{0};
+      for (; first != last && count < kLookupBatch; ++first, ++count) {
+        keys[count] = first;
+        current[count] = root_;
+        candidate[count] = nullptr;
+      }
+      for (bool descending{true}; descending;) {
+        descending = false;
+        for (size_type i{0}; i < count; ++i) {
+          node_type* node{current[i]};
+          if (node == nullptr) {
+            continue;
+          }
+          descending = true;
+          if (compare_(node->GetKey(), *keys[i])) {
+            node = node->right_;
+          } else {
+            candidate[i] = node;
+            node = node->left_;
+          }
+          Prefetch(node);
+          current[i] = node;
+        }
+      }
+      for (size_type i{0}; i < count; ++i) {
+        bool found{candidate[i] &&
+                   compare_(*keys[i], candidate[i]->GetKey()) == false};
+        emit(found ? candidate[i] : nullptr);
+      }
+    }
+  }
+
+  template <typename K>
+  iterator find(const K& key) {
+    return iterator(FindNode(key), this);
+  }
+
+  template <typename K>
+  const_iterator find(const K& key) const {
+    return const_iterator(FindNode(key), this);
+  }
+
+  template <typename K>
+  bool contains(const K& key) const {
+    return FindNode(key) != nullptr;
+  }
+
+  // First element not less than key
+  template <typename K>
+  iterator lower_bound(const K& key) {
+    return iterator(LowerBoundNode(key), this);
+  }
+
+  template <typename K>
+  const_iterator lower_bound(const K& key) const {
+    return const_iterator(LowerBoundNode(key), this);
+  }
+
+  // First element greater than key
+  template <typename K>
+  iterator upper_bound(const K& key) {
+    return iterator(UpperBoundNode(key), this);
+  }
+
+  template <typename K>
+  const_iterator upper_bound(const K& key) const {
+    return const_iterator(UpperBoundNode(key), this);
+  }
+
+  template <typename K>
+  std::pair<iterator, iterator> equal_range(const K& key) {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  template <typename K>
+  std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+
+  // Elements with keys in [lo, hi), empty when hi is not greater than lo
+  template <typename K>
+  TreeRange<iterator> range(const K& lo, const K& hi) {
+    auto [first, last] = RangeNodes(lo, hi);
+    return {iterator(first, this), iterator(last, this)};
+  }
+
+  template <typename K>
+  TreeRange<const_iterator> range(const K& lo, const K& hi) const {
+    auto [first, last] = RangeNodes(lo, hi);
+    return {const_iterator(first, this), const_iterator(last, this)};
+  }
+
+  iterator erase(iterator pos) {
+    iterator next{pos};
+    ++next;
+    RemoveNode(pos.current_);
+    return next;
+  }
+
+  // Erases every element equivalent to key. One descent finds the first
+  // of them, the rest follow through successor links, unless there are so
+  // many that a second descent to the end of them pays off.
+  size_type erase(const Key& key) {
+    size_type old_size{size_};
+    node_type* first{LowerBoundNode(key)};
+    node_type* last{first};
+    size_type count{0};
+    while (last && compare_(key, last->GetKey()) == false) {
+      if (++count == kCutOutRange) {
+        last = UpperBoundNode(key);
+        break;
+      }
+      last = Successor(last);
+    }
+    EraseNodes(first, last, count);
+    return old_size - size_;
+  }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    node_type* end{MutableNode(last)};
+    size_type count{0};
+    for (node_type* node{MutableNode(first)};
+         node != end && count < kCutOutRange; node = Successor(node)) {
+      ++count;
+    }
+    EraseNodes(MutableNode(first), end, count);
+    return iterator(end, this);
+  }
+
+  // Nodes live in pool slabs, so the tree is only walked when the values
+  // need their destructors run; the slabs themselves go back in one pass
+  void clear() {
+    if constexpr (std::is_trivially_destructible_v<node_type> == false) {
+      DestroySubtree(root_);
+    }
+    pool_.Release();
+    root_ = nullptr;
+    leftmost_ = nullptr;
+    rightmost_ = nullptr;
+    size_ = 0;
+  }
+
+  // Replace the contents with [first, last) in O(n) for sorted input,
+  // unsorted input is sorted first. Instead of inserting one by one, the
+  // tree is built bottom-up, perfectly balanced. assign_unique keeps only
+  // the first of equal keys, the same one insert would have kept.
+  template <typename InputIt>
+  void assign_unique(InputIt first, InputIt last) {
+    Assign(first, last, true);
+  }
+
+  template <typename InputIt>
+  void assign_equal(InputIt first, InputIt last) {
+    Assign(first, last, false);
+  }
+
+  // Order statistics, these need nodes augmented with SubtreeSize
+
+  // k-th smallest element counting from 0, end() when k >= size()
+  iterator nth_element(size_type k) {
+    return iterator(SelectNode(k), this);
+  }
+
+  const_iterator nth_element(size_type k) const {
+    return const_iterator(SelectNode(k), this);
+  }
+
+  // Number of elements less than key
+  template <typename K>
+  size_type rank(const K& key) const {
+    return CountBefore(key, false);
+  }
+
+  template <typename K>
+  size_type count(const K& key) const {
+    return CountBefore(key, true) - CountBefore(key, false);
+  }
+
+  // Position of pos in sorted order, size() for end()
+  size_type index_of(const_iterator pos) const {
+    static_assert(kCountsSubtrees, "index_of needs SubtreeSize nodes");
+    const node_type* us{pos.current_};
+    if (us == nullptr) {
+      return size_;
+    }
+    size_type index{SubtreeSize::Of(us->left_)};
+    for (; us->GetParent(); us = us->GetParent()) {
+      if (us == us->GetParent()->right_) {
+        index += SubtreeSize::Of(us->GetParent()->left_) + 1;
+      }
+    }
+    return index;
+  }
+
+  difference_type distance(const_iterator first, const_iterator last) const {
+    return static_cast<difference_type>(index_of(last)) -
+           static_cast<difference_type>(index_of(first));
+  }
+
+  // Same O(n) copy, the nodes already in the tree are recycled for it. If a
+  // value throws while being copied, the tree is left empty.
+  RedBlackTree& operator=(const RedBlackTree& other) {
+    if (this != &other) {
+      if constexpr (alloc_traits::propagate_on_container_copy_assignment::
+                        value) {
+        if (get_allocator() != other.get_allocator()) {
+          clear();
+          pool_ = NodePool<node_type, allocator_type>(other.get_allocator());
+        }
+      }
+      compare_ = other.compare_;
+      CopyFrom(other);
+    }
+    return *this;
+  }
+
+  RedBlackTree& operator=(RedBlackTree&& other) noexcept(
+      alloc_traits::propagate_on_container_move_assignment::value ||
+      alloc_traits::is_always_equal::value) {
+    if (this != &other) {
+      clear();
+      if constexpr (alloc_traits::propagate_on_container_move_assignment::
+                        value == false) {
+        // Nodes from a foreign allocator can't be adopted, copy them over
+        if (get_allocator() != other.get_allocator()) {
+          compare_ = other.compare_;
+          for (const value_type& value : std::as_const(other)) {
+            insert(value);
+          }
+          other.clear();
+          return *this;
+        }
+      }
+      compare_ = other.compare_;
+      root_ = other.root_;
+      other.root_ = nullptr;
+      leftmost_ = other.leftmost_;
+      other.leftmost_ = nullptr;
+      rightmost_ = other.rightmost_;
+      other.rightmost_ = nullptr;
+      size_ = other.size_;
+      other.size_ = 0;
+      pool_ = std::move(other.pool_);
+    }
+    return *this;
+  }
+
+  // O(1), no node moves. As with std containers, the allocators have to
+  // compare equal unless they propagate on swap.
+  void swap(RedBlackTree& other) noexcept {
+    std::swap(compare_, other.compare_);
+    std::swap(root_, other.root_);
+    std::swap(leftmost_, other.leftmost_);
+    std::swap(rightmost_, other.rightmost_);
+    std::swap(size_, other.size_);
+    pool_.swap(other.pool_);
+  }
+
+ private:
+  using alloc_traits = std::allocator_traits<allocator_type>;
+
+  static constexpr bool kAugmented{!std::is_same_v<Augment, NoAugment>};
+  static constexpr bool kCountsSubtrees{
+      std::is_base_of_v<SubtreeSize::NodeData, node_type>};
+
+  // Refreshes augmented data of us and every ancestor after us changed
+  void UpdatePathToRoot(node_type* us) {
+    if constexpr (kAugmented) {
+      for (; us; us = us->GetParent()) {
+        Augment::Update(us);
+      }
+    }
+  }
+
+  template <typename K>
+  node_type* LowerBoundNode(const K& key) const {
+    node_type* current{root_};
+    node_type* result{nullptr};
+    while (current) {
+      if (compare_(current->GetKey(), key)) {
+        current = current->right_;
+      } else {
+        result = current;
+        current = current->left_;
+      }
+    }
+    return result;
+  }
+
+  template <typename K>
+  node_type* UpperBoundNode(const K& key) const {
+    node_type* current{root_};
+    node_type* result{nullptr};
+    while (current) {
+      if (compare_(key, current->GetKey())) {
+        result = current;
+        current = current->left_;
+      } else {
+        current = current->right_;
+      }
+    }
+    return result;
+  }
+
+  // lo and hi are never compared with each other, so a transparent
+  // comparator only has to know how to compare them with keys
+  template <typename K>
+  std::pair<node_type*, node_type*> RangeNodes(const K& lo,
+                                               const K& hi) const {
+    node_type* first{LowerBoundNode(lo)};
+    if (first == nullptr || compare_(first->GetKey(), hi) == false) {
+      return {first, first};
+    }
+    return {first, LowerBoundNode(hi)};
+  }
+
+  node_type* SelectNode(size_type k) const {
+    static_assert(kCountsSubtrees, "nth_element needs SubtreeSize nodes");
+    node_type* current{root_};
+    while (current) {
+      size_type left_size{SubtreeSize::Of(current->left_)};
+      if (k < left_size) {
+        current = current->left_;
+      } else if (k == left_size) {
+        return current;
+      } else {
+        k -= left_size + 1;
+        current = current->right_;
+      }
+    }
+    return nullptr;
+  }
+
+  // Counts elements less than key, or not greater with inclusive set
+  template <typename K>
+  size_type CountBefore(const K& key, bool inclusive) const {
+    static_assert(kCountsSubtrees, "rank and count need SubtreeSize nodes");
+    size_type result{0};
+    node_type* current{root_};
+    while (current) {
+      bool goes_before{inclusive ? !compare_(key, current->GetKey())
+                                 : compare_(current->GetKey(), key)};
+      if (goes_before) {
+        result += SubtreeSize::Of(current->left_) + 1;
+        current = current->right_;
+      } else {
+        current = current->left_;
+      }
+    }
+    return result;
+  }
+
+  // Helper to get key from value_type, or from anything shaped like it
+  template <typename Value>
+  static const auto& ExtractKeyFromAmbiguousValue(const Value& value) {
+    if constexpr (std::is_same_v<T, void>) {
+      return value;  // For Set: value is the key
+    } else {
+      return value.first;  // For Map: value is a pair
+    }
+  }
+
+  void RotateLeft(node_type* us) {
+    Counters::OnRotation();
+    bool us_is_root{root_ == us};
+
+    node_type* right_child{us->right_};
+    node_type* displaced_left_child{right_child->left_};
+
+    // right_child moves up, becoming parent of us
+    right_child->SetParent(us->GetParent());
+
+    // if we had parent, update its child pointer
+    if (us_is_root == false) {
+      if (IsLeftChild(us)) {
+        us->GetParent()->left_ = right_child;
+      } else {
+        us->GetParent()->right_ = right_child;
+      }
+    }
+
+    // changing core rotation connections
+    right_child->left_ = us;
+    us->SetParent(right_child);
+
+    // Reattach the displaced subtree
+    us->right_ = displaced_left_child;
+    if (displaced_left_child) {
+      displaced_left_child->SetParent(us);
+    }
+
+    // us is below right_child now, so it goes first
+    Augment::Update(us);
+    Augment::Update(right_child);
+
+    if (us_is_root) {
+      root_ = right_child;
+    }
+  }
+
+  void RotateRight(node_type* us) {
+    Counters::OnRotation();
+    bool us_is_root{root_ == us};
+
+    node_type* left_child{us->left_};
+    node_type* displaced_right_child{left_child->right_};
+
+    // left_child moves up, becoming parent of us
+    left_child->SetParent(us->GetParent());
+
+    // // if we had parent, update its child pointer
+    if (us_is_root == false) {
+      if (IsLeftChild(us)) {
+        us->GetParent()->left_ = left_child;
+      } else {
+        us->GetParent()->right_ = left_child;
+      }
+    }
+
+    // changing core rotation connections
+    left_child->right_ = us;
+    us->SetParent(left_child);
+
+    // Reattach the displaced subtree
+    us->left_ = displaced_right_child;
+    if (displaced_right_child) {
+      displaced_right_child->SetParent(us);
+    }
+
+    Augment::Update(us);
+    Augment::Update(left_child);
+
+    if (us_is_root) {
+      root_ = left_child;
+    }
+  }
+
+  // The value is constructed right inside the pooled node from args
+  template <typename... Args>
+  node_type* CreateNode(Args&&... args) {
+    node_type* node{pool_.Allocate()};
+    try {
+      new (node) node_type(std::in_place, std::forward<Args>(args)...);
+    } catch (...) {
+      pool_.Deallocate(node);
+      throw;
+    }
+    return node;
+  }
+
+  // Outcome of an insert descent: for unique keys the node that already
+  // holds the key, otherwise the empty child slot of parent_
+  struct InsertSlot {
+    node_type* existing_;
+    node_type* parent_;
+    bool left_;
+  };
+
+  // Walks down like LowerBoundNode, one comparison per level, remembering
+  // the leaf the walk falls off. Only the lower bound can be equivalent to
+  // key, so a single extra comparison at the bottom tells the two apart.
+  template <typename K>
+  InsertSlot FindUniqueSlot(const K& key) const {
+    node_type* current{root_};
+    node_type* lower_bound{nullptr};
+    InsertSlot slot{nullptr, nullptr, false};
+    while (current) {
+      slot.parent_ = current;
+      slot.left_ = !compare_(current->GetKey(), key);
+      if (slot.left_) {
+        lower_bound = current;
+        current = current->left_;
+      } else {
+        current = current->right_;
+      }
+    }
+    if (lower_bound && !compare_(key, lower_bound->GetKey())) {
+      slot.existing_ = lower_bound;
+    }
+    return slot;
+  }
+
+  // Hangs a detached node into an empty slot and rebalances. Whatever
+  // links the node still carries from an earlier tree are overwritten.
+  node_type* LinkNode(node_type* new_node, const InsertSlot& slot) {
+    ++size_;
+    new_node->left_ = nullptr;
+    new_node->right_ = nullptr;
+    new_node->SetColor(NodeColor::RED);
+    new_node->SetParent(slot.parent_);
+    if (slot.parent_ == nullptr) {
+      root_ = new_node;
+      leftmost_ = new_node;
+      rightmost_ = new_node;
+    } else if (slot.left_) {
+      slot.parent_->left_ = new_node;
+      if (slot.parent_ == leftmost_) {
+        leftmost_ = new_node;
+      }
+    } else {
+      slot.parent_->right_ = new_node;
+      if (slot.parent_ == rightmost_) {
+        rightmost_ = new_node;
+      }
+    }
+    UpdatePathToRoot(new_node);
+    Counters::OnInsert();
+    InsertFixup(new_node);
+    return new_node;
+  }
+
+  // Slot after any equal keys
+  InsertSlot FindEqualSlot(const key_type& key) const {
+    InsertSlot slot{nullptr, nullptr, false};
+    for (node_type* current{root_}; current;) {
+      slot.parent_ = current;
+      slot.left_ = compare_(key, current->GetKey());
+      current = slot.left_ ? current->left_ : current->right_;
+    }
+    return slot;
+  }
+
+  // A key fits between two neighbours before and after exactly when one
+  // of them has a free inner child: either after is the leftmost node of
+  // before's right subtree, or before is the rightmost of after's left
+  static InsertSlot SlotBetween(node_type* before, node_type* after) {
+    if (before == nullptr) {
+      return {nullptr, after, true};
+    }
+    if (after == nullptr || before->right_ == nullptr) {
+      return {nullptr, before, false};
+    }
+    return {nullptr, after, true};
+  }
+
+  // Tries the gap right before hint (nullptr for end()), then the one
+  // right after it, before falling back to a full descent
+  template <typename K>
+  InsertSlot FindUniqueSlot(node_type* hint, const K& key) const {
+    if (hint == nullptr) {
+      if (rightmost_ && compare_(rightmost_->GetKey(), key)) {
+        return {nullptr, rightmost_, false};
+      }
+      return FindUniqueSlot(key);
+    }
+    if (compare_(key, hint->GetKey())) {
+      node_type* before{hint == leftmost_ ? nullptr : Predecessor(hint)};
+      if (before == nullptr || compare_(before->GetKey(), key)) {
+        return SlotBetween(before, hint);
+      }
+    } else if (compare_(hint->GetKey(), key)) {
+      node_type* after{Successor(hint)};
+      if (after == nullptr || compare_(key, after->GetKey())) {
+        return SlotBetween(hint, after);
+      }
+    } else {
+      return {hint, nullptr, false};
+    }
+    return FindUniqueSlot(key);
+  }
+
+  // Same checks with equal keys allowed on either side of the gap
+  InsertSlot FindEqualSlot(node_type* hint, const key_type& key) const {
+    if (hint == nullptr) {
+      if (rightmost_ && !compare_(key, rightmost_->GetKey())) {
+        return {nullptr, rightmost_, false};
+      }
+    } else if (!compare_(hint->GetKey(), key)) {
+      node_type* before{hint == leftmost_ ? nullptr : Predecessor(hint)};
+      if (before == nullptr || !compare_(key, before->GetKey())) {
+        return SlotBetween(before, hint);
+      }
+    } else {
+      node_type* after{Successor(hint)};
+      if (after == nullptr || !compare_(after->GetKey(), key)) {
+        return SlotBetween(hint, after);
+      }
+    }
+    return FindEqualSlot(key);
+  }
+
+  node_type* TakeFromHandle(node_handle& handle) {
+    pool_.Adopt(handle.arena_);
+    handle.arena_.reset();
+    return std::exchange(handle.node_, nullptr);
+  }
+
+  // Empties other into this tree through relink(node), which gets nodes
+  // in ascending order with stale links. Should Compare throw, the nodes
+  // not yet taken are rebuilt into other.
+  template <typename Relink>
+  void Merge(RedBlackTree& other, Relink relink) {
+    if (this == &other || other.empty()) {
+      return;
+    }
+    if (get_allocator() != other.get_allocator()) {
+      for (value_type& value : other) {
+        relink(CreateNode(std::move(value)));
+      }
+      other.clear();
+      return;
+    }
+    pool_.Adopt(other.pool_.Share());
+    if (Base::empty()) {
+      std::swap(root_, other.root_);
+      std::swap(leftmost_, other.leftmost_);
+      std::swap(rightmost_, other.rightmost_);
+      std::swap(size_, other.size_);
+      return;
+    }
+    node_type* node{Flatten(other.root_)};
+    size_type remaining{other.size_};
     other.root_ = nullptr;
+    other.leftmost_ = nullptr;
+    other.rightmost_ = nullptr;
     other.size_ = 0;
+    try {
+      while (node) {
+        node_type* next{node->right_};
+        relink(node);
+        node = next;
+        --remaining;
+      }
+    } catch (...) {
+      other.BuildBalanced(remaining, [&node]() {
+        return std::exchange(node, node->right_);
+      });
+      throw;
+    }
   }
 
-  ~RedBlackTree() {
-    DeleteSubtree(root_);
-    root_ = nullptr;
-    size_ = 0;
+  // Rotates a tree into a list sorted by key and linked through right_,
+  // in O(n) and without extra memory. Left links end up cleared, parent
+  // links are left stale.
+  static node_type* Flatten(node_type* root) {
+    node_type* head{nullptr};
+    node_type** tail{&head};
+    while (root) {
+      if (root->left_) {
+        node_type* left{root->left_};
+        root->left_ = left->right_;
+        left->right_ = root;
+        root = left;
+      } else {
+        *tail = root;
+        tail = &root->right_;
+        root = root->right_;
+      }
+    }
+    return head;
   }
 
-  iterator begin() {
-    if (!root_) {
-      return end();
+  // A tree cut loose during set algebra: root_ is black or null, and
+  // black_height_ counts the black nodes on any path down from it
+  struct Subtree {
+    node_type* root_;
+    size_type black_height_;
+  };
+
+  struct SplitResult {
+    Subtree less_;
+    node_type* match_;
+    Subtree greater_;
+  };
+
+  // Nodes that set algebra drops, as whole subtrees chained through the
+  // roots' parent links. They are destroyed only once all branches are done,
+  // since the pool is not thread safe.
+  struct Discards {
+    void Add(node_type* root) {
+      if (root) {
+        root->SetParent(head_);
+        head_ = root;
+        tail_ = tail_ ? tail_ : root;
+      }
     }
-    node_type* current = root_;
-    while (current->left_) {
-      current = current->left_;
+
+    // Adds a node whose children went elsewhere
+    void AddNode(node_type* node) {
+      node->left_ = nullptr;
+      node->right_ = nullptr;
+      Add(node);
     }
-    return iterator(current, this);
-  }
 
-  iterator end() { return iterator(nullptr, this); }
+    void Splice(const Discards& other) {
+      if (other.head_) {
+        other.tail_->SetParent(head_);
+        head_ = other.head_;
+        tail_ = tail_ ? tail_ : other.tail_;
+      }
+    }
 
-  size_type size() const { return size_; }
+    node_type* head_{nullptr};
+    node_type* tail_{nullptr};
+  };
 
-  const_iterator begin() const {
-    if (!root_) {
-      return end();
+  // Branches whose smaller input has at least this black height, and so
+  // over a thousand nodes, are worth handing to another thread
+  static constexpr size_type kParallelBlackHeight{10};
+
+  template <typename Operation>
+  void SetOperation(RedBlackTree& other, Operation operation) {
+    if (this == &other) {
+      RedBlackTree copy{compare_, get_allocator()};
+      for (const value_type& value : std::as_const(*this)) {
+        copy.emplace(value);
+      }
+      SetOperation(copy, operation);
+      return;
     }
-    node_type* current = root_;
-    while (current->left_) {
-      current = current->left_;
+    if (get_allocator() != other.get_allocator()) {
+      RedBlackTree moved{compare_, get_allocator()};
+      moved.merge_equal(other);
+      SetOperation(moved, operation);
+      return;
+    }
+    pool_.Adopt(other.pool_.Share());
+    size_type total_size{size_ + other.size_};
+    Subtree lhs{TakeWhole()};
+    Subtree rhs{other.TakeWhole()};
+
+    Discards discards;
+    Subtree result{operation(lhs, rhs, discards)};
+    root_ = result.root_;
+    leftmost_ = root_ ? Base::GetMin(root_) : nullptr;
+    rightmost_ = root_ ? Base::GetMax(root_) : nullptr;
+    size_ = total_size;
+    for (node_type* root{discards.head_}; root;) {
+      node_type* next{root->GetParent()};
+      DestroyTree(root);
+      root = next;
     }
-    return const_iterator(current, this);
   }
 
-  const_iterator end() const { return const_iterator(nullptr, this); }
-
-  std::pair<node_type*, bool> insert(const value_type& value) {
-    if (root_ == nullptr) {
-      root_ = CreateNode(value);
-      root_->parent_ = nullptr;
-      root_->color_ = NodeColor::BLACK;
-      ++size_;
-      return {root_, true};
-    }
-    node_type* current = root_;
-    const key_type& inserted_value_key{ExtractKeyFromAmbiguousValue(value)};
-    while (true) {
-      if (inserted_value_key < current->GetKey()) {
-        if (current->left_ == nullptr) {
-          node_type* new_node = CreateNode(value);
-          current->left_ = new_node;
-          new_node->parent_ = current;
-          ++size_;
-          InsertFixup(new_node);
-
-          return {new_node, true};
-        }
-        current = current->left_;
-      } else if (inserted_value_key >= current->GetKey()) {
-        if (current->right_ == nullptr) {
-          node_type* new_node = CreateNode(value);
-          current->right_ = new_node;
-          new_node->parent_ = current;
-          ++size_;
-          InsertFixup(new_node);
-          return {new_node, true};
-        }
-        current = current->right_;
+  Subtree TakeWhole() {
+    Subtree whole{root_, 0};
+    for (node_type* node{root_}; node; node = node->left_) {
+      if (IsRedNode(node) == false) {
+        ++whole.black_height_;
       }
     }
+    root_ = nullptr;
+    leftmost_ = nullptr;
+    rightmost_ = nullptr;
+    size_ = 0;
+    return whole;
   }
 
-  node_type* FindNode(const key_type& key) {
-    node_type* current{root_};
-    node_type* result{nullptr};
-
-    while (current) {
-      if (key < current->GetKey()) {
-        current = current->left_;
-      } else if (key > current->GetKey()) {
-        current = current->right_;
-      } else {
-        result = current;  // Found a match
-        // For multiset, continue searching left subtree
-        // to find first occurrence
-        current = current->left_;
-      }
+  // Runs both branches, on two threads when they are large enough
+  template <typename Left, typename Right>
+  static void MaybeFork(size_type black_height, Left&& left, Right&& right) {
+    if (black_height >= kParallelBlackHeight) {
+      ThreadPool::Instance().Fork(std::forward<Left>(left),
+                                  std::forward<Right>(right));
+    } else {
+      left();
+      right();
     }
-    return result;
   }
 
-  iterator erase(iterator pos) {
-    iterator next{pos};
-    ++next;
-    RemoveNode(pos.current_);
-    return next;
+  // Turns a child into a standalone subtree. A child's black height is
+  // one less than that of its black parent, plus one if it gets repainted.
+  static Subtree Detach(node_type* child, size_type black_height) {
+    if (child == nullptr) {
+      return {nullptr, 0};
+    }
+    child->SetParent(nullptr);
+    if (child->GetColor() == NodeColor::RED) {
+      child->SetColor(NodeColor::BLACK);
+      ++black_height;
+    }
+    return {child, black_height};
   }
 
-  size_type erase(const Key& key) {
-    size_type erased_elements{0};
-    node_type* target;
-    while ((target = FindNode(key)) != nullptr) {
-      RemoveNode(target);
-      ++erased_elements;
+  static void Attach(node_type* node, node_type* left, node_type* right) {
+    node->left_ = left;
+    node->right_ = right;
+    if (left) {
+      left->SetParent(node);
     }
-    return erased_elements;
+    if (right) {
+      right->SetParent(node);
+    }
+    Augment::Update(node);
   }
 
-  void clear() { DeleteSubtree(root_); }
-
-  bool empty() { return size_ == 0; }
-
-  node_type* get_root() const { return root_; }
-
-  RedBlackTree& operator=(const RedBlackTree&) = delete;
+  static bool IsRedNode(const node_type* node) {
+    return node && node->GetColor() == NodeColor::RED;
+  }
 
-  RedBlackTree& operator=(RedBlackTree&& other) noexcept {
-    if (this != &other) {
-      clear();
-      root_ = other.root_;
-      other.root_ = nullptr;
-      size_ = other.size_;
+  // Everything in lhs precedes middle, which precedes everything in rhs.
+  // The shorter tree is hung off the spine of the taller one at equal
+  // black height, then red-red conflicts are rotated away on the way up.
+  Subtree Join(Subtree lhs, node_type* middle, Subtree rhs) {
+    node_type* root{middle};
+    size_type black_height{lhs.black_height_};
+    if (lhs.black_height_ > rhs.black_height_) {
+      root = JoinRight(lhs.root_, lhs.black_height_, middle, rhs);
+    } else if (lhs.black_height_ < rhs.black_height_) {
+      root = JoinLeft(lhs, middle, rhs.root_, rhs.black_height_);
+      black_height = rhs.black_height_;
+    } else {
+      Attach(middle, lhs.root_, rhs.root_);
+      middle->SetColor(NodeColor::RED);
     }
-    return *this;
+    root->SetParent(nullptr);
+    if (root->GetColor() == NodeColor::RED) {
+      root->SetColor(NodeColor::BLACK);
+      ++black_height;
+    }
+    return {root, black_height};
   }
 
-  node_type* GetMax(node_type* us) const {
-    node_type* current = us;
-    while (current->right_ != nullptr) {
-      current = current->right_;
+  node_type* JoinRight(node_type* node, size_type black_height,
+                       node_type* middle, Subtree rhs) {
+    bool is_black{!IsRedNode(node)};
+    if (is_black && black_height == rhs.black_height_) {
+      Attach(middle, node, rhs.root_);
+      middle->SetColor(NodeColor::RED);
+      return middle;
     }
-    return current;
+    node_type* right{
+        JoinRight(node->right_, black_height - is_black, middle, rhs)};
+    Attach(node, node->left_, right);
+    if (is_black && IsRedNode(right) && IsRedNode(right->right_)) {
+      right->right_->SetColor(NodeColor::BLACK);
+      Attach(node, node->left_, right->left_);
+      Attach(right, node, right->right_);
+      return right;
+    }
+    return node;
   }
 
- private:
-  // Helper to get key from value_type
-  const key_type& ExtractKeyFromAmbiguousValue(const value_type& value) const {
-    if constexpr (std::is_same_v<T, void>) {
-      return value;  // For Set: value is the key
-    } else {
-      return value.first;  // For Map: value is a pair
+  node_type* JoinLeft(Subtree lhs, node_type* middle, node_type* node,
+                      size_type black_height) {
+    bool is_black{!IsRedNode(node)};
+    if (is_black && black_height == lhs.black_height_) {
+      Attach(middle, lhs.root_, node);
+      middle->SetColor(NodeColor::RED);
+      return middle;
     }
+    node_type* left{
+        JoinLeft(lhs, middle, node->left_, black_height - is_black)};
+    Attach(node, left, node->right_);
+    if (is_black && IsRedNode(left) && IsRedNode(left->left_)) {
+      left->left_->SetColor(NodeColor::BLACK);
+      Attach(node, left->right_, node->right_);
+      Attach(left, left->left_, node);
+      return left;
+    }
+    return node;
   }
 
-  void RotateLeft(node_type* us) {
-    bool us_is_root{root_ == us};
+  // Join without a middle node, which is taken from the end of lhs
+  Subtree Join2(Subtree lhs, Subtree rhs) {
+    if (lhs.root_ == nullptr) {
+      return rhs;
+    }
+    if (rhs.root_ == nullptr) {
+      return lhs;
+    }
+    auto [rest, last] = SplitLast(lhs);
+    return Join(rest, last, rhs);
+  }
 
-    node_type* right_child{us->right_};
-    node_type* displaced_left_child{right_child->left_};
+  std::pair<Subtree, node_type*> SplitLast(Subtree tree) {
+    node_type* root{tree.root_};
+    Subtree left{Detach(root->left_, tree.black_height_ - 1)};
+    Subtree right{Detach(root->right_, tree.black_height_ - 1)};
+    if (right.root_ == nullptr) {
+      return {left, root};
+    }
+    auto [rest, last] = SplitLast(right);
+    return {Join(left, root, rest), last};
+  }
 
-    // right_child moves up, becoming parent of us
-    right_child->parent_ = us->parent_;
+  // Cuts tree into the keys below key, the node equivalent to it if any,
+  // and the keys above it
+  SplitResult Split(Subtree tree, const key_type& key) {
+    node_type* root{tree.root_};
+    if (root == nullptr) {
+      return {{nullptr, 0}, nullptr, {nullptr, 0}};
+    }
+    Subtree left{Detach(root->left_, tree.black_height_ - 1)};
+    Subtree right{Detach(root->right_, tree.black_height_ - 1)};
+    if (compare_(key, root->GetKey())) {
+      SplitResult result{Split(left, key)};
+      result.greater_ = Join(result.greater_, root, right);
+      return result;
+    }
+    if (compare_(root->GetKey(), key)) {
+      SplitResult result{Split(right, key)};
+      result.less_ = Join(left, root, result.less_);
+      return result;
+    }
+    return {left, root, right};
+  }
 
-    // if we had parent, update its child pointer
-    if (us_is_root == false) {
-      if (IsLeftChild(us)) {
-        us->parent_->left_ = right_child;
+  // Cuts the tree in front of pivot by position, not by key, so that it
+  // also works between equal keys. Climbing from pivot to the root, every
+  // ancestor reached from the left goes with its right subtree into the
+  // rest, and every other one with its left subtree into the part before
+  // pivot. Black heights come from pivot's own and grow on the way up.
+  std::pair<Subtree, Subtree> SplitBefore(node_type* pivot) {
+    size_type black_height{0};
+    for (node_type* node{pivot}; node; node = node->left_) {
+      black_height += !IsRedNode(node);
+    }
+    node_type* parent{pivot->GetParent()};
+    bool from_left{parent && parent->left_ == pivot};
+    size_type below{black_height - !IsRedNode(pivot)};
+    Subtree before{Detach(pivot->left_, below)};
+    Subtree rest{Join({nullptr, 0}, pivot, Detach(pivot->right_, below))};
+    while (parent) {
+      node_type* node{parent};
+      parent = node->GetParent();
+      bool node_from_left{from_left};
+      bool is_black{!IsRedNode(node)};
+      from_left = parent && parent->left_ == node;
+      if (node_from_left) {
+        rest = Join(rest, node, Detach(node->right_, black_height));
       } else {
-        us->parent_->right_ = right_child;
+        before = Join(Detach(node->left_, black_height), node, before);
       }
+      // Join repaints node, so its colour was read beforehand
+      black_height += is_black;
     }
+    return {before, rest};
+  }
 
-    // changing core rotation connections
-    right_child->left_ = us;
-    us->parent_ = right_child;
+  // Descents FindMany runs side by side
+  static constexpr size_type kLookupBatch{16};
 
-    // Reattach the displaced subtree
-    us->right_ = displaced_left_child;
-    if (displaced_left_child) {
-      displaced_left_child->parent_ = us;
-    }
+  // Ranges of at least this many nodes are cut out rather than unlinked
+  static constexpr size_type kCutOutRange{32};
 
-    if (us_is_root) {
-      root_ = right_child;
+  // Erases [first, last), which holds count nodes or at least
+  // kCutOutRange of them. A short range is unlinked node by node. A longer
+  // one is cut out of the tree whole with two splits and a join, in
+  // O(log n), after which its nodes are only destroyed, no rebalancing.
+  void EraseNodes(node_type* first, node_type* last, size_type count) {
+    if (count >= kCutOutRange) {
+      CutOut(first, last);
+      return;
+    }
+    while (first != last) {
+      node_type* next{Successor(first)};
+      RemoveNode(first);
+      first = next;
     }
   }
 
-  void RotateRight(node_type* us) {
-    bool us_is_root{root_ == us};
+  // Erases [first, last), last being null for the end of the tree
+  void CutOut(node_type* first, node_type* last) {
+    auto [before, erased] = SplitBefore(first);
+    Subtree after{nullptr, 0};
+    if (last) {
+      std::tie(erased, after) = SplitBefore(last);
+    }
+    root_ = Join2(before, after).root_;
+    leftmost_ = root_ ? Base::GetMin(root_) : nullptr;
+    rightmost_ = root_ ? Base::GetMax(root_) : nullptr;
+    DestroyTree(erased.root_);
+  }
 
-    node_type* left_child{us->left_};
-    node_type* displaced_right_child{left_child->right_};
+  // The three operations below recurse on the root of one tree and split
+  // the other one at its key; both halves are independent and may fork
 
-    // left_child moves up, becoming parent of us
-    left_child->parent_ = us->parent_;
+  Subtree Union(Subtree lhs, Subtree rhs, Discards& discards) {
+    if (lhs.root_ == nullptr) {
+      return rhs;
+    }
+    if (rhs.root_ == nullptr) {
+      return lhs;
+    }
+    node_type* root{lhs.root_};
+    Subtree lhs_left{Detach(root->left_, lhs.black_height_ - 1)};
+    Subtree lhs_right{Detach(root->right_, lhs.black_height_ - 1)};
+    SplitResult rhs_parts{Split(rhs, root->GetKey())};
+    if (rhs_parts.match_) {
+      discards.AddNode(rhs_parts.match_);
+    }
+    Subtree left{nullptr, 0};
+    Subtree right{nullptr, 0};
+    Discards right_discards;
+    MaybeFork(
+        std::min(lhs.black_height_, rhs.black_height_),
+        [&]() { left = Union(lhs_left, rhs_parts.less_, discards); },
+        [&]() {
+          right = Union(lhs_right, rhs_parts.greater_, right_discards);
+        });
+    discards.Splice(right_discards);
+    return Join(left, root, right);
+  }
 
-    // // if we had parent, update its child pointer
-    if (us_is_root == false) {
-      if (IsLeftChild(us)) {
-        us->parent_->left_ = left_child;
-      } else {
-        us->parent_->right_ = left_child;
-      }
+  Subtree Intersection(Subtree lhs, Subtree rhs, Discards& discards) {
+    if (lhs.root_ == nullptr || rhs.root_ == nullptr) {
+      discards.Add(lhs.root_);
+      discards.Add(rhs.root_);
+      return {nullptr, 0};
     }
+    node_type* root{lhs.root_};
+    Subtree lhs_left{Detach(root->left_, lhs.black_height_ - 1)};
+    Subtree lhs_right{Detach(root->right_, lhs.black_height_ - 1)};
+    SplitResult rhs_parts{Split(rhs, root->GetKey())};
+    Subtree left{nullptr, 0};
+    Subtree right{nullptr, 0};
+    Discards right_discards;
+    MaybeFork(
+        std::min(lhs.black_height_, rhs.black_height_),
+        [&]() { left = Intersection(lhs_left, rhs_parts.less_, discards); },
+        [&]() {
+          right = Intersection(lhs_right, rhs_parts.greater_, right_discards);
+        });
+    discards.Splice(right_discards);
+    if (rhs_parts.match_) {
+      discards.AddNode(rhs_parts.match_);
+      return Join(left, root, right);
+    }
+    discards.AddNode(root);
+    return Join2(left, right);
+  }
 
-    // changing core rotation connections
-    left_child->right_ = us;
-    us->parent_ = left_child;
+  Subtree Difference(Subtree lhs, Subtree rhs, Discards& discards) {
+    if (lhs.root_ == nullptr || rhs.root_ == nullptr) {
+      discards.Add(rhs.root_);
+      return lhs;
+    }
+    node_type* root{rhs.root_};
+    Subtree rhs_left{Detach(root->left_, rhs.black_height_ - 1)};
+    Subtree rhs_right{Detach(root->right_, rhs.black_height_ - 1)};
+    SplitResult lhs_parts{Split(lhs, root->GetKey())};
+    Subtree left{nullptr, 0};
+    Subtree right{nullptr, 0};
+    Discards right_discards;
+    MaybeFork(
+        std::min(lhs.black_height_, rhs.black_height_),
+        [&]() { left = Difference(lhs_parts.less_, rhs_left, discards); },
+        [&]() {
+          right = Difference(lhs_parts.greater_, rhs_right, right_discards);
+        });
+    discards.Splice(right_discards);
+    discards.AddNode(root);
+    if (lhs_parts.match_) {
+      discards.AddNode(lhs_parts.match_);
+    }
+    return Join2(left, right);
+  }
 
-    // Reattach the displaced subtree
-    us->left_ = displaced_right_child;
-    if (displaced_right_child) {
-      displaced_right_child->parent_ = us;
+  // Destroys and frees every node of a detached subtree, which size_
+  // still counted
+  void DestroyTree(node_type* root) {
+    if (root) {
+      DestroyTree(root->left_);
+      DestroyTree(root->right_);
+      DestroyNode(root);
+      --size_;
     }
+  }
 
-    if (us_is_root) {
-      root_ = left_child;
+  // Positions come in as const_iterator but name a node of this tree
+  static node_type* MutableNode(const_iterator pos) {
+    return const_cast<node_type*>(pos.current_);
+  }
+
+  static node_type* Predecessor(node_type* node) {
+    if (node->left_) {
+      node = node->left_;
+      while (node->right_) {
+        node = node->right_;
+      }
+      return node;
+    }
+    while (node->GetParent() && node == node->GetParent()->left_) {
+      node = node->GetParent();
     }
+    return node->GetParent();
   }
 
-  // Helper for creating new node - specialized for Map/Set
-  node_type* CreateNode(const value_type& value) {
-    if constexpr (std::is_same_v<T, void>) {
-      return new node_type(value);  // Set case
-    } else {
-      return new node_type(value.first, value.second);  // Map case
+  static node_type* Successor(node_type* node) {
+    if (node->right_) {
+      node = node->right_;
+      while (node->left_) {
+        node = node->left_;
+      }
+      return node;
+    }
+    while (node->GetParent() && node == node->GetParent()->right_) {
+      node = node->GetParent();
     }
+    return node->GetParent();
+  }
+
+  // Links a detached node into the tree, after any equal keys
+  node_type* InsertNode(node_type* new_node) {
+    return LinkNode(new_node, FindEqualSlot(new_node->GetKey()));
+  }
+
+  void DestroyNode(node_type* node) {
+    node->~node_type();
+    pool_.Deallocate(node);
   }
 
   void RemoveNode(node_type* removal_target) {
+    UnlinkNode(removal_target);
+    DestroyNode(removal_target);
+  }
+
+  // Takes the node out of the tree and rebalances, the node itself is
+  // left alone
+  void UnlinkNode(node_type* removal_target) {
+    Counters::OnRemoval();
     // Case 0: we have to remove the only element
     if (removal_target == root_ && !root_->left_ && !root_->right_) {
-      delete root_;
       root_ = nullptr;
+      leftmost_ = nullptr;
+      rightmost_ = nullptr;
       --size_;
       return;
     }
+    // The minimum has no left child, so its successor is either the
+    // minimum of its right subtree or its parent, and the other way round
+    // for the maximum
+    if (removal_target == leftmost_) {
+      leftmost_ = removal_target->right_ ? Base::GetMin(removal_target->right_)
+                                         : removal_target->GetParent();
+    }
+    if (removal_target == rightmost_) {
+      rightmost_ = removal_target->left_ ? Base::GetMax(removal_target->left_)
+                                         : removal_target->GetParent();
+    }
 
     node_type* replacement{nullptr};    // Node that will take target's position
     node_type* node_to_fixup{nullptr};  // Node that may need RB property fixes
@@ -342,56 +1754,57 @@ class RedBlackTree {
 
     // When removing a node, removed_node_original_color stores the color of the
     // node whose position will be physically empty after all the moves
-    NodeColor removed_node_original_color{removal_target->color_};
+    NodeColor removed_node_original_color{removal_target->GetColor()};
 
     // Case 1: removal_target has at most one child
     if (removal_target->left_ == nullptr) {
       replacement = removal_target->right_;  // replacement might be nullptr
       node_to_fixup = replacement;  // here node_to_fixup IS the replacement
       parent_of_node_to_fixup =
-          removal_target->parent_;  // cause replacement can be nullptr
+          removal_target->GetParent();  // cause replacement can be nullptr
       Transplant(removal_target, replacement);
     } else if (removal_target->right_ == nullptr) {
       replacement = removal_target->left_;
       node_to_fixup = replacement;  // same here
-      parent_of_node_to_fixup = removal_target->parent_;
+      parent_of_node_to_fixup = removal_target->GetParent();
       Transplant(removal_target, replacement);
     }
     // Case 2: removal_target has both children
     else {
-      replacement =
-          GetMin(removal_target->right_);  // successor becomes replacement
+      // The successor becomes the replacement
+      replacement = Base::GetMin(removal_target->right_);
 
       removed_node_original_color =
-          replacement->color_;  // We store successor's color because
+          replacement->GetColor();  // We store successor's color because
       // successor's original position becomes empty
 
       node_to_fixup =
           replacement->right_;  // node_to_fixup is NOT the replacement
 
       //  The replacement (successor) is a direct child of removal target
-      if (replacement->parent_ == removal_target) {
+      if (replacement->GetParent() == removal_target) {
         // parent_of_node_to_fixup becomes the replacement because after
         // restructuring, node_to_fixup will be directly under the replacement
         parent_of_node_to_fixup = replacement;
       }
       // The replacement (successor) is deeper in the right subtree
       else {
-        parent_of_node_to_fixup = replacement->parent_;
+        parent_of_node_to_fixup = replacement->GetParent();
         Transplant(replacement, node_to_fixup);
         // ensuring the successor takes over removed target's connections
         replacement->right_ = removal_target->right_;
-        replacement->right_->parent_ = replacement;
+        replacement->right_->SetParent(replacement);
       }
 
       Transplant(removal_target, replacement);
       replacement->left_ = removal_target->left_;
-      replacement->left_->parent_ = replacement;
-      replacement->color_ = removal_target->color_;
+      replacement->left_->SetParent(replacement);
+      replacement->SetColor(removal_target->GetColor());
     }
 
-    delete removal_target;
     --size_;
+    // Everything that lost a descendant lies on the path up from here
+    UpdatePathToRoot(parent_of_node_to_fixup);
     if (removed_node_original_color == NodeColor::BLACK) {
       RemovalFixup(node_to_fixup, parent_of_node_to_fixup);
     }
@@ -399,6 +1812,7 @@ class RedBlackTree {
 
   void RemovalFixup(node_type* x, node_type* parent_of_x) {
     while (x != root_ && IsBlack(x)) {
+      Counters::OnRemovalFixup();
       node_type* sibling = GetSibling(x, parent_of_x);
 
       // case 4: red sibling
@@ -423,15 +1837,15 @@ class RedBlackTree {
         // case 3: black sibling and both children black
         if (IsBlack(siblings_child_near_to_x) &&
             IsBlack(siblings_child_far_from_x)) {
-          sibling->color_ = NodeColor::RED;
+          sibling->SetColor(NodeColor::RED);
           x = parent_of_x;
-          parent_of_x = parent_of_x->parent_;
+          parent_of_x = parent_of_x->GetParent();
         }
         // red child present
         else {
           // case 5 black sibling and near child red
           if (IsBlack(siblings_child_far_from_x) && siblings_child_near_to_x &&
-              siblings_child_near_to_x->color_ == NodeColor::RED) {
+              siblings_child_near_to_x->GetColor() == NodeColor::RED) {
             SwapColors(sibling, siblings_child_near_to_x);
 
             IsRightChild(sibling) ? RotateRight(sibling) : RotateLeft(sibling);
@@ -447,22 +1861,22 @@ class RedBlackTree {
           SwapColors(parent_of_x, sibling);
           IsRightChild(sibling) ? RotateLeft(parent_of_x)
                                 : RotateRight(parent_of_x);
-          siblings_child_far_from_x->color_ = NodeColor::BLACK;
+          siblings_child_far_from_x->SetColor(NodeColor::BLACK);
           x = root_;
         }
       }
     }
-    x->color_ = NodeColor::BLACK;
+    x->SetColor(NodeColor::BLACK);
   }
 
   void Transplant(node_type* old_node, node_type* new_node) {
     if (IsRoot(old_node)) {
       root_ = new_node;
-      new_node->parent_ = nullptr;
+      new_node->SetParent(nullptr);
       return;
     }
 
-    node_type* father{old_node->parent_};
+    node_type* father{old_node->GetParent()};
     if (IsLeftChild(old_node)) {
       father->left_ = new_node;
     } else {
@@ -470,28 +1884,22 @@ class RedBlackTree {
     }
 
     if (new_node != nullptr) {
-      new_node->parent_ = father;
-    }
-  }
-
-  node_type* GetMin(node_type* us) {
-    node_type* current = us;
-    while (current->left_ != nullptr) {
-      current = current->left_;
+      new_node->SetParent(father);
     }
-    return current;
   }
 
   void InsertFixup(node_type* us) {
     if (IsRoot(us)) {
-      us->color_ = NodeColor::BLACK;
+      us->SetColor(NodeColor::BLACK);
       return;
     }
-    if (us->parent_->color_ == NodeColor::BLACK) {
+    if (us->GetParent()->GetColor() == NodeColor::BLACK) {
       return;
     }
+    // Only a red parent makes for a fixup step worth counting
+    Counters::OnInsertFixup();
     if (GrandFatherExists(us) == false) {
-      us->parent_->color_ = NodeColor::BLACK;
+      us->GetParent()->SetColor(NodeColor::BLACK);
       return;
     }
     // At this point we know:
@@ -499,7 +1907,7 @@ class RedBlackTree {
     // 2. Parent is red
     // 3. Grandfather exists
 
-    node_type* grandfather = us->parent_->parent_;
+    node_type* grandfather = us->GetParent()->GetParent();
 
     if (UncleIsRed(us)) {
       // father and uncle are red
@@ -514,12 +1922,12 @@ class RedBlackTree {
       }
     }
     // Ensure root remains black after any modifications
-    root_->color_ = NodeColor::BLACK;
+    root_->SetColor(NodeColor::BLACK);
   }
 
   void InsertFixupTreatOuterChild(node_type* us) {
-    node_type* father{us->parent_};
-    node_type* grandfather{us->parent_->parent_};
+    node_type* father{us->GetParent()};
+    node_type* grandfather{us->GetParent()->GetParent()};
 
     SwapColors(father, grandfather);
     if (IsLeftChild(father)) {
@@ -530,7 +1938,7 @@ class RedBlackTree {
   }
 
   void InsertFixupTreatInnerChild(node_type* us) {
-    node_type* father{us->parent_};
+    node_type* father{us->GetParent()};
     if (IsLeftChild(father)) {
       RotateLeft(father);
       InsertFixupTreatOuterChild(us->left_);
@@ -541,16 +1949,16 @@ class RedBlackTree {
   }
 
   void SwapColors(node_type* first, node_type* other) {
-    NodeColor temp{first->color_};
-    first->color_ = other->color_;
-    other->color_ = temp;
+    NodeColor temp{first->GetColor()};
+    first->SetColor(other->GetColor());
+    other->SetColor(temp);
   }
 
   bool IsBlack(node_type* x) {
     if (x == nullptr) {
       return true;
     } else {
-      return x->color_ == NodeColor::BLACK;
+      return x->GetColor() == NodeColor::BLACK;
     }
   }
 
@@ -575,7 +1983,7 @@ class RedBlackTree {
 
   bool SiblingIsRed(node_type* us, node_type* parent) {
     node_type* sibling{GetSibling(us, parent)};
-    return sibling && sibling->color_ == NodeColor::RED;
+    return sibling && sibling->GetColor() == NodeColor::RED;
   }
 
   bool SiblingIsBlack(node_type* us, node_type* parent) {
@@ -587,17 +1995,17 @@ class RedBlackTree {
     if (uncle == nullptr) {
       return false;
     }
-    return uncle->color_ == NodeColor::RED;
+    return uncle->GetColor() == NodeColor::RED;
   }
 
   bool IsInnerChild(node_type* us) {
-    node_type* father{us->parent_};
+    node_type* father{us->GetParent()};
     return (IsLeftChild(us) && IsRightChild(father)) ||
            (IsRightChild(us) && IsLeftChild(father));
   }
 
   bool IsLeftChild(node_type* us) {
-    return us->parent_ && (us == us->parent_->left_);
+    return us->GetParent() && (us == us->GetParent()->left_);
   }
   bool IsRightChild(node_type* us) { return !IsLeftChild(us); };
 
@@ -605,58 +2013,275 @@ class RedBlackTree {
     if (us == nullptr) {
       return false;
     }
-    return us->parent_ == nullptr;
+    return us->GetParent() == nullptr;
   }
 
   bool GrandFatherExists(node_type* us) {
-    return us && us->parent_ && us->parent_->parent_;
+    return us && us->GetParent() && us->GetParent()->GetParent();
   }
 
   node_type* GetUncle(node_type* us) {
-    node_type* father{us->parent_};
+    node_type* father{us->GetParent()};
     if (IsLeftChild(father)) {
-      return father->parent_->right_;
+      return father->GetParent()->right_;
     } else {
-      return father->parent_->left_;
+      return father->GetParent()->left_;
     }
   }
 
   void RecolorFatherUncleGrandpa(node_type* us) {
     if (GrandFatherExists(us) == false) {
-      if (us->parent_) {
-        us->parent_->color_ = NodeColor::BLACK;
+      if (us->GetParent()) {
+        us->GetParent()->SetColor(NodeColor::BLACK);
       }
       return;
     }
     node_type* uncle{GetUncle(us)};
-    node_type* father{us->parent_};
-    node_type* grandfather{father->parent_};
+    node_type* father{us->GetParent()};
+    node_type* grandfather{father->GetParent()};
 
-    father->color_ = NodeColor::BLACK;
+    father->SetColor(NodeColor::BLACK);
     if (uncle) {
-      uncle->color_ = NodeColor::BLACK;
+      uncle->SetColor(NodeColor::BLACK);
+    }
+    grandfather->SetColor(NodeColor::RED);
+  }
+
+  // Sortedness can be checked on the input itself only when it can be
+  // traversed twice and yields keys of our own type
+  template <typename InputIt>
+  static constexpr bool kCanPrescan =
+      std::is_convertible_v<
+          typename std::iterator_traits<InputIt>::iterator_category,
+          std::forward_iterator_tag> &&
+      std::is_same_v<std::decay_t<decltype(ExtractKeyFromAmbiguousValue(
+                         *std::declval<InputIt&>()))>,
+                     key_type>;
+
+  template <typename InputIt>
+  void Assign(InputIt first, InputIt last, bool unique_keys) {
+    clear();
+    try {
+      if constexpr (kCanPrescan<InputIt>) {
+        auto [sorted, count] = CountSortedRange(first, last, unique_keys);
+        if (sorted) {
+          BuildFromSortedRange(first, count, unique_keys);
+          return;
+        }
+      }
+      BuildFromUnsortedRange(first, last, unique_keys);
+    } catch (...) {
+      clear();
+      throw;
+    }
+  }
+
+  // Returns whether keys never decrease and how many nodes the range makes
+  template <typename ForwardIt>
+  std::pair<bool, size_type> CountSortedRange(ForwardIt first, ForwardIt last,
+                                              bool unique_keys) const {
+    if (first == last) {
+      return {true, 0};
+    }
+    size_type count{1};
+    for (ForwardIt previous{first}, it{std::next(first)}; it != last;
+         previous = it, ++it) {
+      const key_type& previous_key{ExtractKeyFromAmbiguousValue(*previous)};
+      const key_type& key{ExtractKeyFromAmbiguousValue(*it)};
+      if (compare_(key, previous_key)) {
+        return {false, 0};
+      }
+      if (unique_keys == false || compare_(previous_key, key)) {
+        ++count;
+      }
+    }
+    return {true, count};
+  }
+
+  // Nodes are created straight from the input in key order, no buffer
+  template <typename ForwardIt>
+  void BuildFromSortedRange(ForwardIt first, size_type count,
+                            bool unique_keys) {
+    node_type* previous{nullptr};
+    BuildBalanced(count, [&]() {
+      if (unique_keys && previous) {
+        while (!compare_(previous->GetKey(),
+                         ExtractKeyFromAmbiguousValue(*first))) {
+          ++first;
+        }
+      }
+      previous = CreateNode(*first);
+      ++first;
+      return previous;
+    });
+  }
+
+  template <typename InputIt>
+  void BuildFromUnsortedRange(InputIt first, InputIt last, bool unique_keys) {
+    std::vector<node_type*> nodes;
+    try {
+      for (; first != last; ++first) {
+        nodes.push_back(nullptr);
+        nodes.back() = CreateNode(*first);
+      }
+      auto key_less = [this](const node_type* lhs, const node_type* rhs) {
+        return compare_(lhs->GetKey(), rhs->GetKey());
+      };
+      // Stable, so that equal keys keep their input order
+      if (std::is_sorted(nodes.begin(), nodes.end(), key_less) == false) {
+        std::stable_sort(nodes.begin(), nodes.end(), key_less);
+      }
+    } catch (...) {
+      for (node_type* node : nodes) {
+        if (node) {
+          node->~node_type();
+        }
+      }
+      throw;
+    }
+
+    if (unique_keys) {
+      size_type kept{0};
+      for (node_type* node : nodes) {
+        if (kept != 0 &&
+            !compare_(nodes[kept - 1]->GetKey(), node->GetKey())) {
+          DestroyNode(node);
+        } else {
+          nodes[kept++] = node;
+        }
+      }
+      nodes.resize(kept);
+    }
+
+    BuildBalanced(nodes.size(),
+                  [it = nodes.begin()]() mutable { return *it++; });
+  }
+
+  // Links count nodes, produced in key order by next_node, into a tree
+  // where every level but the deepest is full. Colouring the deepest level
+  // red and everything else black gives equal black heights on all paths.
+  template <typename NextNode>
+  void BuildBalanced(size_type count, NextNode next_node) {
+    size_type deepest_level{0};
+    while ((count >> (deepest_level + 1)) != 0) {
+      ++deepest_level;
+    }
+    root_ = BuildSubtree(count, 0, deepest_level, next_node);
+    if (root_) {
+      root_->SetParent(nullptr);
+    }
+    leftmost_ = root_ ? Base::GetMin(root_) : nullptr;
+    rightmost_ = root_ ? Base::GetMax(root_) : nullptr;
+    size_ = count;
+  }
+
+  template <typename NextNode>
+  node_type* BuildSubtree(size_type count, size_type depth,
+                          size_type deepest_level, NextNode& next_node) {
+    if (count == 0) {
+      return nullptr;
+    }
+    node_type* left{
+        BuildSubtree(count / 2, depth + 1, deepest_level, next_node)};
+    node_type* us{nullptr};
+    node_type* right{nullptr};
+    try {
+      us = next_node();
+      right = BuildSubtree(count - count / 2 - 1, depth + 1, deepest_level,
+                           next_node);
+    } catch (...) {
+      DestroySubtree(left);
+      if (us) {
+        us->~node_type();
+      }
+      throw;
     }
-    grandfather->color_ = NodeColor::RED;
+
+    us->left_ = left;
+    us->right_ = right;
+    if (left) {
+      left->SetParent(us);
+    }
+    if (right) {
+      right->SetParent(us);
+    }
+    bool is_red{depth == deepest_level && depth != 0};
+    us->SetColor(is_red ? NodeColor::RED : NodeColor::BLACK);
+    Augment::Update(us);
+    return us;
+  }
+
+  // Old values are destroyed first, which puts their slots on the pool's
+  // free list, so the copy is built in them before any new slab is taken
+  void CopyFrom(const RedBlackTree& other) {
+    RecycleSubtree(root_);
+    root_ = nullptr;
+    leftmost_ = nullptr;
+    rightmost_ = nullptr;
+    size_ = 0;
+    if (other.root_ == nullptr) {
+      return;
+    }
+    try {
+      root_ = CloneSubtree(other.root_, nullptr);
+    } catch (...) {
+      clear();
+      throw;
+    }
+    leftmost_ = Base::GetMin(root_);
+    rightmost_ = Base::GetMax(root_);
+    size_ = other.size_;
+  }
+
+  // Top-down, each node gets its parent and colour before its children
+  node_type* CloneSubtree(const node_type* source, node_type* parent) {
+    node_type* us{CreateNode(source->data_)};
+    us->SetParent(parent);
+    us->SetColor(source->GetColor());
+    try {
+      if (source->left_) {
+        us->left_ = CloneSubtree(source->left_, us);
+      }
+      if (source->right_) {
+        us->right_ = CloneSubtree(source->right_, us);
+      }
+    } catch (...) {
+      DestroySubtree(us);
+      throw;
+    }
+    Augment::Update(us);
+    return us;
   }
 
-  void DeleteSubtree(node_type* n) {
+  // Destroys the values and hands each slot back to the pool
+  void RecycleSubtree(node_type* n) {
     if (n) {
-      DeleteSubtree(n->left_);
-      DeleteSubtree(n->right_);
-      delete n;
+      RecycleSubtree(n->left_);
+      RecycleSubtree(n->right_);
+      DestroyNode(n);
     }
   }
 
-  node_type* root_;
-  size_type size_;
+  // Runs destructors only, storage is returned with the whole pool
+  void DestroySubtree(node_type* n) {
+    if (n) {
+      DestroySubtree(n->left_);
+      DestroySubtree(n->right_);
+      n->~node_type();
+    }
+  }
+
+  Compare compare_;
+  NodePool<node_type, allocator_type> pool_;
 };
 
-template <typename Key, bool is_const, typename T = void>
+#pragma GCC diagnostic pop
+
+template <typename NodeType, bool is_const>
 class RedBlackTreeIteratorBase {
  protected:
-  using node_type =
-      std::conditional_t<is_const, const Node<Key, T>, Node<Key, T>>;
-  using tree_type = const RedBlackTree<Key, T>;
+  using node_type = std::conditional_t<is_const, const NodeType, NodeType>;
+  using tree_type = const RedBlackTreeBase<NodeType>;
 
   RedBlackTreeIteratorBase() = delete;
   RedBlackTreeIteratorBase(node_type* node, tree_type* tree)
@@ -690,10 +2315,10 @@ class RedBlackTreeIteratorBase {
         current_ = current_->left_;
       }
     } else {
-      node_type* parent = current_->parent_;
+      node_type* parent = current_->GetParent();
       while (parent && current_ == parent->right_) {
         current_ = parent;
-        parent = parent->parent_;
+        parent = parent->GetParent();
       }
       current_ = parent;
     }
@@ -701,7 +2326,7 @@ class RedBlackTreeIteratorBase {
 
   void decrement() {
     if (current_ == nullptr && tree_) {
-      current_ = tree_->GetMax(tree_->get_root());
+      current_ = tree_->get_rightmost();
       return;
     }
     if (current_->left_) {
@@ -710,28 +2335,28 @@ class RedBlackTreeIteratorBase {
         current_ = current_->right_;
       }
     } else {
-      node_type* parent = current_->parent_;
+      node_type* parent = current_->GetParent();
       while (parent && current_ == parent->left_) {
         current_ = parent;
-        parent = current_->parent_;
+        parent = current_->GetParent();
       }
       current_ = parent;
     }
   }
 };
 
-// Map version
-template <typename Key, bool is_const, typename T>
-class RedBlackTreeIterator : public RedBlackTreeIteratorBase<Key, is_const, T> {
+template <typename NodeType, bool is_const>
+class RedBlackTreeIterator
+    : public RedBlackTreeIteratorBase<NodeType, is_const> {
  public:
   using iterator_category = std::bidirectional_iterator_tag;
-  using value_type = std::pair<const Key, T>;
+  using value_type = typename NodeType::value_type;
   using difference_type = std::ptrdiff_t;
   using pointer = std::conditional_t<is_const, const value_type*, value_type*>;
   using reference =
       std::conditional_t<is_const, const value_type&, value_type&>;
 
-  using Base = RedBlackTreeIteratorBase<Key, is_const, T>;
+  using Base = RedBlackTreeIteratorBase<NodeType, is_const>;
   using Base::current_;
 
   // Constructors
@@ -743,10 +2368,10 @@ class RedBlackTreeIterator : public RedBlackTreeIteratorBase<Key, is_const, T> {
   template <bool other_is_const,
             typename = std::enable_if_t<(is_const || !other_is_const)>>
   RedBlackTreeIterator(
-      const RedBlackTreeIterator<Key, other_is_const, T>& other)
+      const RedBlackTreeIterator<NodeType, other_is_const>& other)
       : Base(other.current_, other.get_tree()) {}
 
-  // Specialized dereferencing
+  // Set nodes hold just the key, map nodes hold the pair
   reference operator*() const { return current_->data_; }
 
   pointer operator->() const { return &(current_->data_); }
@@ -763,56 +2388,6 @@ class RedBlackTreeIterator : public RedBlackTreeIteratorBase<Key, is_const, T> {
     return temp;
   }
 
-  RedBlackTreeIterator& operator--() {
-    this->decrement();
-    return *this;
-  }
-  RedBlackTreeIterator operator--(int) {
-    RedBlackTreeIterator temp = *this;
-    this->decrement();
-    return temp;
-  }
-};
-
-// Set version
-template <typename Key, bool is_const>
-class RedBlackTreeIterator<Key, is_const, void>
-    : public RedBlackTreeIteratorBase<Key, is_const, void> {
- public:
-  using iterator_category = std::bidirectional_iterator_tag;
-  using value_type = Key;
-  using difference_type = std::ptrdiff_t;
-  using pointer = std::conditional_t<is_const, const Key*, Key*>;
-  using reference = std::conditional_t<is_const, const Key&, Key&>;
-
-  using Base = RedBlackTreeIteratorBase<Key, is_const, void>;
-  using Base::current_;
-
-  RedBlackTreeIterator() = delete;
-  RedBlackTreeIterator(typename Base::node_type* node,
-                       typename Base::tree_type* tree)
-      : Base(node, tree) {}
-
-  template <bool other_is_const,
-            typename = std::enable_if_t<(is_const || !other_is_const)>>
-  RedBlackTreeIterator(const RedBlackTreeIterator<Key, other_is_const>& other)
-      : Base(other.current_, other.get_tree()) {}
-
-  // Specialized dereferencing
-  reference operator*() const { return current_->data_; }
-  pointer operator->() const { return &(current_->data_); }
-
-  RedBlackTreeIterator& operator++() {
-    this->increment();
-    return *this;
-  }
-
-  RedBlackTreeIterator operator++(int) {
-    RedBlackTreeIterator temp = *this;
-    this->increment();
-    return temp;
-  }
-
   RedBlackTreeIterator& operator--() {
     this->decrement();
     return *this;
@@ -831,8 +2406,9 @@ static constexpr const char* BLACK = "\033[2;37m";
 static constexpr const char* RESET = "\033[0m";
 }  // namespace print_color
 
-template <typename Key, typename T>
-void print_tree_helper(const Node<Key, T>* root, std::string prefix = "",
+template <typename Key, typename T, typename Augment>
+void print_tree_helper(const Node<Key, T, Augment>* root,
+                       std::string prefix = "",
                        std::string child_prefix = "") {
   if (!root) {
     std::cout << print_color::BLACK << prefix << "null" << print_color::RESET
@@ -841,8 +2417,8 @@ void print_tree_helper(const Node<Key, T>* root, std::string prefix = "",
   }
 
   std::cout << prefix;
-  std::cout << (root->color_ == NodeColor::RED ? print_color::RED
-                                               : print_color::BLACK);
+  std::cout << (root->GetColor() == NodeColor::RED ? print_color::RED
+                                                   : print_color::BLACK);
 
   // Handle both Set and Map cases for printing the key
   if constexpr (std::is_same_v<T, void>) {
@@ -851,7 +2427,7 @@ void print_tree_helper(const Node<Key, T>* root, std::string prefix = "",
     std::cout << root->data_.first;  // Map case: data_.first is the key
   }
 
-  std::cout << "(" << (root->color_ == NodeColor::RED ? "R" : "B") << ")"
+  std::cout << "(" << (root->GetColor() == NodeColor::RED ? "R" : "B") << ")"
             << print_color::RESET << "\n";
 
   if (root->right_ || root->left_) {
@@ -866,11 +2442,13 @@ void print_tree_helper(const Node<Key, T>* root, std::string prefix = "",
 }
 
 // Main print function
-template <typename Key, typename T>
-void print_tree(const RedBlackTree<Key, T>& tree) {
+template <typename Key, typename T, typename Compare, typename Allocator,
+          typename Augment, typename Counters>
+void print_tree(
+    const RedBlackTree<Key, T, Compare, Allocator, Augment, Counters>& tree) {
   std::cout << "\nTree contents:\n";
-  print_tree_helper(tree.root_);
-  std::cout << "Size: " << tree.size_ << "\n\n";
+  print_tree_helper(tree.get_root());
+  std::cout << "Size: " << tree.size() << "\n\n";
 }
 
 }  // namespace s21
@@ -3,8 +3,11 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <initializer_list>
 #include <limits>
+#include <memory>
+#include <memory_resource>
 #include <type_traits>
 #include <utility>
 
@@ -16,33 +19,67 @@ namespace s21 {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpadded"
 
-template <typename Key>
+template <typename Key, typename Compare = std::less<Key>,
+          typename Allocator = std::allocator<Key>>
 class set {
+  using tree_type = RedBlackTree<Key, void, Compare, Allocator>;
+
  public:
-  using node_type = Node<Key>;
+  using node_type = typename tree_type::node_type;
   using key_type = Key;
   using value_type = Key;
-  using iterator = RedBlackTreeIterator<Key, false, void>;
-  using const_iterator = RedBlackTreeIterator<Key, true, void>;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
   using size_type = std::size_t;
+  using node_handle = typename tree_type::node_handle;
+
+  struct insert_return_type {
+    iterator position;
+    bool inserted;
+    node_handle node;
+  };
 
   set() : tree_{} {}
 
-  set(std::initializer_list<value_type> const& items) : tree_{} {
-    for (const auto& i : items) {
-      insert(i);
-    }
+  explicit set(const Compare& compare,
+               const allocator_type& alloc = allocator_type())
+      : tree_{compare, alloc} {}
+
+  explicit set(const allocator_type& alloc) : tree_{alloc} {}
+
+  set(std::initializer_list<value_type> const& items,
+      const Compare& compare = Compare(),
+      const allocator_type& alloc = allocator_type())
+      : tree_{compare, alloc} {
+    tree_.assign_unique(items.begin(), items.end());
   }
 
-  set(const set& other) : tree_{} {
-    for (auto it = other.begin(); it != other.end(); ++it) {
-      insert(*it);
-    }
+  set(std::initializer_list<value_type> const& items,
+      const allocator_type& alloc)
+      : set(items, Compare(), alloc) {}
+
+  // O(n) when the range is sorted, O(n log n) otherwise
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  set(InputIt first, InputIt last, const Compare& compare = Compare(),
+      const allocator_type& alloc = allocator_type())
+      : tree_{compare, alloc} {
+    tree_.assign_unique(first, last);
   }
 
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  set(InputIt first, InputIt last, const allocator_type& alloc)
+      : set(first, last, Compare(), alloc) {}
+
+  // O(n), the tree is cloned node for node instead of re-inserted
+  set(const set& other) : tree_(other.tree_) {}
+
   set(set&& other) noexcept : tree_(std::move(other.tree_)) {}
 
-  explicit set(size_type size, value_type value) : tree_{} {
+  explicit set(size_type size, value_type value,
+             const allocator_type& alloc = allocator_type())
+      : tree_{alloc} {
     for (size_type i{0}; i < size; i++) {
       insert(value);
     }
@@ -50,14 +87,29 @@ class set {
 
   ~set() = default;
 
-  set& operator=(set&& other) noexcept {
+  // Reuses the nodes this set already has
+  set& operator=(const set& other) {
+    tree_ = other.tree_;
+    return *this;
+  }
+
+  set& operator=(set&& other) noexcept(
+      std::is_nothrow_move_assignable_v<tree_type>) {
     if (this != &other) {
       tree_ = std::move(other.tree_);
-      other.tree_ = RedBlackTree<key_type>();
     }
     return *this;
   }
 
+  allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+  key_compare key_comp() const { return tree_.key_comp(); }
+
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  void assign(InputIt first, InputIt last) {
+    tree_.assign_unique(first, last);
+  }
+
   iterator begin() { return tree_.begin(); }
   iterator end() { return tree_.end(); }
 
@@ -75,28 +127,43 @@ class set {
   void clear() { tree_.clear(); }
 
   std::pair<iterator, bool> insert(const value_type& value) {
-    // let's try to find first
-    node_type* found{tree_.FindNode(value)};
-    if (found) {
-      return {iterator(found, &tree_), false};
-    } else {
-      auto result = tree_.insert(value);
-      return {iterator(result.first, &tree_), result.second};
-    }
+    return WrapResult(tree_.insert_unique(value));
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return WrapResult(tree_.insert_unique(std::move(value)));
+  }
+
+  // O(1) comparisons when value belongs right before hint, so inserting
+  // keys in ascending order at end() skips the descent altogether
+  iterator insert(const_iterator hint, const value_type& value) {
+    return WrapResult(tree_.insert_unique(hint, value)).first;
+  }
+
+  iterator insert(const_iterator hint, value_type&& value) {
+    return WrapResult(tree_.insert_unique(hint, std::move(value))).first;
+  }
+
+  // Builds the key from args right inside the node
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return WrapResult(tree_.emplace_unique(std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    return WrapResult(
+               tree_.emplace_hint_unique(hint, std::forward<Args>(args)...))
+        .first;
   }
 
   template <typename... Args>
   s21::vector<std::pair<node_type*, bool>> insert_many(Args&&... args) {
     s21::vector<std::pair<node_type*, bool>> results;
     for (const auto& value : {std::forward<Args>(args)...}) {
-      node_type* found{tree_.FindNode(value)};
-      if (found) {
-        continue;
-      } else {
-        auto result = tree_.insert(value);
-        std::pair<node_type*, bool> pair =
-            std::make_pair(result.first, result.second);
-        results.push_back(pair);
+      auto result = tree_.insert_unique(value);
+      if (result.second) {
+        results.push_back(result);
       }
     }
     return results;
@@ -104,20 +171,140 @@ class set {
 
   iterator erase(iterator pos) { return tree_.erase(pos); }
 
-  void swap(set& other) noexcept { std::swap(tree_, other.tree_); }
+  // Erases [first, last) in one walk, see RedBlackTree::erase
+  iterator erase(const_iterator first, const_iterator last) {
+    return tree_.erase(first, last);
+  }
 
-  void merge(set& other) {
-    for (auto it = other.begin(); it != other.end();) {
-      insert(*it);
-      it = other.erase(it);
-    }
+  size_type erase(const key_type& key) { return tree_.erase(key); }
+
+  void swap(set& other) noexcept { tree_.swap(other.tree_); }
+
+  // Relinks other's nodes instead of copying them. Keys already present
+  // here are dropped from other, which always ends up empty.
+  void merge(set& other) { tree_.merge_unique(other.tree_); }
+
+  // The node is unlinked as is, no copy is made and nothing is freed
+  node_handle extract(const_iterator pos) { return tree_.extract(pos); }
+  node_handle extract(const key_type& key) { return tree_.extract(key); }
+
+  // Relinks the handle's node. If the key is taken, the node stays in the
+  // returned handle; an empty handle inserts nothing.
+  insert_return_type insert(node_handle&& handle) {
+    auto [position, inserted] = WrapResult(tree_.insert_handle_unique(handle));
+    return {position, inserted, std::move(handle)};
   }
 
-  iterator find(const key_type& key) {
-    return iterator(tree_.FindNode(key), &tree_);
+  // Every lookup below also has a template overload taking any K, which
+  // exists only for transparent comparators and builds no key_type
+
+  iterator find(const key_type& key) { return tree_.find(key); }
+  const_iterator find(const key_type& key) const { return tree_.find(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator find(const K& key) {
+    return tree_.find(key);
   }
-  bool contains(const key_type& key) {
-    return iterator(tree_.FindNode(key), &tree_) != tree_.end();
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  const_iterator find(const K& key) const {
+    return tree_.find(key);
+  }
+
+  bool contains(const key_type& key) const { return tree_.contains(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  bool contains(const K& key) const {
+    return tree_.contains(key);
+  }
+
+  // Looks up every key of [first, last) and writes, in the same order, an
+  // iterator to each element found or end() to out. Faster than find in a
+  // loop once the set outgrows the cache, see RedBlackTree::FindMany.
+  template <typename ForwardIt, typename OutputIt>
+  OutputIt find_many(ForwardIt first, ForwardIt last, OutputIt out) {
+    tree_.FindMany(first, last, [this, &out](node_type* node) {
+      *out++ = iterator(node, &tree_);
+    });
+    return out;
+  }
+
+  template <typename ForwardIt, typename OutputIt>
+  OutputIt find_many(ForwardIt first, ForwardIt last, OutputIt out) const {
+    tree_.FindMany(first, last, [this, &out](const node_type* node) {
+      *out++ = const_iterator(node, &tree_);
+    });
+    return out;
+  }
+
+  // Writes one bool per key of [first, last) to out, like find_many
+  template <typename ForwardIt, typename OutputIt>
+  OutputIt contains_many(ForwardIt first, ForwardIt last, OutputIt out) const {
+    tree_.FindMany(first, last,
+                   [&out](const node_type* node) { *out++ = node != nullptr; });
+    return out;
+  }
+
+  size_type count(const key_type& key) const { return contains(key); }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  size_type count(const K& key) const {
+    return contains(key);
+  }
+
+  iterator lower_bound(const key_type& key) { return tree_.lower_bound(key); }
+  const_iterator lower_bound(const key_type& key) const {
+    return tree_.lower_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator lower_bound(const K& key) {
+    return tree_.lower_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  const_iterator lower_bound(const K& key) const {
+    return tree_.lower_bound(key);
+  }
+
+  iterator upper_bound(const key_type& key) { return tree_.upper_bound(key); }
+  const_iterator upper_bound(const key_type& key) const {
+    return tree_.upper_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  iterator upper_bound(const K& key) {
+    return tree_.upper_bound(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  const_iterator upper_bound(const K& key) const {
+    return tree_.upper_bound(key);
+  }
+
+  std::pair<iterator, iterator> equal_range(const key_type& key) {
+    return tree_.equal_range(key);
+  }
+  std::pair<const_iterator, const_iterator> equal_range(
+      const key_type& key) const {
+    return tree_.equal_range(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  std::pair<iterator, iterator> equal_range(const K& key) {
+    return tree_.equal_range(key);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+    return tree_.equal_range(key);
+  }
+
+  // Lazy view of the elements with keys in [lo, hi)
+  TreeRange<iterator> range(const key_type& lo, const key_type& hi) {
+    return tree_.range(lo, hi);
+  }
+  TreeRange<const_iterator> range(const key_type& lo,
+                                  const key_type& hi) const {
+    return tree_.range(lo, hi);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  TreeRange<iterator> range(const K& lo, const K& hi) {
+    return tree_.range(lo, hi);
+  }
+  template <typename K, typename C = Compare, typename = RequireTransparent<C>>
+  TreeRange<const_iterator> range(const K& lo, const K& hi) const {
+    return tree_.range(lo, hi);
   }
 
   bool operator==(const set& other) const {
@@ -135,9 +322,50 @@ class set {
   }
 
  private:
-  RedBlackTree<key_type> tree_;
+  template <typename K, typename C, typename A>
+  friend set<K, C, A> set_union(set<K, C, A> lhs, set<K, C, A> rhs);
+  template <typename K, typename C, typename A>
+  friend set<K, C, A> set_intersection(set<K, C, A> lhs, set<K, C, A> rhs);
+  template <typename K, typename C, typename A>
+  friend set<K, C, A> set_difference(set<K, C, A> lhs, set<K, C, A> rhs);
+
+  std::pair<iterator, bool> WrapResult(std::pair<node_type*, bool> result) {
+    return {iterator(result.first, &tree_), result.second};
+  }
+
+  tree_type tree_;
 };
 
+// Set algebra by split and join. The arguments are consumed, so hand them
+// over with std::move when they are no longer needed: then the work is
+// O(m log(n/m + 1)) for sizes m <= n, and large inputs are processed in
+// parallel. Lvalue arguments are copied first.
+template <typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator> set_union(set<Key, Compare, Allocator> lhs,
+                                       set<Key, Compare, Allocator> rhs) {
+  lhs.tree_.union_with(rhs.tree_);
+  return lhs;
+}
+
+template <typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator> set_intersection(
+    set<Key, Compare, Allocator> lhs, set<Key, Compare, Allocator> rhs) {
+  lhs.tree_.intersect_with(rhs.tree_);
+  return lhs;
+}
+
+template <typename Key, typename Compare, typename Allocator>
+set<Key, Compare, Allocator> set_difference(set<Key, Compare, Allocator> lhs,
+                                            set<Key, Compare, Allocator> rhs) {
+  lhs.tree_.subtract(rhs.tree_);
+  return lhs;
+}
+
+namespace pmr {
+template <typename Key, typename Compare = std::less<Key>>
+using set = s21::set<Key, Compare, std::pmr::polymorphic_allocator<Key>>;
+}  // namespace pmr
+
 }  // namespace s21
 
 #endif  // S21_SET_H
@@ -0,0 +1,191 @@
+#ifndef S21_THREAD_POOL_H
+#define S21_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace s21 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Fixed set of worker threads for fork-join parallelism. Fork runs one
+// branch on the calling thread and offers the other one to the workers.
+// While waiting for it, the caller runs queued branches itself, so forks
+// nested inside forked branches never leave the pool blocked.
+class ThreadPool {
+ public:
+  explicit ThreadPool(std::size_t workers = DefaultWorkers())
+      : mutex_{}, wakeup_{}, queue_{}, workers_{} {
+    workers_.reserve(workers);
+    for (std::size_t i{0}; i < workers; ++i) {
+      workers_.emplace_back([this]() { WorkerLoop(); });
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      stopping_ = true;
+    }
+    wakeup_.notify_all();
+    for (std::thread& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  // Shared pool with one worker less than the machine has cores, the
+  // calling thread being the last one
+  static ThreadPool& Instance() {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  std::size_t size() const { return workers_.size(); }
+
+  // Runs left and right, possibly at the same time, and returns once both
+  // are done. An exception from either one is rethrown here, left first.
+  template <typename Left, typename Right>
+  void Fork(Left&& left, Right&& right) {
+    if (workers_.empty()) {
+      left();
+      right();
+      return;
+    }
+    Task task{&Invoke<std::remove_reference_t<Right>>, &right};
+    Push(&task);
+
+    std::exception_ptr left_error;
+    try {
+      left();
+    } catch (...) {
+      left_error = std::current_exception();
+    }
+    if (TakeBack(&task)) {
+      Run(&task);
+    } else {
+      HelpUntilDone(task);
+    }
+
+    if (left_error) {
+      std::rethrow_exception(left_error);
+    }
+    if (task.error_) {
+      std::rethrow_exception(task.error_);
+    }
+  }
+
+ private:
+  struct Task {
+    Task(void (*run)(void*), void* function)
+        : run_{run}, function_{function} {}
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    void (*run_)(void*);
+    void* function_;
+    std::exception_ptr error_{};
+    std::atomic<bool> done_{false};
+  };
+
+  static std::size_t DefaultWorkers() {
+    unsigned cores{std::thread::hardware_concurrency()};
+    return cores > 1 ? cores - 1 : 0;
+  }
+
+  template <typename Function>
+  static void Invoke(void* function) {
+    (*static_cast<Function*>(function))();
+  }
+
+  static void Run(Task* task) noexcept {
+    try {
+      task->run_(task->function_);
+    } catch (...) {
+      task->error_ = std::current_exception();
+    }
+    task->done_.store(true, std::memory_order_release);
+  }
+
+  void Push(Task* task) {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      queue_.push_back(task);
+    }
+    wakeup_.notify_one();
+  }
+
+  // Withdraws task if nobody has started it yet
+  bool TakeBack(Task* task) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto it = std::find(queue_.rbegin(), queue_.rend(), task);
+    if (it == queue_.rend()) {
+      return false;
+    }
+    queue_.erase(std::next(it).base());
+    return true;
+  }
+
+  // Newest task first: it is the smallest and most likely related to the
+  // caller's own data
+  Task* TryPopNewest() {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (queue_.empty()) {
+      return nullptr;
+    }
+    Task* task{queue_.back()};
+    queue_.pop_back();
+    return task;
+  }
+
+  void HelpUntilDone(const Task& task) {
+    while (task.done_.load(std::memory_order_acquire) == false) {
+      if (Task* other = TryPopNewest()) {
+        Run(other);
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  void WorkerLoop() {
+    while (true) {
+      Task* task{nullptr};
+      {
+        std::unique_lock<std::mutex> lock{mutex_};
+        wakeup_.wait(lock,
+                     [this]() { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) {
+          return;
+        }
+        task = queue_.front();
+        queue_.pop_front();
+      }
+      Run(task);
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable wakeup_;
+  std::deque<Task*> queue_;
+  std::vector<std::thread> workers_;
+  bool stopping_{false};
+};
+
+#pragma GCC diagnostic pop
+
+}  // namespace s21
+
+#endif  // S21_THREAD_POOL_H
@@ -0,0 +1,227 @@
+#ifndef S21_TREE_STATS_H
+#define S21_TREE_STATS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "s21_red_black_tree.h"
+
+namespace s21 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Shape of a red-black tree, gathered in one O(n) walk
+struct TreeStats {
+  std::size_t node_count{0};
+  // Nodes on the longest path down from the root
+  std::size_t height{0};
+  // Black nodes on the path down from the root to any null child
+  std::size_t black_height{0};
+  // Nodes at each depth, the root being at depth 0
+  std::vector<std::size_t> depth_histogram{};
+  // Nodes a successful lookup visits, averaged over all keys
+  double average_search_path{0.0};
+};
+
+#pragma GCC diagnostic pop
+
+namespace tree_stats_detail {
+
+template <typename NodeType>
+void CountDepths(const NodeType* node, std::size_t depth, TreeStats& stats) {
+  for (; node; node = node->right_, ++depth) {
+    if (stats.depth_histogram.size() <= depth) {
+      stats.depth_histogram.push_back(0);
+    }
+    ++stats.depth_histogram[depth];
+    CountDepths(node->left_, depth + 1, stats);
+  }
+}
+
+// Black height of the subtree, or nothing when its paths disagree or a
+// red node has a red child. Also checks the links up to parent.
+template <typename NodeType>
+bool CheckSubtree(const NodeType* node, const NodeType* parent,
+                  std::size_t& black_height) {
+  black_height = 0;
+  if (node == nullptr) {
+    return true;
+  }
+  if (node->GetParent() != parent) {
+    return false;
+  }
+  bool is_red{node->GetColor() == NodeColor::RED};
+  for (const NodeType* child : {node->left_, node->right_}) {
+    if (is_red && child && child->GetColor() == NodeColor::RED) {
+      return false;
+    }
+  }
+  std::size_t left_height{0};
+  std::size_t right_height{0};
+  if (!CheckSubtree(node->left_, node, left_height) ||
+      !CheckSubtree(node->right_, node, right_height) ||
+      left_height != right_height) {
+    return false;
+  }
+  black_height = left_height + !is_red;
+  return true;
+}
+
+// In-order walk checking that no key is less than the one before it
+template <typename NodeType, typename Compare>
+bool CheckOrder(const NodeType* node, const Compare& compare,
+                const NodeType*& previous, std::size_t& count) {
+  if (node == nullptr) {
+    return true;
+  }
+  if (!CheckOrder(node->left_, compare, previous, count)) {
+    return false;
+  }
+  if (previous && compare(node->GetKey(), previous->GetKey())) {
+    return false;
+  }
+  previous = node;
+  ++count;
+  return CheckOrder(node->right_, compare, previous, count);
+}
+
+template <typename Key>
+void WriteLabel(std::ostream& out, const Key& key) {
+  std::ostringstream text;
+  text << key;
+  for (char c : text.str()) {
+    if (c == '"' || c == '\\') {
+      out << '\\';
+    }
+    out << c;
+  }
+}
+
+}  // namespace tree_stats_detail
+
+template <typename Key, typename T, typename Compare, typename Allocator,
+          typename Augment, typename Counters>
+TreeStats collect_stats(
+    const RedBlackTree<Key, T, Compare, Allocator, Augment, Counters>& tree) {
+  TreeStats stats;
+  tree_stats_detail::CountDepths(tree.get_root(), 0, stats);
+  std::size_t path_total{0};
+  for (std::size_t depth{0}; depth < stats.depth_histogram.size(); ++depth) {
+    stats.node_count += stats.depth_histogram[depth];
+    path_total += stats.depth_histogram[depth] * (depth + 1);
+  }
+  stats.height = stats.depth_histogram.size();
+  for (auto node = tree.get_root(); node; node = node->left_) {
+    stats.black_height += node->GetColor() == NodeColor::BLACK;
+  }
+  if (stats.node_count != 0) {
+    stats.average_search_path = static_cast<double>(path_total) /
+                                static_cast<double>(stats.node_count);
+  }
+  return stats;
+}
+
+// Checks every invariant the tree relies on in one O(n) walk with no
+// allocations: the red-black rules, parent links, key order, size and
+// the cached ends. Cheap enough to run after every write in a test.
+template <typename Key, typename T, typename Compare, typename Allocator,
+          typename Augment, typename Counters>
+bool is_valid_tree(
+    const RedBlackTree<Key, T, Compare, Allocator, Augment, Counters>& tree) {
+  using node_type = typename RedBlackTree<Key, T, Compare, Allocator, Augment,
+                                          Counters>::node_type;
+  const node_type* root{tree.get_root()};
+  if (root == nullptr) {
+    return tree.size() == 0 && tree.get_leftmost() == nullptr &&
+           tree.get_rightmost() == nullptr;
+  }
+  std::size_t black_height{0};
+  if (root->GetColor() != NodeColor::BLACK ||
+      !tree_stats_detail::CheckSubtree<node_type>(root, nullptr,
+                                                  black_height)) {
+    return false;
+  }
+  const node_type* previous{nullptr};
+  std::size_t count{0};
+  if (!tree_stats_detail::CheckOrder(root, tree.key_comp(), previous,
+                                     count)) {
+    return false;
+  }
+  return count == tree.size() && tree.get_rightmost() == previous &&
+         tree.get_leftmost() == tree.GetMin(tree.get_root());
+}
+
+// Shape and, for trees that keep them, operation counters as one JSON
+// object
+template <typename Key, typename T, typename Compare, typename Allocator,
+          typename Augment, typename Counters>
+void dump_json(
+    const RedBlackTree<Key, T, Compare, Allocator, Augment, Counters>& tree,
+    std::ostream& out) {
+  TreeStats stats{collect_stats(tree)};
+  out << "{\"node_count\":" << stats.node_count
+      << ",\"height\":" << stats.height
+      << ",\"black_height\":" << stats.black_height
+      << ",\"average_search_path\":" << stats.average_search_path
+      << ",\"depth_histogram\":[";
+  for (std::size_t depth{0}; depth < stats.depth_histogram.size(); ++depth) {
+    out << (depth ? "," : "") << stats.depth_histogram[depth];
+  }
+  out << "]";
+  if constexpr (std::is_same_v<Counters, OperationCounters>) {
+    const OperationCounters& counters{tree.get_counters()};
+    out << ",\"counters\":{\"inserts\":" << counters.inserts
+        << ",\"removals\":" << counters.removals
+        << ",\"insert_fixups\":" << counters.insert_fixups
+        << ",\"removal_fixups\":" << counters.removal_fixups
+        << ",\"max_insert_fixups\":" << counters.max_insert_fixups
+        << ",\"max_removal_fixups\":" << counters.max_removal_fixups
+        << ",\"rotations\":" << counters.rotations << "}";
+  }
+  out << "}";
+}
+
+// The tree as a Graphviz digraph, nodes labelled with their keys and
+// filled with their colours. Left edges leave a node from the south-west,
+// right ones from the south-east, so the drawing keeps the two apart.
+template <typename Key, typename T, typename Compare, typename Allocator,
+          typename Augment, typename Counters>
+void dump_graphviz(
+    const RedBlackTree<Key, T, Compare, Allocator, Augment, Counters>& tree,
+    std::ostream& out) {
+  using node_type = typename RedBlackTree<Key, T, Compare, Allocator, Augment,
+                                          Counters>::node_type;
+  out << "digraph RedBlackTree {\n"
+         "  node [shape=circle, style=filled, fontcolor=white];\n";
+  std::vector<const node_type*> pending;
+  if (tree.get_root()) {
+    pending.push_back(tree.get_root());
+  }
+  while (!pending.empty()) {
+    const node_type* node{pending.back()};
+    pending.pop_back();
+    out << "  n" << node << " [label=\"";
+    tree_stats_detail::WriteLabel(out, node->GetKey());
+    out << "\", fillcolor="
+        << (node->GetColor() == NodeColor::RED ? "red" : "black") << "];\n";
+    if (node->left_) {
+      out << "  n" << node << ":sw -> n" << node->left_ << ";\n";
+      pending.push_back(node->left_);
+    }
+    if (node->right_) {
+      out << "  n" << node << ":se -> n" << node->right_ << ";\n";
+      pending.push_back(node->right_);
+    }
+  }
+  out << "}\n";
+}
+
+}  // namespace s21
+
+#endif  // S21_TREE_STATS_H
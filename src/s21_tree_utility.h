@@ -0,0 +1,50 @@
+#ifndef S21_TREE_UTILITY_H
+#define S21_TREE_UTILITY_H
+
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+namespace s21 {
+
+enum class NodeColor : std::int8_t { RED = 0, BLACK = 1 };
+
+// Asks for the cache line at address ahead of use, a no-op for compilers
+// without the builtin. Prefetching never faults, not even on null.
+inline void Prefetch(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(address);
+#else
+  static_cast<void>(address);
+#endif
+}
+
+// Non-owning view of [first, last), walked lazily by range-based for
+template <typename Iterator>
+class TreeRange {
+ public:
+  TreeRange(Iterator first, Iterator last) : first_{first}, last_{last} {}
+
+  Iterator begin() const { return first_; }
+  Iterator end() const { return last_; }
+  bool empty() const { return first_ == last_; }
+
+ private:
+  Iterator first_;
+  Iterator last_;
+};
+
+// Keeps range overloads from hijacking calls like set(5, 3)
+template <typename It>
+using RequireInputIterator = std::enable_if_t<std::is_convertible_v<
+    typename std::iterator_traits<It>::iterator_category,
+    std::input_iterator_tag>>;
+
+// Lookups that pass an arbitrary K through to Compare are only offered
+// when the comparator opts in, the same way std::map does it
+template <typename Compare>
+using RequireTransparent = std::void_t<typename Compare::is_transparent>;
+
+}  // namespace s21
+
+#endif  // S21_TREE_UTILITY_H
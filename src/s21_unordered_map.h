@@ -0,0 +1,287 @@
+#ifndef S21_UNORDERED_MAP_H
+#define S21_UNORDERED_MAP_H
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "s21_hash_table.h"
+#include "s21_tree_utility.h"
+#include "s21_vector.h"
+
+namespace s21 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Hashed counterpart of s21::map: average O(1) lookups and inserts on a
+// flat open-addressing table, see HashTable. Iteration order is
+// unspecified and any insert may rehash, invalidating all iterators.
+// Erase invalidates only iterators to the erased element.
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>,
+          typename Allocator = std::allocator<std::pair<const Key, T>>>
+class unordered_map {
+  using table_type = HashTable<Key, T, Hash, KeyEqual, Allocator>;
+
+ public:
+  using value_type = std::pair<const Key, T>;
+  using key_type = Key;
+  using mapped_type = T;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using allocator_type = Allocator;
+  using iterator = typename table_type::iterator;
+  using const_iterator = typename table_type::const_iterator;
+  using size_type = std::size_t;
+
+  unordered_map() : table_{} {}
+
+  explicit unordered_map(size_type bucket_count, const Hash& hash = Hash(),
+                         const KeyEqual& equal = KeyEqual(),
+                         const allocator_type& alloc = allocator_type())
+      : table_{bucket_count, hash, equal, alloc} {}
+
+  explicit unordered_map(const allocator_type& alloc) : table_{alloc} {}
+
+  unordered_map(std::initializer_list<value_type> const& items,
+                size_type bucket_count = 0, const Hash& hash = Hash(),
+                const KeyEqual& equal = KeyEqual(),
+                const allocator_type& alloc = allocator_type())
+      : unordered_map(items.begin(), items.end(), bucket_count, hash, equal,
+                      alloc) {}
+
+  unordered_map(std::initializer_list<value_type> const& items,
+                const allocator_type& alloc)
+      : unordered_map(items, 0, Hash(), KeyEqual(), alloc) {}
+
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  unordered_map(InputIt first, InputIt last, size_type bucket_count = 0,
+                const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                const allocator_type& alloc = allocator_type())
+      : table_{bucket_count, hash, equal, alloc} {
+    insert(first, last);
+  }
+
+  unordered_map(const unordered_map& other) : table_{other.table_} {}
+  unordered_map(unordered_map&& other) noexcept
+      : table_{std::move(other.table_)} {}
+
+  ~unordered_map() = default;
+
+  unordered_map& operator=(const unordered_map& other) {
+    table_ = other.table_;
+    return *this;
+  }
+
+  unordered_map& operator=(unordered_map&& other) noexcept(
+      std::is_nothrow_move_assignable_v<table_type>) {
+    table_ = std::move(other.table_);
+    return *this;
+  }
+
+  allocator_type get_allocator() const { return table_.get_allocator(); }
+  hasher hash_function() const { return table_.hash_function(); }
+  key_equal key_eq() const { return table_.key_eq(); }
+
+  mapped_type& at(const key_type& key) {
+    iterator it{table_.find(key)};
+    if (it == end()) {
+      throw std::out_of_range("Out of range");
+    }
+    return it->second;
+  }
+
+  const mapped_type& at(const key_type& key) const {
+    return const_cast<unordered_map*>(this)->at(key);
+  }
+
+  // A missing key gets a value-initialized mapped value built in place
+  mapped_type& operator[](const key_type& key) {
+    return table_.try_emplace(key).first->second;
+  }
+
+  mapped_type& operator[](key_type&& key) {
+    return table_.try_emplace(std::move(key)).first->second;
+  }
+
+  iterator begin() { return table_.begin(); }
+  iterator end() { return table_.end(); }
+
+  const_iterator begin() const { return table_.begin(); }
+  const_iterator end() const { return table_.end(); }
+
+  bool empty() const { return table_.empty(); }
+
+  size_type size() const { return table_.size(); }
+
+  size_type max_size() const {
+    return std::numeric_limits<size_type>::max() / sizeof(value_type);
+  }
+
+  void clear() { table_.clear(); }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return table_.insert_unique(value);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return table_.insert_unique(std::move(value));
+  }
+
+  std::pair<iterator, bool> insert(const key_type& key, const T& obj) {
+    return table_.try_emplace(key, obj);
+  }
+
+  std::pair<iterator, bool> insert(const key_type& key, T&& obj) {
+    return table_.try_emplace(key, std::move(obj));
+  }
+
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  void insert(InputIt first, InputIt last) {
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                    typename std::iterator_traits<
+                                        InputIt>::iterator_category>) {
+      table_.reserve(size() + static_cast<size_type>(
+                                  std::distance(first, last)));
+    }
+    for (; first != last; ++first) {
+      table_.insert_unique(*first);
+    }
+  }
+
+  // Builds the pair from args before looking its key up. Prefer
+  // try_emplace when the key is at hand, it builds nothing for a taken
+  // key.
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return table_.emplace_unique(std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+    return table_.try_emplace(key, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+    return table_.try_emplace(std::move(key), std::forward<Args>(args)...);
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+    auto result = table_.try_emplace(key, std::forward<M>(obj));
+    if (result.second == false) {
+      result.first->second = std::forward<M>(obj);
+    }
+    return result;
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj) {
+    auto result = table_.try_emplace(std::move(key), std::forward<M>(obj));
+    if (result.second == false) {
+      result.first->second = std::forward<M>(obj);
+    }
+    return result;
+  }
+
+  // Iterators are looked up once everything is in, so a rehash on the
+  // way leaves none of them dangling
+  template <typename... Args>
+  s21::vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
+    auto values = {std::forward<Args>(args)...};
+    s21::vector<const key_type*> inserted;
+    for (const auto& value : values) {
+      if (table_.insert_unique(value).second) {
+        inserted.push_back(&value.first);
+      }
+    }
+    s21::vector<std::pair<iterator, bool>> results;
+    for (const key_type* key : inserted) {
+      results.push_back(std::make_pair(find(*key), true));
+    }
+    return results;
+  }
+
+  iterator erase(const_iterator pos) { return table_.erase(pos); }
+  iterator erase(iterator pos) { return table_.erase(pos); }
+  size_type erase(const key_type& key) { return table_.erase(key); }
+
+  void swap(unordered_map& other) noexcept { table_.swap(other.table_); }
+
+  // Moves the elements of other over. Keys already present here are
+  // dropped from other, which always ends up empty.
+  void merge(unordered_map& other) { table_.merge_unique(other.table_); }
+
+  iterator find(const key_type& key) { return table_.find(key); }
+  const_iterator find(const key_type& key) const { return table_.find(key); }
+
+  bool contains(const key_type& key) const { return table_.contains(key); }
+
+  size_type count(const key_type& key) const { return contains(key); }
+
+  std::pair<iterator, iterator> equal_range(const key_type& key) {
+    iterator it{find(key)};
+    return {it, it == end() ? it : std::next(it)};
+  }
+
+  std::pair<const_iterator, const_iterator> equal_range(
+      const key_type& key) const {
+    const_iterator it{find(key)};
+    return {it, it == end() ? it : std::next(it)};
+  }
+
+  size_type bucket_count() const { return table_.capacity(); }
+
+  float load_factor() const {
+    return bucket_count() == 0 ? 0.0f
+                               : static_cast<float>(size()) /
+                                     static_cast<float>(bucket_count());
+  }
+
+  // Fixed at 7/8, the table is rebuilt before it fills up any further
+  float max_load_factor() const {
+    return static_cast<float>(table_type::max_load_factor());
+  }
+
+  void rehash(size_type bucket_count) { table_.rehash(bucket_count); }
+
+  void reserve(size_type count) { table_.reserve(count); }
+
+  bool operator==(const unordered_map& other) const {
+    if (size() != other.size()) return false;
+    for (const value_type& value : *this) {
+      const_iterator it{other.find(value.first)};
+      if (it == other.end() || it->second != value.second) return false;
+    }
+    return true;
+  }
+
+  bool operator!=(const unordered_map& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  table_type table_;
+};
+
+#pragma GCC diagnostic pop
+
+namespace pmr {
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+using unordered_map = s21::unordered_map<
+    Key, T, Hash, KeyEqual,
+    std::pmr::polymorphic_allocator<std::pair<const Key, T>>>;
+}  // namespace pmr
+
+}  // namespace s21
+
+#endif  // S21_UNORDERED_MAP_H
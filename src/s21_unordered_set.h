@@ -0,0 +1,210 @@
+#ifndef S21_UNORDERED_SET_H
+#define S21_UNORDERED_SET_H
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+#include "s21_hash_table.h"
+#include "s21_tree_utility.h"
+#include "s21_vector.h"
+
+namespace s21 {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+// Hashed counterpart of s21::set, on the same table as unordered_map
+template <typename Key, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>,
+          typename Allocator = std::allocator<Key>>
+class unordered_set {
+  using table_type = HashTable<Key, void, Hash, KeyEqual, Allocator>;
+
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using allocator_type = Allocator;
+  // Keys are never modified in place, that would lose them in the table
+  using iterator = typename table_type::const_iterator;
+  using const_iterator = typename table_type::const_iterator;
+  using size_type = std::size_t;
+
+  unordered_set() : table_{} {}
+
+  explicit unordered_set(size_type bucket_count, const Hash& hash = Hash(),
+                         const KeyEqual& equal = KeyEqual(),
+                         const allocator_type& alloc = allocator_type())
+      : table_{bucket_count, hash, equal, alloc} {}
+
+  explicit unordered_set(const allocator_type& alloc) : table_{alloc} {}
+
+  unordered_set(std::initializer_list<value_type> const& items,
+                size_type bucket_count = 0, const Hash& hash = Hash(),
+                const KeyEqual& equal = KeyEqual(),
+                const allocator_type& alloc = allocator_type())
+      : unordered_set(items.begin(), items.end(), bucket_count, hash, equal,
+                      alloc) {}
+
+  unordered_set(std::initializer_list<value_type> const& items,
+                const allocator_type& alloc)
+      : unordered_set(items, 0, Hash(), KeyEqual(), alloc) {}
+
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  unordered_set(InputIt first, InputIt last, size_type bucket_count = 0,
+                const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                const allocator_type& alloc = allocator_type())
+      : table_{bucket_count, hash, equal, alloc} {
+    insert(first, last);
+  }
+
+  unordered_set(const unordered_set& other) : table_{other.table_} {}
+  unordered_set(unordered_set&& other) noexcept
+      : table_{std::move(other.table_)} {}
+
+  ~unordered_set() = default;
+
+  unordered_set& operator=(const unordered_set& other) {
+    table_ = other.table_;
+    return *this;
+  }
+
+  unordered_set& operator=(unordered_set&& other) noexcept(
+      std::is_nothrow_move_assignable_v<table_type>) {
+    table_ = std::move(other.table_);
+    return *this;
+  }
+
+  allocator_type get_allocator() const { return table_.get_allocator(); }
+  hasher hash_function() const { return table_.hash_function(); }
+  key_equal key_eq() const { return table_.key_eq(); }
+
+  iterator begin() const { return table_.begin(); }
+  iterator end() const { return table_.end(); }
+
+  bool empty() const { return table_.empty(); }
+
+  size_type size() const { return table_.size(); }
+
+  size_type max_size() const {
+    return std::numeric_limits<size_type>::max() / sizeof(key_type);
+  }
+
+  void clear() { table_.clear(); }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return table_.insert_unique(value);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return table_.insert_unique(std::move(value));
+  }
+
+  template <typename InputIt, typename = RequireInputIterator<InputIt>>
+  void insert(InputIt first, InputIt last) {
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                    typename std::iterator_traits<
+                                        InputIt>::iterator_category>) {
+      table_.reserve(size() + static_cast<size_type>(
+                                  std::distance(first, last)));
+    }
+    for (; first != last; ++first) {
+      table_.insert_unique(*first);
+    }
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return table_.emplace_unique(std::forward<Args>(args)...);
+  }
+
+  // Iterators are looked up once everything is in, so a rehash on the
+  // way leaves none of them dangling
+  template <typename... Args>
+  s21::vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
+    auto values = {std::forward<Args>(args)...};
+    s21::vector<const value_type*> inserted;
+    for (const auto& value : values) {
+      if (table_.insert_unique(value).second) {
+        inserted.push_back(&value);
+      }
+    }
+    s21::vector<std::pair<iterator, bool>> results;
+    for (const value_type* value : inserted) {
+      results.push_back(std::make_pair(find(*value), true));
+    }
+    return results;
+  }
+
+  iterator erase(const_iterator pos) { return table_.erase(pos); }
+  size_type erase(const key_type& key) { return table_.erase(key); }
+
+  void swap(unordered_set& other) noexcept { table_.swap(other.table_); }
+
+  // Moves the keys of other over. Keys already present here are dropped
+  // from other, which always ends up empty.
+  void merge(unordered_set& other) { table_.merge_unique(other.table_); }
+
+  iterator find(const key_type& key) const { return table_.find(key); }
+
+  bool contains(const key_type& key) const { return table_.contains(key); }
+
+  size_type count(const key_type& key) const { return contains(key); }
+
+  std::pair<iterator, iterator> equal_range(const key_type& key) const {
+    iterator it{find(key)};
+    return {it, it == end() ? it : std::next(it)};
+  }
+
+  size_type bucket_count() const { return table_.capacity(); }
+
+  float load_factor() const {
+    return bucket_count() == 0 ? 0.0f
+                               : static_cast<float>(size()) /
+                                     static_cast<float>(bucket_count());
+  }
+
+  // Fixed at 7/8, the table is rebuilt before it fills up any further
+  float max_load_factor() const {
+    return static_cast<float>(table_type::max_load_factor());
+  }
+
+  void rehash(size_type bucket_count) { table_.rehash(bucket_count); }
+
+  void reserve(size_type count) { table_.reserve(count); }
+
+  bool operator==(const unordered_set& other) const {
+    if (size() != other.size()) return false;
+    for (const value_type& value : *this) {
+      if (other.contains(value) == false) return false;
+    }
+    return true;
+  }
+
+  bool operator!=(const unordered_set& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  table_type table_;
+};
+
+#pragma GCC diagnostic pop
+
+namespace pmr {
+template <typename Key, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+using unordered_set = s21::unordered_set<Key, Hash, KeyEqual,
+                                         std::pmr::polymorphic_allocator<Key>>;
+}  // namespace pmr
+
+}  // namespace s21
+
+#endif  // S21_UNORDERED_SET_H
@@ -1,20 +1,27 @@
 #ifndef S21_VECTOR_H
 #define S21_VECTOR_H
 
+#include <algorithm>
 #include <cstring>
 #include <initializer_list>
 #include <iterator>
 #include <limits>
+#include <memory>
+#include <memory_resource>
 
 namespace s21 {
 
 template <typename T, bool is_const>
 class VectorIterator;
 
-template <typename T>
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+
+template <typename T, typename Allocator = std::allocator<T>>
 class vector {
  public:
   using value_type = T;
+  using allocator_type = Allocator;
   using reference = T&;
   using const_reference = const T;
   using iterator = VectorIterator<T, false>;
@@ -23,39 +30,44 @@ class vector {
   using reverse_iterator = std::reverse_iterator<iterator>;
   using size_type = typename std::size_t;
 
-  explicit vector(size_type n = kMinN)
-      : data_{nullptr}, size_{n}, capacity_{n} {
-    if (n > 0) {
-      if (n > max_size()) {
-        throw std::length_error("too much length");
-      }
-      data_ = new value_type[n]();
-    } else {
-      data_ = new value_type[0]();
+  explicit vector(size_type n = kMinN,
+                  const allocator_type& alloc = allocator_type())
+      : allocator_{alloc}, data_{nullptr}, size_{n}, capacity_{n} {
+    if (n > max_size()) {
+      throw std::length_error("too much length");
     }
+    data_ = Allocate(n);
   }
 
+  explicit vector(const allocator_type& alloc) : vector(kMinN, alloc) {}
+
   vector(const vector& other)
-      : data_{other.size_ ? new value_type[other.size_] : nullptr},
+      : allocator_{alloc_traits::select_on_container_copy_construction(
+            other.allocator_)},
+        data_{other.size_ ? Allocate(other.size_) : nullptr},
         size_{other.size_},
         capacity_{other.size_} {
     std::copy(other.data_, other.data_ + size_, data_);
   }
 
   vector(vector&& other) noexcept
-      : data_{other.data_}, size_{other.size_}, capacity_{other.capacity_} {
+      : allocator_{std::move(other.allocator_)},
+        data_{other.data_},
+        size_{other.size_},
+        capacity_{other.capacity_} {
     other.data_ = nullptr;
     other.size_ = 0;
     other.capacity_ = 0;
   }
 
-  explicit vector(size_type size, value_type value)
-      : data_{nullptr}, size_{0}, capacity_{0} {
+  explicit vector(size_type size, value_type value,
+                  const allocator_type& alloc = allocator_type())
+      : allocator_{alloc}, data_{nullptr}, size_{0}, capacity_{0} {
     if (size > 0) {
       if (size > max_size()) {
         throw std::length_error("too much length");
       }
-      data_ = new value_type[size]();
+      data_ = Allocate(size);
       size_ = size;
       capacity_ = size;
 
@@ -65,13 +77,17 @@ class vector {
     }
   }
 
-  explicit vector(std::initializer_list<value_type> init)
-      : data_{new value_type[init.size()]},
+  explicit vector(std::initializer_list<value_type> init,
+                  const allocator_type& alloc = allocator_type())
+      : allocator_{alloc},
+        data_{Allocate(init.size())},
         size_{init.size()},
         capacity_{init.size()} {
     std::copy(init.begin(), init.end(), data_);
   }
-  ~vector() { delete[] data_; }
+  ~vector() { Deallocate(data_, capacity_); }
+
+  allocator_type get_allocator() const { return allocator_; }
 
   reference at(size_type position) const {
     if (position >= size_) {
@@ -111,27 +127,23 @@ class vector {
   }
 
   void clear() {
-    for (size_type i{0}; i < size_; i++) {
-      data_[i].~value_type();
-    }
+    ResetSlots(0, size_);
     size_ = 0;
   }
 
   void resize(size_t n) {
     if (n < size_) {
-      for (size_type i = n; i < size_; i++) {
-        data_[i].~value_type();
-      }
+      ResetSlots(n, size_);
     } else if (n > size_) {
       if (n > capacity_) {
-        value_type* new_data = new value_type[n];
+        value_type* new_data = Allocate(n);
         for (size_type i = 0; i < size_; i++) {
           new_data[i] = std::move(data_[i]);
         }
         for (size_type i = size_; i < n; i++) {
           new_data[i] = value_type();
         }
-        delete[] data_;
+        Deallocate(data_, capacity_);
         data_ = new_data;
         capacity_ = n;
       } else {
@@ -148,11 +160,11 @@ class vector {
       throw std::length_error("too much length");
     }
     if (n > capacity_) {
-      value_type* new_data = new value_type[n];
+      value_type* new_data = Allocate(n);
       for (size_type i{0}; i < size_; i++) {
         new_data[i] = std::move(data_[i]);
       }
-      delete[] data_;
+      Deallocate(data_, capacity_);
 
       data_ = new_data;
       capacity_ = n;
@@ -161,11 +173,11 @@ class vector {
 
   void shrink_to_fit() {
     if (size_ < capacity_) {
-      value_type* new_data = new value_type[size_];
+      value_type* new_data = Allocate(size_);
       for (size_type i{0}; i < size_; i++) {
         new_data[i] = std::move(data_[i]);
       }
-      delete[] data_;
+      Deallocate(data_, capacity_);
       data_ = new_data;
       capacity_ = size_;
     }
@@ -184,10 +196,10 @@ class vector {
     size_++;
   }
 
-  void pop_back() noexcept {
+  void pop_back() {
     if (size_ > 0) {
       --size_;
-      data_[size_].~value_type();
+      ResetSlots(size_, size_ + 1);
     }
   }
 
@@ -196,9 +208,8 @@ class vector {
     size_type index = static_cast<size_type>(std::distance(cbegin(), position));
     resize(size() + 1);
 
-    for (size_type i = size() - 1; i > index; --i) {
-      data_[i] = std::move(data_[i - 1]);
-    }
+    // A single memmove for trivially copyable elements
+    std::move_backward(data_ + index, data_ + size_ - 1, data_ + size_);
     data_[index] = std::forward<U>(value);
 
     return iterator(data_ + index);
@@ -291,9 +302,7 @@ class vector {
       }
     }
 
-    if constexpr (std::is_trivially_destructible_v<value_type> == false) {
-      data_[size_ - 1].~value_type();
-    }
+    ResetSlots(size_ - 1, size_);
 
     --size_;
     return iterator(data_ + index);
@@ -319,17 +328,17 @@ class vector {
       }
     }
 
-    if constexpr (!std::is_trivially_destructible_v<value_type>) {
-      for (size_type i = size_ - count; i < size_; ++i) {
-        data_[i].~value_type();
-      }
-    }
+    ResetSlots(size_ - count, size_);
 
     size_ -= count;
     return iterator(data_ + start_index);
   }
 
   void swap(vector& other) noexcept {
+    if constexpr (alloc_traits::propagate_on_container_swap::value) {
+      std::swap(allocator_, other.allocator_);
+    }
+
     value_type* temp_data = data_;
     data_ = other.data_;
     other.data_ = temp_data;
@@ -345,11 +354,15 @@ class vector {
 
   vector& operator=(const vector& other) {
     if (this != &other) {
-      delete[] data_;
+      Deallocate(data_, capacity_);
+      if constexpr (alloc_traits::propagate_on_container_copy_assignment::
+                        value) {
+        allocator_ = other.allocator_;
+      }
       size_ = other.size_;
       capacity_ = other.capacity_;
       if (capacity_ > 0) {
-        data_ = new value_type[capacity_];
+        data_ = Allocate(capacity_);
         std::copy(other.data_, other.data_ + size_, data_);
       } else {
         data_ = nullptr;
@@ -358,15 +371,29 @@ class vector {
     return *this;
   }
 
-  vector& operator=(vector&& other) noexcept {
+  vector& operator=(vector&& other) noexcept(
+      alloc_traits::propagate_on_container_move_assignment::value ||
+      alloc_traits::is_always_equal::value) {
     if (this != &other) {
-      delete[] data_;
-      data_ = other.data_;
-      size_ = other.size_;
-      capacity_ = other.capacity_;
-      other.data_ = nullptr;
-      other.size_ = 0;
-      other.capacity_ = 0;
+      if constexpr (alloc_traits::propagate_on_container_move_assignment::
+                        value) {
+        Deallocate(data_, capacity_);
+        allocator_ = std::move(other.allocator_);
+        StealStorage(other);
+      } else if (allocator_ == other.allocator_) {
+        Deallocate(data_, capacity_);
+        StealStorage(other);
+      } else {
+        // Storage from a foreign allocator can't be adopted, so move the
+        // elements over one by one instead
+        value_type* new_data = Allocate(other.size_);
+        std::move(other.data_, other.data_ + other.size_, new_data);
+        Deallocate(data_, capacity_);
+        data_ = new_data;
+        size_ = other.size_;
+        capacity_ = other.size_;
+        other.clear();
+      }
     }
     return *this;
   }
@@ -385,12 +412,65 @@ class vector {
   }
 
  private:
+  using alloc_traits = std::allocator_traits<allocator_type>;
+
+  // Storage always holds capacity constructed elements, the same way
+  // new value_type[n] did
+  value_type* Allocate(size_type n) {
+    value_type* data{alloc_traits::allocate(allocator_, n)};
+    size_type constructed{0};
+    try {
+      for (; constructed < n; ++constructed) {
+        alloc_traits::construct(allocator_, data + constructed);
+      }
+    } catch (...) {
+      for (size_type i{0}; i < constructed; ++i) {
+        alloc_traits::destroy(allocator_, data + i);
+      }
+      alloc_traits::deallocate(allocator_, data, n);
+      throw;
+    }
+    return data;
+  }
+
+  void Deallocate(value_type* data, size_type n) {
+    if (data == nullptr) {
+      return;
+    }
+    for (size_type i{0}; i < n; ++i) {
+      alloc_traits::destroy(allocator_, data + i);
+    }
+    alloc_traits::deallocate(allocator_, data, n);
+  }
+
+  // Slots past size_ stay constructed, so removed elements are reset to a
+  // default value instead of being destroyed; trivial types are left as is
+  void ResetSlots(size_type first, size_type last) {
+    if constexpr (std::is_trivially_destructible_v<value_type> == false) {
+      for (size_type i{first}; i < last; ++i) {
+        data_[i] = value_type();
+      }
+    }
+  }
+
+  void StealStorage(vector& other) noexcept {
+    data_ = other.data_;
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.capacity_ = 0;
+  }
+
+  allocator_type allocator_;
   value_type* data_{nullptr};
   size_type size_{kMinN};
   size_type capacity_{kMinN};
   static constexpr size_type kMinN{0};
 };
 
+#pragma GCC diagnostic pop
+
 template <typename T, bool is_const>
 class VectorIterator {
  public:
@@ -414,7 +494,8 @@ class VectorIterator {
 
   operator pointer() const { return ptr_; }
   reference operator[](difference_type n) const { return ptr_[n]; }
-  reference operator*() { return *ptr_; }
+  reference operator*() const { return *ptr_; }
+  pointer operator->() const { return ptr_; }
 
   VectorIterator& operator++() {
     ++ptr_;
@@ -491,9 +572,10 @@ class VectorIterator {
   pointer ptr_;
 };
 
-template <typename T>
-bool operator==(const s21::vector<T>& first, const std::vector<T>& other) {
-  using size_type = typename s21::vector<T>::size_type;
+template <typename T, typename Allocator>
+bool operator==(const s21::vector<T, Allocator>& first,
+                const std::vector<T>& other) {
+  using size_type = typename s21::vector<T, Allocator>::size_type;
 
   if (first.size() != other.size()) {
     return false;
@@ -507,11 +589,17 @@ bool operator==(const s21::vector<T>& first, const std::vector<T>& other) {
   return true;
 }
 
-template <typename T>
-bool operator==(const std::vector<T>& first, const s21::vector<T>& other) {
+template <typename T, typename Allocator>
+bool operator==(const std::vector<T>& first,
+                const s21::vector<T, Allocator>& other) {
   return other == first;
 }
 
+namespace pmr {
+template <typename T>
+using vector = s21::vector<T, std::pmr::polymorphic_allocator<T>>;
+}  // namespace pmr
+
 }  // namespace s21
 
 #endif  // S21_VECTOR_H
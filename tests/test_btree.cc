@@ -0,0 +1,319 @@
+#include "s21_btree.h"
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+#include <gtest/gtest.h>
+#pragma GCC diagnostic pop
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "random.h"
+
+// Walks the whole tree and checks every structural invariant: separators
+// bound their subtrees, counts and subtree sizes add up, parent links and
+// positions match, all leaves sit at one depth and chain in key order
+template <typename Tree>
+class BTreeValidator {
+  using node_type = typename Tree::node_type;
+  using leaf_type = typename Tree::leaf_type;
+  using inner_type = typename Tree::inner_type;
+  using key_type = typename Tree::key_type;
+
+ public:
+  explicit BTreeValidator(const Tree& tree) : tree_{tree} {}
+
+  bool Validate() {
+    const node_type* root{tree_.get_root()};
+    if (root == nullptr) {
+      return tree_.size() == 0 && tree_.begin() == tree_.end();
+    }
+    if (root->parent_ != nullptr || root->size_ != tree_.size()) {
+      return false;
+    }
+    if (!ValidateNode(root, nullptr, nullptr, 0)) {
+      return false;
+    }
+    return ValidateChain();
+  }
+
+ private:
+  bool ValidateNode(const node_type* node, const key_type* lo,
+                    const key_type* hi, std::size_t depth) {
+    auto compare = tree_.key_comp();
+    if (node->leaf_) {
+      if (leaf_depth_ == 0) leaf_depth_ = depth + 1;
+      if (leaf_depth_ != depth + 1) return false;
+      const auto* leaf = static_cast<const leaf_type*>(node);
+      if (leaf->count_ == 0 || leaf->size_ != leaf->count_) return false;
+      leaves_.push_back(leaf);
+      for (std::size_t i{0}; i < leaf->count_; ++i) {
+        const key_type& key{leaf->slots_[i].GetKey()};
+        if (lo != nullptr && compare(key, *lo)) return false;
+        if (hi != nullptr && compare(*hi, key)) return false;
+        if (i > 0 && compare(key, leaf->slots_[i - 1].GetKey())) {
+          return false;
+        }
+      }
+      return true;
+    }
+    const auto* inner = static_cast<const inner_type*>(node);
+    if (inner->count_ == 0) return false;
+    std::size_t size{0};
+    for (std::size_t i{0}; i <= inner->count_; ++i) {
+      const node_type* child{inner->children_[i]};
+      if (child->parent_ != inner || child->position_ != i) return false;
+      const key_type* child_lo{i == 0 ? lo : &inner->keys_[i - 1].value_};
+      const key_type* child_hi{i == inner->count_ ? hi
+                                                  : &inner->keys_[i].value_};
+      if (!ValidateNode(child, child_lo, child_hi, depth + 1)) return false;
+      size += child->size_;
+    }
+    return size == inner->size_;
+  }
+
+  bool ValidateChain() const {
+    for (std::size_t i{0}; i < leaves_.size(); ++i) {
+      const leaf_type* prev{i == 0 ? nullptr : leaves_[i - 1]};
+      const leaf_type* next{i + 1 == leaves_.size() ? nullptr : leaves_[i + 1]};
+      if (leaves_[i]->prev_ != prev || leaves_[i]->next_ != next) return false;
+    }
+    return true;
+  }
+
+  const Tree& tree_;
+  std::vector<const leaf_type*> leaves_{};
+  std::size_t leaf_depth_{0};
+};
+
+template <typename Tree>
+bool ValidateBTree(const Tree& tree) {
+  return BTreeValidator<Tree>{tree}.Validate();
+}
+
+TEST(BTreeTest, EmptyTree) {
+  s21::BTree<int> tree;
+  EXPECT_TRUE(tree.empty());
+  EXPECT_EQ(tree.begin(), tree.end());
+  EXPECT_EQ(tree.find(1), tree.end());
+  EXPECT_EQ(tree.lower_bound(1), tree.end());
+  EXPECT_EQ(tree.nth_element(0), tree.end());
+  EXPECT_EQ(tree.erase_equal(1), size_t{0});
+  EXPECT_TRUE(ValidateBTree(tree));
+}
+
+TEST(BTreeTest, AscendingInsertFillsLeaves) {
+  s21::BTree<int> tree;
+  const int n{5000};
+  for (int i{0}; i < n; ++i) {
+    tree.insert_unique(tree.end(), i);
+  }
+  ASSERT_TRUE(ValidateBTree(tree));
+  EXPECT_EQ(tree.size(), size_t{n});
+  // Appends split off a single element and leave the old leaf full
+  const auto* leftmost =
+      static_cast<const s21::BTree<int>::leaf_type*>(tree.get_root());
+  while (leftmost->leaf_ == false) {
+    leftmost = static_cast<const s21::BTree<int>::leaf_type*>(
+        static_cast<const s21::BTree<int>::inner_type*>(
+            static_cast<const s21::BTree<int>::node_type*>(leftmost))
+            ->children_[0]);
+  }
+  EXPECT_EQ(leftmost->count_, s21::BTree<int>::leaf_type::kSlots);
+  int expected{0};
+  for (int key : tree) {
+    EXPECT_EQ(key, expected++);
+  }
+  expected = n;
+  for (auto it = tree.end(); it != tree.begin();) {
+    EXPECT_EQ(*--it, --expected);
+  }
+}
+
+TEST(BTreeTest, DescendingInsert) {
+  s21::BTree<int> tree;
+  for (int i{3000}; i > 0; --i) {
+    tree.insert_unique(tree.begin(), i);
+  }
+  ASSERT_TRUE(ValidateBTree(tree));
+  EXPECT_EQ(*tree.begin(), 1);
+  EXPECT_EQ(*std::prev(tree.end()), 3000);
+}
+
+TEST(BTreeTest, WrongHintsStillInsertInOrder) {
+  s21::BTree<int> tree;
+  for (int i{0}; i < 2000; ++i) {
+    int key{Random::Get(0, 999)};
+    auto hint = tree.nth_element(
+        static_cast<size_t>(Random::Get(0, static_cast<int>(tree.size()))));
+    tree.emplace_hint_equal(hint, key);
+  }
+  EXPECT_TRUE(ValidateBTree(tree));
+  EXPECT_TRUE(std::is_sorted(tree.begin(), tree.end()));
+}
+
+TEST(BTreeTest, RandomInsertEraseMatchesStdMultiset) {
+  s21::BTree<int> tree;
+  std::multiset<int> reference;
+  for (int round{0}; round < 20000; ++round) {
+    int key{Random::Get(0, 2000)};
+    if (Random::Get(0, 2) != 0) {
+      tree.emplace_equal(key);
+      reference.insert(key);
+    } else {
+      EXPECT_EQ(tree.erase_equal(key), reference.erase(key));
+    }
+    if (round % 997 == 0) {
+      ASSERT_TRUE(ValidateBTree(tree));
+    }
+  }
+  ASSERT_TRUE(ValidateBTree(tree));
+  ASSERT_TRUE(std::equal(tree.begin(), tree.end(), reference.begin(),
+                         reference.end()));
+  for (int key{0}; key <= 2000; key += 7) {
+    EXPECT_EQ(tree.count(key), reference.count(key));
+    EXPECT_EQ(tree.rank(key),
+              static_cast<size_t>(std::distance(reference.begin(),
+                                                reference.lower_bound(key))));
+  }
+  size_t index{0};
+  for (auto it = tree.begin(); it != tree.end(); ++it, ++index) {
+    EXPECT_EQ(tree.index_of(it), index);
+    EXPECT_EQ(tree.nth_element(index), it);
+  }
+}
+
+TEST(BTreeTest, EraseByIteratorReturnsNext) {
+  s21::BTree<int> tree;
+  for (int i{0}; i < 1000; ++i) {
+    tree.insert_unique(i);
+  }
+  auto it = tree.begin();
+  int expected{0};
+  while (it != tree.end()) {
+    EXPECT_EQ(*it, expected);
+    it = tree.erase(it);
+    if (it != tree.end()) {
+      ++it;
+    }
+    expected += 2;
+    ASSERT_TRUE(ValidateBTree(tree));
+  }
+  EXPECT_EQ(tree.size(), size_t{500});
+  for (int key : tree) {
+    EXPECT_EQ(key % 2, 1);
+  }
+}
+
+TEST(BTreeTest, EraseRangeCollapsesTree) {
+  s21::BTree<int> tree;
+  for (int i{0}; i < 4000; ++i) {
+    tree.insert_unique(i);
+  }
+  auto last = tree.erase(tree.find(100), tree.find(3900));
+  EXPECT_EQ(*last, 3900);
+  EXPECT_EQ(tree.size(), size_t{200});
+  ASSERT_TRUE(ValidateBTree(tree));
+  tree.erase(tree.begin(), tree.end());
+  EXPECT_TRUE(tree.empty());
+  EXPECT_EQ(tree.get_root(), nullptr);
+}
+
+TEST(BTreeTest, StringKeysUseBinarySearch) {
+  s21::BTree<std::string, int> tree;
+  std::map<std::string, int> reference;
+  for (int i{0}; i < 3000; ++i) {
+    std::string key{std::to_string(Random::Get(0, 5000))};
+    if (i % 3 == 2) {
+      tree.erase_equal(key);
+      reference.erase(key);
+    } else {
+      tree.try_emplace(key, i);
+      reference.try_emplace(key, i);
+    }
+  }
+  ASSERT_TRUE(ValidateBTree(tree));
+  ASSERT_EQ(tree.size(), reference.size());
+  auto ref = reference.begin();
+  for (const auto& [key, value] : tree) {
+    EXPECT_EQ(key, ref->first);
+    EXPECT_EQ(value, ref->second);
+    ++ref;
+  }
+}
+
+TEST(BTreeTest, GreaterComparator) {
+  s21::BTree<int, void, std::greater<int>> tree;
+  for (int i{0}; i < 1000; ++i) {
+    tree.insert_unique(Random::Get(0, 500));
+  }
+  ASSERT_TRUE(ValidateBTree(tree));
+  EXPECT_TRUE(std::is_sorted(tree.begin(), tree.end(), std::greater<int>{}));
+  EXPECT_EQ(tree.lower_bound(250), tree.find(250) == tree.end()
+                                       ? tree.upper_bound(250)
+                                       : tree.find(250));
+}
+
+TEST(BTreeTest, EqualKeysKeepInsertionOrder) {
+  s21::BTree<int, int> tree;
+  for (int i{0}; i < 600; ++i) {
+    tree.emplace_equal(i % 3, i);
+  }
+  ASSERT_TRUE(ValidateBTree(tree));
+  int previous{-1};
+  for (auto it = tree.lower_bound(1); it != tree.upper_bound(1); ++it) {
+    EXPECT_GT(it->second, previous);
+    previous = it->second;
+  }
+  EXPECT_EQ(tree.count(1), size_t{200});
+}
+
+TEST(BTreeTest, MoveOnlyValues) {
+  s21::BTree<int, std::unique_ptr<int>> tree;
+  for (int i{0}; i < 500; ++i) {
+    tree.try_emplace(i, std::make_unique<int>(i));
+  }
+  for (int i{0}; i < 500; i += 2) {
+    tree.erase_equal(i);
+  }
+  ASSERT_TRUE(ValidateBTree(tree));
+  for (const auto& [key, value] : tree) {
+    EXPECT_EQ(*value, key);
+  }
+}
+
+TEST(BTreeTest, SetAlgebra) {
+  s21::BTree<int> lhs;
+  s21::BTree<int> rhs;
+  for (int i{0}; i < 1000; i += 2) lhs.insert_unique(i);
+  for (int i{0}; i < 1000; i += 3) rhs.insert_unique(i);
+
+  s21::BTree<int> both;
+  both.assign_unique(lhs.begin(), lhs.end());
+  s21::BTree<int> other;
+  other.assign_unique(rhs.begin(), rhs.end());
+  both.intersect_with(other);
+  ASSERT_TRUE(ValidateBTree(both));
+  EXPECT_TRUE(other.empty());
+  for (int key : both) {
+    EXPECT_EQ(key % 6, 0);
+  }
+  EXPECT_EQ(both.size(), size_t{167});
+
+  lhs.subtract(rhs);
+  ASSERT_TRUE(ValidateBTree(lhs));
+  for (int key : lhs) {
+    EXPECT_EQ(key % 2, 0);
+    EXPECT_NE(key % 3, 0);
+  }
+  lhs.union_with(both);
+  ASSERT_TRUE(ValidateBTree(lhs));
+  EXPECT_EQ(lhs.size(), size_t{500});
+}
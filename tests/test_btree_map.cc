@@ -0,0 +1,285 @@
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+#include <gtest/gtest.h>
+#pragma GCC diagnostic pop
+
+#include <iterator>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "dummy_object.h"
+#include "random.h"
+#include "s21_btree_map.h"
+#include "tracking_resource.h"
+
+TEST(BTreeMapTest, InsertAndLookup) {
+  s21::btree_map<int, std::string> m{{3, "c"}, {1, "a"}, {2, "b"}, {1, "x"}};
+  EXPECT_EQ(m.size(), size_t{3});
+  EXPECT_EQ(m.at(1), "a");
+  EXPECT_EQ(m.begin()->first, 1);
+  EXPECT_TRUE(m.contains(3));
+  EXPECT_FALSE(m.contains(4));
+  EXPECT_EQ(m.count(2), size_t{1});
+  EXPECT_THROW(m.at(4), std::out_of_range);
+
+  auto [it, inserted] = m.insert({4, "d"});
+  EXPECT_TRUE(inserted);
+  EXPECT_EQ(it->second, "d");
+  EXPECT_FALSE(m.insert(4, "dd").second);
+  EXPECT_EQ(m.at(4), "d");
+}
+
+TEST(BTreeMapTest, OperatorSubscript) {
+  s21::btree_map<std::string, int> m;
+  m["one"] = 1;
+  m["two"] += 2;
+  ++m["one"];
+  EXPECT_EQ(m.size(), size_t{2});
+  EXPECT_EQ(m["one"], 2);
+  EXPECT_EQ(m.at("two"), 2);
+}
+
+TEST(BTreeMapTest, MatchesStdMap) {
+  s21::btree_map<int, int> m;
+  std::map<int, int> reference;
+  for (int i{0}; i < 20000; ++i) {
+    int key{Random::Get(0, 3000)};
+    switch (Random::Get(0, 3)) {
+      case 0:
+        m.insert_or_assign(key, i);
+        reference.insert_or_assign(key, i);
+        break;
+      case 1:
+        m.try_emplace(m.lower_bound(key), key, i);
+        reference.try_emplace(key, i);
+        break;
+      case 2: {
+        auto it = m.find(key);
+        if (it != m.end()) {
+          auto next = m.erase(it);
+          auto expected = reference.erase(reference.find(key));
+          EXPECT_EQ(next == m.end(), expected == reference.end());
+        }
+        break;
+      }
+      default:
+        m[key] = -i;
+        reference[key] = -i;
+    }
+  }
+  ASSERT_EQ(m.size(), reference.size());
+  auto ref = reference.begin();
+  for (const auto& [key, value] : m) {
+    EXPECT_EQ(key, ref->first);
+    EXPECT_EQ(value, ref->second);
+    ++ref;
+  }
+}
+
+TEST(BTreeMapTest, InsertMany) {
+  s21::btree_map<int, std::string> m{{2, "b"}};
+  auto results = m.insert_many(std::pair<const int, std::string>{1, "a"},
+                               std::pair<const int, std::string>{2, "x"},
+                               std::pair<const int, std::string>{3, "c"});
+  ASSERT_EQ(results.size(), size_t{2});
+  EXPECT_EQ(results[0].first->second, "a");
+  EXPECT_EQ(results[1].first->second, "c");
+  EXPECT_EQ(m.at(2), "b");
+}
+
+TEST(BTreeMapTest, CopyMoveAndSwap) {
+  s21::btree_map<int, DummyObject> m;
+  for (int i{0}; i < 500; ++i) {
+    m.insert(i, DummyObject{i});
+  }
+  s21::btree_map<int, DummyObject> copy{m};
+  EXPECT_TRUE(copy == m);
+
+  s21::btree_map<int, DummyObject> moved{std::move(copy)};
+  EXPECT_TRUE(copy.empty());
+  EXPECT_TRUE(moved == m);
+
+  s21::btree_map<int, DummyObject> other{{1000, DummyObject{1}}};
+  other.swap(moved);
+  EXPECT_EQ(other.size(), size_t{500});
+  EXPECT_EQ(moved.size(), size_t{1});
+
+  moved = std::move(other);
+  EXPECT_TRUE(moved == m);
+}
+
+TEST(BTreeMapTest, Merge) {
+  s21::btree_map<int, std::string> m{{1, "a"}, {3, "c"}};
+  s21::btree_map<int, std::string> other{{2, "b"}, {3, "x"}};
+  m.merge(other);
+  EXPECT_EQ(m.size(), size_t{3});
+  EXPECT_EQ(m.at(3), "c");
+  EXPECT_TRUE(other.empty());
+}
+
+TEST(BTreeMapTest, BoundsAndRange) {
+  s21::btree_map<int, int> m;
+  for (int i{0}; i < 1000; i += 10) {
+    m.insert(m.end(), {i, i});
+  }
+  EXPECT_EQ(m.lower_bound(15)->first, 20);
+  EXPECT_EQ(m.upper_bound(20)->first, 30);
+  EXPECT_EQ(m.lower_bound(991), m.end());
+  auto [first, last] = m.equal_range(50);
+  EXPECT_EQ(std::distance(first, last), 1);
+
+  int expected{100};
+  for (const auto& [key, value] : m.range(100, 200)) {
+    EXPECT_EQ(key, expected);
+    expected += 10;
+  }
+  EXPECT_EQ(expected, 200);
+}
+
+TEST(BTreeMapTest, TransparentLookup) {
+  s21::btree_map<std::string, int, std::less<>> m{{"one", 1}, {"two", 2}};
+  std::string_view key{"two"};
+
+  EXPECT_EQ(m.find(key)->second, 2);
+  EXPECT_TRUE(m.contains(std::string_view{"one"}));
+  EXPECT_EQ(m.count(std::string_view{"three"}), size_t{0});
+  EXPECT_EQ(m.lower_bound(std::string_view{"p"})->first, "two");
+}
+
+TEST(BTreeMapTest, MoveOnlyValues) {
+  s21::btree_map<int, std::unique_ptr<int>> m;
+  for (int i{0}; i < 300; ++i) {
+    m.try_emplace(i, std::make_unique<int>(i));
+  }
+  auto value = std::make_unique<int>(-1);
+  EXPECT_FALSE(m.try_emplace(5, std::move(value)).second);
+  ASSERT_NE(value, nullptr);
+  m.insert_or_assign(5, std::move(value));
+  EXPECT_EQ(*m.at(5), -1);
+  m.emplace(std::piecewise_construct, std::forward_as_tuple(1000),
+            std::forward_as_tuple(new int{1000}));
+  EXPECT_EQ(*m.at(1000), 1000);
+}
+
+TEST(BTreeMapTest, SetAlgebraKeepsLeftValues) {
+  s21::btree_map<int, std::string> lhs{{1, "a"}, {2, "b"}};
+  s21::btree_map<int, std::string> rhs{{2, "x"}, {3, "c"}};
+
+  auto all = s21::set_union(lhs, rhs);
+  EXPECT_EQ(all.size(), size_t{3});
+  EXPECT_EQ(all.at(2), "b");
+
+  auto common = s21::set_intersection(lhs, rhs);
+  EXPECT_EQ(common.size(), size_t{1});
+  EXPECT_EQ(common.at(2), "b");
+
+  auto rest = s21::set_difference(std::move(lhs), std::move(rhs));
+  EXPECT_EQ(rest.size(), size_t{1});
+  EXPECT_EQ(rest.at(1), "a");
+}
+
+TEST(BTreeMapAllocatorTest, UsesFewerAllocationsThanNodes) {
+  TrackingResource resource;
+  {
+    s21::pmr::btree_map<int, DummyObject> m{&resource};
+    for (int i{0}; i < 1000; ++i) {
+      m.insert(i, DummyObject{i});
+    }
+    EXPECT_EQ(m.get_allocator().resource(), &resource);
+    EXPECT_LT(resource.allocations(), size_t{200});
+    m.erase(m.begin());
+    s21::pmr::btree_map<int, DummyObject> copy{m};
+    EXPECT_TRUE(copy == m);
+  }
+  EXPECT_EQ(resource.bytes_in_use(), size_t{0});
+}
+
+TEST(BTreeMapAllocatorTest, MoveAssignBetweenResources) {
+  TrackingResource first_resource;
+  TrackingResource second_resource;
+  {
+    s21::pmr::btree_map<int, int> first({{1, 1}, {2, 2}}, &first_resource);
+    s21::pmr::btree_map<int, int> second({{3, 3}}, &second_resource);
+
+    first = std::move(second);
+    EXPECT_EQ(first.size(), size_t{1});
+    EXPECT_EQ(first.at(3), 3);
+    EXPECT_EQ(first.get_allocator().resource(), &first_resource);
+    EXPECT_EQ(second.size(), size_t{0});
+  }
+  EXPECT_EQ(first_resource.bytes_in_use(), size_t{0});
+  EXPECT_EQ(second_resource.bytes_in_use(), size_t{0});
+}
+
+TEST(BTreeMapAllocatorTest, CopyAssignKeepsResource) {
+  TrackingResource first_resource;
+  TrackingResource second_resource;
+  {
+    s21::pmr::btree_map<int, std::string> first({{1, "a"}}, &first_resource);
+    s21::pmr::btree_map<int, std::string> second(&second_resource);
+    for (int i{0}; i < 500; ++i) {
+      second.insert(i, std::to_string(i) + " is long enough to allocate");
+    }
+
+    first = second;
+    EXPECT_TRUE(first == second);
+    EXPECT_EQ(first.at(1), second.at(1));
+    EXPECT_EQ(first.get_allocator().resource(), &first_resource);
+    first = std::as_const(first);
+    EXPECT_EQ(first.size(), size_t{500});
+  }
+  EXPECT_EQ(first_resource.bytes_in_use(), size_t{0});
+  EXPECT_EQ(second_resource.bytes_in_use(), size_t{0});
+}
+
+TEST(BTreeMapTest, EraseKeyAndRange) {
+  s21::btree_map<int, int> m;
+  std::map<int, int> reference;
+  for (int i{0}; i < 2000; ++i) {
+    m.insert({i, -i});
+    reference.insert({i, -i});
+  }
+  EXPECT_EQ(m.erase(700), size_t{1});
+  EXPECT_EQ(m.erase(700), size_t{0});
+  reference.erase(700);
+  auto next = m.erase(m.find(100), m.find(1500));
+  reference.erase(reference.find(100), reference.find(1500));
+  EXPECT_EQ(next->first, 1500);
+  ASSERT_EQ(m.size(), reference.size());
+  EXPECT_TRUE(std::equal(m.begin(), m.end(), reference.begin(),
+                         [](const auto& lhs, const auto& rhs) {
+                           return lhs.first == rhs.first &&
+                                  lhs.second == rhs.second;
+                         }));
+  auto last = m.erase(m.begin(), m.end());
+  EXPECT_EQ(last, m.end());
+  EXPECT_TRUE(m.empty());
+}
+
+TEST(BTreeMapTest, FindManyKeepsInputOrder) {
+  s21::btree_map<int, std::string> m{{1, "one"}, {2, "two"}, {3, "three"}};
+  std::vector<int> keys{3, 7, 1, 1};
+  std::vector<s21::btree_map<int, std::string>::iterator> found;
+  m.find_many(keys.begin(), keys.end(), std::back_inserter(found));
+  ASSERT_EQ(found.size(), 4u);
+  EXPECT_EQ(found[0]->second, "three");
+  EXPECT_TRUE(found[1] == m.end());
+  EXPECT_TRUE(found[2] == m.begin());
+  found[3]->second = "uno";
+  EXPECT_EQ(m.at(1), "uno");
+
+  const auto& constant = m;
+  std::vector<s21::btree_map<int, std::string>::const_iterator> const_found;
+  constant.find_many(keys.begin(), keys.end(),
+                     std::back_inserter(const_found));
+  EXPECT_TRUE(const_found[1] == constant.end());
+  std::vector<bool> present;
+  m.contains_many(keys.begin(), keys.end(), std::back_inserter(present));
+  EXPECT_EQ(present, (std::vector<bool>{true, false, true, true}));
+}
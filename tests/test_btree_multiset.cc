@@ -0,0 +1,150 @@
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+#include <gtest/gtest.h>
+#pragma GCC diagnostic pop
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "random.h"
+#include "s21_btree_multiset.h"
+#include "tracking_resource.h"
+
+TEST(BTreeMultisetTest, InsertDuplicates) {
+  s21::btree_multiset<int> mset;
+  for (int i{0}; i < 3; ++i) {
+    mset.insert(42);
+  }
+  mset.emplace(7);
+  EXPECT_EQ(mset.count(42), size_t{3});
+  EXPECT_EQ(mset.size(), size_t{4});
+  EXPECT_EQ(*mset.begin(), 7);
+}
+
+TEST(BTreeMultisetTest, SizeValueConstructor) {
+  s21::btree_multiset<int> mset(500, 42);
+  EXPECT_EQ(mset.size(), size_t{500});
+  EXPECT_EQ(mset.count(42), size_t{500});
+  EXPECT_EQ(mset.erase(42), size_t{500});
+  EXPECT_TRUE(mset.empty());
+}
+
+TEST(BTreeMultisetTest, OrderStatisticsMatchStdMultiset) {
+  s21::btree_multiset<int> mset;
+  std::multiset<int> reference;
+  for (int i{0}; i < 20000; ++i) {
+    int key{Random::Get(0, 1000)};
+    if (Random::Get(0, 3) != 0) {
+      mset.insert(key);
+      reference.insert(key);
+    } else {
+      EXPECT_EQ(mset.erase(key), reference.erase(key));
+    }
+  }
+  ASSERT_EQ(mset.size(), reference.size());
+  EXPECT_TRUE(std::equal(mset.begin(), mset.end(), reference.begin(),
+                         reference.end()));
+  for (int key{0}; key <= 1000; key += 11) {
+    EXPECT_EQ(mset.count(key), reference.count(key));
+    EXPECT_EQ(mset.rank(key),
+              static_cast<size_t>(std::distance(reference.begin(),
+                                                reference.lower_bound(key))));
+  }
+  auto ref = reference.begin();
+  for (size_t k{0}; k < mset.size(); k += 37) {
+    EXPECT_EQ(*mset.nth_element(k), *std::next(ref, static_cast<long>(k)));
+  }
+  EXPECT_EQ(mset.nth_element(mset.size()), mset.end());
+  EXPECT_EQ(mset.distance(mset.begin(), mset.end()),
+            static_cast<std::ptrdiff_t>(mset.size()));
+}
+
+TEST(BTreeMultisetTest, HintedInsertAppendsInOrder) {
+  s21::btree_multiset<int> mset;
+  for (int i{0}; i < 1000; ++i) {
+    auto it = mset.insert(mset.end(), i / 3);
+    EXPECT_EQ(*it, i / 3);
+  }
+  EXPECT_TRUE(std::is_sorted(mset.begin(), mset.end()));
+  EXPECT_EQ(mset.count(10), size_t{3});
+}
+
+TEST(BTreeMultisetTest, EqualRangeAndRange) {
+  s21::btree_multiset<int> mset{1, 2, 2, 2, 3, 5, 5};
+  auto [first, last] = mset.equal_range(2);
+  EXPECT_EQ(std::distance(first, last), 3);
+  EXPECT_EQ(*mset.find(5), 5);
+  EXPECT_EQ(mset.find(4), mset.end());
+
+  size_t count{0};
+  for (int key : mset.range(2, 5)) {
+    EXPECT_TRUE(key >= 2 && key < 5);
+    ++count;
+  }
+  EXPECT_EQ(count, size_t{4});
+}
+
+TEST(BTreeMultisetTest, CopyMoveAndMerge) {
+  s21::btree_multiset<std::string> mset{"b", "a", "b"};
+  s21::btree_multiset<std::string> copy{mset};
+  EXPECT_TRUE(copy == mset);
+
+  s21::btree_multiset<std::string> other{"b", "c"};
+  mset.merge(other);
+  EXPECT_TRUE(other.empty());
+  EXPECT_EQ(mset.count("b"), size_t{3});
+
+  s21::btree_multiset<std::string> moved{std::move(mset)};
+  EXPECT_EQ(moved.size(), size_t{5});
+  EXPECT_TRUE(mset.empty());
+  moved.swap(copy);
+  EXPECT_EQ(moved.size(), size_t{3});
+}
+
+TEST(BTreeMultisetTest, CopyAssignKeepsDuplicates) {
+  s21::btree_multiset<int> mset{7, 8};
+  s21::btree_multiset<int> other;
+  for (int i{0}; i < 3000; ++i) {
+    other.insert(i % 10);
+  }
+  mset = other;
+  EXPECT_TRUE(mset == other);
+  EXPECT_EQ(mset.count(3), size_t{300});
+  EXPECT_EQ(mset.count(7), size_t{300});
+}
+
+TEST(BTreeMultisetAllocatorTest, ReleasesEverything) {
+  TrackingResource resource;
+  {
+    s21::pmr::btree_multiset<int> mset{&resource};
+    for (int i{0}; i < 5000; ++i) {
+      mset.insert(i % 100);
+    }
+    while (!mset.empty()) {
+      mset.erase(mset.begin());
+    }
+  }
+  EXPECT_GT(resource.allocations(), size_t{0});
+  EXPECT_EQ(resource.bytes_in_use(), size_t{0});
+}
+
+TEST(BTreeMultisetTest, EraseRangeKeepsDuplicatesOutside) {
+  s21::btree_multiset<int> s;
+  std::multiset<int> reference;
+  for (int i{0}; i < 3000; ++i) {
+    s.insert(i % 500);
+    reference.insert(i % 500);
+  }
+  auto next = s.erase(s.lower_bound(100), s.upper_bound(399));
+  reference.erase(reference.lower_bound(100), reference.upper_bound(399));
+  EXPECT_EQ(*next, 400);
+  ASSERT_EQ(s.size(), reference.size());
+  EXPECT_TRUE(std::equal(s.begin(), s.end(), reference.begin()));
+  EXPECT_EQ(s.count(99), size_t{6});
+  auto last = s.erase(s.begin(), s.end());
+  EXPECT_EQ(last, s.end());
+  EXPECT_TRUE(s.empty());
+}
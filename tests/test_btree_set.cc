@@ -0,0 +1,187 @@
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+#include <gtest/gtest.h>
+#pragma GCC diagnostic pop
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "random.h"
+#include "s21_btree_set.h"
+#include "tracking_resource.h"
+
+template <typename Key>
+class BTreeSetTest : public testing::Test {
+ protected:
+  BTreeSetTest()
+      : stl_set_{103, 53, 73, 106, 57, 102, 46, 104, 53},
+        s21_set_{103, 53, 73, 106, 57, 102, 46, 104, 53} {}
+
+  std::set<Key> stl_set_;
+  s21::btree_set<Key> s21_set_;
+};
+
+using TestedTypes = ::testing::Types<int, double>;
+TYPED_TEST_SUITE(BTreeSetTest, TestedTypes, );
+
+TYPED_TEST(BTreeSetTest, InitializerList) {
+  EXPECT_EQ(this->s21_set_.size(), this->stl_set_.size());
+  EXPECT_TRUE(std::equal(this->s21_set_.begin(), this->s21_set_.end(),
+                         this->stl_set_.begin(), this->stl_set_.end()));
+}
+
+TYPED_TEST(BTreeSetTest, InsertDuplicate) {
+  auto [it, inserted] = this->s21_set_.insert(TypeParam{53});
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(*it, TypeParam{53});
+  EXPECT_TRUE(this->s21_set_.insert(TypeParam{54}).second);
+  EXPECT_EQ(this->s21_set_.size(), size_t{9});
+}
+
+TYPED_TEST(BTreeSetTest, Erase) {
+  auto next = this->s21_set_.erase(this->s21_set_.find(TypeParam{73}));
+  EXPECT_EQ(*next, TypeParam{102});
+  EXPECT_FALSE(this->s21_set_.contains(TypeParam{73}));
+  EXPECT_EQ(this->s21_set_.size(), size_t{7});
+}
+
+TYPED_TEST(BTreeSetTest, Bounds) {
+  EXPECT_EQ(*this->s21_set_.lower_bound(TypeParam{60}), TypeParam{73});
+  EXPECT_EQ(*this->s21_set_.upper_bound(TypeParam{73}), TypeParam{102});
+  EXPECT_EQ(this->s21_set_.upper_bound(TypeParam{106}),
+            this->s21_set_.end());
+}
+
+TEST(BTreeSetNonTyped, MatchesStdSet) {
+  s21::btree_set<int> s;
+  std::set<int> reference;
+  for (int i{0}; i < 20000; ++i) {
+    int key{Random::Get(0, 5000)};
+    if (Random::Get(0, 2) != 0) {
+      s.insert(s.upper_bound(key), key);
+      reference.insert(key);
+    } else {
+      auto it = s.find(key);
+      if (it != s.end()) {
+        s.erase(it);
+      }
+      reference.erase(key);
+    }
+  }
+  EXPECT_EQ(s.size(), reference.size());
+  EXPECT_TRUE(
+      std::equal(s.begin(), s.end(), reference.begin(), reference.end()));
+  for (int key{0}; key <= 5000; key += 13) {
+    EXPECT_EQ(s.contains(key), reference.count(key) == 1);
+  }
+}
+
+TEST(BTreeSetNonTyped, RangeConstructorAndAssign) {
+  std::vector<int> sorted(1000);
+  for (int i{0}; i < 1000; ++i) {
+    sorted[static_cast<size_t>(i)] = i;
+  }
+  s21::btree_set<int> s{sorted.begin(), sorted.end()};
+  EXPECT_EQ(s.size(), size_t{1000});
+
+  std::vector<int> unsorted{5, 3, 9, 3, 1};
+  s.assign(unsorted.begin(), unsorted.end());
+  EXPECT_TRUE(s == s21::btree_set<int>({1, 3, 5, 9}));
+}
+
+TEST(BTreeSetNonTyped, InsertManyReturnsValidIterators) {
+  s21::btree_set<int> s{2};
+  auto results = s.insert_many(1, 2, 3, 4);
+  ASSERT_EQ(results.size(), size_t{3});
+  EXPECT_EQ(*results[0].first, 1);
+  EXPECT_EQ(*results[1].first, 3);
+  EXPECT_EQ(*results[2].first, 4);
+}
+
+TEST(BTreeSetNonTyped, CustomCompareAndTransparentLookup) {
+  s21::btree_set<std::string, std::greater<>> s{"apple", "pear", "fig"};
+  EXPECT_EQ(*s.begin(), "pear");
+  EXPECT_TRUE(s.contains(std::string_view{"fig"}));
+  EXPECT_EQ(*s.lower_bound(std::string_view{"b"}), "apple");
+}
+
+TEST(BTreeSetNonTyped, MergeAndSetAlgebra) {
+  s21::btree_set<int> odd{1, 3, 5, 7};
+  s21::btree_set<int> small{1, 2, 3};
+
+  EXPECT_TRUE(s21::set_union(odd, small) ==
+              s21::btree_set<int>({1, 2, 3, 5, 7}));
+  EXPECT_TRUE(s21::set_intersection(odd, small) ==
+              s21::btree_set<int>({1, 3}));
+  EXPECT_TRUE(s21::set_difference(odd, small) ==
+              s21::btree_set<int>({5, 7}));
+
+  odd.merge(small);
+  EXPECT_EQ(odd.size(), size_t{5});
+  EXPECT_TRUE(small.empty());
+}
+
+TEST(BTreeSetNonTyped, CopyAssign) {
+  s21::btree_set<int, std::greater<int>> s{1, 2, 3};
+  s21::btree_set<int, std::greater<int>> other;
+  for (int i{0}; i < 1000; ++i) {
+    other.insert(i);
+  }
+  s = other;
+  EXPECT_TRUE(s == other);
+  EXPECT_EQ(*s.begin(), 999);
+  other.clear();
+  EXPECT_EQ(s.size(), size_t{1000});
+  s = other;
+  EXPECT_TRUE(s.empty());
+}
+
+TEST(BTreeSetAllocatorTest, ReleasesEverything) {
+  TrackingResource resource;
+  {
+    s21::pmr::btree_set<std::string> s{&resource};
+    for (int i{0}; i < 500; ++i) {
+      s.emplace(std::to_string(i) + " is a long enough string to allocate");
+    }
+    s.erase(s.begin());
+    EXPECT_EQ(s.size(), size_t{499});
+  }
+  EXPECT_GT(resource.allocations(), size_t{0});
+  EXPECT_EQ(resource.bytes_in_use(), size_t{0});
+}
+
+TEST(BTreeSetNonTyped, EraseKeyAndRange) {
+  s21::btree_set<int> s;
+  for (int i{0}; i < 2000; ++i) {
+    s.insert(i);
+  }
+  EXPECT_EQ(s.erase(3), size_t{1});
+  EXPECT_EQ(s.erase(3), size_t{0});
+  auto next = s.erase(s.find(2), s.find(1900));
+  EXPECT_EQ(*next, 1900);
+  EXPECT_EQ(s.size(), size_t{102});
+  EXPECT_EQ(*std::next(s.begin(), 2), 1900);
+  auto last = s.erase(s.begin(), s.end());
+  EXPECT_EQ(last, s.end());
+  EXPECT_TRUE(s.empty());
+}
+
+TEST(BTreeSetNonTyped, FindManyKeepsInputOrder) {
+  s21::btree_set<std::string> s{"apple", "banana", "cherry"};
+  std::vector<std::string> keys{"cherry", "kiwi", "apple", "apple"};
+  std::vector<s21::btree_set<std::string>::iterator> found;
+  s.find_many(keys.begin(), keys.end(), std::back_inserter(found));
+  ASSERT_EQ(found.size(), 4u);
+  EXPECT_EQ(*found[0], "cherry");
+  EXPECT_TRUE(found[1] == s.end());
+  EXPECT_TRUE(found[2] == s.begin());
+  EXPECT_TRUE(found[3] == s.begin());
+  std::vector<bool> present;
+  s.contains_many(keys.begin(), keys.end(), std::back_inserter(present));
+  EXPECT_EQ(present, (std::vector<bool>{true, false, true, true}));
+}
@@ -0,0 +1,150 @@
+#include "s21_concurrent_map.h"
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+#include <gtest/gtest.h>
+#pragma GCC diagnostic pop
+
+#include <chrono>
+#include <iterator>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "random.h"
+
+TEST(ConcurrentMapTest, BasicOperations) {
+  s21::concurrent_map<int, std::string> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_TRUE(map.insert({1, "one"}));
+  EXPECT_FALSE(map.insert(1, "uno"));
+  EXPECT_TRUE(map.try_emplace(2, 3, 'x'));
+  EXPECT_TRUE(map.insert_or_assign(3, "three"));
+  EXPECT_FALSE(map.insert_or_assign(3, "tres"));
+
+  EXPECT_EQ(map.find(1), "one");
+  EXPECT_EQ(map.find(2), "xxx");
+  EXPECT_EQ(map.find(3), "tres");
+  EXPECT_FALSE(map.find(4).has_value());
+  EXPECT_TRUE(map.contains(2));
+  EXPECT_EQ(map.count(4), 0u);
+  EXPECT_EQ(map.size(), 3u);
+
+  EXPECT_EQ(map.erase(2), 1u);
+  EXPECT_EQ(map.erase(2), 0u);
+  EXPECT_EQ(map.size(), 2u);
+  map.clear();
+  EXPECT_TRUE(map.empty());
+}
+
+TEST(ConcurrentMapTest, UpdateInPlace) {
+  s21::concurrent_map<int, std::vector<int>> map;
+  map.insert(7, {});
+  EXPECT_TRUE(map.update(7, [](std::vector<int>& v) { v.push_back(1); }));
+  EXPECT_FALSE(map.update(8, [](std::vector<int>&) { FAIL(); }));
+  EXPECT_EQ(map.find(7)->size(), 1u);
+}
+
+TEST(ConcurrentMapTest, KeysSpreadOverShards) {
+  s21::concurrent_map<int, int, 8> map;
+  for (int i = 0; i < 8000; i += 8) map.insert(i, i);
+  std::size_t seen{0};
+  map.for_each_shard([&seen](const auto& shard) {
+    EXPECT_GT(shard.size(), 0u);
+    seen += shard.size();
+    for (const auto& [key, value] : shard) {
+      EXPECT_EQ(key, value);
+    }
+  });
+  EXPECT_EQ(seen, 1000u);
+  for (int i = 0; i < 8000; i += 8) {
+    EXPECT_LT(map.shard_of(i), map.shard_count());
+  }
+}
+
+TEST(ConcurrentMapTest, ForEachShardCanWrite) {
+  s21::concurrent_map<int, int, 4> map;
+  for (int i = 0; i < 100; ++i) map.insert(i, i);
+  map.for_each_shard([](auto& shard) {
+    for (auto& [key, value] : shard) value = -key;
+  });
+  EXPECT_EQ(map.find(42), -42);
+}
+
+TEST(ConcurrentMapTest, OrderedViewMergesShards) {
+  s21::concurrent_map<int, int, 5> map;
+  std::map<int, int> reference;
+  for (int i = 0; i < 2000; ++i) {
+    int key = Random::Get(-5000, 5000);
+    map.insert(key, i);
+    reference.emplace(key, i);
+  }
+  auto view = map.lock_ordered();
+  EXPECT_EQ(view.size(), reference.size());
+  EXPECT_EQ(static_cast<std::size_t>(std::distance(view.begin(), view.end())),
+            reference.size());
+  auto it = view.begin();
+  for (const auto& [key, value] : reference) {
+    ASSERT_NE(it, view.end());
+    EXPECT_EQ(it->first, key);
+    EXPECT_EQ(it->second, value);
+    ++it;
+  }
+  EXPECT_EQ(it, view.end());
+}
+
+TEST(ConcurrentMapTest, OrderedViewOfEmptyMap) {
+  s21::concurrent_map<int, int> map;
+  auto view = map.lock_ordered();
+  EXPECT_EQ(view.begin(), view.end());
+}
+
+TEST(ConcurrentMapTest, OrderedViewHoldsOffWriters) {
+  s21::concurrent_map<int, int, 1> map;
+  map.insert(1, 1);
+  std::thread writer;
+  {
+    auto view = map.lock_ordered();
+    writer = std::thread{[&map]() { map.insert(0, 0); }};
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(view.begin()->first, 1);
+    EXPECT_EQ(view.size(), 1u);
+  }
+  writer.join();
+  EXPECT_EQ(map.size(), 2u);
+}
+
+TEST(ConcurrentMapTest, ConcurrentWritersAndReaders) {
+  constexpr int kThreads{4};
+  constexpr int kPerThread{2000};
+  s21::concurrent_map<int, long> map;
+  for (int i = 0; i < 100; ++i) map.insert(i, 0);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&map, t]() {
+      for (int i = 0; i < kPerThread; ++i) {
+        map.insert(1000 + t * kPerThread + i, i);
+        map.update(i % 100, [](long& counter) { ++counter; });
+        map.contains(i);
+        if (i % 2 == 1) map.erase(1000 + t * kPerThread + i);
+      }
+    });
+  }
+  threads.emplace_back([&map]() {
+    for (int i = 0; i < 20; ++i) {
+      auto view = map.lock_ordered();
+      int previous{-1};
+      for (const auto& [key, value] : view) {
+        EXPECT_LT(previous, key);
+        previous = key;
+      }
+    }
+  });
+  for (std::thread& thread : threads) thread.join();
+
+  long total{0};
+  for (int i = 0; i < 100; ++i) total += *map.find(i);
+  EXPECT_EQ(total, long{kThreads} * kPerThread);
+  EXPECT_EQ(map.size(), 100u + kThreads * kPerThread / 2);
+}
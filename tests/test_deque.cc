@@ -9,6 +9,7 @@
 #include "dummy_object.h"
 #include "random.h"
 #include "s21_deque.h"
+#include "tracking_resource.h"
 
 template <typename T>
 class DequeTest : public testing::Test {
@@ -762,3 +763,51 @@ TEST(DequeTest, MoveAssignmentOperator) {
   EXPECT_EQ(moved.size(), size_t{0});
   EXPECT_THROW(moved.at(0), std::out_of_range);
 }
+
+TEST(DequeAllocatorTest, ArenaBacked) {
+  std::byte buffer[32768];
+  std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer),
+                                            std::pmr::null_memory_resource()};
+  s21::pmr::deque<int> d{&arena};
+  for (int i{0}; i < 2000; ++i) {
+    d.push_back(i);
+    d.push_front(-i);
+  }
+
+  EXPECT_EQ(d.size(), size_t{4000});
+  EXPECT_EQ(d.front(), -1999);
+  EXPECT_EQ(d.back(), 1999);
+}
+
+TEST(DequeAllocatorTest, ReleasesEverything) {
+  TrackingResource resource;
+  {
+    s21::pmr::deque<DummyObject> d({DummyObject{1}, DummyObject{2}},
+                                   &resource);
+    for (int i{0}; i < 100; ++i) {
+      d.push_front(DummyObject{i});
+    }
+    s21::pmr::deque<DummyObject> copy{d};
+    EXPECT_EQ(copy.size(), d.size());
+    EXPECT_EQ(copy.back(), DummyObject{2});
+  }
+  EXPECT_GT(resource.allocations(), size_t{0});
+  EXPECT_EQ(resource.bytes_in_use(), size_t{0});
+}
+
+TEST(DequeAllocatorTest, MoveAssignBetweenResources) {
+  TrackingResource first_resource;
+  TrackingResource second_resource;
+  {
+    s21::pmr::deque<int> first({1, 2, 3}, &first_resource);
+    s21::pmr::deque<int> second({4, 5}, &second_resource);
+
+    first = std::move(second);
+    EXPECT_EQ(first.size(), size_t{2});
+    EXPECT_EQ(first.back(), 5);
+    EXPECT_EQ(first.get_allocator().resource(), &first_resource);
+    EXPECT_EQ(second.size(), size_t{0});
+  }
+  EXPECT_EQ(first_resource.bytes_in_use(), size_t{0});
+  EXPECT_EQ(second_resource.bytes_in_use(), size_t{0});
+}
@@ -0,0 +1,277 @@
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+#include <gtest/gtest.h>
+#pragma GCC diagnostic pop
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "dummy_object.h"
+#include "random.h"
+#include "s21_flat_map.h"
+#include "tracking_resource.h"
+
+TEST(FlatMapTest, InsertAndLookup) {
+  s21::flat_map<int, std::string> m{{3, "c"}, {1, "a"}, {2, "b"}, {1, "x"}};
+  EXPECT_EQ(m.size(), size_t{3});
+  EXPECT_EQ(m.at(1), "a");
+  EXPECT_EQ(m.begin()->first, 1);
+  EXPECT_TRUE(m.contains(3));
+  EXPECT_FALSE(m.contains(4));
+  EXPECT_THROW(m.at(4), std::out_of_range);
+
+  auto [it, inserted] = m.insert({4, "d"});
+  EXPECT_TRUE(inserted);
+  EXPECT_EQ(it->second, "d");
+  EXPECT_FALSE(m.insert(4, "dd").second);
+  EXPECT_EQ(m.at(4), "d");
+
+  m[5] = "e";
+  EXPECT_EQ(std::prev(m.end())->second, "e");
+}
+
+TEST(FlatMapTest, MatchesStdMap) {
+  s21::flat_map<int, int> m;
+  std::map<int, int> reference;
+  for (int i{0}; i < 10000; ++i) {
+    int key{Random::Get(0, 2000)};
+    switch (Random::Get(0, 3)) {
+      case 0:
+        m.insert_or_assign(key, i);
+        reference.insert_or_assign(key, i);
+        break;
+      case 1:
+        m.try_emplace(m.lower_bound(key), key, i);
+        reference.try_emplace(key, i);
+        break;
+      case 2: {
+        auto it = m.find(key);
+        if (it != m.end()) {
+          m.erase(it);
+        }
+        reference.erase(key);
+        break;
+      }
+      default:
+        m[key] = -i;
+        reference[key] = -i;
+    }
+  }
+  ASSERT_EQ(m.size(), reference.size());
+  auto ref = reference.begin();
+  for (const auto& [key, value] : m) {
+    EXPECT_EQ(key, ref->first);
+    EXPECT_EQ(value, ref->second);
+    ++ref;
+  }
+}
+
+TEST(FlatMapTest, BatchInsertMergesAndKeepsExistingValues) {
+  s21::flat_map<int, int> m{{1, 1}, {5, 5}, {9, 9}};
+  std::vector<std::pair<int, int>> batch{
+      {7, 70}, {5, 50}, {0, 0}, {7, 71}, {12, 120}};
+  m.insert(batch.begin(), batch.end());
+
+  std::vector<std::pair<int, int>> expected{
+      {0, 0}, {1, 1}, {5, 5}, {7, 70}, {9, 9}, {12, 120}};
+  ASSERT_EQ(m.size(), expected.size());
+  EXPECT_TRUE(std::equal(m.begin(), m.end(), expected.begin()));
+
+  std::map<int, int> reference{m.begin(), m.end()};
+  std::vector<std::pair<int, int>> random_batch;
+  for (int i{0}; i < 5000; ++i) {
+    random_batch.emplace_back(Random::Get(0, 3000), i);
+  }
+  m.insert(random_batch.begin(), random_batch.end());
+  reference.insert(random_batch.begin(), random_batch.end());
+  ASSERT_EQ(m.size(), reference.size());
+  auto ref = reference.begin();
+  for (const auto& [key, value] : m) {
+    EXPECT_EQ(key, ref->first);
+    EXPECT_EQ(value, ref->second);
+    ++ref;
+  }
+}
+
+TEST(FlatMapTest, AdoptTakesStorageWithoutCopying) {
+  s21::vector<std::pair<int, std::string>> sorted;
+  for (int i{0}; i < 100; ++i) {
+    sorted.push_back(std::pair<int, std::string>{i * 2, std::to_string(i)});
+  }
+  const auto* storage = sorted.data();
+
+  auto m = s21::flat_map<int, std::string>::adopt(std::move(sorted));
+  EXPECT_EQ(m.size(), size_t{100});
+  EXPECT_EQ(&*m.begin(), storage);
+  EXPECT_EQ(m.at(42), "21");
+  EXPECT_FALSE(m.contains(43));
+}
+
+TEST(FlatMapTest, HintedInsertAppendsInOrder) {
+  s21::flat_map<int, int> m;
+  for (int i{0}; i < 1000; ++i) {
+    auto it = m.insert(m.end(), {i, i * 2});
+    EXPECT_EQ(it->first, i);
+  }
+  for (int i{-1}; i > -100; --i) {
+    m.emplace_hint(m.begin(), i, i);
+  }
+  m.try_emplace(m.begin() + 500, 250, 0);
+  EXPECT_EQ(m.at(250), 500);
+  EXPECT_EQ(m.size(), size_t{1099});
+  EXPECT_TRUE(std::is_sorted(
+      m.begin(), m.end(),
+      [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; }));
+}
+
+TEST(FlatMapTest, InsertManyAndMerge) {
+  s21::flat_map<int, std::string> m{{2, "b"}};
+  auto results = m.insert_many(std::pair<int, std::string>{1, "a"},
+                               std::pair<int, std::string>{2, "x"},
+                               std::pair<int, std::string>{3, "c"});
+  ASSERT_EQ(results.size(), size_t{2});
+  EXPECT_EQ(results[0].first->second, "a");
+  EXPECT_EQ(results[1].first->second, "c");
+
+  s21::flat_map<int, std::string> other{{3, "x"}, {4, "d"}};
+  m.merge(other);
+  EXPECT_EQ(m.size(), size_t{4});
+  EXPECT_EQ(m.at(3), "c");
+  EXPECT_TRUE(other.empty());
+}
+
+TEST(FlatMapTest, BoundsAndRange) {
+  s21::flat_map<int, int> m;
+  for (int i{0}; i < 1000; i += 10) {
+    m.insert(m.end(), {i, i});
+  }
+  EXPECT_EQ(m.lower_bound(15)->first, 20);
+  EXPECT_EQ(m.upper_bound(20)->first, 30);
+  EXPECT_EQ(m.lower_bound(991), m.end());
+  EXPECT_EQ(m.upper_bound(-1), m.begin());
+
+  int expected{100};
+  for (const auto& [key, value] : m.range(100, 200)) {
+    EXPECT_EQ(key, expected);
+    expected += 10;
+  }
+  EXPECT_EQ(expected, 200);
+  EXPECT_TRUE(m.range(200, 100).empty());
+}
+
+TEST(FlatMapTest, TransparentLookup) {
+  s21::flat_map<std::string, int, std::less<>> m{{"one", 1}, {"two", 2}};
+  EXPECT_EQ(m.find(std::string_view{"two"})->second, 2);
+  EXPECT_TRUE(m.contains(std::string_view{"one"}));
+  EXPECT_EQ(m.count(std::string_view{"three"}), size_t{0});
+}
+
+TEST(FlatMapTest, CopyMoveAndSetAlgebra) {
+  s21::flat_map<int, DummyObject> lhs{{1, DummyObject{1}},
+                                      {2, DummyObject{2}}};
+  s21::flat_map<int, DummyObject> rhs{{2, DummyObject{20}},
+                                      {3, DummyObject{3}}};
+
+  auto all = s21::set_union(lhs, rhs);
+  EXPECT_EQ(all.size(), size_t{3});
+  EXPECT_EQ(all.at(2).get_value(), 2);
+  auto common = s21::set_intersection(lhs, rhs);
+  EXPECT_EQ(common.size(), size_t{1});
+  auto rest = s21::set_difference(std::move(lhs), std::move(rhs));
+  EXPECT_EQ(rest.size(), size_t{1});
+  EXPECT_EQ(rest.at(1).get_value(), 1);
+
+  s21::flat_map<int, DummyObject> copy{all};
+  EXPECT_TRUE(copy == all);
+  s21::flat_map<int, DummyObject> moved{std::move(copy)};
+  EXPECT_TRUE(copy.empty());
+  EXPECT_TRUE(moved == all);
+}
+
+TEST(FlatMapAllocatorTest, ReleasesEverything) {
+  TrackingResource resource;
+  {
+    s21::pmr::flat_map<int, std::string> m{&resource};
+    for (int i{0}; i < 300; ++i) {
+      m.try_emplace(i, "a string long enough to allocate its own buffer");
+    }
+    EXPECT_EQ(m.get_allocator().resource(), &resource);
+    m.erase(m.begin());
+  }
+  EXPECT_GT(resource.allocations(), size_t{0});
+  EXPECT_EQ(resource.bytes_in_use(), size_t{0});
+}
+
+TEST(FlatMapAllocatorTest, CopyAssignKeepsResource) {
+  TrackingResource first_resource;
+  TrackingResource second_resource;
+  {
+    s21::pmr::flat_map<int, std::string> first({{1, "a"}}, &first_resource);
+    s21::pmr::flat_map<int, std::string> second(&second_resource);
+    for (int i{0}; i < 300; ++i) {
+      second.try_emplace(i, std::to_string(i) + " is long enough to allocate");
+    }
+
+    first = second;
+    EXPECT_TRUE(first == second);
+    EXPECT_EQ(first.at(1), second.at(1));
+    EXPECT_EQ(first.get_allocator().resource(), &first_resource);
+    first = std::as_const(first);
+    EXPECT_EQ(first.size(), size_t{300});
+  }
+  EXPECT_EQ(first_resource.bytes_in_use(), size_t{0});
+  EXPECT_EQ(second_resource.bytes_in_use(), size_t{0});
+}
+
+TEST(FlatMapTest, EraseKeyAndRange) {
+  s21::flat_map<int, int> m;
+  std::map<int, int> reference;
+  for (int i{0}; i < 2000; ++i) {
+    m.insert({i, -i});
+    reference.insert({i, -i});
+  }
+  EXPECT_EQ(m.erase(700), size_t{1});
+  EXPECT_EQ(m.erase(700), size_t{0});
+  reference.erase(700);
+  auto next = m.erase(m.find(100), m.find(1500));
+  reference.erase(reference.find(100), reference.find(1500));
+  EXPECT_EQ(next->first, 1500);
+  ASSERT_EQ(m.size(), reference.size());
+  EXPECT_TRUE(std::equal(m.begin(), m.end(), reference.begin(),
+                         [](const auto& lhs, const auto& rhs) {
+                           return lhs.first == rhs.first &&
+                                  lhs.second == rhs.second;
+                         }));
+  auto last = m.erase(m.begin(), m.end());
+  EXPECT_EQ(last, m.end());
+  EXPECT_TRUE(m.empty());
+}
+
+TEST(FlatMapTest, FindManyKeepsInputOrder) {
+  s21::flat_map<int, std::string> m{{1, "one"}, {2, "two"}, {3, "three"}};
+  std::vector<int> keys{3, 7, 1, 1};
+  std::vector<s21::flat_map<int, std::string>::iterator> found;
+  m.find_many(keys.begin(), keys.end(), std::back_inserter(found));
+  ASSERT_EQ(found.size(), 4u);
+  EXPECT_EQ(found[0]->second, "three");
+  EXPECT_TRUE(found[1] == m.end());
+  EXPECT_TRUE(found[2] == m.begin());
+  found[3]->second = "uno";
+  EXPECT_EQ(m.at(1), "uno");
+
+  const auto& constant = m;
+  std::vector<s21::flat_map<int, std::string>::const_iterator> const_found;
+  constant.find_many(keys.begin(), keys.end(),
+                     std::back_inserter(const_found));
+  EXPECT_TRUE(const_found[1] == constant.end());
+  std::vector<bool> present;
+  m.contains_many(keys.begin(), keys.end(), std::back_inserter(present));
+  EXPECT_EQ(present, (std::vector<bool>{true, false, true, true}));
+}
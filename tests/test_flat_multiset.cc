@@ -0,0 +1,113 @@
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+#include <gtest/gtest.h>
+#pragma GCC diagnostic pop
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "random.h"
+#include "s21_flat_multiset.h"
+
+TEST(FlatMultisetTest, OrderStatisticsMatchStdMultiset) {
+  s21::flat_multiset<int> mset;
+  std::multiset<int> reference;
+  for (int i{0}; i < 5000; ++i) {
+    int key{Random::Get(0, 300)};
+    if (Random::Get(0, 3) != 0) {
+      mset.insert(key);
+      reference.insert(key);
+    } else {
+      EXPECT_EQ(mset.erase(key), reference.erase(key));
+    }
+  }
+  ASSERT_EQ(mset.size(), reference.size());
+  EXPECT_TRUE(std::equal(mset.begin(), mset.end(), reference.begin(),
+                         reference.end()));
+  for (int key{0}; key <= 300; key += 7) {
+    EXPECT_EQ(mset.count(key), reference.count(key));
+    EXPECT_EQ(mset.rank(key),
+              static_cast<size_t>(std::distance(reference.begin(),
+                                                reference.lower_bound(key))));
+  }
+  EXPECT_EQ(mset.nth_element(mset.size()), mset.end());
+  EXPECT_EQ(mset.distance(mset.begin(), mset.end()),
+            static_cast<std::ptrdiff_t>(mset.size()));
+}
+
+TEST(FlatMultisetTest, EqualKeysKeepInsertionOrder) {
+  using Entry = std::pair<int, int>;
+  struct ByFirst {
+    bool operator()(const Entry& lhs, const Entry& rhs) const {
+      return lhs.first < rhs.first;
+    }
+  };
+  s21::flat_multiset<Entry, ByFirst> mset{{1, 0}, {0, 1}, {1, 2}};
+  mset.insert({1, 3});
+  std::vector<Entry> batch{{1, 4}, {0, 5}, {1, 6}};
+  mset.insert(batch.begin(), batch.end());
+  mset.emplace_hint(mset.begin(), 1, 7);
+
+  std::vector<Entry> expected{{0, 1}, {0, 5}, {1, 7}, {1, 0},
+                              {1, 2}, {1, 3}, {1, 4}, {1, 6}};
+  EXPECT_TRUE(
+      std::equal(mset.begin(), mset.end(), expected.begin(), expected.end()));
+}
+
+TEST(FlatMultisetTest, AdoptAndMerge) {
+  s21::vector<std::string> sorted{};
+  for (const char* word : {"a", "b", "b", "c"}) {
+    sorted.push_back(std::string{word});
+  }
+  auto mset = s21::flat_multiset<std::string>::adopt(std::move(sorted));
+  EXPECT_EQ(mset.count("b"), size_t{2});
+
+  s21::flat_multiset<std::string> other{"b", "d"};
+  mset.merge(other);
+  EXPECT_TRUE(other.empty());
+  EXPECT_EQ(mset.count("b"), size_t{3});
+  EXPECT_EQ(*mset.nth_element(5), "d");
+
+  auto [first, last] = mset.equal_range("b");
+  EXPECT_EQ(std::distance(first, last), 3);
+  size_t count{0};
+  for (const auto& key : mset.range("b", "d")) {
+    EXPECT_NE(key, "d");
+    ++count;
+  }
+  EXPECT_EQ(count, size_t{4});
+}
+
+TEST(FlatMultisetTest, CopyAssignKeepsDuplicates) {
+  s21::flat_multiset<int> mset{7, 8};
+  s21::flat_multiset<int> other;
+  for (int i{0}; i < 3000; ++i) {
+    other.insert(i % 10);
+  }
+  mset = other;
+  EXPECT_TRUE(mset == other);
+  EXPECT_EQ(mset.count(3), size_t{300});
+  EXPECT_EQ(mset.count(7), size_t{300});
+}
+
+TEST(FlatMultisetTest, EraseRangeKeepsDuplicatesOutside) {
+  s21::flat_multiset<int> s;
+  std::multiset<int> reference;
+  for (int i{0}; i < 3000; ++i) {
+    s.insert(i % 500);
+    reference.insert(i % 500);
+  }
+  auto next = s.erase(s.lower_bound(100), s.upper_bound(399));
+  reference.erase(reference.lower_bound(100), reference.upper_bound(399));
+  EXPECT_EQ(*next, 400);
+  ASSERT_EQ(s.size(), reference.size());
+  EXPECT_TRUE(std::equal(s.begin(), s.end(), reference.begin()));
+  EXPECT_EQ(s.count(99), size_t{6});
+  auto last = s.erase(s.begin(), s.end());
+  EXPECT_EQ(last, s.end());
+  EXPECT_TRUE(s.empty());
+}
@@ -0,0 +1,173 @@
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+#include <gtest/gtest.h>
+#pragma GCC diagnostic pop
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "random.h"
+#include "s21_flat_set.h"
+#include "tracking_resource.h"
+
+template <typename Key>
+class FlatSetTest : public testing::Test {
+ protected:
+  FlatSetTest()
+      : stl_set_{103, 53, 73, 106, 57, 102, 46, 104, 53},
+        s21_set_{103, 53, 73, 106, 57, 102, 46, 104, 53} {}
+
+  std::set<Key> stl_set_;
+  s21::flat_set<Key> s21_set_;
+};
+
+using TestedTypes = ::testing::Types<int, double>;
+TYPED_TEST_SUITE(FlatSetTest, TestedTypes, );
+
+TYPED_TEST(FlatSetTest, InitializerList) {
+  EXPECT_EQ(this->s21_set_.size(), this->stl_set_.size());
+  EXPECT_TRUE(std::equal(this->s21_set_.begin(), this->s21_set_.end(),
+                         this->stl_set_.begin(), this->stl_set_.end()));
+}
+
+TYPED_TEST(FlatSetTest, InsertAndErase) {
+  EXPECT_FALSE(this->s21_set_.insert(TypeParam{53}).second);
+  EXPECT_TRUE(this->s21_set_.insert(TypeParam{54}).second);
+  auto next = this->s21_set_.erase(this->s21_set_.find(TypeParam{73}));
+  EXPECT_EQ(*next, TypeParam{102});
+  EXPECT_EQ(this->s21_set_.size(), size_t{8});
+}
+
+TYPED_TEST(FlatSetTest, Bounds) {
+  EXPECT_EQ(*this->s21_set_.lower_bound(TypeParam{60}), TypeParam{73});
+  EXPECT_EQ(*this->s21_set_.upper_bound(TypeParam{73}), TypeParam{102});
+  EXPECT_EQ(this->s21_set_.upper_bound(TypeParam{106}),
+            this->s21_set_.end());
+  EXPECT_EQ(this->s21_set_.lower_bound(TypeParam{0}),
+            this->s21_set_.begin());
+}
+
+TEST(FlatSetNonTyped, BinarySearchMatchesStdSet) {
+  for (int size : {0, 1, 2, 3, 7, 8, 9, 100, 1000}) {
+    std::set<int> reference;
+    while (reference.size() < static_cast<size_t>(size)) {
+      reference.insert(Random::Get(0, 4 * size));
+    }
+    s21::flat_set<int> s{reference.begin(), reference.end()};
+    for (int key{-1}; key <= 4 * size + 1; ++key) {
+      EXPECT_EQ(std::distance(s.begin(), s.lower_bound(key)),
+                std::distance(reference.begin(), reference.lower_bound(key)));
+      EXPECT_EQ(std::distance(s.begin(), s.upper_bound(key)),
+                std::distance(reference.begin(), reference.upper_bound(key)));
+      EXPECT_EQ(s.contains(key), reference.count(key) == 1);
+    }
+  }
+}
+
+TEST(FlatSetNonTyped, BatchInsertFromInputIterator) {
+  s21::flat_set<int> s{5, 1};
+  std::istringstream input{"9 3 5 7 3"};
+  s.insert(std::istream_iterator<int>{input}, std::istream_iterator<int>{});
+  EXPECT_TRUE(s == s21::flat_set<int>({1, 3, 5, 7, 9}));
+
+  std::list<int> sorted_tail{10, 11, 12};
+  s.insert(sorted_tail.begin(), sorted_tail.end());
+  EXPECT_EQ(s.size(), size_t{8});
+  EXPECT_EQ(*std::prev(s.end()), 12);
+}
+
+TEST(FlatSetNonTyped, AdoptAndCustomCompare) {
+  s21::vector<std::string> sorted{};
+  for (const char* word : {"pear", "fig", "apple"}) {
+    sorted.push_back(std::string{word});
+  }
+  auto s = s21::flat_set<std::string, std::greater<>>::adopt(std::move(sorted));
+  EXPECT_EQ(*s.begin(), "pear");
+  EXPECT_TRUE(s.contains(std::string_view{"fig"}));
+  EXPECT_EQ(*s.lower_bound(std::string_view{"b"}), "apple");
+  s.insert("kiwi");
+  EXPECT_EQ(*std::next(s.begin()), "kiwi");
+}
+
+TEST(FlatSetNonTyped, MergeAndSetAlgebra) {
+  s21::flat_set<int> odd{1, 3, 5, 7};
+  s21::flat_set<int> small{1, 2, 3};
+
+  EXPECT_TRUE(s21::set_union(odd, small) ==
+              s21::flat_set<int>({1, 2, 3, 5, 7}));
+  EXPECT_TRUE(s21::set_intersection(odd, small) ==
+              s21::flat_set<int>({1, 3}));
+  EXPECT_TRUE(s21::set_difference(odd, small) ==
+              s21::flat_set<int>({5, 7}));
+
+  odd.merge(small);
+  EXPECT_EQ(odd.size(), size_t{5});
+  EXPECT_TRUE(small.empty());
+}
+
+TEST(FlatSetNonTyped, CopyAssign) {
+  s21::flat_set<int, std::greater<int>> s{1, 2, 3};
+  s21::flat_set<int, std::greater<int>> other;
+  for (int i{0}; i < 1000; ++i) {
+    other.insert(i);
+  }
+  s = other;
+  EXPECT_TRUE(s == other);
+  EXPECT_EQ(*s.begin(), 999);
+  other.clear();
+  EXPECT_EQ(s.size(), size_t{1000});
+  s = other;
+  EXPECT_TRUE(s.empty());
+}
+
+TEST(FlatSetAllocatorTest, ReleasesEverything) {
+  TrackingResource resource;
+  {
+    s21::pmr::flat_set<int> s{&resource};
+    for (int i{0}; i < 500; ++i) {
+      s.insert(Random::Get(0, 1000));
+    }
+    s21::pmr::flat_set<int> copy{s};
+    EXPECT_TRUE(copy == s);
+  }
+  EXPECT_GT(resource.allocations(), size_t{0});
+  EXPECT_EQ(resource.bytes_in_use(), size_t{0});
+}
+
+TEST(FlatSetNonTyped, EraseKeyAndRange) {
+  s21::flat_set<int> s;
+  for (int i{0}; i < 2000; ++i) {
+    s.insert(i);
+  }
+  EXPECT_EQ(s.erase(3), size_t{1});
+  EXPECT_EQ(s.erase(3), size_t{0});
+  auto next = s.erase(s.find(2), s.find(1900));
+  EXPECT_EQ(*next, 1900);
+  EXPECT_EQ(s.size(), size_t{102});
+  EXPECT_EQ(*std::next(s.begin(), 2), 1900);
+  auto last = s.erase(s.begin(), s.end());
+  EXPECT_EQ(last, s.end());
+  EXPECT_TRUE(s.empty());
+}
+
+TEST(FlatSetNonTyped, FindManyKeepsInputOrder) {
+  s21::flat_set<std::string> s{"apple", "banana", "cherry"};
+  std::vector<std::string> keys{"cherry", "kiwi", "apple", "apple"};
+  std::vector<s21::flat_set<std::string>::iterator> found;
+  s.find_many(keys.begin(), keys.end(), std::back_inserter(found));
+  ASSERT_EQ(found.size(), 4u);
+  EXPECT_EQ(*found[0], "cherry");
+  EXPECT_TRUE(found[1] == s.end());
+  EXPECT_TRUE(found[2] == s.begin());
+  EXPECT_TRUE(found[3] == s.begin());
+  std::vector<bool> present;
+  s.contains_many(keys.begin(), keys.end(), std::back_inserter(present));
+  EXPECT_EQ(present, (std::vector<bool>{true, false, true, true}));
+}
@@ -0,0 +1,62 @@
+#include "s21_frozen_map.h"
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+#include <gtest/gtest.h>
+#pragma GCC diagnostic pop
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "random.h"
+
+TEST(FrozenMapTest, MatchesMap) {
+  s21::map<int, std::string> source;
+  for (int i = 0; i < 3000; ++i) {
+    source.insert({Random::Get(-50000, 50000), std::to_string(i)});
+  }
+  s21::frozen_map<int, std::string> frozen{source};
+  ASSERT_EQ(frozen.size(), source.size());
+  auto it = frozen.begin();
+  for (const auto& [key, value] : source) {
+    EXPECT_EQ(it->first, key);
+    EXPECT_EQ(it->second, value);
+    EXPECT_EQ(frozen.at(key), value);
+    ++it;
+  }
+  EXPECT_EQ(it, frozen.end());
+  for (int i = 0; i < 1000; ++i) {
+    int key = Random::Get(-51000, 51000);
+    auto lower = source.lower_bound(key);
+    auto frozen_lower = frozen.lower_bound(key);
+    ASSERT_EQ(frozen_lower == frozen.end(), lower == source.end());
+    if (lower != source.end()) {
+      EXPECT_EQ(frozen_lower->second, lower->second);
+    }
+    EXPECT_EQ(frozen.contains(key), source.contains(key));
+  }
+  EXPECT_THROW(frozen.at(60000), std::out_of_range);
+}
+
+TEST(FrozenMapTest, FirstOfEquivalentKeysWins) {
+  s21::frozen_map<int, int> frozen{{2, 20}, {1, 10}, {2, 21}, {3, 30}};
+  std::vector<std::pair<int, int>> items;
+  for (const auto& [key, value] : frozen) items.emplace_back(key, value);
+  EXPECT_EQ(items, (std::vector<std::pair<int, int>>{
+                       {1, 10}, {2, 20}, {3, 30}}));
+}
+
+TEST(FrozenMapTest, MoveOnlyValuesFromRange) {
+  std::vector<std::pair<int, std::unique_ptr<int>>> items;
+  for (int i = 0; i < 10; ++i) {
+    items.emplace_back(9 - i, std::make_unique<int>(i));
+  }
+  s21::frozen_map<int, std::unique_ptr<int>> frozen(
+      std::make_move_iterator(items.begin()),
+      std::make_move_iterator(items.end()));
+  EXPECT_EQ(*frozen.at(0), 9);
+  EXPECT_EQ(*frozen.begin()->second, 9);
+  EXPECT_EQ(frozen.find(10), frozen.end());
+}
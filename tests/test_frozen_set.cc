@@ -0,0 +1,98 @@
+#include "s21_frozen_set.h"
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+#include <gtest/gtest.h>
+#pragma GCC diagnostic pop
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "random.h"
+
+TEST(FrozenSetTest, EverySizeMatchesStdSet) {
+  // Sizes around powers of two cover full, nearly full and one-node
+  // bottom levels
+  for (int size : {0, 1, 2, 3, 4, 6, 7, 8, 9, 15, 16, 17, 100, 1000}) {
+    std::set<int> reference;
+    while (reference.size() < static_cast<std::size_t>(size)) {
+      reference.insert(Random::Get(-10000, 10000));
+    }
+    s21::frozen_set<int> frozen(reference.begin(), reference.end());
+    ASSERT_EQ(frozen.size(), reference.size());
+    EXPECT_TRUE(std::equal(frozen.begin(), frozen.end(), reference.begin(),
+                           reference.end()));
+    EXPECT_TRUE(std::equal(std::make_reverse_iterator(frozen.end()),
+                           std::make_reverse_iterator(frozen.begin()),
+                           reference.rbegin(), reference.rend()));
+
+    for (int key = -10010; key <= 10010; key += 7) {
+      auto lower = reference.lower_bound(key);
+      auto upper = reference.upper_bound(key);
+      auto frozen_lower = frozen.lower_bound(key);
+      auto frozen_upper = frozen.upper_bound(key);
+      ASSERT_EQ(frozen_lower == frozen.end(), lower == reference.end());
+      ASSERT_EQ(frozen_upper == frozen.end(), upper == reference.end());
+      if (lower != reference.end()) {
+        EXPECT_EQ(*frozen_lower, *lower);
+      }
+      if (upper != reference.end()) {
+        EXPECT_EQ(*frozen_upper, *upper);
+      }
+      EXPECT_EQ(frozen.contains(key), reference.count(key) == 1);
+    }
+    for (int key : reference) {
+      ASSERT_NE(frozen.find(key), frozen.end());
+      EXPECT_EQ(*frozen.find(key), key);
+    }
+  }
+}
+
+TEST(FrozenSetTest, FromSet) {
+  s21::set<std::string, std::greater<std::string>> source{"pear", "apple",
+                                                          "fig", "quince"};
+  s21::frozen_set<std::string, std::greater<std::string>> frozen{source};
+  EXPECT_EQ(std::vector<std::string>(frozen.begin(), frozen.end()),
+            (std::vector<std::string>{"quince", "pear", "fig", "apple"}));
+  EXPECT_EQ(frozen.count("fig"), 1u);
+  EXPECT_EQ(*frozen.lower_bound("g"), "fig");
+  EXPECT_EQ(frozen.lower_bound("a"), frozen.end());
+  EXPECT_EQ(frozen.begin()->size(), 6u);
+}
+
+TEST(FrozenSetTest, UnsortedInputWithDuplicates) {
+  s21::frozen_set<int> frozen{5, 3, 9, 3, 1, 5, 7};
+  EXPECT_EQ(std::vector<int>(frozen.begin(), frozen.end()),
+            (std::vector<int>{1, 3, 5, 7, 9}));
+  auto [first, last] = frozen.equal_range(5);
+  EXPECT_EQ(*first, 5);
+  EXPECT_EQ(*last, 7);
+  auto [missing_first, missing_last] = frozen.equal_range(4);
+  EXPECT_EQ(missing_first, missing_last);
+}
+
+TEST(FrozenSetTest, TransparentLookups) {
+  s21::frozen_set<std::string, std::less<>> frozen{"b", "d", "f"};
+  std::string_view key{"d"};
+  EXPECT_TRUE(frozen.contains(key));
+  EXPECT_EQ(*frozen.upper_bound(key), "f");
+}
+
+TEST(FrozenSetTest, CopiesAndMoves) {
+  std::vector<int> keys(500);
+  for (int i = 0; i < 500; ++i) keys[static_cast<std::size_t>(i)] = i * 2;
+  s21::frozen_set<int> original(keys.begin(), keys.end());
+  s21::frozen_set<int> copy{original};
+  s21::frozen_set<int> moved{std::move(original)};
+  EXPECT_TRUE(original.empty());
+  EXPECT_EQ(original.begin(), original.end());
+  EXPECT_TRUE(std::equal(copy.begin(), copy.end(), keys.begin(), keys.end()));
+  EXPECT_TRUE(std::equal(moved.begin(), moved.end(), keys.begin(), keys.end()));
+  copy = s21::frozen_set<int>{1};
+  EXPECT_EQ(copy.size(), 1u);
+  EXPECT_TRUE(copy.contains(1));
+}
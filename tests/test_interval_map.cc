@@ -0,0 +1,232 @@
+#include "s21_interval_map.h"
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+#include <gtest/gtest.h>
+#pragma GCC diagnostic pop
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "random.h"
+#include "tracking_resource.h"
+
+namespace {
+
+using Window = std::pair<int, int>;
+
+template <typename NodeType>
+bool ValidateMaxEndpoints(const NodeType* node) {
+  if (node == nullptr) {
+    return true;
+  }
+  int expected{node->GetKey().high};
+  for (const NodeType* child : {node->left_, node->right_}) {
+    if (child) {
+      expected = std::max(expected, child->max_high_);
+    }
+  }
+  return node->max_high_ == expected && ValidateMaxEndpoints(node->left_) &&
+         ValidateMaxEndpoints(node->right_);
+}
+
+// Every node of the map's tree against the endpoints below it
+template <typename Map>
+bool EndpointsValid(const Map& map) {
+  return ValidateMaxEndpoints(map.begin().get_tree()->get_root());
+}
+
+template <typename Range>
+std::vector<Window> Collect(const Range& range) {
+  std::vector<Window> result;
+  for (const auto& [key, value] : range) {
+    result.emplace_back(key.low, key.high);
+  }
+  return result;
+}
+
+std::vector<Window> BruteForce(const std::vector<Window>& windows, int low,
+                               int high) {
+  std::vector<Window> result;
+  for (const Window& window : windows) {
+    if (window.first < window.second && window.first < high &&
+        low < window.second) {
+      result.push_back(window);
+    }
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+}  // namespace
+
+TEST(IntervalMapTest, HalfOpenBounds) {
+  s21::interval_map<int, std::string> windows{
+      {{10, 20}, "a"}, {{20, 30}, "b"}, {{15, 25}, "c"}, {{5, 5}, "empty"}};
+  EXPECT_EQ(Collect(windows.stabbing(20)),
+            (std::vector<Window>{{15, 25}, {20, 30}}));
+  EXPECT_EQ(Collect(windows.stabbing(10)), (std::vector<Window>{{10, 20}}));
+  EXPECT_TRUE(windows.stabbing(30).empty());
+  EXPECT_TRUE(windows.stabbing(5).empty());
+  EXPECT_TRUE(windows.stabbing(9).empty());
+
+  EXPECT_EQ(Collect(windows.overlapping(0, 5)), std::vector<Window>{});
+  EXPECT_EQ(Collect(windows.overlapping(0, 11)),
+            (std::vector<Window>{{10, 20}}));
+  EXPECT_EQ(Collect(windows.overlapping(25, 100)),
+            (std::vector<Window>{{20, 30}}));
+  EXPECT_TRUE(windows.overlaps(29, 31));
+  EXPECT_FALSE(windows.overlaps(30, 40));
+}
+
+TEST(IntervalMapTest, EmptyAndInvertedQueriesMatchNothing) {
+  s21::interval_map<int, int> windows{{{0, 10}, 1}, {{4, 6}, 2}};
+  EXPECT_TRUE(windows.overlapping(5, 5).empty());
+  EXPECT_TRUE(windows.overlapping(5, 3).empty());
+  EXPECT_TRUE(std::as_const(windows).overlapping(8, 2).empty());
+  EXPECT_FALSE(windows.overlaps(5, 5));
+  EXPECT_FALSE(windows.overlaps(5, 3));
+  EXPECT_EQ(Collect(windows.overlapping(5, 6)),
+            (std::vector<Window>{{0, 10}, {4, 6}}));
+}
+
+TEST(IntervalMapTest, EmptyAndInvertedStoredIntervalsMatchNothing) {
+  s21::interval_map<int, int> windows;
+  windows.insert(487, 485, 1);
+  windows.insert(5, 5, 2);
+  EXPECT_TRUE(windows.overlapping(484, 524).empty());
+  EXPECT_TRUE(windows.overlapping(4, 6).empty());
+  EXPECT_TRUE(windows.stabbing(486).empty());
+  EXPECT_TRUE(windows.stabbing(5).empty());
+
+  // They must not hide the real matches that sort after them either
+  windows.insert(5, 10, 3);
+  windows.insert(488, 490, 4);
+  windows.insert(0, 1, 5);
+  EXPECT_EQ(Collect(windows.overlapping(4, 6)), (std::vector<Window>{{5, 10}}));
+  EXPECT_EQ(Collect(windows.overlapping(484, 524)),
+            (std::vector<Window>{{488, 490}}));
+  EXPECT_EQ(Collect(windows.overlapping(0, 500)),
+            (std::vector<Window>{{0, 1}, {5, 10}, {488, 490}}));
+  EXPECT_TRUE(EndpointsValid(windows));
+}
+
+TEST(IntervalMapTest, MatchesBruteForce) {
+  s21::interval_map<int, int> tree;
+  std::vector<Window> windows;
+  for (int i = 0; i < 3000; ++i) {
+    int low = Random::Get(0, 10000);
+    int high = low + Random::Get(i % 7 == 0 ? -50 : 0,
+                                 i % 10 == 0 ? 3000 : 100);
+    tree.insert(low, high, i);
+    windows.emplace_back(low, high);
+    if (i % 3 == 2) {
+      std::size_t victim{static_cast<std::size_t>(
+          Random::Get(0, static_cast<int>(windows.size()) - 1))};
+      auto it = tree.find({windows[victim].first, windows[victim].second});
+      ASSERT_TRUE(it != tree.end());
+      tree.erase(it);
+      windows.erase(windows.begin() + static_cast<long>(victim));
+    }
+  }
+  ASSERT_EQ(tree.size(), windows.size());
+  ASSERT_TRUE(EndpointsValid(tree));
+
+  for (int i = 0; i < 300; ++i) {
+    int low = Random::Get(-100, 10100);
+    int high = low + Random::Get(1, 500);
+    EXPECT_EQ(Collect(tree.overlapping(low, high)),
+              BruteForce(windows, low, high));
+    EXPECT_EQ(Collect(std::as_const(tree).stabbing(low)),
+              BruteForce(windows, low, low + 1));
+  }
+}
+
+TEST(IntervalMapTest, DuplicatesAndPayloads) {
+  s21::interval_map<int, std::string> tree;
+  tree.insert(1, 5, "first");
+  tree.insert(1, 5, "second");
+  tree.insert(1, 3, "short");
+  EXPECT_EQ(tree.size(), 3u);
+  std::vector<std::string> payloads;
+  for (auto& [key, value] : tree.stabbing(2)) {
+    value += "!";
+    payloads.push_back(value);
+  }
+  EXPECT_EQ(payloads,
+            (std::vector<std::string>{"short!", "first!", "second!"}));
+  EXPECT_EQ(tree.erase(s21::interval<int>{1, 5}), 2u);
+  EXPECT_TRUE(tree.contains({1, 3}));
+  EXPECT_FALSE(tree.contains({1, 5}));
+}
+
+TEST(IntervalMapTest, EraseWhileStreaming) {
+  s21::interval_map<int, int> tree;
+  for (int i = 0; i < 1000; ++i) {
+    tree.insert(i, i + 50, i);
+  }
+  auto matches = tree.stabbing(500);
+  std::size_t erased{0};
+  for (auto it = matches.begin(); it != matches.end();) {
+    if (it->second % 2 == 0) {
+      it = tree.erase(it);
+      ++erased;
+    } else {
+      ++it;
+    }
+  }
+  EXPECT_EQ(erased, 25u);
+  EXPECT_EQ(tree.size(), 975u);
+  EXPECT_EQ(Collect(tree.stabbing(500)).size(), 25u);
+  EXPECT_TRUE(EndpointsValid(tree));
+
+  auto first = tree.overlapping(600, 601).begin();
+  auto plain = first.base();
+  EXPECT_EQ(plain->first.low, 551);
+  EXPECT_EQ((++plain)->first.low, 552);
+}
+
+TEST(IntervalMapTest, CopyAndMoveKeepEndpoints) {
+  s21::interval_map<int, int> tree;
+  for (int i = 0; i < 500; ++i) {
+    int low = Random::Get(0, 1000);
+    tree.insert(low, low + Random::Get(0, 200), i);
+  }
+  s21::interval_map<int, int> copy{tree};
+  EXPECT_TRUE(copy == tree);
+  EXPECT_TRUE(EndpointsValid(copy));
+  EXPECT_EQ(Collect(copy.overlapping(300, 400)),
+            Collect(tree.overlapping(300, 400)));
+
+  s21::interval_map<int, int> moved{std::move(copy)};
+  EXPECT_EQ(moved.size(), 500u);
+  EXPECT_TRUE(copy.empty());
+  EXPECT_TRUE(copy.stabbing(0).empty());
+}
+
+TEST(IntervalMapTest, DescendingPoints) {
+  s21::interval_map<int, char, std::greater<int>> tree{
+      {{30, 20}, 'a'}, {{25, 10}, 'b'}, {{10, 0}, 'c'}};
+  EXPECT_EQ(Collect(tree.stabbing(20)), (std::vector<Window>{{25, 10}}));
+  EXPECT_EQ(Collect(tree.stabbing(21)),
+            (std::vector<Window>{{30, 20}, {25, 10}}));
+  EXPECT_EQ(tree.begin()->second, 'a');
+}
+
+TEST(IntervalMapAllocatorTest, ReleasesEverything) {
+  TrackingResource resource;
+  {
+    s21::pmr::interval_map<double, std::string> tree(&resource);
+    for (int i = 0; i < 300; ++i) {
+      tree.insert(i * 0.5, i * 0.5 + 2.0, std::to_string(i));
+    }
+    auto matches = tree.stabbing(10.25);
+    EXPECT_EQ(std::distance(matches.begin(), matches.end()), 4);
+    EXPECT_EQ(tree.get_allocator().resource(), &resource);
+  }
+  EXPECT_GT(resource.allocations(), 0u);
+  EXPECT_EQ(resource.bytes_in_use(), 0u);
+}
@@ -9,6 +9,7 @@
 
 #include "dummy_object.h"
 #include "s21_list.h"
+#include "tracking_resource.h"
 
 template <typename T>
 class ListTest : public testing::Test {
@@ -537,3 +538,51 @@ TEST(ListTest, insert_many_front) {
   EXPECT_EQ(*it_check++, 2);
   EXPECT_EQ(*it_check++, 3);
 }
+
+TEST(ListAllocatorTest, ArenaBacked) {
+  std::byte buffer[8192];
+  std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer),
+                                            std::pmr::null_memory_resource()};
+  s21::pmr::list<int> l{&arena};
+  for (int i{0}; i < 100; ++i) {
+    l.push_back(i);
+  }
+  l.push_front(-1);
+  l.insert_many_back(100, 101);
+
+  EXPECT_EQ(l.size(), size_t{103});
+  EXPECT_EQ(l.front(), -1);
+  EXPECT_EQ(l.back(), 101);
+}
+
+TEST(ListAllocatorTest, ReleasesEverything) {
+  TrackingResource resource;
+  {
+    s21::pmr::list<DummyObject> l({DummyObject{3}, DummyObject{1}},
+                                  &resource);
+    l.push_back(DummyObject{2});
+    l.push_front(DummyObject{1});
+    s21::pmr::list<DummyObject> copy{l};
+    EXPECT_EQ(copy.front(), DummyObject{1});
+    l.erase(l.begin());
+  }
+  EXPECT_GT(resource.allocations(), size_t{0});
+  EXPECT_EQ(resource.bytes_in_use(), size_t{0});
+}
+
+TEST(ListAllocatorTest, MoveAssignBetweenResources) {
+  TrackingResource first_resource;
+  TrackingResource second_resource;
+  {
+    s21::pmr::list<int> first({1, 2, 3}, &first_resource);
+    s21::pmr::list<int> second({4, 5}, &second_resource);
+
+    first = std::move(second);
+    EXPECT_EQ(first.size(), size_t{2});
+    EXPECT_EQ(first.back(), 5);
+    EXPECT_EQ(first.get_allocator().resource(), &first_resource);
+    EXPECT_EQ(second.size(), size_t{0});
+  }
+  EXPECT_EQ(first_resource.bytes_in_use(), size_t{0});
+  EXPECT_EQ(second_resource.bytes_in_use(), size_t{0});
+}
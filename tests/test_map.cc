@@ -4,12 +4,20 @@
 #pragma GCC diagnostic pop
 
 #include <algorithm>
+#include <cctype>
 #include <cstring>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
 #include <vector>
 
 #include "dummy_object.h"
 #include "random.h"
 #include "s21_map.h"
+#include "tracking_resource.h"
 
 template <typename T>
 class MapTest : public testing::Test {
@@ -440,3 +448,499 @@ TYPED_TEST(MapTest, Find_InEmptyMap) {
   EXPECT_EQ(s21_it, this->empty_s21_map_.end());
   EXPECT_EQ(std_it, this->empty_stl_map_.end());
 }
+
+TEST(MapNonTyped, RangeConstructor) {
+  std::vector<std::pair<int, std::string>> items{
+      {5, "e"}, {1, "a"}, {3, "c"}, {1, "dup"}, {4, "d"}};
+  s21::map<int, std::string> m(items.begin(), items.end());
+  std::map<int, std::string> stl_m(items.begin(), items.end());
+
+  EXPECT_EQ(m.size(), stl_m.size());
+  EXPECT_TRUE(std::equal(m.begin(), m.end(), stl_m.begin(), stl_m.end()));
+  EXPECT_EQ(m.at(1), "a");
+}
+
+TEST(MapNonTyped, AssignReplacesContents) {
+  s21::map<int, int> m{{100, 1}, {200, 2}};
+  std::vector<std::pair<int, int>> sorted;
+  for (int i = 0; i < 1000; ++i) {
+    sorted.emplace_back(i, i * i);
+  }
+  m.assign(sorted.begin(), sorted.end());
+
+  EXPECT_EQ(m.size(), size_t{1000});
+  EXPECT_EQ(m.at(30), 900);
+  EXPECT_FALSE(m.contains(1000));
+  m[1000] = 1;
+  EXPECT_EQ(m.size(), size_t{1001});
+}
+
+TEST(MapNonTyped, Bounds) {
+  s21::map<int, std::string> m{{10, "a"}, {20, "b"}, {30, "c"}};
+  std::map<int, std::string> stl_m{{10, "a"}, {20, "b"}, {30, "c"}};
+
+  for (int key : {5, 10, 15, 20, 30, 35}) {
+    auto lower = m.lower_bound(key);
+    auto stl_lower = stl_m.lower_bound(key);
+    ASSERT_EQ(lower == m.end(), stl_lower == stl_m.end());
+    if (stl_lower != stl_m.end()) {
+      EXPECT_EQ(*lower, *stl_lower);
+    }
+
+    auto upper = m.upper_bound(key);
+    auto stl_upper = stl_m.upper_bound(key);
+    ASSERT_EQ(upper == m.end(), stl_upper == stl_m.end());
+    if (stl_upper != stl_m.end()) {
+      EXPECT_EQ(*upper, *stl_upper);
+    }
+  }
+
+  const auto& const_m = m;
+  auto [first, last] = const_m.equal_range(20);
+  ASSERT_NE(first, last);
+  EXPECT_EQ(first->second, "b");
+  EXPECT_EQ(++first, last);
+}
+
+TEST(MapNonTyped, RangeView) {
+  s21::map<int, int> m;
+  for (int i = 0; i < 50; ++i) {
+    m[i * 10] = i;
+  }
+
+  int sum = 0;
+  for (auto& [key, value] : m.range(100, 150)) {
+    sum += value;
+    value = -1;
+  }
+  EXPECT_EQ(sum, 10 + 11 + 12 + 13 + 14);
+  EXPECT_EQ(m.at(120), -1);
+  EXPECT_EQ(m.at(150), 15);
+  EXPECT_TRUE(m.range(151, 159).empty());
+}
+
+TEST(MapNonTyped, FindManyMatchesFind) {
+  s21::map<int, int> m;
+  for (int i = 0; i < 1000; i += 2) {
+    m[i] = -i;
+  }
+  std::vector<int> keys{0};
+  for (int i = 0; i < 100; ++i) {
+    keys.push_back(Random::Get(-10, 1010));
+  }
+
+  std::vector<s21::map<int, int>::iterator> found;
+  m.find_many(keys.begin(), keys.end(), std::back_inserter(found));
+  ASSERT_EQ(found.size(), keys.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(found[i], m.find(keys[i]));
+  }
+  found.front()->second = 1;
+  EXPECT_EQ(m.at(0), 1);
+
+  const auto& const_m = m;
+  std::vector<bool> present(keys.size());
+  auto end = const_m.contains_many(keys.begin(), keys.end(), present.begin());
+  EXPECT_EQ(end, present.end());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(present[i], m.contains(keys[i]));
+  }
+  std::vector<s21::map<int, int>::const_iterator> none;
+  const_m.find_many(keys.end(), keys.end(), std::back_inserter(none));
+  EXPECT_TRUE(none.empty());
+}
+
+TEST(MapNonTyped, EraseKeyAndRange) {
+  s21::map<int, int> m;
+  for (int i = 0; i < 50; ++i) {
+    m[i] = i;
+  }
+
+  EXPECT_EQ(m.erase(7), size_t{1});
+  EXPECT_EQ(m.erase(7), size_t{0});
+  auto range = m.range(10, 40);
+  auto next = m.erase(range.begin(), range.end());
+  EXPECT_EQ(next->first, 40);
+  EXPECT_EQ(m.size(), size_t{19});
+  EXPECT_EQ(m.erase(m.begin(), m.begin()), m.begin());
+  EXPECT_FALSE(m.contains(25));
+  EXPECT_EQ(std::prev(m.find(40))->first, 9);
+}
+
+struct CaseInsensitiveLess {
+  bool operator()(const std::string& lhs, const std::string& rhs) const {
+    return std::lexicographical_compare(
+        lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](char a, char b) {
+          return std::tolower(static_cast<unsigned char>(a)) <
+                 std::tolower(static_cast<unsigned char>(b));
+        });
+  }
+};
+
+TEST(MapNonTyped, CustomCompare) {
+  s21::map<std::string, int, CaseInsensitiveLess> m;
+  m["Apple"] = 1;
+  m["apple"] = 2;
+  m.insert("BANANA", 3);
+
+  EXPECT_EQ(m.size(), size_t{2});
+  EXPECT_EQ(m.at("APPLE"), 2);
+  EXPECT_TRUE(m.contains("banana"));
+  EXPECT_EQ(m.begin()->first, "Apple");
+}
+
+TEST(MapNonTyped, TransparentLookup) {
+  s21::map<std::string, int, std::less<>> m{{"one", 1}, {"two", 2}};
+  std::string_view key{"two"};
+
+  EXPECT_EQ(m.find(key)->second, 2);
+  EXPECT_TRUE(m.contains(std::string_view{"one"}));
+  EXPECT_EQ(m.count(std::string_view{"three"}), size_t{0});
+  EXPECT_EQ(m.lower_bound(std::string_view{"p"})->first, "two");
+
+  const auto& const_m = m;
+  auto [first, last] = const_m.equal_range(key);
+  EXPECT_EQ(std::distance(first, last), 1);
+}
+
+struct CopyCounter {
+  static inline int copies{0};
+  int value{0};
+
+  CopyCounter() = default;
+  explicit CopyCounter(int v) : value{v} {}
+  CopyCounter(const CopyCounter& other) : value{other.value} { ++copies; }
+  CopyCounter(CopyCounter&& other) noexcept : value{other.value} {}
+  CopyCounter& operator=(const CopyCounter& other) {
+    value = other.value;
+    ++copies;
+    return *this;
+  }
+  CopyCounter& operator=(CopyCounter&& other) noexcept {
+    value = other.value;
+    return *this;
+  }
+};
+
+TEST(MapNonTyped, MoveOnlyValues) {
+  s21::map<int, std::unique_ptr<std::vector<int>>> m;
+  m[1] = std::make_unique<std::vector<int>>(1000, 1);
+  m.try_emplace(2, std::make_unique<std::vector<int>>(10, 2));
+  m.emplace(3, std::make_unique<std::vector<int>>(5, 3));
+  m.insert_or_assign(1, std::make_unique<std::vector<int>>(3, 7));
+  m.insert({4, nullptr});
+
+  EXPECT_EQ(m.size(), size_t{4});
+  EXPECT_EQ(m.at(1)->size(), size_t{3});
+  EXPECT_EQ(m.at(1)->front(), 7);
+  EXPECT_EQ(m.at(2)->size(), size_t{10});
+  EXPECT_EQ(m.at(3)->back(), 3);
+  EXPECT_EQ(m.at(4), nullptr);
+}
+
+TEST(MapNonTyped, InPlaceConstructionDoesNotCopy) {
+  s21::map<int, CopyCounter> m;
+  CopyCounter::copies = 0;
+
+  m[1].value = 10;
+  m.try_emplace(2, 20);
+  m.emplace(std::piecewise_construct, std::forward_as_tuple(3),
+            std::forward_as_tuple(30));
+  m.emplace_hint(m.end(), 4, CopyCounter{40});
+  m.insert({5, CopyCounter{50}});
+  m.insert_or_assign(5, CopyCounter{55});
+  m.insert(6, CopyCounter{60});
+
+  EXPECT_EQ(CopyCounter::copies, 0);
+  EXPECT_EQ(m.size(), size_t{6});
+  EXPECT_EQ(m.at(3).value, 30);
+  EXPECT_EQ(m.at(5).value, 55);
+}
+
+TEST(MapNonTyped, TryEmplaceLeavesArgumentsAloneWhenKeyExists) {
+  s21::map<std::string, std::unique_ptr<int>> m;
+  m.try_emplace("key", std::make_unique<int>(1));
+
+  auto value = std::make_unique<int>(2);
+  auto [it, inserted] = m.try_emplace("key", std::move(value));
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(*it->second, 1);
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(*value, 2);
+
+  auto [it2, inserted2] = m.insert_or_assign("key", std::move(value));
+  EXPECT_FALSE(inserted2);
+  EXPECT_EQ(*it2->second, 2);
+}
+
+TEST(MapNonTyped, EmplaceDuplicateKeepsOriginal) {
+  s21::map<int, std::string> m{{1, "one"}};
+  auto [it, inserted] = m.emplace(1, "uno");
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(it->second, "one");
+  EXPECT_EQ(m.size(), size_t{1});
+}
+
+TEST(MapNonTyped, HintedInsertAppendsInOrder) {
+  s21::map<int, int> m;
+  for (int i{0}; i < 1000; ++i) {
+    auto it = m.insert(m.end(), {i, i * 2});
+    EXPECT_EQ(it->first, i);
+  }
+  EXPECT_EQ(m.size(), size_t{1000});
+  EXPECT_EQ(std::prev(m.end())->first, 999);
+  int expected{0};
+  for (const auto& [key, value] : m) {
+    EXPECT_EQ(key, expected);
+    EXPECT_EQ(value, key * 2);
+    ++expected;
+  }
+}
+
+TEST(MapNonTyped, HintedInsertWithAnyHint) {
+  s21::map<int, int> m;
+  std::map<int, int> reference;
+  for (int i{0}; i < 3000; ++i) {
+    int key{Random::Get(0, 999)};
+    s21::map<int, int>::const_iterator hint{m.end()};
+    switch (i % 4) {
+      case 0:
+        hint = m.lower_bound(key);
+        break;
+      case 1:
+        hint = m.begin();
+        break;
+      case 2:
+        hint = m.upper_bound(key);
+        break;
+      default:
+        break;
+    }
+    auto it = m.insert(hint, {key, i});
+    EXPECT_EQ(it->first, key);
+    EXPECT_EQ(it->second, reference.insert({key, i}).first->second);
+  }
+  EXPECT_TRUE(std::equal(m.begin(), m.end(), reference.begin(),
+                         reference.end()));
+}
+
+TEST(MapNonTyped, TryEmplaceAndEmplaceWithHint) {
+  s21::map<int, std::string> m;
+  for (int i{10}; i > 0; --i) {
+    m.try_emplace(m.begin(), i, size_t(2), 'a');
+  }
+  auto it = m.try_emplace(m.end(), 5, "ignored");
+  EXPECT_EQ(it->second, "aa");
+  it = m.emplace_hint(m.find(7), 7, "ignored");
+  EXPECT_EQ(it->second, "aa");
+  it = m.emplace_hint(m.end(), 11, "b");
+  EXPECT_EQ(it->second, "b");
+  EXPECT_EQ(m.size(), size_t{11});
+  EXPECT_EQ(m.begin()->first, 1);
+  EXPECT_EQ(std::prev(m.end())->first, 11);
+}
+
+TEST(MapNonTyped, ExtractAndInsertNodeHandle) {
+  s21::map<int, std::string> m{{1, "one"}, {2, "two"}, {3, "three"}};
+  auto handle = m.extract(2);
+  EXPECT_EQ(m.size(), size_t{2});
+  ASSERT_FALSE(handle.empty());
+  EXPECT_EQ(handle.key(), 2);
+  handle.mapped() = "deux";
+  const std::string* address = &handle.mapped();
+
+  s21::map<int, std::string> other;
+  auto result = other.insert(std::move(handle));
+  EXPECT_TRUE(result.inserted);
+  EXPECT_TRUE(result.node.empty());
+  EXPECT_EQ(&result.position->second, address);
+  EXPECT_EQ(other.at(2), "deux");
+
+  result = m.insert(m.extract(m.find(1)));
+  EXPECT_TRUE(result.inserted);
+  EXPECT_TRUE(m.extract(42).empty());
+
+  s21::map<int, std::string> clash{{3, "trois"}};
+  result = clash.insert(m.extract(3));
+  EXPECT_FALSE(result.inserted);
+  EXPECT_EQ(result.position->second, "trois");
+  EXPECT_EQ(result.node.mapped(), "three");
+}
+
+TEST(MapNonTyped, NodeHandleOutlivesMap) {
+  s21::map<int, std::string>::node_handle handle;
+  {
+    s21::map<int, std::string> m;
+    for (int i{0}; i < 100; ++i) {
+      m.insert({i, std::string(40, 'x')});
+    }
+    handle = m.extract(50);
+  }
+  EXPECT_EQ(handle.mapped(), std::string(40, 'x'));
+
+  s21::map<int, std::string> target;
+  target.insert(std::move(handle));
+  target.erase(target.begin());
+  target.insert({7, "reuses the adopted slot"});
+  EXPECT_EQ(target.at(7), "reuses the adopted slot");
+}
+
+TEST(MapNonTyped, MergeMovesNodes) {
+  s21::map<int, std::string> m{{1, "a"}, {3, "c"}};
+  s21::map<int, std::string> other{{2, "b"}, {3, "x"}, {4, "d"}};
+  const std::string* address = &other.at(4);
+  m.merge(other);
+  EXPECT_EQ(m.size(), size_t{4});
+  EXPECT_EQ(&m.at(4), address);
+  EXPECT_EQ(m.at(3), "c");
+  EXPECT_TRUE(other.empty());
+  other.insert({5, "e"});
+  EXPECT_EQ(other.size(), size_t{1});
+}
+
+TEST(MapAllocatorTest, MergeAcrossResources) {
+  TrackingResource first_resource;
+  TrackingResource second_resource;
+  {
+    s21::pmr::map<int, int> first({{1, 1}, {2, 2}}, &first_resource);
+    s21::pmr::map<int, int> second({{2, 20}, {3, 3}}, &second_resource);
+    first.merge(second);
+    EXPECT_EQ(first.size(), size_t{3});
+    EXPECT_EQ(first.at(2), 2);
+    EXPECT_EQ(first.at(3), 3);
+    EXPECT_TRUE(second.empty());
+  }
+  EXPECT_EQ(first_resource.bytes_in_use(), size_t{0});
+  EXPECT_EQ(second_resource.bytes_in_use(), size_t{0});
+}
+
+TEST(MapAllocatorTest, MergeSharesSlabsUntilBothAreGone) {
+  TrackingResource resource;
+  {
+    s21::pmr::map<int, DummyObject> target(&resource);
+    {
+      s21::pmr::map<int, DummyObject> source(&resource);
+      for (int i{0}; i < 300; ++i) {
+        source.insert(i, DummyObject{i});
+      }
+      target.merge(source);
+    }
+    EXPECT_EQ(target.size(), size_t{300});
+    EXPECT_GT(resource.bytes_in_use(), size_t{0});
+    target.clear();
+  }
+  EXPECT_EQ(resource.bytes_in_use(), size_t{0});
+}
+
+TEST(MapNonTyped, SetAlgebraKeepsLeftValues) {
+  s21::map<int, std::string> lhs{{1, "a"}, {2, "b"}, {3, "c"}};
+  s21::map<int, std::string> rhs{{2, "B"}, {3, "C"}, {4, "D"}};
+
+  auto merged = s21::set_union(lhs, rhs);
+  EXPECT_EQ(merged.size(), size_t{4});
+  EXPECT_EQ(merged.at(2), "b");
+  EXPECT_EQ(merged.at(4), "D");
+
+  auto common = s21::set_intersection(rhs, lhs);
+  EXPECT_EQ(common.size(), size_t{2});
+  EXPECT_EQ(common.at(3), "C");
+
+  auto rest = s21::set_difference(std::move(lhs), std::move(rhs));
+  EXPECT_EQ(rest.size(), size_t{1});
+  EXPECT_EQ(rest.at(1), "a");
+}
+
+TEST(MapAllocatorTest, ArenaBacked) {
+  std::byte buffer[131072];
+  std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer),
+                                            std::pmr::null_memory_resource()};
+  s21::pmr::map<int, double> m{&arena};
+  for (int i{0}; i < 1000; ++i) {
+    m[i] = i * 0.5;
+  }
+
+  EXPECT_EQ(m.size(), size_t{1000});
+  EXPECT_EQ(m.at(10), 5.0);
+  EXPECT_EQ(m.get_allocator().resource(), &arena);
+}
+
+TEST(MapAllocatorTest, ReleasesEverything) {
+  TrackingResource resource;
+  {
+    s21::pmr::map<int, DummyObject> m({{1, DummyObject{1}}}, &resource);
+    for (int i{2}; i < 300; ++i) {
+      m.insert(i, DummyObject{i});
+    }
+    m.erase(m.begin());
+    s21::pmr::map<int, DummyObject> copy{m};
+    EXPECT_TRUE(copy == m);
+  }
+  EXPECT_GT(resource.allocations(), size_t{0});
+  EXPECT_EQ(resource.bytes_in_use(), size_t{0});
+}
+
+TEST(MapAllocatorTest, SwapKeepsNodesInPlace) {
+  TrackingResource resource;
+  {
+    s21::pmr::map<int, int> first({{1, 1}, {2, 2}}, &resource);
+    s21::pmr::map<int, int> second({{3, 3}}, &resource);
+    auto kept = first.find(2);
+    std::size_t allocations{resource.allocations()};
+
+    first.swap(second);
+    EXPECT_EQ(resource.allocations(), allocations);
+    EXPECT_EQ(first.size(), size_t{1});
+    EXPECT_EQ(first.at(3), 3);
+    EXPECT_EQ(second.size(), size_t{2});
+    EXPECT_EQ(kept->second, 2);
+    EXPECT_EQ(std::next(kept), second.end());
+    second.insert(4, 4);
+    first.erase(3);
+    EXPECT_TRUE(first.empty());
+  }
+  EXPECT_EQ(resource.bytes_in_use(), size_t{0});
+}
+
+TEST(MapAllocatorTest, MoveAssignBetweenResources) {
+  TrackingResource first_resource;
+  TrackingResource second_resource;
+  {
+    s21::pmr::map<int, int> first({{1, 1}, {2, 2}}, &first_resource);
+    s21::pmr::map<int, int> second({{3, 3}}, &second_resource);
+
+    first = std::move(second);
+    EXPECT_EQ(first.size(), size_t{1});
+    EXPECT_EQ(first.at(3), 3);
+    EXPECT_EQ(first.get_allocator().resource(), &first_resource);
+    EXPECT_EQ(second.size(), size_t{0});
+  }
+  EXPECT_EQ(first_resource.bytes_in_use(), size_t{0});
+  EXPECT_EQ(second_resource.bytes_in_use(), size_t{0});
+}
+
+TEST(MapAllocatorTest, CopyAssignRecyclesNodes) {
+  TrackingResource resource;
+  TrackingResource other_resource;
+  {
+    s21::pmr::map<int, int> target(&resource);
+    s21::pmr::map<int, int> smaller(&other_resource);
+    for (int i{0}; i < 1000; ++i) {
+      target[i] = i;
+      if (i % 5 != 0) {
+        smaller[-i] = i;
+      }
+    }
+    std::size_t allocations{resource.allocations()};
+    target = smaller;
+    EXPECT_EQ(resource.allocations(), allocations);
+    EXPECT_TRUE(target == smaller);
+    EXPECT_EQ(target.get_allocator().resource(), &resource);
+
+    s21::pmr::map<int, int> copy{target};
+    EXPECT_TRUE(copy == smaller);
+    EXPECT_EQ(copy.get_allocator().resource(),
+              std::pmr::get_default_resource());
+  }
+  EXPECT_EQ(resource.bytes_in_use(), size_t{0});
+  EXPECT_EQ(other_resource.bytes_in_use(), size_t{0});
+}
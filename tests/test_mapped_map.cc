@@ -0,0 +1,156 @@
+#include "s21_mapped_map.h"
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+#include <gtest/gtest.h>
+#pragma GCC diagnostic pop
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <system_error>
+
+#include "random.h"
+
+namespace {
+
+std::string FrozenPath(const std::string& name) {
+  return testing::TempDir() + "s21_mapped_map_" + name;
+}
+
+struct Point {
+  double x;
+  double y;
+  char tag;
+};
+
+}  // namespace
+
+TEST(MappedMapTest, RoundTrip) {
+  s21::map<int, long> source;
+  std::map<int, long> reference;
+  for (int i = 0; i < 5000; ++i) {
+    int key = Random::Get(-100000, 100000);
+    source.insert_or_assign(key, i);
+    reference[key] = i;
+  }
+  std::string path{FrozenPath("round_trip")};
+  s21::freeze(source, path);
+
+  s21::mapped_map<int, long> frozen{path};
+  ASSERT_EQ(frozen.size(), reference.size());
+  auto it = frozen.begin();
+  for (const auto& [key, value] : reference) {
+    EXPECT_EQ(it->first, key);
+    EXPECT_EQ(it->second, value);
+    EXPECT_EQ(frozen.at(key), value);
+    EXPECT_EQ(frozen.find(key), it);
+    ++it;
+  }
+  EXPECT_EQ(it, frozen.end());
+  EXPECT_EQ(static_cast<std::size_t>(frozen.end() - frozen.begin()),
+            reference.size());
+
+  for (int i = 0; i < 1000; ++i) {
+    int key = Random::Get(-110000, 110000);
+    auto lower = reference.lower_bound(key);
+    auto upper = reference.upper_bound(key);
+    EXPECT_EQ(frozen.contains(key), reference.count(key) == 1);
+    EXPECT_EQ(frozen.lower_bound(key) - frozen.begin(),
+              std::distance(reference.begin(), lower));
+    EXPECT_EQ(frozen.upper_bound(key) - frozen.begin(),
+              std::distance(reference.begin(), upper));
+    auto [first, last] = frozen.equal_range(key);
+    EXPECT_EQ(last - first, std::distance(lower, upper));
+  }
+  EXPECT_THROW(frozen.at(200000), std::out_of_range);
+  std::remove(path.c_str());
+}
+
+TEST(MappedMapTest, EmptyMap) {
+  std::string path{FrozenPath("empty")};
+  s21::freeze(s21::map<int, int>{}, path);
+  s21::mapped_map<int, int> frozen{path};
+  EXPECT_TRUE(frozen.empty());
+  EXPECT_EQ(frozen.begin(), frozen.end());
+  EXPECT_EQ(frozen.find(1), frozen.end());
+  EXPECT_EQ(frozen.count(1), 0u);
+  std::remove(path.c_str());
+}
+
+TEST(MappedMapTest, StructValuesAndCustomOrder) {
+  s21::map<short, Point, std::greater<short>> source;
+  for (short i = 0; i < 100; ++i) {
+    char tag{static_cast<char>('a' + i % 26)};
+    source.insert({i, Point{i * 0.5, -i * 0.5, tag}});
+  }
+  std::string path{FrozenPath("points")};
+  s21::freeze(source, path);
+
+  s21::mapped_map<short, Point, std::greater<short>> frozen{path};
+  EXPECT_EQ(frozen.begin()->first, 99);
+  EXPECT_EQ(std::prev(frozen.end())->first, 0);
+  const Point& point{frozen.at(30)};
+  EXPECT_EQ(point.x, 15.0);
+  EXPECT_EQ(point.y, -15.0);
+  EXPECT_EQ(point.tag, 'e');
+  EXPECT_EQ(frozen.lower_bound(50)->first, 50);
+  std::remove(path.c_str());
+}
+
+TEST(MappedMapTest, ReplacesExistingFile) {
+  std::string path{FrozenPath("replace")};
+  s21::freeze(s21::map<int, int>{{1, 1}}, path);
+  s21::mapped_map<int, int> old_frozen{path};
+  s21::freeze(s21::map<int, int>{{2, 2}, {3, 3}}, path);
+  s21::mapped_map<int, int> new_frozen{path};
+  EXPECT_EQ(old_frozen.size(), 1u);
+  EXPECT_EQ(old_frozen.at(1), 1);
+  EXPECT_EQ(new_frozen.size(), 2u);
+  EXPECT_FALSE(new_frozen.contains(1));
+  std::remove(path.c_str());
+}
+
+TEST(MappedMapTest, RejectsBadFiles) {
+  EXPECT_THROW((s21::mapped_map<int, int>{FrozenPath("missing")}),
+               std::system_error);
+
+  std::string path{FrozenPath("bad")};
+  std::ofstream{path} << "definitely not a frozen map, just some text";
+  EXPECT_THROW((s21::mapped_map<int, int>{path}), std::runtime_error);
+
+  std::ofstream{path} << "tiny";
+  EXPECT_THROW((s21::mapped_map<int, int>{path}), std::runtime_error);
+
+  s21::map<int, int> source{{1, 2}, {3, 4}};
+  s21::freeze(source, path);
+  EXPECT_THROW((s21::mapped_map<int, long>{path}), std::runtime_error);
+  EXPECT_THROW((s21::mapped_map<long, int>{path}), std::runtime_error);
+
+  std::string truncated{FrozenPath("truncated")};
+  {
+    std::ifstream in{path, std::ios::binary};
+    std::string bytes{std::istreambuf_iterator<char>{in}, {}};
+    std::ofstream{truncated, std::ios::binary}
+        << bytes.substr(0, bytes.size() - 1);
+  }
+  EXPECT_THROW((s21::mapped_map<int, int>{truncated}), std::runtime_error);
+  std::remove(path.c_str());
+  std::remove(truncated.c_str());
+}
+
+TEST(MappedMapTest, MoveOnly) {
+  std::string path{FrozenPath("move")};
+  s21::freeze(s21::map<int, int>{{1, 10}, {2, 20}}, path);
+  s21::mapped_map<int, int> first{path};
+  s21::mapped_map<int, int> second{std::move(first)};
+  EXPECT_EQ(second.at(2), 20);
+  EXPECT_TRUE(first.empty());
+
+  s21::mapped_map<int, int> third{path};
+  third = std::move(second);
+  EXPECT_EQ(third.size(), 2u);
+  EXPECT_EQ(third.at(1), 10);
+  std::remove(path.c_str());
+}
@@ -3,9 +3,16 @@
 #include <gtest/gtest.h>
 #pragma GCC diagnostic pop
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
 #include <set>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "s21_multiset.h"
+#include "tracking_resource.h"
 
 template <typename Key>
 class MultisetTest : public testing::Test {
@@ -148,3 +155,208 @@ TEST(MultisetNonTyped, ComplexOperations) {
   EXPECT_NE(new_lower, lower);
   EXPECT_EQ(*new_lower, 1);
 }
+
+TEST(MultisetNonTyped, CopyKeepsDuplicates) {
+  s21::multiset<int> source{5, 1, 5, 3, 5, 1};
+  s21::multiset<int> copy{source};
+  EXPECT_EQ(copy, source);
+  EXPECT_EQ(copy.count(5), size_t{3});
+
+  s21::multiset<int> target{7, 7, 7, 7, 7, 7, 7, 7};
+  target = source;
+  EXPECT_EQ(target, source);
+  EXPECT_EQ(target.count(1), size_t{2});
+  EXPECT_EQ(target.count(7), size_t{0});
+}
+
+TEST(MultisetNonTyped, RangeConstructorKeepsDuplicates) {
+  std::vector<int> items{5, 1, 5, 3, 1, 5};
+  s21::multiset<int> mset(items.begin(), items.end());
+  std::multiset<int> stl_mset(items.begin(), items.end());
+
+  EXPECT_EQ(mset.size(), stl_mset.size());
+  EXPECT_EQ(mset.count(5), size_t{3});
+  EXPECT_TRUE(
+      std::equal(mset.begin(), mset.end(), stl_mset.begin(), stl_mset.end()));
+}
+
+TEST(MultisetNonTyped, AssignSorted) {
+  std::vector<int> sorted{1, 1, 2, 2, 2, 3};
+  s21::multiset<int> mset{7, 8};
+  mset.assign(sorted.begin(), sorted.end());
+
+  EXPECT_EQ(mset.size(), sorted.size());
+  EXPECT_EQ(mset.count(2), size_t{3});
+  EXPECT_FALSE(mset.contains(7));
+}
+
+TEST(MultisetNonTyped, CountMatchesStd) {
+  s21::multiset<int> mset;
+  std::multiset<int> stl_mset;
+  for (int i = 0; i < 1000; ++i) {
+    mset.insert(i % 37);
+    stl_mset.insert(i % 37);
+  }
+  mset.erase(mset.find(5));
+  stl_mset.erase(stl_mset.find(5));
+
+  for (int key = -1; key < 40; ++key) {
+    EXPECT_EQ(mset.count(key), stl_mset.count(key));
+  }
+}
+
+TEST(MultisetNonTyped, Percentiles) {
+  s21::multiset<int> latencies;
+  for (int i = 1000; i >= 1; --i) {
+    latencies.insert(i);
+  }
+
+  EXPECT_EQ(*latencies.nth_element(0), 1);
+  EXPECT_EQ(*latencies.nth_element(499), 500);
+  EXPECT_EQ(*latencies.nth_element(989), 990);
+  EXPECT_EQ(latencies.nth_element(1000), latencies.end());
+  EXPECT_EQ(latencies.rank(250), size_t{249});
+  EXPECT_EQ(latencies.distance(latencies.find(100), latencies.find(200)),
+            100);
+}
+
+TEST(MultisetNonTyped, RangeViewWithDuplicates) {
+  s21::multiset<int> mset{5, 1, 3, 3, 3, 4, 6, 5};
+  std::vector<int> seen;
+  for (int key : mset.range(3, 5)) {
+    seen.push_back(key);
+  }
+  EXPECT_EQ(seen, (std::vector<int>{3, 3, 3, 4}));
+
+  const auto& const_mset = mset;
+  auto [first, last] = const_mset.equal_range(5);
+  EXPECT_EQ(std::distance(first, last), 2);
+  EXPECT_EQ(const_mset.lower_bound(2), const_mset.equal_range(3).first);
+}
+
+TEST(MultisetNonTyped, CustomCompare) {
+  s21::multiset<int, std::greater<int>> mset{1, 3, 3, 2};
+  std::vector<int> expected{3, 3, 2, 1};
+
+  EXPECT_TRUE(
+      std::equal(mset.begin(), mset.end(), expected.begin(), expected.end()));
+  EXPECT_EQ(mset.count(3), size_t{2});
+  EXPECT_EQ(*mset.nth_element(2), 2);
+  EXPECT_EQ(mset.rank(2), size_t{2});
+  EXPECT_EQ(mset.erase(3), size_t{2});
+}
+
+TEST(MultisetNonTyped, TransparentLookup) {
+  s21::multiset<std::string, std::less<>> mset{"b", "a", "b", "c"};
+  std::string_view key{"b"};
+
+  EXPECT_EQ(mset.count(key), size_t{2});
+  EXPECT_EQ(mset.rank(key), size_t{1});
+  EXPECT_EQ(*mset.find(key), "b");
+  EXPECT_EQ(*mset.upper_bound(key), "c");
+}
+
+TEST(MultisetNonTyped, EmplaceKeepsDuplicates) {
+  s21::multiset<std::string> mset;
+  mset.emplace(size_t{2}, 'a');
+  mset.emplace("aa");
+  std::string key{"b"};
+  mset.insert(std::move(key));
+  mset.emplace_hint(mset.end(), "b");
+
+  EXPECT_EQ(mset.size(), size_t{4});
+  EXPECT_EQ(mset.count("aa"), size_t{2});
+  EXPECT_EQ(mset.count("b"), size_t{2});
+}
+
+TEST(MultisetNonTyped, HintedInsertKeepsEqualKeysAtHint) {
+  s21::multiset<int> ms{1, 3, 3, 3, 5};
+  auto second_three = std::next(ms.find(3));
+  auto it = ms.insert(second_three, 3);
+  EXPECT_EQ(std::next(it), second_three);
+  EXPECT_EQ(std::distance(ms.begin(), it), 2);
+
+  it = ms.emplace_hint(ms.end(), 7);
+  EXPECT_EQ(std::next(it), ms.end());
+  it = ms.insert(ms.begin(), 4);
+  EXPECT_EQ(*std::prev(it), 3);
+  EXPECT_EQ(*std::next(it), 5);
+
+  std::vector<int> keys(ms.begin(), ms.end());
+  EXPECT_EQ(keys, (std::vector<int>{1, 3, 3, 3, 3, 4, 5, 7}));
+}
+
+TEST(MultisetNonTyped, HintedAppendInOrder) {
+  s21::multiset<int> ms;
+  std::multiset<int> reference;
+  for (int i{0}; i < 2000; ++i) {
+    ms.insert(ms.end(), i / 3);
+    reference.insert(reference.end(), i / 3);
+  }
+  EXPECT_EQ(ms.size(), size_t{2000});
+  EXPECT_EQ(ms.count(100), size_t{3});
+  EXPECT_TRUE(std::equal(ms.begin(), ms.end(), reference.begin(),
+                         reference.end()));
+}
+
+TEST(MultisetNonTyped, ExtractAndMergeKeepDuplicates) {
+  s21::multiset<int> ms{1, 2, 2, 3};
+  s21::multiset<int> other{2, 3, 3, 4};
+  auto handle = other.extract(3);
+  EXPECT_EQ(other.count(3), size_t{1});
+  auto it = ms.insert(std::move(handle));
+  EXPECT_EQ(*it, 3);
+  EXPECT_EQ(*std::prev(it), 3);
+
+  ms.merge(other);
+  EXPECT_TRUE(other.empty());
+  std::vector<int> keys(ms.begin(), ms.end());
+  EXPECT_EQ(keys, (std::vector<int>{1, 2, 2, 2, 3, 3, 3, 4}));
+  EXPECT_EQ(ms.rank(3), size_t{4});
+  EXPECT_EQ(ms.insert(s21::multiset<int>::node_handle{}), ms.end());
+}
+
+TEST(MultisetNonTyped, EraseExpiredWindow) {
+  s21::multiset<int> timestamps;
+  std::multiset<int> reference;
+  for (int i = 0; i < 5000; ++i) {
+    timestamps.insert(i / 3);
+    reference.insert(i / 3);
+  }
+  for (int cutoff : {10, 500, 1600}) {
+    auto next = timestamps.erase(timestamps.begin(),
+                                 timestamps.lower_bound(cutoff));
+    reference.erase(reference.begin(), reference.lower_bound(cutoff));
+    EXPECT_EQ(next, timestamps.begin());
+    EXPECT_TRUE(std::equal(timestamps.begin(), timestamps.end(),
+                           reference.begin(), reference.end()));
+  }
+  EXPECT_EQ(timestamps.erase(1650), size_t{3});
+  EXPECT_EQ(timestamps.size(), reference.size() - 3);
+}
+
+TEST(MultisetAllocatorTest, ArenaBacked) {
+  std::byte buffer[131072];
+  std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer),
+                                            std::pmr::null_memory_resource()};
+  s21::pmr::multiset<int> mset{&arena};
+  for (int i{0}; i < 1000; ++i) {
+    mset.insert(i % 10);
+  }
+
+  EXPECT_EQ(mset.size(), size_t{1000});
+  EXPECT_EQ(mset.count(3), size_t{100});
+}
+
+TEST(MultisetAllocatorTest, ReleasesEverything) {
+  TrackingResource resource;
+  {
+    s21::pmr::multiset<int> mset(5, 42, &resource);
+    mset.insert(1);
+    mset.erase(42);
+    s21::pmr::multiset<int> copy{mset};
+    EXPECT_TRUE(copy == mset);
+  }
+  EXPECT_GT(resource.allocations(), size_t{0});
+  EXPECT_EQ(resource.bytes_in_use(), size_t{0});
+}
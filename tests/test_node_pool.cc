@@ -0,0 +1,97 @@
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+#include <gtest/gtest.h>
+#pragma GCC diagnostic pop
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "s21_node_pool.h"
+
+struct SmallObject {
+  int value_;
+};
+
+struct LargeObject {
+  char data_[200];
+};
+
+TEST(NodePoolTest, SmallSlotsFitInCacheLine) {
+  EXPECT_EQ(s21::NodePool<SmallObject>::SlotSize(), sizeof(void*));
+  EXPECT_EQ(s21::NodePool<char[40]>::SlotSize(), size_t{64});
+  EXPECT_EQ(64 % s21::NodePool<char[24]>::SlotSize(), size_t{0});
+  EXPECT_GE(s21::NodePool<LargeObject>::SlotSize(), sizeof(LargeObject));
+}
+
+TEST(NodePoolTest, AllocateDistinctAlignedSlots) {
+  s21::NodePool<char[40]> pool;
+  std::set<void*> seen;
+  for (int i{0}; i < 1000; ++i) {
+    void* slot = pool.Allocate();
+    EXPECT_TRUE(seen.insert(slot).second);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(slot) % 64, 0u);
+  }
+}
+
+TEST(NodePoolTest, DeallocatedSlotIsReused) {
+  s21::NodePool<SmallObject> pool;
+  SmallObject* first = pool.Allocate();
+  SmallObject* second = pool.Allocate();
+  pool.Deallocate(first);
+  EXPECT_EQ(pool.Allocate(), first);
+  pool.Deallocate(second);
+  EXPECT_EQ(pool.Allocate(), second);
+}
+
+TEST(NodePoolTest, ReleaseAndReuse) {
+  s21::NodePool<std::string> pool;
+  std::vector<std::string*> strings;
+  for (int i{0}; i < 500; ++i) {
+    strings.push_back(new (pool.Allocate()) std::string(100, 'x'));
+  }
+  for (std::string* str : strings) {
+    str->~basic_string();
+  }
+  pool.Release();
+
+  std::string* str = new (pool.Allocate()) std::string("after release");
+  EXPECT_EQ(*str, "after release");
+  str->~basic_string();
+}
+
+TEST(NodePoolTest, MoveTransfersSlabs) {
+  s21::NodePool<SmallObject> pool;
+  SmallObject* object = new (pool.Allocate()) SmallObject{42};
+
+  s21::NodePool<SmallObject> other{std::move(pool)};
+  EXPECT_EQ(object->value_, 42);
+  other.Deallocate(object);
+  EXPECT_EQ(other.Allocate(), object);
+  object->value_ = 21;
+
+  pool = std::move(other);
+  EXPECT_EQ(object->value_, 21);
+}
+
+TEST(NodePoolTest, SharedSlabsOutliveRelease) {
+  s21::NodePool<SmallObject> pool;
+  SmallObject* object = new (pool.Allocate()) SmallObject{7};
+  std::shared_ptr<const void> keep_alive = pool.Share();
+  pool.Release();
+  EXPECT_EQ(object->value_, 7);
+  EXPECT_NE(pool.Allocate(), object);
+}
+
+TEST(NodePoolTest, AdoptedSlotIsRecycled) {
+  s21::NodePool<SmallObject> source;
+  SmallObject* object = new (source.Allocate()) SmallObject{1};
+  s21::NodePool<SmallObject> target;
+  target.Adopt(source.Share());
+  source.Release();
+
+  target.Deallocate(object);
+  EXPECT_EQ(target.Allocate(), object);
+}
@@ -0,0 +1,150 @@
+#include "s21_persistent_map.h"
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+#include <gtest/gtest.h>
+#pragma GCC diagnostic pop
+
+#include <functional>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "random.h"
+#include "tracking_resource.h"
+
+TEST(PersistentMapTest, InitializerListAndLookups) {
+  s21::persistent_map<int, std::string> map{{3, "c"}, {1, "a"}, {2, "b"}};
+  EXPECT_EQ(map.size(), 3u);
+  EXPECT_EQ(map.at(2), "b");
+  EXPECT_THROW(map.at(4), std::out_of_range);
+  EXPECT_TRUE(map.contains(1));
+  EXPECT_EQ(map.count(5), 0u);
+  EXPECT_EQ(map.begin()->first, 1);
+  EXPECT_EQ(std::prev(map.end())->first, 3);
+  EXPECT_EQ(map.lower_bound(2)->second, "b");
+  EXPECT_EQ(map.upper_bound(2)->second, "c");
+  auto [first, last] = map.equal_range(2);
+  EXPECT_EQ(std::distance(first, last), 1);
+}
+
+TEST(PersistentMapTest, InsertVariants) {
+  s21::persistent_map<int, std::string> map;
+  EXPECT_TRUE(map.insert({1, "one"}).second);
+  EXPECT_FALSE(map.insert({1, "uno"}).second);
+  EXPECT_TRUE(map.insert(2, "two").second);
+  EXPECT_TRUE(map.emplace(3, "three").second);
+  EXPECT_FALSE(map.try_emplace(3, "tres").second);
+  EXPECT_TRUE(map.try_emplace(4, 3, 'x').second);
+  EXPECT_EQ(map.at(1), "one");
+  EXPECT_EQ(map.at(3), "three");
+  EXPECT_EQ(map.at(4), "xxx");
+}
+
+TEST(PersistentMapTest, SnapshotIsolation) {
+  s21::persistent_map<int, int> map;
+  for (int i = 0; i < 100; ++i) map.insert(i, i);
+  auto snapshot = map.snapshot();
+  EXPECT_TRUE(snapshot == map);
+
+  map.insert_or_assign(10, -10);
+  map.erase(20);
+  map.insert(1000, 1000);
+  EXPECT_EQ(map.at(10), -10);
+  EXPECT_EQ(snapshot.at(10), 10);
+  EXPECT_TRUE(snapshot.contains(20));
+  EXPECT_FALSE(snapshot.contains(1000));
+  EXPECT_FALSE(snapshot == map);
+  EXPECT_EQ(snapshot.size(), 100u);
+  EXPECT_EQ(map.size(), 100u);
+}
+
+TEST(PersistentMapTest, SnapshotsMatchStdMap) {
+  s21::persistent_map<int, int> map;
+  std::map<int, int> reference;
+  std::vector<std::pair<s21::persistent_map<int, int>, std::map<int, int>>>
+      snapshots;
+  for (int i = 0; i < 3000; ++i) {
+    int key = Random::Get(0, 200);
+    switch (Random::Get(0, 3)) {
+      case 0:
+        EXPECT_EQ(map.erase(key), reference.erase(key));
+        break;
+      case 1:
+        map.insert_or_assign(key, i);
+        reference.insert_or_assign(key, i);
+        break;
+      default:
+        EXPECT_EQ(map.insert(key, i).second, reference.emplace(key, i).second);
+    }
+    if (i % 250 == 0) {
+      snapshots.emplace_back(map.snapshot(), reference);
+    }
+  }
+  EXPECT_TRUE(std::equal(map.begin(), map.end(), reference.begin(),
+                         reference.end()));
+  for (const auto& [snapshot, expected] : snapshots) {
+    EXPECT_TRUE(std::equal(snapshot.begin(), snapshot.end(), expected.begin(),
+                           expected.end()));
+  }
+}
+
+TEST(PersistentMapTest, EraseByIterator) {
+  s21::persistent_map<int, int> map;
+  for (int i = 0; i < 10; ++i) map.insert(i, i);
+  auto it = map.erase(map.find(4));
+  EXPECT_EQ(it->first, 5);
+  EXPECT_EQ(map.erase(std::prev(map.end())), map.end());
+  EXPECT_EQ(map.size(), 8u);
+}
+
+TEST(PersistentMapTest, Range) {
+  s21::persistent_map<int, int> map;
+  for (int i = 0; i < 20; ++i) map.insert(i, i * i);
+  int sum = 0;
+  for (const auto& [key, value] : map.range(5, 8)) {
+    sum += value;
+    EXPECT_LT(key, 8);
+  }
+  EXPECT_EQ(sum, 25 + 36 + 49);
+}
+
+TEST(PersistentMapTest, TransparentLookup) {
+  s21::persistent_map<std::string, int, std::less<>> map{{"apple", 1},
+                                                          {"pear", 2}};
+  EXPECT_TRUE(map.contains("pear"));
+  EXPECT_EQ(map.find("apple")->second, 1);
+  EXPECT_EQ(map.count("plum"), 0u);
+}
+
+TEST(PersistentMapTest, CopyAndMove) {
+  s21::persistent_map<int, int> map{{1, 1}, {2, 2}};
+  s21::persistent_map<int, int> copy{map};
+  s21::persistent_map<int, int> moved{std::move(map)};
+  EXPECT_TRUE(map.empty());
+  EXPECT_TRUE(copy == moved);
+  map = copy;
+  EXPECT_EQ(map.size(), 2u);
+  map.clear();
+  EXPECT_EQ(copy.size(), 2u);
+  map.swap(copy);
+  EXPECT_TRUE(copy.empty());
+  EXPECT_EQ(map.size(), 2u);
+}
+
+TEST(PersistentMapTest, PmrSnapshotsReleaseMemory) {
+  TrackingResource resource;
+  {
+    s21::pmr::persistent_map<int, int> map{&resource};
+    for (int i = 0; i < 1000; ++i) map.insert(i, i);
+    std::size_t before{resource.allocations()};
+    auto snapshot = map.snapshot();
+    EXPECT_EQ(resource.allocations(), before);
+    map.insert_or_assign(500, 0);
+    EXPECT_GT(resource.allocations(), before);
+    EXPECT_EQ(snapshot.at(500), 500);
+  }
+  EXPECT_EQ(resource.bytes_in_use(), 0u);
+}
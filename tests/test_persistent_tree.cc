@@ -0,0 +1,415 @@
+#include "s21_persistent_tree.h"
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+#include <gtest/gtest.h>
+#pragma GCC diagnostic pop
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "random.h"
+#include "tracking_resource.h"
+
+// Checks the red-black properties, key order, the element count and that
+// every reachable node is still referenced
+template <typename Tree>
+bool ValidatePersistentTree(const Tree& tree) {
+  const auto* root{tree.get_root()};
+  if (root == nullptr) {
+    return tree.size() == 0 && tree.begin() == tree.end();
+  }
+  if (root->color_ != s21::NodeColor::BLACK) {
+    return false;
+  }
+  std::size_t count{0};
+  bool valid{true};
+  auto walk = [&](const auto& self, const auto* node) -> int {
+    if (node == nullptr) {
+      return 1;
+    }
+    ++count;
+    if (node->references_.load() == 0) valid = false;
+    if (node->color_ == s21::NodeColor::RED &&
+        ((node->left_ && node->left_->color_ == s21::NodeColor::RED) ||
+         (node->right_ && node->right_->color_ == s21::NodeColor::RED))) {
+      valid = false;
+    }
+    int left{self(self, node->left_)};
+    int right{self(self, node->right_)};
+    if (left != right) valid = false;
+    return left + (node->color_ == s21::NodeColor::BLACK ? 1 : 0);
+  };
+  walk(walk, root);
+  if (!valid || count != tree.size()) {
+    return false;
+  }
+  return std::is_sorted(tree.begin(), tree.end()) &&
+         std::adjacent_find(tree.begin(), tree.end()) == tree.end();
+}
+
+template <typename Tree>
+std::size_t Height(const Tree& tree) {
+  auto walk = [](const auto& self, const auto* node) -> std::size_t {
+    return node ? 1 + std::max(self(self, node->left_),
+                               self(self, node->right_))
+                : 0;
+  };
+  return walk(walk, tree.get_root());
+}
+
+// Copies throw once the budget runs out, a negative budget never does
+struct ThrowingCopy {
+  static inline int copies_left = -1;
+
+  explicit ThrowingCopy(int value) : value_{value} {}
+  ThrowingCopy(const ThrowingCopy& other) : value_{other.value_} {
+    if (copies_left == 0) {
+      throw std::runtime_error("copy");
+    }
+    if (copies_left > 0) {
+      --copies_left;
+    }
+  }
+  ThrowingCopy& operator=(const ThrowingCopy&) = default;
+
+  bool operator<(const ThrowingCopy& other) const {
+    return value_ < other.value_;
+  }
+  bool operator==(const ThrowingCopy& other) const {
+    return value_ == other.value_;
+  }
+
+  int value_;
+};
+
+using IntTree = s21::PersistentTree<int>;
+using PmrIntTree =
+    s21::PersistentTree<int, void, std::less<int>,
+                        std::pmr::polymorphic_allocator<int>>;
+
+TEST(PersistentTreeTest, EmptyTree) {
+  IntTree tree;
+  EXPECT_TRUE(tree.empty());
+  EXPECT_EQ(tree.begin(), tree.end());
+  EXPECT_EQ(tree.find(1), tree.end());
+  EXPECT_FALSE(tree.contains(1));
+  EXPECT_EQ(tree.erase_unique(1), 0u);
+  EXPECT_TRUE(ValidatePersistentTree(tree));
+}
+
+TEST(PersistentTreeTest, InsertAndIterateBothWays) {
+  IntTree tree;
+  for (int i = 0; i < 500; ++i) {
+    auto [it, inserted] = tree.insert_unique((i * 37) % 500);
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(*it, (i * 37) % 500);
+  }
+  EXPECT_FALSE(tree.insert_unique(7).second);
+  EXPECT_EQ(tree.size(), 500u);
+  EXPECT_TRUE(ValidatePersistentTree(tree));
+
+  int expected = 0;
+  for (int value : tree) {
+    EXPECT_EQ(value, expected++);
+  }
+  auto it = tree.end();
+  for (int i = 499; i >= 0; --i) {
+    EXPECT_EQ(*--it, i);
+  }
+  EXPECT_EQ(it, tree.begin());
+}
+
+TEST(PersistentTreeTest, Bounds) {
+  IntTree tree;
+  for (int i = 0; i < 100; i += 10) tree.insert_unique(i);
+  EXPECT_EQ(*tree.lower_bound(30), 30);
+  EXPECT_EQ(*tree.lower_bound(31), 40);
+  EXPECT_EQ(*tree.upper_bound(30), 40);
+  EXPECT_EQ(tree.lower_bound(91), tree.end());
+  EXPECT_EQ(*std::prev(tree.lower_bound(91)), 90);
+  EXPECT_EQ(*tree.find(50), 50);
+  EXPECT_EQ(tree.find(55), tree.end());
+  auto [first, last] = tree.equal_range(20);
+  EXPECT_EQ(std::distance(first, last), 1);
+}
+
+TEST(PersistentTreeTest, CopySharesTheRoot) {
+  IntTree tree;
+  for (int i = 0; i < 100; ++i) tree.insert_unique(i);
+  IntTree copy{tree};
+  EXPECT_EQ(copy.get_root(), tree.get_root());
+  EXPECT_EQ(tree.get_root()->references_.load(), 2u);
+  EXPECT_TRUE(std::equal(tree.begin(), tree.end(), copy.begin(), copy.end()));
+}
+
+TEST(PersistentTreeTest, SnapshotsKeepTheirVersion) {
+  IntTree tree;
+  std::set<int> reference;
+  std::vector<IntTree> snapshots;
+  std::vector<std::set<int>> expected;
+  for (int i = 0; i < 4000; ++i) {
+    int key = Random::Get(0, 300);
+    if (Random::Get(0, 2) == 0) {
+      EXPECT_EQ(tree.erase_unique(key), reference.erase(key));
+    } else {
+      EXPECT_EQ(tree.insert_unique(key).second, reference.insert(key).second);
+    }
+    if (i % 100 == 0) {
+      snapshots.push_back(tree);
+      expected.push_back(reference);
+      ASSERT_TRUE(ValidatePersistentTree(tree));
+    }
+  }
+  EXPECT_TRUE(ValidatePersistentTree(tree));
+  EXPECT_TRUE(
+      std::equal(tree.begin(), tree.end(), reference.begin(), reference.end()));
+  for (std::size_t i = 0; i < snapshots.size(); ++i) {
+    ASSERT_TRUE(ValidatePersistentTree(snapshots[i]));
+    EXPECT_TRUE(std::equal(snapshots[i].begin(), snapshots[i].end(),
+                           expected[i].begin(), expected[i].end()));
+  }
+}
+
+TEST(PersistentTreeTest, SnapshotWritesLeaveTheOriginal) {
+  IntTree tree;
+  for (int i = 0; i < 200; ++i) tree.insert_unique(i);
+  IntTree copy{tree};
+  for (int i = 0; i < 200; i += 2) copy.erase_unique(i);
+  for (int i = 200; i < 300; ++i) copy.insert_unique(i);
+  EXPECT_EQ(tree.size(), 200u);
+  EXPECT_EQ(copy.size(), 200u);
+  EXPECT_TRUE(ValidatePersistentTree(tree));
+  EXPECT_TRUE(ValidatePersistentTree(copy));
+  EXPECT_TRUE(tree.contains(0));
+  EXPECT_FALSE(copy.contains(0));
+  EXPECT_FALSE(tree.contains(250));
+}
+
+TEST(PersistentTreeTest, WriteAfterSnapshotCopiesOnlyThePath) {
+  TrackingResource resource;
+  PmrIntTree tree{&resource};
+  for (int i = 0; i < 10000; ++i) tree.insert_unique(i * 2);
+  std::size_t height{Height(tree)};
+
+  std::size_t before{resource.allocations()};
+  PmrIntTree snapshot{tree};
+  EXPECT_EQ(resource.allocations(), before);
+
+  tree.insert_unique(5001);
+  std::size_t copied{resource.allocations() - before};
+  EXPECT_GE(copied, 2u);
+  EXPECT_LE(copied, 2 * height + 1);
+
+  before = resource.allocations();
+  tree.erase_unique(8000);
+  EXPECT_LE(resource.allocations() - before, 4 * height);
+  EXPECT_TRUE(ValidatePersistentTree(tree));
+  EXPECT_TRUE(ValidatePersistentTree(snapshot));
+  EXPECT_TRUE(snapshot.contains(8000));
+  EXPECT_FALSE(snapshot.contains(5001));
+}
+
+TEST(PersistentTreeTest, UnsharedWritesWorkInPlace) {
+  TrackingResource resource;
+  PmrIntTree tree{&resource};
+  for (int i = 0; i < 1000; ++i) tree.insert_unique(i);
+  std::size_t before{resource.allocations()};
+  tree.insert_unique(5000);
+  EXPECT_EQ(resource.allocations(), before + 1);
+  tree.erase_unique(500);
+  tree.erase_unique(5000);
+  EXPECT_EQ(resource.allocations(), before + 1);
+  EXPECT_EQ(resource.bytes_in_use(), 999 * sizeof(PmrIntTree::node_type));
+}
+
+TEST(PersistentTreeTest, LastCopyFreesEverything) {
+  TrackingResource resource;
+  {
+    PmrIntTree tree{&resource};
+    std::vector<PmrIntTree> snapshots;
+    for (int i = 0; i < 2000; ++i) {
+      tree.insert_unique(Random::Get(0, 1000));
+      if (i % 7 == 0) tree.erase_unique(Random::Get(0, 1000));
+      if (i % 50 == 0) snapshots.push_back(tree);
+    }
+    // Drop every other snapshot first, then the rest with the tree
+    for (std::size_t i = 0; i < snapshots.size(); i += 2) {
+      snapshots[i].clear();
+    }
+    for (const auto& snapshot : snapshots) {
+      EXPECT_TRUE(ValidatePersistentTree(snapshot));
+    }
+  }
+  EXPECT_EQ(resource.bytes_in_use(), 0u);
+}
+
+TEST(PersistentTreeTest, EraseIteratorReturnsNext) {
+  IntTree tree;
+  for (int i = 0; i < 50; ++i) tree.insert_unique(i);
+  IntTree snapshot{tree};
+  auto it = tree.find(10);
+  while (it != tree.end() && *it < 40) {
+    it = tree.erase(it);
+  }
+  EXPECT_EQ(*it, 40);
+  EXPECT_EQ(tree.size(), 20u);
+  EXPECT_EQ(tree.erase(tree.find(49)), tree.end());
+  EXPECT_TRUE(ValidatePersistentTree(tree));
+  EXPECT_EQ(snapshot.size(), 50u);
+}
+
+TEST(PersistentTreeTest, KeyFromOwnElement) {
+  s21::PersistentTree<std::string> tree;
+  for (int i = 0; i < 100; ++i) tree.insert_unique(std::to_string(i));
+  std::size_t erased{0};
+  for (bool shared = false; !tree.empty(); shared = !shared) {
+    auto snapshot = shared ? tree : decltype(tree){};
+    erased += tree.erase_unique(*tree.begin());
+    if (!tree.empty()) {
+      EXPECT_FALSE(tree.insert_unique(*tree.begin()).second);
+    }
+  }
+  EXPECT_EQ(erased, 100u);
+}
+
+TEST(PersistentTreeTest, MapValuesCopyOnAssign) {
+  s21::PersistentTree<int, std::string> tree;
+  for (int i = 0; i < 100; ++i) tree.try_emplace(i, "old");
+  auto snapshot = tree;
+  auto [it, inserted] = tree.insert_or_assign(42, std::string("new"));
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(it->second, "new");
+  EXPECT_EQ(snapshot.find(42)->second, "old");
+  EXPECT_TRUE(tree.insert_or_assign(100, std::string("added")).second);
+  EXPECT_FALSE(snapshot.contains(100));
+
+  auto emplaced = tree.emplace_unique(7, "dup");
+  EXPECT_FALSE(emplaced.second);
+  EXPECT_EQ(emplaced.first->second, "old");
+  EXPECT_TRUE(ValidatePersistentTree(tree));
+}
+
+TEST(PersistentTreeTest, FailedCopyLeavesTreeIntact) {
+  s21::PersistentTree<ThrowingCopy> tree;
+  for (int i = 0; i < 300; ++i) tree.emplace_unique(i * 2);
+  for (int budget = 0; budget < 40; ++budget) {
+    auto snapshot = tree;
+    int key = Random::Get(0, 600);
+    ThrowingCopy::copies_left = budget;
+    try {
+      if (key % 2) {
+        tree.insert_unique(ThrowingCopy{key});
+      } else {
+        tree.erase_unique(ThrowingCopy{key});
+      }
+    } catch (const std::runtime_error&) {
+      ThrowingCopy::copies_left = -1;
+      EXPECT_TRUE(std::equal(tree.begin(), tree.end(), snapshot.begin(),
+                             snapshot.end()));
+    }
+    ThrowingCopy::copies_left = -1;
+    ASSERT_TRUE(ValidatePersistentTree(tree));
+    ASSERT_TRUE(ValidatePersistentTree(snapshot));
+  }
+}
+
+TEST(PersistentTreeTest, MoveAndSwap) {
+  IntTree tree;
+  for (int i = 0; i < 10; ++i) tree.insert_unique(i);
+  IntTree moved{std::move(tree)};
+  EXPECT_TRUE(tree.empty());
+  EXPECT_EQ(moved.size(), 10u);
+  IntTree other;
+  other.insert_unique(100);
+  other.swap(moved);
+  EXPECT_EQ(other.size(), 10u);
+  EXPECT_EQ(*moved.begin(), 100);
+  moved = other;
+  EXPECT_EQ(moved.get_root(), other.get_root());
+  moved = std::move(other);
+  EXPECT_EQ(moved.size(), 10u);
+}
+
+TEST(PersistentTreeTest, CopyAssignAcrossResources) {
+  TrackingResource first_resource;
+  TrackingResource second_resource;
+  PmrIntTree first{&first_resource};
+  PmrIntTree second{&second_resource};
+  for (int i = 0; i < 20; ++i) first.insert_unique(i);
+  second = first;
+  EXPECT_NE(second.get_root(), first.get_root());
+  EXPECT_EQ(second.size(), 20u);
+  EXPECT_EQ(second_resource.bytes_in_use(),
+            20 * sizeof(PmrIntTree::node_type));
+  EXPECT_TRUE(ValidatePersistentTree(second));
+}
+
+// A writer publishes a snapshot after every batch, readers take the
+// latest one under the lock and walk it without. Each batch keeps the
+// element count stored under key -1 in step with the size.
+TEST(PersistentTreeTest, ReadersWalkSnapshotsWhileWriterWrites) {
+  using Tree = s21::PersistentTree<int, int>;
+  std::mutex mutex;
+  Tree published;
+  std::atomic<bool> done{false};
+  std::atomic<int> inconsistent{0};
+  std::atomic<int> walks{0};
+
+  auto reader = [&]() {
+    while (!done.load() || walks.load() < 4) {
+      Tree snapshot;
+      {
+        std::lock_guard<std::mutex> lock{mutex};
+        snapshot = published;
+      }
+      if (snapshot.empty()) continue;
+      int previous = -2;
+      std::size_t seen = 0;
+      for (const auto& [key, value] : snapshot) {
+        if (key <= previous) ++inconsistent;
+        previous = key;
+        ++seen;
+        (void)value;
+      }
+      auto count = snapshot.find(-1);
+      if (count == snapshot.end() ||
+          static_cast<std::size_t>(count->second) + 1 != seen) {
+        ++inconsistent;
+      }
+      ++walks;
+    }
+  };
+
+  std::thread first{reader};
+  std::thread second{reader};
+  Tree tree;
+  tree.insert_or_assign(-1, 0);
+  for (int batch = 0; batch < 300; ++batch) {
+    for (int i = 0; i < 20; ++i) {
+      int key = Random::Get(0, 2000);
+      if (Random::Get(0, 3) == 0) {
+        tree.erase_unique(key);
+      } else {
+        tree.insert_or_assign(key, batch);
+      }
+    }
+    tree.insert_or_assign(-1, static_cast<int>(tree.size()) - 1);
+    std::lock_guard<std::mutex> lock{mutex};
+    published = tree;
+  }
+  done = true;
+  first.join();
+  second.join();
+  EXPECT_EQ(inconsistent.load(), 0);
+  EXPECT_TRUE(ValidatePersistentTree(tree));
+}
@@ -5,21 +5,28 @@
 #pragma GCC diagnostic pop
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <set>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "random.h"
 
-template <typename Key, typename T>
-bool ValidateProperties(const s21::Node<Key, T>* node, int& black_height);
+template <typename NodeType>
+bool ValidateProperties(const NodeType* node, int& black_height);
 
-template <typename Key, typename T>
-bool ValidateRedBlackTree(const s21::RedBlackTree<Key, T>& tree) {
-  const s21::Node<Key, T>* root{tree.get_root()};
+template <typename Tree>
+bool ValidateRedBlackTree(const Tree& tree) {
+  const auto* root{tree.get_root()};
 
   if (!root) return true;
 
-  if (root->color_ != s21::NodeColor::BLACK) {
+  if (root->GetColor() != s21::NodeColor::BLACK) {
     std::cerr << "Root must be black";
     return false;
   }
@@ -28,9 +35,10 @@ bool ValidateRedBlackTree(const s21::RedBlackTree<Key, T>& tree) {
   return ValidateProperties(root, black_height);
 }
 
-template <typename Key, typename T>
-bool ValidateBSTProperty(const s21::Node<Key, T>* node, const Key* min_key,
-                         const Key* max_key) {
+template <typename NodeType>
+bool ValidateBSTProperty(const NodeType* node,
+                         const typename NodeType::key_type* min_key,
+                         const typename NodeType::key_type* max_key) {
   if (!node) return true;
 
   if (min_key && node->GetKey() < *min_key) {
@@ -46,14 +54,14 @@ bool ValidateBSTProperty(const s21::Node<Key, T>* node, const Key* min_key,
          ValidateBSTProperty(node->right_, &node->GetKey(), max_key);
 }
 
-template <typename Key, typename T>
-bool ValidateProperties(const s21::Node<Key, T>* node, int& black_height) {
+template <typename NodeType>
+bool ValidateProperties(const NodeType* node, int& black_height) {
   if (!node) {
     black_height = 0;
     return true;
   }
 
-  if (!ValidateBSTProperty<Key, T>(node, nullptr, nullptr)) {
+  if (!ValidateBSTProperty<NodeType>(node, nullptr, nullptr)) {
     return false;
   }
 
@@ -70,24 +78,24 @@ bool ValidateProperties(const s21::Node<Key, T>* node, int& black_height) {
     return false;
   }
 
-  if (node->color_ == s21::NodeColor::RED) {
-    if ((node->left_ && node->left_->color_ == s21::NodeColor::RED) ||
-        (node->right_ && node->right_->color_ == s21::NodeColor::RED)) {
+  if (node->GetColor() == s21::NodeColor::RED) {
+    if ((node->left_ && node->left_->GetColor() == s21::NodeColor::RED) ||
+        (node->right_ && node->right_->GetColor() == s21::NodeColor::RED)) {
       std::cerr << "Property 3: red nodes cannot have red children";
       return false;
     }
   }
 
   black_height = left_black_height;
-  if (node->color_ == s21::NodeColor::BLACK) {
+  if (node->GetColor() == s21::NodeColor::BLACK) {
     black_height++;
   }
 
-  if (node->left_ && node->left_->parent_ != node) {
+  if (node->left_ && node->left_->GetParent() != node) {
     std::cerr << "Parent pointers error.";
     return false;
   }
-  if (node->right_ && node->right_->parent_ != node) {
+  if (node->right_ && node->right_->GetParent() != node) {
     std::cerr << "Parent pointers error.";
     return false;
   }
@@ -133,6 +141,23 @@ TEST(RedBlackTreeMapTest, EmptyAndSingleNode) {
   EXPECT_TRUE(ValidateRedBlackTree(tree));
 }
 
+TEST(RedBlackTreeNodeTest, ColourSharesParentWord) {
+  static_assert(sizeof(s21::Node<std::int64_t>) == 4 * sizeof(void*));
+
+  s21::Node<std::int64_t> parent{1};
+  s21::Node<std::int64_t> child{2};
+  child.SetColor(s21::NodeColor::BLACK);
+  child.SetParent(&parent);
+  EXPECT_EQ(child.GetParent(), &parent);
+  EXPECT_EQ(child.GetColor(), s21::NodeColor::BLACK);
+
+  child.SetColor(s21::NodeColor::RED);
+  EXPECT_EQ(child.GetParent(), &parent);
+  child.SetParent(nullptr);
+  EXPECT_EQ(child.GetColor(), s21::NodeColor::RED);
+  EXPECT_EQ(child.GetParent(), nullptr);
+}
+
 TEST(RedBlackTreeMapTest, SimpleLeftRotation) {
   s21::RedBlackTree<int, int> tree;
   tree.insert({10, 999});
@@ -1479,3 +1504,803 @@ TEST(RedBlackTreeMapTest, DecrementEndIteratorBehavior) {
   EXPECT_EQ(std_it->first, s21_it->first);
   EXPECT_EQ(std_it->second, s21_it->second);
 }
+
+TEST(RedBlackTreeSetTest, ClearAndReuse) {
+  s21::RedBlackTree<int> tree;
+  for (int i = 0; i < 1000; ++i) {
+    tree.insert(i);
+  }
+  tree.clear();
+  EXPECT_EQ(tree.size(), size_t{0});
+  EXPECT_EQ(tree.begin(), tree.end());
+  EXPECT_TRUE(tree.get_root() == nullptr);
+
+  for (int i = 0; i < 100; ++i) {
+    tree.insert(i);
+  }
+  EXPECT_EQ(tree.size(), size_t{100});
+  EXPECT_TRUE(ValidateRedBlackTree(tree));
+}
+
+TEST(RedBlackTreeMapTest, ClearWithNonTrivialValues) {
+  s21::RedBlackTree<std::string, std::string> tree;
+  for (int i = 0; i < 500; ++i) {
+    tree.insert({std::to_string(i), std::string(64, 'v')});
+  }
+  tree.clear();
+  EXPECT_EQ(tree.size(), size_t{0});
+
+  tree.insert({"key", "value"});
+  EXPECT_EQ(tree.begin()->second, "value");
+}
+
+TEST(RedBlackTreeMapTest, ChurnReusesNodes) {
+  s21::RedBlackTree<int, std::string> tree;
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 300; ++i) {
+      tree.insert({i, std::to_string(i)});
+    }
+    for (int i = 0; i < 300; i += 2) {
+      tree.erase(i);
+    }
+    EXPECT_TRUE(ValidateRedBlackTree(tree));
+    for (int i = 1; i < 300; i += 2) {
+      tree.erase(i);
+    }
+    EXPECT_EQ(tree.size(), size_t{0});
+  }
+}
+
+TEST(RedBlackTreeSetTest, MoveKeepsNodesAlive) {
+  s21::RedBlackTree<std::string> tree;
+  for (int i = 0; i < 200; ++i) {
+    tree.insert(std::to_string(i));
+  }
+  s21::RedBlackTree<std::string> moved{std::move(tree)};
+  EXPECT_EQ(moved.size(), size_t{200});
+  EXPECT_TRUE(ValidateRedBlackTree(moved));
+
+  tree.insert("fresh");
+  EXPECT_EQ(*tree.begin(), "fresh");
+
+  tree = std::move(moved);
+  EXPECT_EQ(tree.size(), size_t{200});
+  EXPECT_TRUE(ValidateRedBlackTree(tree));
+}
+
+template <typename NodeType>
+int TreeHeight(const NodeType* node) {
+  if (!node) return 0;
+  return 1 + std::max(TreeHeight(node->left_), TreeHeight(node->right_));
+}
+
+TEST(RedBlackTreeSetTest, AssignSortedBuildsBalancedTree) {
+  for (int n = 0; n < 130; ++n) {
+    std::vector<int> keys(static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i) keys[static_cast<size_t>(i)] = i * 2;
+
+    s21::RedBlackTree<int> tree;
+    tree.insert(-1);
+    tree.assign_unique(keys.begin(), keys.end());
+    ASSERT_EQ(tree.size(), static_cast<size_t>(n));
+    ASSERT_TRUE(ValidateRedBlackTree(tree));
+    EXPECT_TRUE(std::equal(tree.begin(), tree.end(), keys.begin(), keys.end()));
+
+    int min_height = 0;
+    while ((1 << min_height) - 1 < n) ++min_height;
+    EXPECT_EQ(TreeHeight(tree.get_root()), min_height);
+  }
+}
+
+TEST(RedBlackTreeSetTest, AssignUnsortedWithDuplicates) {
+  std::vector<int> keys;
+  for (int i = 0; i < 2000; ++i) keys.push_back(Random::Get(0, 500));
+  std::vector<int> sorted{keys};
+  std::sort(sorted.begin(), sorted.end());
+
+  s21::RedBlackTree<int> equal_tree;
+  equal_tree.assign_equal(keys.begin(), keys.end());
+  EXPECT_TRUE(ValidateRedBlackTree(equal_tree));
+  EXPECT_TRUE(std::equal(equal_tree.begin(), equal_tree.end(), sorted.begin(),
+                         sorted.end()));
+
+  sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+  s21::RedBlackTree<int> unique_tree;
+  unique_tree.assign_unique(keys.begin(), keys.end());
+  EXPECT_TRUE(ValidateRedBlackTree(unique_tree));
+  EXPECT_TRUE(std::equal(unique_tree.begin(), unique_tree.end(),
+                         sorted.begin(), sorted.end()));
+
+  unique_tree.insert(1000);
+  unique_tree.erase(sorted.front());
+  EXPECT_TRUE(ValidateRedBlackTree(unique_tree));
+}
+
+TEST(RedBlackTreeMapTest, AssignKeepsFirstOfEqualKeys) {
+  std::vector<std::pair<int, std::string>> sorted{
+      {1, "a"}, {1, "b"}, {2, "c"}, {3, "d"}, {3, "e"}};
+  s21::RedBlackTree<int, std::string> tree;
+  tree.assign_unique(sorted.begin(), sorted.end());
+  ASSERT_EQ(tree.size(), size_t{3});
+  EXPECT_EQ(tree.FindNode(1)->GetValue(), "a");
+  EXPECT_EQ(tree.FindNode(3)->GetValue(), "d");
+
+  std::vector<std::pair<int, std::string>> unsorted{
+      {3, "x"}, {1, "y"}, {3, "z"}, {1, "w"}};
+  tree.assign_unique(unsorted.begin(), unsorted.end());
+  ASSERT_EQ(tree.size(), size_t{2});
+  EXPECT_EQ(tree.FindNode(1)->GetValue(), "y");
+  EXPECT_EQ(tree.FindNode(3)->GetValue(), "x");
+  EXPECT_TRUE(ValidateRedBlackTree(tree));
+}
+
+struct ThrowingKey {
+  static inline int copies_left{0};
+  std::string payload{std::string(32, 'p')};
+  long value{0};
+
+  explicit ThrowingKey(long v) : value{v} {}
+  ThrowingKey(const ThrowingKey& other)
+      : payload{other.payload}, value{other.value} {
+    if (--copies_left < 0) throw std::runtime_error("copy failed");
+  }
+  ThrowingKey& operator=(const ThrowingKey&) = default;
+  bool operator<(const ThrowingKey& other) const {
+    return value < other.value;
+  }
+};
+
+TEST(RedBlackTreeSetTest, AssignFailureLeavesTreeEmpty) {
+  std::vector<ThrowingKey> sorted;
+  std::vector<ThrowingKey> unsorted;
+  ThrowingKey::copies_left = 1000;
+  for (long i = 0; i < 100; ++i) {
+    sorted.emplace_back(i);
+    unsorted.emplace_back(100 - i);
+  }
+  s21::RedBlackTree<ThrowingKey> tree;
+
+  ThrowingKey::copies_left = 50;
+  EXPECT_THROW(tree.assign_unique(sorted.begin(), sorted.end()),
+               std::runtime_error);
+  EXPECT_EQ(tree.size(), size_t{0});
+  EXPECT_TRUE(tree.get_root() == nullptr);
+
+  ThrowingKey::copies_left = 50;
+  EXPECT_THROW(tree.assign_equal(unsorted.begin(), unsorted.end()),
+               std::runtime_error);
+  EXPECT_EQ(tree.size(), size_t{0});
+
+  ThrowingKey::copies_left = 1000;
+  tree.assign_equal(unsorted.begin(), unsorted.end());
+  EXPECT_EQ(tree.size(), size_t{100});
+  EXPECT_EQ(tree.begin()->value, 1);
+}
+
+template <typename NodeType>
+bool ValidateSubtreeSizes(const NodeType* node) {
+  if (!node) return true;
+  size_t expected = s21::SubtreeSize::Of(node->left_) +
+                    s21::SubtreeSize::Of(node->right_) + 1;
+  if (node->subtree_size_ != expected) {
+    std::cerr << "Subtree size mismatch";
+    return false;
+  }
+  return ValidateSubtreeSizes(node->left_) &&
+         ValidateSubtreeSizes(node->right_);
+}
+
+using OrderStatisticTree =
+    s21::RedBlackTree<int, void, std::less<int>, std::allocator<int>,
+                      s21::SubtreeSize>;
+
+TEST(RedBlackTreeOrderStatisticTest, SizesSurviveInsertAndErase) {
+  OrderStatisticTree tree;
+  std::multiset<int> reference;
+  for (int i = 0; i < 2000; ++i) {
+    int key = Random::Get(0, 300);
+    tree.insert(key);
+    reference.insert(key);
+  }
+  ASSERT_TRUE(ValidateSubtreeSizes(tree.get_root()));
+  ASSERT_TRUE(ValidateRedBlackTree(tree));
+
+  for (int i = 0; i < 1500; ++i) {
+    int key = Random::Get(0, 300);
+    tree.erase(key);
+    reference.erase(key);
+    if (i % 100 == 0) {
+      ASSERT_TRUE(ValidateSubtreeSizes(tree.get_root()));
+    }
+  }
+  EXPECT_TRUE(ValidateSubtreeSizes(tree.get_root()));
+  EXPECT_TRUE(ValidateRedBlackTree(tree));
+  EXPECT_EQ(tree.size(), reference.size());
+}
+
+TEST(RedBlackTreeOrderStatisticTest, SelectRankAndCount) {
+  std::vector<int> keys;
+  for (int i = 0; i < 1000; ++i) keys.push_back(Random::Get(0, 200));
+  OrderStatisticTree tree;
+  for (int key : keys) tree.insert(key);
+  std::sort(keys.begin(), keys.end());
+
+  for (size_t k = 0; k < keys.size(); ++k) {
+    ASSERT_EQ(*tree.nth_element(k), keys[k]);
+    ASSERT_EQ(tree.index_of(tree.nth_element(k)), k);
+  }
+  EXPECT_EQ(tree.nth_element(keys.size()), tree.end());
+  EXPECT_EQ(tree.index_of(tree.end()), keys.size());
+
+  for (int key = -1; key <= 201; ++key) {
+    auto lower = std::lower_bound(keys.begin(), keys.end(), key);
+    auto upper = std::upper_bound(keys.begin(), keys.end(), key);
+    ASSERT_EQ(tree.rank(key), static_cast<size_t>(lower - keys.begin()));
+    ASSERT_EQ(tree.count(key), static_cast<size_t>(upper - lower));
+  }
+
+  EXPECT_EQ(tree.distance(tree.begin(), tree.end()), 1000);
+  EXPECT_EQ(tree.distance(tree.nth_element(900), tree.nth_element(100)),
+            -800);
+}
+
+TEST(RedBlackTreeOrderStatisticTest, BulkAssignKeepsSizes) {
+  std::vector<int> keys;
+  for (int i = 0; i < 777; ++i) keys.push_back(Random::Get(0, 100));
+  OrderStatisticTree tree;
+  tree.assign_equal(keys.begin(), keys.end());
+  EXPECT_TRUE(ValidateSubtreeSizes(tree.get_root()));
+  EXPECT_EQ(tree.get_root()->subtree_size_, size_t{777});
+
+  std::sort(keys.begin(), keys.end());
+  tree.assign_equal(keys.begin(), keys.end());
+  EXPECT_TRUE(ValidateSubtreeSizes(tree.get_root()));
+  EXPECT_EQ(*tree.nth_element(388), keys[388]);
+}
+
+TEST(RedBlackTreeSetTest, BoundsMatchStd) {
+  s21::RedBlackTree<int> tree;
+  std::multiset<int> reference;
+  for (int i = 0; i < 500; ++i) {
+    int key = Random::Get(0, 100) * 2;
+    tree.insert(key);
+    reference.insert(key);
+  }
+  const s21::RedBlackTree<int>& const_tree{tree};
+
+  for (int key = -2; key <= 203; ++key) {
+    auto lower = tree.lower_bound(key);
+    auto upper = const_tree.upper_bound(key);
+    auto std_lower = reference.lower_bound(key);
+    auto std_upper = reference.upper_bound(key);
+
+    ASSERT_EQ(lower == tree.end(), std_lower == reference.end());
+    if (std_lower != reference.end()) {
+      ASSERT_EQ(*lower, *std_lower);
+    }
+    ASSERT_EQ(upper == const_tree.end(), std_upper == reference.end());
+    if (std_upper != reference.end()) {
+      ASSERT_EQ(*upper, *std_upper);
+    }
+
+    auto [first, last] = tree.equal_range(key);
+    ASSERT_EQ(static_cast<size_t>(std::distance(first, last)),
+              reference.count(key));
+  }
+}
+
+TEST(RedBlackTreeSetTest, RangeView) {
+  s21::RedBlackTree<int> tree;
+  for (int i = 0; i < 100; ++i) tree.insert(i);
+
+  std::vector<int> seen;
+  for (int key : tree.range(10, 15)) seen.push_back(key);
+  EXPECT_EQ(seen, (std::vector<int>{10, 11, 12, 13, 14}));
+
+  EXPECT_TRUE(tree.range(15, 10).empty());
+  EXPECT_TRUE(tree.range(200, 300).empty());
+  EXPECT_EQ(std::distance(tree.range(-5, 1000).begin(),
+                          tree.range(-5, 1000).end()),
+            100);
+}
+
+struct CountingLess {
+  int* calls;
+  bool operator()(int lhs, int rhs) const {
+    ++*calls;
+    return lhs < rhs;
+  }
+};
+
+TEST(RedBlackTreeSetTest, FindComparesOncePerLevel) {
+  int calls = 0;
+  s21::RedBlackTree<int, void, CountingLess> tree{CountingLess{&calls}};
+  for (int i = 0; i < 1000; ++i) tree.insert(i);
+  int height = TreeHeight(tree.get_root());
+
+  for (int key : {0, 1, 499, 998, 999, 5000, -1}) {
+    calls = 0;
+    tree.FindNode(key);
+    EXPECT_LE(calls, height + 1);
+  }
+}
+
+TEST(RedBlackTreeSetTest, FindManyComparesOncePerLevel) {
+  int calls = 0;
+  s21::RedBlackTree<int, void, CountingLess> tree{CountingLess{&calls}};
+  for (int i = 0; i < 1000; ++i) tree.insert(i);
+  int height = TreeHeight(tree.get_root());
+
+  std::vector<int> keys(40);
+  for (int& key : keys) key = Random::Get(-100, 1100);
+  calls = 0;
+  std::vector<const void*> nodes;
+  tree.FindMany(keys.begin(), keys.end(),
+                [&nodes](const void* node) { nodes.push_back(node); });
+  EXPECT_LE(calls, 40 * (height + 1));
+  ASSERT_EQ(nodes.size(), keys.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(nodes[i], tree.FindNode(keys[i]));
+  }
+}
+
+TEST(RedBlackTreeSetTest, InsertUniqueDescendsOnce) {
+  int calls = 0;
+  s21::RedBlackTree<int, void, CountingLess> tree{CountingLess{&calls}};
+  for (int i = 0; i < 1000; i += 2) tree.insert_unique(i);
+  int height = TreeHeight(tree.get_root());
+
+  for (int key : {0, 1, 500, 501, 998, 999, -1}) {
+    calls = 0;
+    auto [node, inserted] = tree.insert_unique(key);
+    EXPECT_EQ(inserted, key % 2 != 0);
+    EXPECT_EQ(node->data_, key);
+    EXPECT_LE(calls, height + 1);
+  }
+  EXPECT_EQ(tree.size(), 504u);
+  EXPECT_TRUE(ValidateRedBlackTree(tree));
+}
+
+TEST(RedBlackTreeSetTest, HintedAppendComparesOnce) {
+  int calls = 0;
+  s21::RedBlackTree<int, void, CountingLess> tree{CountingLess{&calls}};
+  for (int i = 0; i < 1000; ++i) {
+    calls = 0;
+    auto [node, inserted] = tree.insert_unique(std::as_const(tree).end(), i);
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(calls, i == 0 ? 0 : 1);
+  }
+  EXPECT_TRUE(ValidateRedBlackTree(tree));
+  EXPECT_EQ(tree.get_rightmost()->data_, 999);
+}
+
+TEST(RedBlackTreeSetTest, EndsFollowInsertAndErase) {
+  s21::RedBlackTree<int> tree;
+  std::multiset<int> reference;
+  for (int i = 0; i < 3000; ++i) {
+    int key = Random::Get(0, 500);
+    if (i % 3 == 2 && !reference.empty()) {
+      tree.erase(tree.find(key) != tree.end() ? tree.find(key)
+                                              : std::prev(tree.end()));
+      auto it = reference.find(key);
+      reference.erase(it != reference.end() ? it : std::prev(reference.end()));
+    } else {
+      tree.insert(key);
+      reference.insert(key);
+    }
+    if (reference.empty()) {
+      EXPECT_EQ(tree.get_leftmost(), nullptr);
+      EXPECT_EQ(tree.get_rightmost(), nullptr);
+      EXPECT_EQ(tree.begin(), tree.end());
+    } else {
+      ASSERT_NE(tree.get_leftmost(), nullptr);
+      ASSERT_NE(tree.get_rightmost(), nullptr);
+      EXPECT_EQ(tree.get_leftmost()->data_, *reference.begin());
+      EXPECT_EQ(tree.get_rightmost()->data_, *reference.rbegin());
+      EXPECT_EQ(*tree.begin(), *reference.begin());
+    }
+  }
+  tree.clear();
+  EXPECT_EQ(tree.get_leftmost(), nullptr);
+  EXPECT_EQ(tree.get_rightmost(), nullptr);
+}
+
+TEST(RedBlackTreeSetTest, HintedPrependComparesOnce) {
+  int calls = 0;
+  s21::RedBlackTree<int, void, CountingLess> tree{CountingLess{&calls}};
+  for (int i = 1000; i > 0; --i) {
+    calls = 0;
+    auto hint = std::as_const(tree).begin();
+    auto [node, inserted] = tree.insert_unique(hint, i);
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(calls, i == 1000 ? 0 : 1);
+  }
+  EXPECT_TRUE(ValidateRedBlackTree(tree));
+  EXPECT_EQ(tree.get_leftmost()->data_, 1);
+}
+
+TEST(RedBlackTreeSetTest, LeftmostAfterBulkOperations) {
+  s21::RedBlackTree<int> tree;
+  std::vector<int> keys{5, 3, 9, 1, 7};
+  tree.assign_unique(keys.begin(), keys.end());
+  EXPECT_EQ(tree.get_leftmost()->data_, 1);
+
+  s21::RedBlackTree<int> other;
+  for (int i = -10; i < 0; ++i) other.insert_unique(i);
+  tree.union_with(other);
+  EXPECT_EQ(tree.get_leftmost()->data_, -10);
+  EXPECT_EQ(*tree.begin(), -10);
+
+  s21::RedBlackTree<int> low;
+  low.insert_unique(-20);
+  tree.merge_unique(low);
+  EXPECT_EQ(tree.get_leftmost()->data_, -20);
+  EXPECT_EQ(low.get_leftmost(), nullptr);
+
+  s21::RedBlackTree<int> moved{std::move(tree)};
+  EXPECT_EQ(moved.get_leftmost()->data_, -20);
+  EXPECT_EQ(tree.begin(), tree.end());
+  EXPECT_TRUE(ValidateRedBlackTree(moved));
+}
+
+TEST(RedBlackTreeSetTest, EraseKeyDescendsOnce) {
+  int calls = 0;
+  s21::RedBlackTree<int, void, CountingLess> tree{CountingLess{&calls}};
+  for (int i = 0; i < 1000; ++i) tree.insert(i % 100);
+  int height = TreeHeight(tree.get_root());
+
+  calls = 0;
+  EXPECT_EQ(tree.erase(42), 10u);
+  EXPECT_LE(calls, height + 11);
+  EXPECT_EQ(tree.erase(42), 0u);
+  EXPECT_EQ(tree.size(), 990u);
+  EXPECT_TRUE(ValidateRedBlackTree(tree));
+}
+
+TEST(RedBlackTreeSetTest, EraseKeyCutsOutLongRuns) {
+  OrderStatisticTree tree;
+  for (int i = 0; i < 3000; ++i) tree.insert(i % 3 == 0 ? i : 7);
+  EXPECT_EQ(tree.erase(7), 2000u);
+  EXPECT_EQ(tree.size(), 1000u);
+  EXPECT_FALSE(tree.contains(7));
+  EXPECT_TRUE(ValidateRedBlackTree(tree));
+  EXPECT_TRUE(ValidateSubtreeSizes(tree.get_root()));
+  EXPECT_EQ(tree.erase(0), 1u);
+  EXPECT_EQ(tree.get_leftmost()->data_, 3);
+}
+
+TEST(RedBlackTreeSetTest, RangeEraseMatchesStd) {
+  for (int round = 0; round < 200; ++round) {
+    OrderStatisticTree tree;
+    std::multiset<int> reference;
+    int count = Random::Get(0, 300);
+    for (int i = 0; i < count; ++i) {
+      int key = Random::Get(0, 100);
+      tree.insert(key);
+      reference.insert(key);
+    }
+    // Both ends are positions, so equal keys may straddle them
+    auto offset = Random::Get(0, count);
+    auto length = Random::Get(0, count - offset);
+    auto first = std::next(std::as_const(tree).begin(), offset);
+    auto last = std::next(first, length);
+    auto expected_next = last == std::as_const(tree).end() ? -1 : *last;
+
+    auto next = tree.erase(first, last);
+    auto ref_first = std::next(reference.begin(), offset);
+    reference.erase(ref_first, std::next(ref_first, length));
+
+    EXPECT_EQ(next == tree.end() ? -1 : *next, expected_next);
+    ASSERT_EQ(tree.size(), reference.size());
+    EXPECT_TRUE(std::equal(tree.begin(), tree.end(), reference.begin()));
+    EXPECT_TRUE(ValidateRedBlackTree(tree));
+    EXPECT_TRUE(ValidateSubtreeSizes(tree.get_root()));
+    if (reference.empty()) {
+      EXPECT_EQ(tree.get_leftmost(), nullptr);
+    } else {
+      EXPECT_EQ(tree.get_leftmost()->data_, *reference.begin());
+      EXPECT_EQ(tree.get_rightmost()->data_, *reference.rbegin());
+    }
+  }
+}
+
+TEST(RedBlackTreeSetTest, RangeEraseDestroysValues) {
+  s21::RedBlackTree<std::string> tree;
+  std::set<std::string> reference;
+  for (int i = 0; i < 1000; ++i) {
+    tree.insert(std::to_string(i));
+    reference.insert(std::to_string(i));
+  }
+  tree.erase(std::as_const(tree).begin(),
+             std::next(std::as_const(tree).begin(), 900));
+  reference.erase(reference.begin(), std::next(reference.begin(), 900));
+  EXPECT_TRUE(std::equal(tree.begin(), tree.end(), reference.begin(),
+                         reference.end()));
+  tree.erase(std::as_const(tree).begin(), std::as_const(tree).end());
+  EXPECT_TRUE(tree.empty());
+  EXPECT_EQ(tree.begin(), tree.end());
+  for (int i = 0; i < 10; ++i) tree.insert(std::to_string(i));
+  EXPECT_TRUE(ValidateRedBlackTree(tree));
+}
+
+TEST(RedBlackTreeSetTest, MergeRelinksNodes) {
+  s21::RedBlackTree<int> tree;
+  s21::RedBlackTree<int> other;
+  std::set<int> reference;
+  std::vector<const int*> moved;
+  for (int i = 0; i < 2000; ++i) {
+    int key = Random::Get(0, 3000);
+    if (i % 2 == 0) {
+      tree.insert_unique(key);
+    } else {
+      other.insert_unique(key);
+    }
+    reference.insert(key);
+  }
+  for (const int& key : std::as_const(other)) {
+    if (!tree.contains(key)) moved.push_back(&key);
+  }
+
+  tree.merge_unique(other);
+  EXPECT_TRUE(other.empty());
+  EXPECT_EQ(other.begin(), other.end());
+  EXPECT_TRUE(ValidateRedBlackTree(tree));
+  EXPECT_TRUE(std::equal(tree.begin(), tree.end(), reference.begin(),
+                         reference.end()));
+  for (const int* key : moved) {
+    EXPECT_EQ(&*tree.find(*key), key);
+  }
+}
+
+TEST(RedBlackTreeSetTest, MergeKeepsSubtreeSizes) {
+  OrderStatisticTree tree;
+  OrderStatisticTree other;
+  for (int i = 0; i < 500; ++i) {
+    tree.insert(i % 50);
+    other.insert(i % 70);
+  }
+  tree.merge_equal(other);
+  EXPECT_EQ(tree.size(), 1000u);
+  EXPECT_TRUE(ValidateSubtreeSizes(tree.get_root()));
+  EXPECT_TRUE(ValidateRedBlackTree(tree));
+  EXPECT_EQ(tree.count(10), 17u);
+  EXPECT_EQ(tree.count(60), 7u);
+
+  OrderStatisticTree empty;
+  empty.merge_equal(tree);
+  EXPECT_EQ(empty.size(), 1000u);
+  EXPECT_TRUE(tree.empty());
+  EXPECT_EQ(*std::prev(empty.end()), 69);
+}
+
+struct ThrowingLess {
+  static inline int calls_left{-1};
+  bool operator()(int lhs, int rhs) const {
+    if (calls_left >= 0 && calls_left-- == 0) {
+      throw std::runtime_error("compare failed");
+    }
+    return lhs < rhs;
+  }
+};
+
+TEST(RedBlackTreeSetTest, ThrowingCompareDuringMergeKeepsNodes) {
+  s21::RedBlackTree<int, void, ThrowingLess> tree;
+  s21::RedBlackTree<int, void, ThrowingLess> other;
+  for (int i = 0; i < 100; ++i) {
+    tree.insert_unique(i * 2);
+    other.insert_unique(i * 2 + 1);
+  }
+  ThrowingLess::calls_left = 300;
+  EXPECT_THROW(tree.merge_unique(other), std::runtime_error);
+  ThrowingLess::calls_left = -1;
+
+  EXPECT_EQ(tree.size() + other.size(), 200u);
+  EXPECT_TRUE(ValidateRedBlackTree(tree));
+  EXPECT_TRUE(ValidateRedBlackTree(other));
+  EXPECT_GT(tree.size(), 100u);
+  EXPECT_EQ(other.get_rightmost()->data_, 199);
+}
+
+TEST(RedBlackTreeSetTest, ExtractAndReinsertHandle) {
+  s21::RedBlackTree<int> tree;
+  for (int i = 0; i < 100; ++i) tree.insert_unique(i);
+  auto handle = tree.extract(50);
+  ASSERT_FALSE(handle.empty());
+  const int* address = &handle.value();
+  EXPECT_EQ(tree.size(), 99u);
+  EXPECT_FALSE(tree.contains(50));
+  EXPECT_TRUE(ValidateRedBlackTree(tree));
+
+  handle.value() = 1000;
+  auto [node, inserted] = tree.insert_handle_unique(handle);
+  EXPECT_TRUE(inserted);
+  EXPECT_TRUE(handle.empty());
+  EXPECT_EQ(&node->data_, address);
+  EXPECT_EQ(tree.get_rightmost(), node);
+  EXPECT_TRUE(tree.extract(5000).empty());
+  EXPECT_TRUE(ValidateRedBlackTree(tree));
+}
+
+template <typename Tree>
+Tree TreeOf(const std::set<int>& keys) {
+  Tree tree;
+  for (int key : keys) tree.insert_unique(key);
+  return tree;
+}
+
+std::set<int> RandomKeys(size_t count, int max_key) {
+  std::set<int> keys;
+  while (keys.size() < count) keys.insert(Random::Get(0, max_key));
+  return keys;
+}
+
+template <typename Tree>
+void CheckSetAlgebra(const std::set<int>& lhs, const std::set<int>& rhs) {
+  std::vector<int> expected;
+  Tree tree = TreeOf<Tree>(lhs);
+  Tree other = TreeOf<Tree>(rhs);
+  tree.union_with(other);
+  std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                 std::back_inserter(expected));
+  EXPECT_TRUE(other.empty());
+  ASSERT_EQ(tree.size(), expected.size());
+  EXPECT_TRUE(std::equal(tree.begin(), tree.end(), expected.begin()));
+  EXPECT_TRUE(ValidateRedBlackTree(tree));
+
+  expected.clear();
+  tree = TreeOf<Tree>(lhs);
+  other = TreeOf<Tree>(rhs);
+  tree.intersect_with(other);
+  std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                        std::back_inserter(expected));
+  ASSERT_EQ(tree.size(), expected.size());
+  EXPECT_TRUE(std::equal(tree.begin(), tree.end(), expected.begin()));
+  EXPECT_TRUE(ValidateRedBlackTree(tree));
+
+  expected.clear();
+  tree = TreeOf<Tree>(lhs);
+  other = TreeOf<Tree>(rhs);
+  tree.subtract(other);
+  std::set_difference(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                      std::back_inserter(expected));
+  ASSERT_EQ(tree.size(), expected.size());
+  EXPECT_TRUE(std::equal(tree.begin(), tree.end(), expected.begin()));
+  EXPECT_TRUE(ValidateRedBlackTree(tree));
+  if (!expected.empty()) {
+    EXPECT_EQ(*std::prev(tree.end()), expected.back());
+  }
+}
+
+TEST(RedBlackTreeSetTest, SetAlgebraMatchesStd) {
+  CheckSetAlgebra<s21::RedBlackTree<int>>({}, {});
+  CheckSetAlgebra<s21::RedBlackTree<int>>({1, 2, 3}, {});
+  CheckSetAlgebra<s21::RedBlackTree<int>>({}, {1, 2, 3});
+  for (int round = 0; round < 20; ++round) {
+    CheckSetAlgebra<s21::RedBlackTree<int>>(
+        RandomKeys(static_cast<size_t>(Random::Get(0, 300)), 500),
+        RandomKeys(static_cast<size_t>(Random::Get(0, 300)), 500));
+  }
+  CheckSetAlgebra<s21::RedBlackTree<int>>(RandomKeys(5, 100000),
+                                          RandomKeys(20000, 100000));
+}
+
+TEST(RedBlackTreeSetTest, SetAlgebraInParallel) {
+  CheckSetAlgebra<s21::RedBlackTree<int>>(RandomKeys(60000, 200000),
+                                          RandomKeys(40000, 200000));
+}
+
+TEST(RedBlackTreeSetTest, SetAlgebraKeepsSubtreeSizes) {
+  std::set<int> lhs = RandomKeys(3000, 6000);
+  std::set<int> rhs = RandomKeys(2000, 6000);
+  CheckSetAlgebra<OrderStatisticTree>(lhs, rhs);
+
+  OrderStatisticTree tree = TreeOf<OrderStatisticTree>(lhs);
+  OrderStatisticTree other = TreeOf<OrderStatisticTree>(rhs);
+  tree.union_with(other);
+  EXPECT_TRUE(ValidateSubtreeSizes(tree.get_root()));
+  EXPECT_EQ(tree.get_root()->subtree_size_, tree.size());
+}
+
+TEST(RedBlackTreeSetTest, SetAlgebraWithItself) {
+  s21::RedBlackTree<int> tree = TreeOf<s21::RedBlackTree<int>>({1, 2, 3});
+  tree.union_with(tree);
+  EXPECT_EQ(tree.size(), 3u);
+  tree.intersect_with(tree);
+  EXPECT_EQ(tree.size(), 3u);
+  tree.subtract(tree);
+  EXPECT_TRUE(tree.empty());
+}
+
+TEST(RedBlackTreeSetTest, UniqueInsertsKeepTreeValid) {
+  s21::RedBlackTree<int> tree;
+  std::set<int> reference;
+  for (int i = 0; i < 5000; ++i) {
+    int key = Random::Get(0, 1999);
+    bool expected = reference.insert(key).second;
+    if (i % 3 == 0) {
+      EXPECT_EQ(tree.emplace_unique(key).second, expected);
+    } else {
+      EXPECT_EQ(tree.insert_unique(key).second, expected);
+    }
+  }
+  EXPECT_TRUE(ValidateRedBlackTree(tree));
+  EXPECT_TRUE(std::equal(tree.begin(), tree.end(), reference.begin(),
+                         reference.end()));
+}
+
+TEST(RedBlackTreeSetTest, CustomCompareOrdersDescending) {
+  s21::RedBlackTree<int, void, std::greater<int>> tree;
+  for (int key : {3, 1, 4, 1, 5, 9, 2, 6}) tree.insert(key);
+  std::vector<int> keys(tree.begin(), tree.end());
+  EXPECT_EQ(keys, (std::vector<int>{9, 6, 5, 4, 3, 2, 1, 1}));
+  EXPECT_EQ(*tree.lower_bound(7), 6);
+  EXPECT_EQ(*tree.upper_bound(4), 3);
+}
+
+template <typename NodeType>
+bool SameShape(const NodeType* lhs, const NodeType* rhs) {
+  if (lhs == nullptr || rhs == nullptr) {
+    return lhs == rhs;
+  }
+  return lhs != rhs && lhs->GetKey() == rhs->GetKey() &&
+         lhs->GetColor() == rhs->GetColor() &&
+         lhs->subtree_size_ == rhs->subtree_size_ &&
+         SameShape(lhs->left_, rhs->left_) &&
+         SameShape(lhs->right_, rhs->right_);
+}
+
+TEST(RedBlackTreeOrderStatisticTest, CopyKeepsShapeAndColours) {
+  OrderStatisticTree tree;
+  for (int i = 0; i < 3000; ++i) {
+    int key = Random::Get(0, 999);
+    if (i % 4 == 3) {
+      tree.erase(key);
+    } else {
+      tree.insert(key);
+    }
+  }
+  OrderStatisticTree copy{tree};
+  EXPECT_TRUE(SameShape(tree.get_root(), copy.get_root()));
+  EXPECT_TRUE(ValidateRedBlackTree(copy));
+  EXPECT_TRUE(ValidateSubtreeSizes(copy.get_root()));
+  EXPECT_EQ(copy.size(), tree.size());
+  EXPECT_EQ(*copy.begin(), *tree.begin());
+  EXPECT_EQ(*std::prev(copy.end()), *std::prev(tree.end()));
+
+  copy.insert(5000);
+  EXPECT_EQ(*std::prev(copy.end()), 5000);
+  EXPECT_NE(*std::prev(tree.end()), 5000);
+
+  OrderStatisticTree empty;
+  copy = empty;
+  EXPECT_TRUE(copy.empty());
+  EXPECT_TRUE(copy.begin() == copy.end());
+  copy = tree;
+  EXPECT_TRUE(SameShape(tree.get_root(), copy.get_root()));
+  EXPECT_EQ(*copy.nth_element(copy.size() / 2),
+            *tree.nth_element(tree.size() / 2));
+}
+
+TEST(RedBlackTreeSetTest, CopyFailureLeavesTreeEmpty) {
+  ThrowingKey::copies_left = 1000;
+  s21::RedBlackTree<ThrowingKey> source;
+  s21::RedBlackTree<ThrowingKey> target;
+  for (long i = 0; i < 100; ++i) {
+    source.emplace_unique(i);
+    target.emplace_unique(-i);
+  }
+
+  ThrowingKey::copies_left = 50;
+  EXPECT_THROW(s21::RedBlackTree<ThrowingKey>{source}, std::runtime_error);
+  ThrowingKey::copies_left = 50;
+  EXPECT_THROW(target = source, std::runtime_error);
+  EXPECT_EQ(target.size(), size_t{0});
+  EXPECT_TRUE(target.get_root() == nullptr);
+  EXPECT_TRUE(target.begin() == target.end());
+
+  ThrowingKey::copies_left = 1000;
+  target = source;
+  EXPECT_EQ(target.size(), size_t{100});
+  EXPECT_EQ(target.begin()->value, 0);
+  EXPECT_EQ(std::prev(target.end())->value, 99);
+}
@@ -5,11 +5,17 @@
 
 #include <algorithm>
 #include <cstring>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "dummy_object.h"
 #include "random.h"
 #include "s21_set.h"
+#include "tracking_resource.h"
 
 template <typename Key>
 class SetTest : public testing::Test {
@@ -160,6 +166,19 @@ TYPED_TEST(SetTest, MoveConstructor) {
   EXPECT_FALSE(this->s21_set_.contains(3));
 }
 
+TEST(SetNonTyped, CopyAssign) {
+  s21::set<std::string> source{"delta", "alpha", "charlie", "bravo"};
+  s21::set<std::string> target{"x", "y"};
+  target = source;
+  EXPECT_EQ(target, source);
+  source.erase("alpha");
+  EXPECT_TRUE(target.contains("alpha"));
+  EXPECT_EQ(*target.begin(), "alpha");
+  EXPECT_EQ(*std::prev(target.end()), "delta");
+  target = target;
+  EXPECT_EQ(target.size(), size_t{4});
+}
+
 TEST(SetNonTyped, ConstructorWithSizeAndValue) {
   size_t size = 5;
   int value = 42;
@@ -520,3 +539,231 @@ TYPED_TEST(SetTest, Find_InEmptySet) {
   EXPECT_EQ(s21_it, this->empty_s21_set_.end());
   EXPECT_EQ(std_it, this->empty_stl_set_.end());
 }
+
+TEST(SetNonTyped, RangeConstructor) {
+  std::vector<int> items{9, 3, 7, 3, 1, 9};
+  s21::set<int> s(items.begin(), items.end());
+  std::set<int> stl_s(items.begin(), items.end());
+
+  EXPECT_EQ(s.size(), stl_s.size());
+  EXPECT_TRUE(std::equal(s.begin(), s.end(), stl_s.begin(), stl_s.end()));
+}
+
+TEST(SetNonTyped, RangeConstructorFromInputIterator) {
+  std::istringstream input{"4 2 8 2 6"};
+  s21::set<int> s(std::istream_iterator<int>{input},
+                  std::istream_iterator<int>{});
+  std::vector<int> expected{2, 4, 6, 8};
+
+  EXPECT_TRUE(std::equal(s.begin(), s.end(), expected.begin(), expected.end()));
+}
+
+TEST(SetNonTyped, AssignFromConvertibleRange) {
+  std::vector<const char*> items{"b", "a", "c"};
+  s21::set<std::string> s{"z"};
+  s.assign(items.begin(), items.end());
+  std::vector<std::string> expected{"a", "b", "c"};
+
+  EXPECT_TRUE(std::equal(s.begin(), s.end(), expected.begin(), expected.end()));
+}
+
+TEST(SetNonTyped, Bounds) {
+  s21::set<int> s{1, 3, 5, 7};
+  EXPECT_EQ(*s.lower_bound(3), 3);
+  EXPECT_EQ(*s.lower_bound(4), 5);
+  EXPECT_EQ(*s.upper_bound(3), 5);
+  EXPECT_EQ(s.upper_bound(7), s.end());
+  EXPECT_EQ(*s.lower_bound(-10), 1);
+
+  auto [first, last] = s.equal_range(4);
+  EXPECT_EQ(first, last);
+}
+
+TEST(SetNonTyped, RangeView) {
+  s21::set<std::string> s{"apple", "banana", "cherry", "date", "fig"};
+  const auto& const_s = s;
+  std::vector<std::string> seen;
+  for (const auto& fruit : const_s.range("b", "d")) {
+    seen.push_back(fruit);
+  }
+  EXPECT_EQ(seen, (std::vector<std::string>{"banana", "cherry"}));
+}
+
+TEST(SetNonTyped, FindManyKeepsInputOrder) {
+  s21::set<std::string> s{"apple", "banana", "cherry"};
+  std::vector<std::string> keys{"cherry", "kiwi", "apple", "apple"};
+  std::vector<s21::set<std::string>::iterator> found;
+  s.find_many(keys.begin(), keys.end(), std::back_inserter(found));
+  ASSERT_EQ(found.size(), 4u);
+  EXPECT_EQ(*found[0], "cherry");
+  EXPECT_EQ(found[1], s.end());
+  EXPECT_EQ(found[2], s.begin());
+  EXPECT_EQ(found[3], s.begin());
+  std::vector<bool> present;
+  s.contains_many(keys.begin(), keys.end(), std::back_inserter(present));
+  EXPECT_EQ(present, (std::vector<bool>{true, false, true, true}));
+}
+
+TEST(SetNonTyped, EraseKeyAndRange) {
+  s21::set<int> s{1, 2, 3, 4, 5, 6};
+  EXPECT_EQ(s.erase(3), size_t{1});
+  EXPECT_EQ(s.erase(3), size_t{0});
+  auto next = s.erase(s.find(2), s.find(6));
+  EXPECT_EQ(*next, 6);
+  EXPECT_EQ(s.erase(s.begin(), s.end()), s.end());
+  EXPECT_TRUE(s.empty());
+}
+
+struct CountedKey {
+  static inline int constructions{0};
+  int id;
+
+  explicit CountedKey(int value) : id{value} { ++constructions; }
+  CountedKey(const CountedKey& other) : id{other.id} { ++constructions; }
+  CountedKey& operator=(const CountedKey&) = default;
+};
+
+struct CountedKeyLess {
+  using is_transparent = void;
+  bool operator()(const CountedKey& lhs, const CountedKey& rhs) const {
+    return lhs.id < rhs.id;
+  }
+  bool operator()(const CountedKey& lhs, int rhs) const {
+    return lhs.id < rhs;
+  }
+  bool operator()(int lhs, const CountedKey& rhs) const {
+    return lhs < rhs.id;
+  }
+};
+
+TEST(SetNonTyped, TransparentLookupBuildsNoKeys) {
+  s21::set<CountedKey, CountedKeyLess> s;
+  for (int i = 0; i < 100; i += 2) {
+    s.insert(CountedKey{i});
+  }
+
+  CountedKey::constructions = 0;
+  EXPECT_EQ(s.find(42)->id, 42);
+  EXPECT_EQ(s.find(43), s.end());
+  EXPECT_TRUE(s.contains(10));
+  EXPECT_EQ(s.count(11), size_t{0});
+  EXPECT_EQ(s.lower_bound(11)->id, 12);
+  EXPECT_EQ(s.upper_bound(12)->id, 14);
+  EXPECT_EQ(std::distance(s.range(10, 20).begin(), s.range(10, 20).end()), 5);
+  EXPECT_EQ(CountedKey::constructions, 0);
+}
+
+TEST(SetNonTyped, StringViewLookup) {
+  s21::set<std::string, std::less<>> s{"alpha", "beta", "gamma"};
+  std::string_view key{"beta-and-more", 4};
+
+  EXPECT_TRUE(s.contains(key));
+  EXPECT_EQ(*s.find(key), "beta");
+  EXPECT_EQ(s.count(std::string_view{"delta"}), size_t{0});
+}
+
+TEST(SetNonTyped, CustomCompare) {
+  s21::set<int, std::greater<int>> s{1, 5, 3, 5};
+  std::vector<int> expected{5, 3, 1};
+  EXPECT_TRUE(std::equal(s.begin(), s.end(), expected.begin(), expected.end()));
+
+  s21::set<int, std::greater<int>> copy{s};
+  copy.insert(4);
+  expected = {5, 4, 3, 1};
+  EXPECT_TRUE(
+      std::equal(copy.begin(), copy.end(), expected.begin(), expected.end()));
+}
+
+TEST(SetNonTyped, EmplaceAndMoveInsert) {
+  s21::set<std::string> s;
+  auto [it, inserted] = s.emplace(size_t{3}, 'x');
+  EXPECT_TRUE(inserted);
+  EXPECT_EQ(*it, "xxx");
+  EXPECT_FALSE(s.emplace("xxx").second);
+
+  std::string long_key(100, 'k');
+  s.insert(std::move(long_key));
+  EXPECT_TRUE(s.contains(std::string(100, 'k')));
+  EXPECT_EQ(*s.emplace_hint(s.begin(), "a"), "a");
+  EXPECT_EQ(s.size(), size_t{3});
+}
+
+TEST(SetNonTyped, ExtractChangesKeyWithoutCopy) {
+  s21::set<std::string> s{"apple", "banana", "cherry"};
+  auto handle = s.extract("banana");
+  std::string* address = &handle.value();
+  handle.value() = "blueberry";
+  auto result = s.insert(std::move(handle));
+  EXPECT_TRUE(result.inserted);
+  EXPECT_EQ(&*result.position, address);
+  EXPECT_TRUE(s.contains("blueberry"));
+  EXPECT_FALSE(s.contains("banana"));
+
+  auto empty = s.insert(s21::set<std::string>::node_handle{});
+  EXPECT_FALSE(empty.inserted);
+  EXPECT_EQ(empty.position, s.end());
+}
+
+TEST(SetNonTyped, MergeRelinksAndDropsDuplicates) {
+  s21::set<int> s;
+  s21::set<int> other;
+  std::set<int> reference;
+  for (int i{0}; i < 1000; ++i) {
+    int key{Random::Get(0, 1500)};
+    (i % 2 ? s : other).insert(key);
+    reference.insert(key);
+  }
+  s.merge(other);
+  EXPECT_TRUE(other.empty());
+  EXPECT_TRUE(std::equal(s.begin(), s.end(), reference.begin(),
+                         reference.end()));
+}
+
+TEST(SetNonTyped, SetAlgebra) {
+  s21::set<int> evens;
+  s21::set<int> threes;
+  for (int i{0}; i < 30; ++i) {
+    if (i % 2 == 0) evens.insert(i);
+    if (i % 3 == 0) threes.insert(i);
+  }
+  s21::set<int> both = s21::set_intersection(evens, threes);
+  EXPECT_EQ(std::vector<int>(both.begin(), both.end()),
+            (std::vector<int>{0, 6, 12, 18, 24}));
+  s21::set<int> only_evens = s21::set_difference(evens, threes);
+  EXPECT_EQ(only_evens.size(), size_t{10});
+  EXPECT_FALSE(only_evens.contains(6));
+  EXPECT_EQ(evens.size(), size_t{15});
+
+  s21::set<int> any = s21::set_union(std::move(evens), std::move(threes));
+  EXPECT_EQ(any.size(), size_t{20});
+  EXPECT_TRUE(evens.empty());
+  EXPECT_TRUE(threes.empty());
+}
+
+TEST(SetAllocatorTest, ArenaBacked) {
+  std::byte buffer[131072];
+  std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer),
+                                            std::pmr::null_memory_resource()};
+  s21::pmr::set<int> s{&arena};
+  for (int i{0}; i < 1000; ++i) {
+    s.insert(i % 500);
+  }
+
+  EXPECT_EQ(s.size(), size_t{500});
+  EXPECT_TRUE(s.contains(499));
+}
+
+TEST(SetAllocatorTest, ReleasesEverything) {
+  TrackingResource resource;
+  {
+    s21::pmr::set<std::string> s({"b", "a"}, &resource);
+    for (int i{0}; i < 300; ++i) {
+      s.insert(std::to_string(i));
+    }
+    s21::pmr::set<std::string> copy{s};
+    EXPECT_TRUE(copy == s);
+    s.clear();
+  }
+  EXPECT_GT(resource.allocations(), size_t{0});
+  EXPECT_EQ(resource.bytes_in_use(), size_t{0});
+}
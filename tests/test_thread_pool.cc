@@ -0,0 +1,85 @@
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+#include <gtest/gtest.h>
+#pragma GCC diagnostic pop
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "s21_thread_pool.h"
+
+namespace {
+
+long ParallelSum(s21::ThreadPool& pool, const std::vector<long>& values,
+                 std::size_t first, std::size_t last) {
+  if (last - first <= 64) {
+    long sum{0};
+    for (std::size_t i{first}; i < last; ++i) {
+      sum += values[i];
+    }
+    return sum;
+  }
+  std::size_t middle{first + (last - first) / 2};
+  long left{0};
+  long right{0};
+  pool.Fork([&]() { left = ParallelSum(pool, values, first, middle); },
+            [&]() { right = ParallelSum(pool, values, middle, last); });
+  return left + right;
+}
+
+}  // namespace
+
+TEST(ThreadPoolTest, ForkRunsBothBranches) {
+  s21::ThreadPool pool{2};
+  int left{0};
+  int right{0};
+  pool.Fork([&]() { left = 1; }, [&]() { right = 2; });
+  EXPECT_EQ(left, 1);
+  EXPECT_EQ(right, 2);
+  EXPECT_EQ(pool.size(), size_t{2});
+}
+
+TEST(ThreadPoolTest, NestedForksDoNotDeadlock) {
+  std::vector<long> values(100000);
+  for (std::size_t i{0}; i < values.size(); ++i) {
+    values[i] = static_cast<long>(i);
+  }
+  for (std::size_t workers : {size_t{0}, size_t{1}, size_t{3}}) {
+    s21::ThreadPool pool{workers};
+    EXPECT_EQ(ParallelSum(pool, values, 0, values.size()),
+              99999L * 100000L / 2);
+  }
+}
+
+TEST(ThreadPoolTest, BranchesUseSeveralThreads) {
+  s21::ThreadPool pool{3};
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  std::atomic<int> started{0};
+  auto branch = [&]() {
+    ++started;
+    while (started.load() < 2) {
+      std::this_thread::yield();
+    }
+    std::lock_guard<std::mutex> lock{mutex};
+    threads.insert(std::this_thread::get_id());
+  };
+  pool.Fork(branch, branch);
+  EXPECT_EQ(threads.size(), size_t{2});
+}
+
+TEST(ThreadPoolTest, ExceptionsReachTheCaller) {
+  s21::ThreadPool pool{2};
+  bool right_ran{false};
+  EXPECT_THROW(pool.Fork([]() { throw std::runtime_error("left"); },
+                         [&]() { right_ran = true; }),
+               std::runtime_error);
+  EXPECT_TRUE(right_ran);
+  EXPECT_THROW(
+      pool.Fork([]() {}, []() { throw std::logic_error("right"); }),
+      std::logic_error);
+}
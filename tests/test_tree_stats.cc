@@ -0,0 +1,173 @@
+#include "s21_tree_stats.h"
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+#include <gtest/gtest.h>
+#pragma GCC diagnostic pop
+
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "random.h"
+
+using CountingTree =
+    s21::RedBlackTree<int, void, std::less<int>, std::allocator<int>,
+                      s21::NoAugment, s21::OperationCounters>;
+
+TEST(TreeStatsTest, EmptyTree) {
+  s21::RedBlackTree<int> tree;
+  s21::TreeStats stats{s21::collect_stats(tree)};
+  EXPECT_EQ(stats.node_count, 0u);
+  EXPECT_EQ(stats.height, 0u);
+  EXPECT_EQ(stats.black_height, 0u);
+  EXPECT_TRUE(stats.depth_histogram.empty());
+  EXPECT_EQ(stats.average_search_path, 0.0);
+  EXPECT_TRUE(s21::is_valid_tree(tree));
+}
+
+TEST(TreeStatsTest, ShapeOfBalancedBuild) {
+  s21::RedBlackTree<int> tree;
+  std::vector<int> keys(15);
+  std::iota(keys.begin(), keys.end(), 0);
+  tree.assign_equal(keys.begin(), keys.end());
+
+  s21::TreeStats stats{s21::collect_stats(tree)};
+  EXPECT_EQ(stats.node_count, 15u);
+  EXPECT_EQ(stats.height, 4u);
+  EXPECT_EQ(stats.depth_histogram, (std::vector<std::size_t>{1, 2, 4, 8}));
+  EXPECT_DOUBLE_EQ(stats.average_search_path,
+                   (1 + 2 * 2 + 4 * 3 + 8 * 4) / 15.0);
+  EXPECT_GE(stats.black_height, 3u);
+}
+
+TEST(TreeStatsTest, HeightStaysLogarithmic) {
+  s21::RedBlackTree<int> tree;
+  for (int i = 0; i < 4096; ++i) tree.insert(i);
+  s21::TreeStats stats{s21::collect_stats(tree)};
+  EXPECT_EQ(stats.node_count, 4096u);
+  EXPECT_LE(stats.height, 2 * stats.black_height);
+  EXPECT_LE(static_cast<double>(stats.height), 2 * std::log2(4097.0));
+  EXPECT_LE(stats.average_search_path, static_cast<double>(stats.height));
+  EXPECT_TRUE(s21::is_valid_tree(tree));
+}
+
+TEST(TreeStatsTest, ValidatorCatchesBrokenInvariants) {
+  s21::RedBlackTree<int> tree;
+  for (int i = 0; i < 100; ++i) tree.insert(i);
+  ASSERT_TRUE(s21::is_valid_tree(tree));
+
+  auto* root = tree.get_root();
+  root->SetColor(s21::NodeColor::RED);
+  EXPECT_FALSE(s21::is_valid_tree(tree));
+  root->SetColor(s21::NodeColor::BLACK);
+
+  std::swap(root->data_, root->left_->data_);
+  EXPECT_FALSE(s21::is_valid_tree(tree));
+  std::swap(root->data_, root->left_->data_);
+
+  auto* parent = root->left_->GetParent();
+  root->left_->SetParent(root->right_);
+  EXPECT_FALSE(s21::is_valid_tree(tree));
+  root->left_->SetParent(parent);
+  EXPECT_TRUE(s21::is_valid_tree(tree));
+}
+
+TEST(TreeStatsTest, CountersFollowOperations) {
+  CountingTree tree;
+  for (int i = 0; i < 1000; ++i) tree.insert(i);
+  const s21::OperationCounters& counters{tree.get_counters()};
+  EXPECT_EQ(counters.inserts, 1000u);
+  EXPECT_GT(counters.insert_fixups, 0u);
+  EXPECT_GT(counters.rotations, 0u);
+  EXPECT_GE(counters.max_insert_fixups, 2u);
+  EXPECT_EQ(counters.removals, 0u);
+
+  for (int i = 0; i < 1000; i += 2) tree.erase(tree.find(i));
+  EXPECT_EQ(counters.removals, 500u);
+  EXPECT_GT(counters.removal_fixups, 0u);
+  EXPECT_LE(counters.max_removal_fixups,
+            s21::collect_stats(tree).height + 1);
+  EXPECT_TRUE(s21::is_valid_tree(tree));
+
+  tree.reset_counters();
+  EXPECT_EQ(counters.inserts, 0u);
+  EXPECT_EQ(counters.rotations, 0u);
+}
+
+TEST(TreeStatsTest, BlackParentIsNoFixup) {
+  CountingTree tree;
+  for (int key : {2, 1, 3}) tree.insert(key);
+  const s21::OperationCounters& counters{tree.get_counters()};
+  EXPECT_EQ(counters.inserts, 3u);
+  EXPECT_EQ(counters.insert_fixups, 0u);
+  EXPECT_EQ(counters.max_insert_fixups, 0u);
+
+  tree.insert(4);
+  EXPECT_EQ(counters.insert_fixups, 1u);
+  EXPECT_EQ(counters.rotations, 0u);
+  tree.insert(5);
+  EXPECT_EQ(counters.insert_fixups, 2u);
+  EXPECT_EQ(counters.rotations, 1u);
+  EXPECT_EQ(counters.max_insert_fixups, 1u);
+}
+
+TEST(TreeStatsTest, CountersCostNothingWhenOff) {
+  EXPECT_TRUE(std::is_empty_v<s21::NoCounters>);
+  EXPECT_EQ(sizeof(s21::RedBlackTree<int>) + sizeof(s21::OperationCounters),
+            sizeof(CountingTree));
+}
+
+TEST(TreeStatsTest, JsonDump) {
+  CountingTree tree;
+  for (int key : {2, 1, 3}) tree.insert(key);
+  std::ostringstream out;
+  s21::dump_json(tree, out);
+  EXPECT_EQ(out.str(),
+            "{\"node_count\":3,\"height\":2,\"black_height\":1,"
+            "\"average_search_path\":1.66667,\"depth_histogram\":[1,2],"
+            "\"counters\":{\"inserts\":3,\"removals\":0,\"insert_fixups\":0,"
+            "\"removal_fixups\":0,\"max_insert_fixups\":0,"
+            "\"max_removal_fixups\":0,\"rotations\":0}}");
+
+  s21::RedBlackTree<int> plain;
+  std::ostringstream plain_out;
+  s21::dump_json(plain, plain_out);
+  EXPECT_EQ(plain_out.str(),
+            "{\"node_count\":0,\"height\":0,\"black_height\":0,"
+            "\"average_search_path\":0,\"depth_histogram\":[]}");
+}
+
+TEST(TreeStatsTest, GraphvizDump) {
+  s21::RedBlackTree<std::string> tree;
+  for (const char* key : {"b", "a", "say \"c\""}) tree.insert(key);
+  std::ostringstream out;
+  s21::dump_graphviz(tree, out);
+  std::string dot{out.str()};
+  EXPECT_EQ(dot.rfind("digraph RedBlackTree {\n", 0), 0u);
+  EXPECT_NE(dot.find("label=\"b\", fillcolor=black"), std::string::npos);
+  EXPECT_NE(dot.find("label=\"a\", fillcolor=red"), std::string::npos);
+  EXPECT_NE(dot.find("label=\"say \\\"c\\\"\""), std::string::npos);
+  EXPECT_NE(dot.find(":sw -> "), std::string::npos);
+  EXPECT_NE(dot.find(":se -> "), std::string::npos);
+  EXPECT_EQ(dot.substr(dot.size() - 2), "}\n");
+}
+
+TEST(TreeStatsTest, ValidAfterRandomWork) {
+  CountingTree tree;
+  for (int i = 0; i < 2000; ++i) {
+    int key = Random::Get(0, 300);
+    if (i % 3 == 2 && tree.contains(key)) {
+      tree.erase(tree.find(key));
+    } else {
+      tree.insert(key);
+    }
+  }
+  EXPECT_TRUE(s21::is_valid_tree(tree));
+  const s21::OperationCounters& counters{tree.get_counters()};
+  EXPECT_EQ(counters.inserts - counters.removals, tree.size());
+}
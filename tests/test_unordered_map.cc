@@ -0,0 +1,188 @@
+#include "s21_unordered_map.h"
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+#include <gtest/gtest.h>
+#pragma GCC diagnostic pop
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "dummy_object.h"
+#include "random.h"
+#include "tracking_resource.h"
+
+namespace {
+
+// Sends every key to the same group, so each lookup has to probe past
+// all the others
+struct CollidingHash {
+  std::size_t operator()(int) const { return 42; }
+};
+
+}  // namespace
+
+TEST(UnorderedMapTest, BasicOperations) {
+  s21::unordered_map<std::string, int> map{{"one", 1}, {"two", 2}};
+  EXPECT_EQ(map.size(), 2u);
+  EXPECT_EQ(map.at("one"), 1);
+  EXPECT_THROW(map.at("three"), std::out_of_range);
+
+  EXPECT_TRUE(map.insert({"three", 3}).second);
+  EXPECT_FALSE(map.insert("three", 33).second);
+  EXPECT_FALSE(map.insert_or_assign("three", 30).second);
+  EXPECT_EQ(map["three"], 30);
+  EXPECT_EQ(map["four"], 0);
+  EXPECT_TRUE(map.try_emplace("five", 5).second);
+  EXPECT_TRUE(map.emplace("six", 6).second);
+  EXPECT_EQ(map.size(), 6u);
+
+  EXPECT_EQ(map.erase("four"), 1u);
+  EXPECT_EQ(map.erase("four"), 0u);
+  EXPECT_FALSE(map.contains("four"));
+  EXPECT_EQ(map.count("five"), 1u);
+  auto [first, last] = map.equal_range("two");
+  EXPECT_EQ(first->second, 2);
+  EXPECT_EQ(std::next(first), last);
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.begin(), map.end());
+  EXPECT_GT(map.bucket_count(), 0u);
+}
+
+TEST(UnorderedMapTest, RandomWorkMatchesStd) {
+  s21::unordered_map<int, int> map;
+  std::unordered_map<int, int> reference;
+  for (int i = 0; i < 50000; ++i) {
+    int key = Random::Get(0, 3000);
+    if (Random::Get(0, 2) == 0) {
+      EXPECT_EQ(map.erase(key), reference.erase(key));
+    } else {
+      EXPECT_EQ(map.insert_or_assign(key, i).second,
+                reference.insert_or_assign(key, i).second);
+    }
+  }
+  ASSERT_EQ(map.size(), reference.size());
+  for (const auto& [key, value] : reference) {
+    EXPECT_EQ(map.at(key), value);
+  }
+  std::size_t seen{0};
+  for (const auto& [key, value] : map) {
+    EXPECT_EQ(reference.at(key), value);
+    ++seen;
+  }
+  EXPECT_EQ(seen, reference.size());
+  EXPECT_LE(map.load_factor(), map.max_load_factor());
+}
+
+TEST(UnorderedMapTest, AllKeysInOneProbeSequence) {
+  s21::unordered_map<int, int, CollidingHash> map;
+  for (int i = 0; i < 200; ++i) map.insert(i, i * 2);
+  for (int i = 0; i < 200; i += 2) map.erase(i);
+  for (int i = 0; i < 200; ++i) {
+    EXPECT_EQ(map.contains(i), i % 2 == 1);
+  }
+  for (int i = 0; i < 200; i += 2) map.insert(i, -i);
+  EXPECT_EQ(map.size(), 200u);
+  EXPECT_EQ(map.at(100), -100);
+  EXPECT_EQ(map.at(101), 202);
+}
+
+TEST(UnorderedMapTest, EraseWhileIterating) {
+  s21::unordered_map<int, std::string> map;
+  for (int i = 0; i < 1000; ++i) map.insert(i, std::to_string(i));
+  for (auto it = map.begin(); it != map.end();) {
+    it = it->first % 3 == 0 ? map.erase(it) : std::next(it);
+  }
+  EXPECT_EQ(map.size(), 666u);
+  EXPECT_FALSE(map.contains(999));
+  EXPECT_EQ(map.at(998), "998");
+}
+
+TEST(UnorderedMapTest, ChurnDoesNotGrowTable) {
+  s21::unordered_map<int, int> map;
+  map.reserve(1000);
+  std::size_t buckets{map.bucket_count()};
+  for (int round = 0; round < 100; ++round) {
+    for (int i = 0; i < 1000; ++i) map.insert(round * 1000 + i, i);
+    for (int i = 0; i < 1000; ++i) map.erase(round * 1000 + i);
+  }
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.bucket_count(), buckets);
+
+  map.insert(1, 1);
+  map.rehash(0);
+  EXPECT_LE(map.bucket_count(), 16u);
+  EXPECT_EQ(map.at(1), 1);
+}
+
+TEST(UnorderedMapTest, CopyMoveSwapMerge) {
+  s21::unordered_map<int, DummyObject> map;
+  for (int i = 0; i < 100; ++i) map.insert(i, DummyObject{i});
+  s21::unordered_map<int, DummyObject> copy{map};
+  EXPECT_TRUE(copy == map);
+  s21::unordered_map<int, DummyObject> moved{std::move(copy)};
+  EXPECT_TRUE(copy.empty());
+  EXPECT_TRUE(moved == map);
+
+  s21::unordered_map<int, DummyObject> other{{200, DummyObject{200}},
+                                             {5, DummyObject{-5}}};
+  other.swap(moved);
+  EXPECT_EQ(other.size(), 100u);
+  EXPECT_EQ(moved.size(), 2u);
+  other.merge(moved);
+  EXPECT_TRUE(moved.empty());
+  EXPECT_EQ(other.size(), 101u);
+  EXPECT_TRUE(other != map);
+  copy = other;
+  EXPECT_TRUE(copy == other);
+}
+
+TEST(UnorderedMapTest, InsertManyAndMoveOnlyValues) {
+  s21::unordered_map<int, int> map{{1, 1}};
+  auto results = map.insert_many(std::pair<const int, int>{1, 10},
+                                 std::pair<const int, int>{2, 20},
+                                 std::pair<const int, int>{3, 30});
+  ASSERT_EQ(results.size(), 2u);
+  EXPECT_EQ(results[0].first->second, 20);
+  EXPECT_EQ(results[1].first->second, 30);
+
+  s21::unordered_map<std::string, std::unique_ptr<int>> owners;
+  for (int i = 0; i < 100; ++i) {
+    owners.try_emplace(std::to_string(i), std::make_unique<int>(i));
+  }
+  EXPECT_EQ(*owners.at("42"), 42);
+}
+
+TEST(UnorderedMapAllocatorTest, ReleasesEverything) {
+  TrackingResource resource;
+  {
+    s21::pmr::unordered_map<int, DummyObject> map(&resource);
+    for (int i = 0; i < 300; ++i) map.insert(i, DummyObject{i});
+    map.erase(map.begin());
+    s21::pmr::unordered_map<int, DummyObject> copy{map};
+    EXPECT_TRUE(copy == map);
+  }
+  EXPECT_GT(resource.allocations(), 0u);
+  EXPECT_EQ(resource.bytes_in_use(), 0u);
+}
+
+TEST(UnorderedMapAllocatorTest, MoveAssignBetweenResources) {
+  TrackingResource first_resource;
+  TrackingResource second_resource;
+  {
+    s21::pmr::unordered_map<int, int> first({{1, 1}, {2, 2}},
+                                            &first_resource);
+    s21::pmr::unordered_map<int, int> second({{3, 3}}, &second_resource);
+    first = std::move(second);
+    EXPECT_EQ(first.size(), 1u);
+    EXPECT_EQ(first.at(3), 3);
+    EXPECT_EQ(first.get_allocator().resource(), &first_resource);
+    EXPECT_TRUE(second.empty());
+  }
+  EXPECT_EQ(first_resource.bytes_in_use(), 0u);
+  EXPECT_EQ(second_resource.bytes_in_use(), 0u);
+}
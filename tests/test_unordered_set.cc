@@ -0,0 +1,97 @@
+#include "s21_unordered_set.h"
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpadded"
+#include <gtest/gtest.h>
+#pragma GCC diagnostic pop
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "random.h"
+
+namespace {
+
+// Throws on the key it was told to, to check that a failed insert
+// leaves the table as it was
+struct PickyHash {
+  std::size_t operator()(int key) const {
+    if (key == bad_key_) throw std::runtime_error("bad key");
+    return std::hash<int>{}(key);
+  }
+  int bad_key_{-1};
+};
+
+}  // namespace
+
+TEST(UnorderedSetTest, BasicOperations) {
+  s21::unordered_set<int> set{5, 3, 5, 1};
+  EXPECT_EQ(set.size(), 3u);
+  EXPECT_TRUE(set.insert(7).second);
+  EXPECT_FALSE(set.insert(7).second);
+  EXPECT_TRUE(set.emplace(9).second);
+  EXPECT_EQ(*set.find(9), 9);
+  EXPECT_EQ(set.find(4), set.end());
+  EXPECT_EQ(set.erase(3), 1u);
+  EXPECT_EQ(set.count(3), 0u);
+  auto results = set.insert_many(1, 2, 3);
+  EXPECT_EQ(results.size(), 2u);
+  EXPECT_EQ(*results[1].first, 3);
+  std::vector<int> keys(set.begin(), set.end());
+  std::sort(keys.begin(), keys.end());
+  EXPECT_EQ(keys, (std::vector<int>{1, 2, 3, 5, 7, 9}));
+}
+
+TEST(UnorderedSetTest, RandomWorkMatchesStd) {
+  s21::unordered_set<std::string> set;
+  std::unordered_set<std::string> reference;
+  for (int i = 0; i < 20000; ++i) {
+    std::string key{std::to_string(Random::Get(0, 2000))};
+    if (Random::Get(0, 1) == 0) {
+      EXPECT_EQ(set.erase(key), reference.erase(key));
+    } else {
+      EXPECT_EQ(set.insert(key).second, reference.insert(key).second);
+    }
+  }
+  ASSERT_EQ(set.size(), reference.size());
+  for (const std::string& key : reference) {
+    EXPECT_TRUE(set.contains(key));
+  }
+  EXPECT_TRUE(s21::unordered_set<std::string>(reference.begin(),
+                                              reference.end()) == set);
+}
+
+TEST(UnorderedSetTest, ReserveAvoidsRehash) {
+  s21::unordered_set<int> set;
+  set.reserve(1000);
+  std::size_t buckets{set.bucket_count()};
+  EXPECT_GE(static_cast<double>(buckets) * set.max_load_factor(), 1000.0);
+  // Full up to the load limit, and not one element more
+  int limit{static_cast<int>(buckets / 8 * 7)};
+  for (int i = 0; i < limit; ++i) set.insert(i);
+  EXPECT_EQ(set.bucket_count(), buckets);
+  set.insert(limit);
+  EXPECT_EQ(set.bucket_count(), 2 * buckets);
+}
+
+TEST(UnorderedSetTest, FailedInsertLeavesTable) {
+  s21::unordered_set<int, PickyHash> set;
+  for (int i = 0; i < 14; ++i) set.insert(i);
+  set = s21::unordered_set<int, PickyHash>(set.begin(), set.end(), 0,
+                                           PickyHash{100});
+  EXPECT_THROW(set.insert(100), std::runtime_error);
+  EXPECT_EQ(set.size(), 14u);
+  for (int i = 14; i < 100; ++i) set.insert(i);
+  EXPECT_EQ(set.size(), 100u);
+  for (int i = 0; i < 100; ++i) EXPECT_TRUE(set.contains(i));
+}
+
+TEST(UnorderedSetTest, Merge) {
+  s21::unordered_set<int> set{1, 2, 3};
+  s21::unordered_set<int> other{3, 4};
+  set.merge(other);
+  EXPECT_EQ(set.size(), 4u);
+  EXPECT_TRUE(other.empty());
+}
@@ -10,6 +10,7 @@
 #include "dummy_object.h"
 #include "random.h"
 #include "s21_vector.h"
+#include "tracking_resource.h"
 
 template <typename T>
 class VectorTest : public testing::Test {
@@ -860,3 +861,49 @@ TYPED_TEST(VectorTest, IteratorDereference) {
   *it = TypeParam{};
   EXPECT_EQ(this->s21_vec_[0], TypeParam{});
 }
+
+TEST(VectorAllocatorTest, ArenaBacked) {
+  std::byte buffer[4096];
+  std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer),
+                                            std::pmr::null_memory_resource()};
+  s21::pmr::vector<int> v{&arena};
+  for (int i{0}; i < 100; ++i) {
+    v.push_back(i);
+  }
+  v.shrink_to_fit();
+
+  EXPECT_EQ(v.size(), size_t{100});
+  EXPECT_EQ(v[99], 99);
+  EXPECT_EQ(v.get_allocator().resource(), &arena);
+}
+
+TEST(VectorAllocatorTest, ReleasesEverything) {
+  TrackingResource resource;
+  {
+    s21::pmr::vector<DummyObject> v({DummyObject{1}, DummyObject{2}},
+                                    &resource);
+    v.reserve(50);
+    v.push_back(DummyObject{3});
+    s21::pmr::vector<DummyObject> copy{v};
+    EXPECT_TRUE(copy == v);
+  }
+  EXPECT_GT(resource.allocations(), size_t{0});
+  EXPECT_EQ(resource.bytes_in_use(), size_t{0});
+}
+
+TEST(VectorAllocatorTest, MoveAssignBetweenResources) {
+  TrackingResource first_resource;
+  TrackingResource second_resource;
+  {
+    s21::pmr::vector<int> first({1, 2, 3}, &first_resource);
+    s21::pmr::vector<int> second({4, 5}, &second_resource);
+
+    first = std::move(second);
+    EXPECT_EQ(first.size(), size_t{2});
+    EXPECT_EQ(first[1], 5);
+    EXPECT_EQ(first.get_allocator().resource(), &first_resource);
+    EXPECT_EQ(second.size(), size_t{0});
+  }
+  EXPECT_EQ(first_resource.bytes_in_use(), size_t{0});
+  EXPECT_EQ(second_resource.bytes_in_use(), size_t{0});
+}
@@ -0,0 +1,43 @@
+#ifndef TRACKING_RESOURCE_H_
+#define TRACKING_RESOURCE_H_
+
+#include <cstddef>
+#include <memory_resource>
+
+// Memory resource that forwards to upstream and counts what goes through it
+class TrackingResource : public std::pmr::memory_resource {
+ public:
+  explicit TrackingResource(
+      std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+      : upstream_{upstream} {}
+  TrackingResource(const TrackingResource&) = delete;
+  TrackingResource& operator=(const TrackingResource&) = delete;
+
+  std::size_t allocations() const { return allocations_; }
+  std::size_t bytes_in_use() const { return bytes_in_use_; }
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    void* result = upstream_->allocate(bytes, alignment);
+    ++allocations_;
+    bytes_in_use_ += bytes;
+    return result;
+  }
+
+  void do_deallocate(void* p, std::size_t bytes,
+                     std::size_t alignment) override {
+    upstream_->deallocate(p, bytes, alignment);
+    bytes_in_use_ -= bytes;
+  }
+
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  std::pmr::memory_resource* upstream_;
+  std::size_t allocations_{0};
+  std::size_t bytes_in_use_{0};
+};
+
+#endif  // TRACKING_RESOURCE_H_